@@ -15,9 +15,18 @@ limitations under the License.
 */
 
 #include "DataSet.h"
+#include "DataSpan.h"
 #include "LogDL.h"
 #include "Workspace.h"
 #include "Block.h"
+#include <tools/BufferPool.h>
+#include <tools/MinMax.h>
+#include <tools/TypeConvert.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <string.h>
 
 namespace terbit
 {
@@ -27,17 +36,22 @@ static char *TerbitDataTypeStrs[] = { TERBIT_DATA_TYPES };
 #undef X
 
 DataSet::DataSet(): DataSource(), m_buffer(NULL), m_strideBytes(0),
-   m_managedBufferSize(0), m_managedBuffer(false), m_inputSource(this), m_indexDataSet(NULL)
+   m_storage(NULL), m_snapshot(NULL), m_snapshotStart(0), m_snapshotCount(0), m_inputSource(this), m_indexDataSet(NULL),
+   m_summaryEnabled(false), m_readScale(1.0), m_readOffset(0.0), m_readSaturate(true),
+   m_ringHead(0), m_ringCapacity(0), m_pager(NULL), m_affine(false), m_affineStart(0.0), m_affineStep(1.0)
 {
    //NOTE: default input source as this dataset
+
+   //connected first so the summary is stale before any consumer looks at the new data
+   connect(this, SIGNAL(NewData(DataClass*)), this, SLOT(OnNewData(DataClass*)));
 }
 
 DataSet::~DataSet()
 {
-   if (m_managedBuffer)
-   {
-      free(m_buffer);
-   }
+   //remotes sharing the buffer keep it until they let go
+   leaveStorage();
+   dropSnapshot();
+   delete m_pager;
 }
 
 bool DataSet::ImpendingDeletion()
@@ -185,13 +199,7 @@ void DataSet::RefreshData()
 {
    if (CanRefreshData()) //paranoid check
    {
-      //for now assume we are mirror of source . . . so update data set in-case the source structure data type changed . . .
-      //future sync option perhaps . . .
-      if (m_inputSource->GetDataType() != GetDataType())
-      {
-         CreateBuffer(GetDataType(),GetFirstIndex(),GetCount());
-      }
-
+      //the data set keeps its own data type, the read request converts from the source type
       m_inputSource->ReadRequest(GetFirstIndex(), GetCount(), GetAutoId());
 
       //automatically refresh index too
@@ -206,6 +214,33 @@ void DataSet::RefreshData()
    }
 }
 
+bool DataSet::ReadWindow(uint64_t firstIndex, size_t count)
+{
+   if (!CanRefreshData())
+   {
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("Attempt to read a window on a data set that is not refreshable."));
+      return false;
+   }
+
+   //keep the window inside the source
+   uint64_t sourceFirst = m_inputSource->GetFirstIndex();
+   uint64_t sourceEnd = sourceFirst + m_inputSource->GetCount();
+   if (count == 0 || sourceEnd == sourceFirst)
+   {
+      return false;
+   }
+   count = (size_t)std::min<uint64_t>(count, sourceEnd - sourceFirst);
+   firstIndex = std::max(firstIndex, sourceFirst);
+   if (firstIndex + count > sourceEnd)
+   {
+      firstIndex = sourceEnd - count;
+   }
+
+   CreateBuffer(GetDataType(), firstIndex, count);
+   RefreshData();
+   return true;
+}
+
 void DataSet::OnBeforeInputSourceRemoved(DataClass* source)
 {
    source;
@@ -232,17 +267,21 @@ void DataSet::OnInputSourceStructureChanged(DataSource *source)
 
 void DataSet::SetBuffer(TerbitDataType type, uint64_t firstIndex, size_t elementCount, void* bufferAddress, size_t strideBytes)
 {
+   emit BeforeBufferChange(this);
+   closePager();
+
    //setup as unmanaged buffer
-   if (m_managedBuffer)
-   {
-      free(m_buffer);
-      m_managedBufferSize = 0;
-      m_managedBuffer = false;
-   }
+   leaveStorage();
+   dropSnapshot();
 
+   m_affine = false;
    m_buffer = bufferAddress;
    m_strideBytes = strideBytes;
+   m_ringHead = 0;
+   m_ringCapacity = 0;
    m_defaultBufferElements = elementCount;
+   m_summary.Invalidate();
+   m_stats.Clear();
    UpdateStructure(type,firstIndex,elementCount);
 }
 
@@ -251,439 +290,990 @@ void DataSet::CreateBuffer(TerbitDataType type, uint64_t firstIndex, size_t elem
    //create managed buffer
    size_t elementSize = TerbitDataTypeSize(type);
 
-   if (m_managedBuffer)
-   {
-      if (elementSize*elementCount > m_managedBufferSize)
-      {
-         free(m_buffer);
-         m_managedBufferSize = elementCount*elementSize;
-         m_buffer = malloc(elementCount*elementSize);
-         if (!m_buffer)
-         {
-            FatalError(g_log.general, QObject::tr("DataSet::CreateBuffer Memory Allocation Failure"));
-         }
-      }
-   }
-   else
+   emit BeforeBufferChange(this);
+   closePager();
+
+   //buffers come from the pool so a source that keeps changing structure
+   //reuses freed blocks; keep the current block while it's ours alone and the size class matches
+   size_t bytes = elementSize*elementCount;
+   dropSnapshot();
+   if (!m_storage || m_storage->holders.size() > 1 || m_storage->pins > 0 || BufferPool::SizeClass(bytes) != m_storage->bytes)
    {
-      m_managedBuffer = true;
-      m_managedBufferSize = elementCount*elementSize;
-      m_buffer = malloc(elementCount*elementSize);
-      if (!m_buffer)
-      {
-         FatalError(g_log.general, QObject::tr("DataSet::CreateBuffer Memory Allocation Failure"));
-      }
+      Storage_t* s = allocStorage(bytes);
+      joinStorage(s, s->data);
    }
+   m_storage->owner = this;
+   m_buffer = m_storage->data;
+   m_affine = false;
 
    m_strideBytes = elementSize;
    m_defaultBufferElements = elementCount;
+   m_ringHead = 0;
+   m_ringCapacity = 0;
+   m_summary.Invalidate();
+   m_stats.Clear();
    UpdateStructure(type,firstIndex, elementCount);
 }
 
 void DataSet::CreateBufferAsIndex(uint64_t firstIndex, size_t elementCount)
 {
+   //element i is i, computed rather than stored
 #ifdef TERBIT_64BIT
-   CreateBuffer(TERBIT_UINT64, firstIndex, elementCount);
-   uint64_t* buf = (uint64_t*)GetBufferAddress();
+   CreateAffine(TERBIT_UINT64, firstIndex, elementCount, 0.0, 1.0);
 #else
-   CreateBuffer(TERBIT_UINT32, firstIndex, elementCount);
-   uint32_t* buf = (uint32_t*)GetBufferAddress();
+   CreateAffine(TERBIT_UINT32, firstIndex, elementCount, 0.0, 1.0);
 #endif
-   for(size_t i = 0; i < elementCount; ++i)
-   {
-      *buf = i;
-      ++buf;
-   }
 }
 
-void DataSet::ReadRequest(uint64_t startIndex, size_t elementCount, DataClassAutoId_t dataSetId)
+void DataSet::CreateAffine(TerbitDataType type, uint64_t firstIndex, size_t count, double start, double step)
 {
-   if (GetHasData() == false)
+   emit BeforeBufferChange(this);
+   closePager();
+   leaveStorage();
+   dropSnapshot();
+
+   m_affine = true;
+   m_affineStart = start;
+   m_affineStep = step;
+   m_buffer = NULL;
+   m_strideBytes = TerbitDataTypeSize(type);
+   m_ringHead = 0;
+   m_ringCapacity = 0;
+   m_defaultBufferElements = count;
+   m_summary.Invalidate();
+   m_stats.Clear();
+
+   SetHasData(true);
+   UpdateStructure(type, firstIndex, count);
+}
+
+void DataSet::CreateRingBuffer(TerbitDataType type, uint64_t firstIndex, size_t capacity)
+{
+   CreateBuffer(type, firstIndex, capacity);
+   m_ringCapacity = capacity;
+   UpdateStructure(type, firstIndex, 0);
+}
+
+bool DataSet::Append(const void* src, TerbitDataType srcType, size_t srcStrideBytes, size_t count)
+{
+   if (!IsRing() || !m_buffer)
    {
-      LogWarning2(GetType()->GetLogCategory(),GetName(),tr("Read request on source with no data.  The data set/element count may be setup, but there is no valid data in the source data set to be read."));
-      return;
+      return false;
    }
-
-   //validate start index
-   uint64_t sourceEndElement = GetFirstIndex() + GetCount();
-   if (!(startIndex >= GetFirstIndex() && startIndex < sourceEndElement))
+   if (count == 0)
    {
-      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The start index is out of range. Start index %1 not in range of first index %2 count %3").arg(startIndex).arg(GetFirstIndex()).arg(GetCount()));
-      return;
+      return true;
    }
 
-   //validate elementCount . . . we'll be nice and reduce if it's too big instead of error
-   //or should we error??
-   if (startIndex + elementCount > sourceEndElement)
+   //more than fits, only the newest elements are kept
+   size_t skip = count > m_ringCapacity ? count - m_ringCapacity : 0;
+   size_t n = count - skip;
+   const char* s = (const char*)src + skip*srcStrideBytes;
+   size_t pos = (m_ringHead + m_count + skip) % m_ringCapacity;
+   size_t first = std::min(n, m_ringCapacity - pos);
+
+   GetWriteAddress();
+
+   if (!ConvertElements(s, srcType, srcStrideBytes, (char*)m_buffer + pos*m_strideBytes, m_dataType, m_strideBytes, first))
    {
-      LogWarning2(GetType()->GetLogCategory(),GetName(),tr("Read request element count is too long.  Returning less data than requested."));
-      elementCount = sourceEndElement - startIndex;
+      return false;
    }
-
-   //get destination
-   DataSet* destDS = static_cast<DataSet*>(GetWorkspace()->FindInstance(dataSetId));
-   if (destDS == NULL)
+   if (n > first)
    {
-      LogError2(GetType()->GetLogCategory(),GetName(),tr("Read Request destination data set not found.  Destination data set id: %1").arg(dataSetId));
-      return;
+      ConvertElements(s + first*srcStrideBytes, srcType, srcStrideBytes, m_buffer, m_dataType, m_strideBytes, n - first);
    }
 
-   DataSet* dest =  destDS;
-   if (!dest->GetWritable())
+   uint64_t total = (uint64_t)m_count + count;
+   size_t keep = (size_t)std::min<uint64_t>(total, m_ringCapacity);
+   m_ringHead = ((pos + n) % m_ringCapacity + m_ringCapacity - keep) % m_ringCapacity;
+   m_summary.Invalidate();
+   SetHasData(true);
+   UpdateStructure(m_dataType, m_firstIndex + (total - keep), keep);
+   m_stats.Trim(GetFirstIndex());
+   return true;
+}
+
+bool DataSet::AppendFrom(const DataSet* src, size_t start, size_t count)
+{
+   if (!src || src == this || start + count > src->GetCount())
    {
-      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The destination data set is not writable.  Destination data set: %1").arg(destDS->GetName()));
-      return;
+      return false;
    }
 
-   if (elementCount > dest->GetCount())
+   //one run per contiguous piece of the source (wrapped ring or pages), computed blocks when affine
+   bool res = IsRing();
+   double block[256];
+   while (count > 0 && res && src->IsAffine())
    {
-      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The destination data set buffer is too small for the requested read count.  Destination data set=%1 buffer elements=%2 Requested Read=%3").arg(destDS->GetName()).arg(dest->GetCount()).arg(elementCount));
-      return;
+      size_t n = std::min(count, sizeof(block)/sizeof(block[0]));
+      res = src->CopyElements(start, n, block, TERBIT_DOUBLE, sizeof(double)) && Append(block, TERBIT_DOUBLE, sizeof(double), n);
+      start += n;
+      count -= n;
    }
-
-   if (dest->GetDataType() != GetDataType())
+   PagePin pin;
+   while (count > 0 && res)
    {
-      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The data set and destination data types do no match.  Data type conversion is not currently supported.  Destination data set: %1").arg(destDS->GetName()));
-      return;
+      size_t n = std::min(count, src->GetContiguousCount(start));
+      const void* data = src->GetElementAddress(start, pin);
+      res = data != NULL && Append(data, src->GetDataType(), src->GetStrideBytes(), n);
+      start += n;
+      count -= n;
    }
-
-   //copy the data
-   size_t elementSize = TerbitDataTypeSize(GetDataType());   
-   memcpy((char*)dest->GetBufferAddress(), (char*)GetBufferAddress() + (startIndex-GetFirstIndex())*elementSize, elementCount * elementSize);
-
-   //also read properties of data
-   //properties should by in sync with data so we read them together
-   dest->GetProperties() = m_properties;
-
-   dest->SetHasData(true);
-   dest->UpdateStructure(dest->GetDataType(),startIndex, elementCount);
-   emit dest->NewData(dest);
+   return res;
 }
 
-
-template<typename DataType>
-DataType ValueAtIndexTemplate(size_t index, char* data, size_t strideBytes)
+bool DataSet::OpenPagedFile(const QString& filename, TerbitDataType type, uint64_t headerBytes, uint64_t firstIndex, size_t pageBytes, uint64_t budgetBytes)
 {
-   return (*((DataType*)((data)+index*strideBytes)));
-}
+   size_t elementSize = TerbitDataTypeSize(type);
+   if (elementSize == 0 || !IsConvertibleDataType(type))
+   {
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("Paged data sets need a numeric data type."));
+      return false;
+   }
 
-double DataSet::GetValueAtIndex(size_t index) const
-{
-   double dataPoint;
-
-   switch (m_dataType)
-   {
-   case TERBIT_INT64:
-      dataPoint = ValueAtIndexTemplate<int64_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_UINT64:
-      dataPoint = ValueAtIndexTemplate<uint64_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_INT32:
-      dataPoint = ValueAtIndexTemplate<int32_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_UINT32:
-      dataPoint = ValueAtIndexTemplate<uint32_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_INT16:
-      dataPoint = ValueAtIndexTemplate<int16_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_UINT16:
-      dataPoint = ValueAtIndexTemplate<uint16_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_INT8:
-      dataPoint = ValueAtIndexTemplate<int8_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_UINT8:
-      dataPoint = ValueAtIndexTemplate<uint8_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_FLOAT:
-      dataPoint = ValueAtIndexTemplate<float>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_DOUBLE:
-      dataPoint = ValueAtIndexTemplate<double>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_SIZE_T:
-      dataPoint = ValueAtIndexTemplate<size_t>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   case TERBIT_BOOL:
-      dataPoint = ValueAtIndexTemplate<bool>(index, (char*) m_buffer, m_strideBytes);
-      break;
-   default:
-      if(TERBIT_DATA_TYPE_GUARD < m_dataType)
-      {
-         FatalError(g_log.general, QString("GetValueAtIndex Unknown data type - %1").arg(m_dataType));
-      }
-      else
-      {
-         LogWarning(g_log.general, tr("Cannot convert data type %1 (%2) to double.").arg(m_dataType).arg(TerbitDataTypeStrs[m_dataType]));
-      }
-      dataPoint = 0;
-      break;
+   //whole elements per page
+   pageBytes = std::max<size_t>(pageBytes / elementSize, 1) * elementSize;
+
+   PageCache* pager = new PageCache();
+   if (!pager->Open(filename, headerBytes, 0, pageBytes, budgetBytes))
+   {
+      delete pager;
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("Unable to open %1 as a paged data set.").arg(filename));
+      return false;
    }
 
-   return dataPoint;
+   emit BeforeBufferChange(this);
+   closePager();
+   leaveStorage();
+   dropSnapshot();
+
+   size_t count = (size_t)(pager->GetLength() / elementSize);
+   m_pager = pager;
+   m_affine = false;
+   m_buffer = NULL;
+   m_strideBytes = elementSize;
+   m_ringHead = 0;
+   m_ringCapacity = 0;
+   m_defaultBufferElements = std::min(count, DATASET_PAGED_WINDOW_ELEMENTS);
+   m_summary.Invalidate();
+   m_stats.Clear();
+
+   //the file is only read
+   SetWritable(false);
+   SetHasData(count > 0);
+   UpdateStructure(type, firstIndex, count);
+   return true;
 }
 
-template<typename DataType>
-void SetValueAtIndexTemplate(size_t index, char* data, size_t strideBytes, double value)
+void DataSet::closePager()
 {
-   (*((DataType*)((data)+index*strideBytes))) = (DataType)value;
+   if (m_pager)
+   {
+      delete m_pager;
+      m_pager = NULL;
+      SetWritable(true);
+   }
 }
 
-void DataSet::SetValueAtIndex(size_t index, double value)
+DataSet::Storage_t* DataSet::allocStorage(size_t bytes)
 {
-   switch (m_dataType)
-   {
-   case TERBIT_INT64:
-      SetValueAtIndexTemplate<int64_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_UINT64:
-      SetValueAtIndexTemplate<uint64_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_INT32:
-      SetValueAtIndexTemplate<int32_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_UINT32:
-      SetValueAtIndexTemplate<uint32_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_INT16:
-      SetValueAtIndexTemplate<int16_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_UINT16:
-      SetValueAtIndexTemplate<uint16_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_INT8:
-      SetValueAtIndexTemplate<int8_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_UINT8:
-      SetValueAtIndexTemplate<uint8_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_FLOAT:
-      SetValueAtIndexTemplate<float>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_DOUBLE:
-      SetValueAtIndexTemplate<double>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_SIZE_T:
-      SetValueAtIndexTemplate<size_t>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   case TERBIT_BOOL:
-      SetValueAtIndexTemplate<bool>(index, (char*) m_buffer, m_strideBytes, value);
-      break;
-   default:
-      if(TERBIT_DATA_TYPE_GUARD < m_dataType)
-      {
-         FatalError(g_log.general, QString("SetValueAtIndex Unknown data type - %1").arg(m_dataType));
-      }
-      else
-      {
-         LogWarning(g_log.general, tr("Cannot convert data type %1 (%2) to double.").arg(m_dataType).arg(TerbitDataTypeStrs[m_dataType]));
-      }
-      break;
+   Storage_t* s = new Storage_t();
+   s->data = (char*)BufferPool::Instance().Allocate(bytes, s->bytes);
+   if (!s->data)
+   {
+      FatalError(g_log.general, QObject::tr("DataSet Memory Allocation Failure"));
    }
+   s->owner = NULL;
+   s->pins = 0;
+   return s;
 }
 
-double DataSet::GetValueAtLogicalIndex(uint64_t index) const
+void DataSet::unpinStorage(Storage_t* s)
 {
-   return GetValueAtIndex((size_t)(index - m_firstIndex));
+   if (s && --s->pins == 0 && s->holders.empty())
+   {
+      BufferPool::Instance().Release(s->data);
+      delete s;
+   }
 }
 
-void DataSet::SetValueAtLogicalIndex(uint64_t index, double value)
+void DataSet::joinStorage(Storage_t* s, char* buffer)
 {
-   SetValueAtIndex((size_t)(index - m_firstIndex), value);
+   s->holders.push_back(this);
+   leaveStorage();
+   m_storage = s;
+   m_buffer = buffer;
 }
 
-template<typename DataType>
-void LowerBoundIndexTemplate(double key, size_t& index, char* data, size_t strideBytes, size_t count)
+void DataSet::leaveStorage()
 {
-   //find the bound
-   DataType value;
-   size_t left, right, mid;
-   left = 0;
-   right = count-1;
-   while (left < right)
+   Storage_t* s = m_storage;
+   if (!s)
    {
-      mid = left + (right - left) / 2;
-      value = ValueAtIndexTemplate<DataType>(mid, data, strideBytes);
-      if (value < key)
-      {
-         left = mid + 1;
-      }
-      else
-      {
-         right = mid;
-      }
+      return;
    }
+   m_storage = NULL;
+   m_buffer = NULL;
 
-   //now make sure value we found is on proper side
-   //left is set properly
-   //because values are not exact, could be before or after bound
-   value = ValueAtIndexTemplate<DataType>(left, data, strideBytes); //ensure value is for left
-   if (value <= key)
+   s->holders.erase(std::find(s->holders.begin(), s->holders.end(), this));
+   if (s->owner == this)
    {
-      index = left;
+      s->owner = NULL;
    }
-   else
+   if (s->holders.empty() && s->pins == 0)
    {
-      index = left - 1;
+      BufferPool::Instance().Release(s->data);
+      delete s;
    }
 }
 
-template<typename DataType>
-void UpperBoundIndexTemplate(double key, size_t& index, char* data, size_t strideBytes, size_t count)
+void DataSet::detach(bool keepData)
 {
-   //find the bound
-   DataType value;
-   size_t left, right, mid;
-   left = 0;
-   right = count-1;
-   while (left < right)
+   Storage_t* s = m_storage;
+   if (!s)
    {
-      mid = left + (right - left) / 2;
-      value = ValueAtIndexTemplate<DataType>(mid, data, strideBytes);
-      if (value < key)
+      return;
+   }
+   if (s->holders.size() == 1 && s->pins == 0)
+   {
+      s->owner = this;
+      return;
+   }
+
+   if (s->owner == this)
+   {
+      //the others move to a copy of the part they use, we keep our address (producers hold it)
+      char* lo = NULL;
+      char* hi = NULL;
+      std::vector<DataSet*> others;
+      for (DataSet* h : s->holders)
       {
-         left = mid + 1;
+         if (h != this)
+         {
+            char* b = (char*)h->m_buffer;
+            char* e = b + h->bufferCapacity()*h->m_strideBytes;
+            lo = (!lo || b < lo) ? b : lo;
+            hi = (!hi || e > hi) ? e : hi;
+            others.push_back(h);
+         }
       }
-      else
+      Storage_t* c = allocStorage(s->bytes);
+      memcpy(c->data + (lo - s->data), lo, hi - lo);
+      for (DataSet* h : others)
       {
-         right = mid;
+         emit h->BeforeBufferChange(h);
+         h->joinStorage(c, c->data + ((char*)h->m_buffer - s->data));
       }
    }
-
-   //now make sure value we found is on proper side
-   //left is set properly
-   //because values are not exact, could be before or after bound
-   value = ValueAtIndexTemplate<DataType>(left, data, strideBytes); //ensure value is for left
-   if (value >= key)
-   {
-      index = left;
-   }
    else
    {
-      index = left+1;
+      //move to storage of our own
+      size_t bytes = bufferCapacity()*m_strideBytes;
+      Storage_t* c = allocStorage(bytes);
+      if (keepData)
+      {
+         memcpy(c->data, m_buffer, bytes);
+      }
+      joinStorage(c, c->data);
+      c->owner = this;
    }
 }
 
-template<typename DataType>
-bool BoundingIndiciesTemplate(double startValue, double endValue, size_t& start, size_t& end, char* data, size_t strideBytes, size_t count)
+bool DataSet::shareInto(DataSet* dest, size_t pos, size_t count)
 {
-   //assume data is ordered
-   //find indicies that tightly cover given value range
-   //ensure that there's overlap with given value range
-   bool foundStart, foundEnd;
-   foundStart = foundEnd = false;
-
-   if (count > 0)
+   if (m_affine)
    {
-      DataType firstValue, lastValue;
-      firstValue = ValueAtIndexTemplate<DataType>(0, data, strideBytes);
-      lastValue = ValueAtIndexTemplate<DataType>(count-1, data, strideBytes);
-
-      //check that there's overlap, may be outside range entirely
-      if (firstValue >= startValue && firstValue < endValue)
+      //an affine source is read as an affine remote, the read conversion folds into it
+      if (dest == this || dest->IsRing() || dest->IsPaged() || (dest->m_buffer && !dest->m_storage))
       {
-         start = 0;
-         foundStart = true;
+         return false;
       }
-      else if (firstValue < startValue)
+      emit dest->BeforeBufferChange(dest);
+      dest->leaveStorage();
+      dest->dropSnapshot();
+      dest->m_affine = true;
+      dest->m_affineStart = affineValue(pos)*dest->GetReadScale() + dest->GetReadOffset();
+      dest->m_affineStep = m_affineStep*dest->GetReadScale();
+      dest->m_strideBytes = TerbitDataTypeSize(dest->GetDataType());
+      dest->m_ringHead = 0;
+      return true;
+   }
+
+   size_t elementSize = TerbitDataTypeSize(m_dataType);
+   if (dest == this || count == 0 || dest->GetDataType() != m_dataType || !IsConvertibleDataType(m_dataType) ||
+       dest->GetReadScale() != 1.0 || dest->GetReadOffset() != 0.0 ||
+       IsRing() || IsPaged() || !m_buffer || dest->IsRing() || dest->IsPaged() || (dest->m_buffer && !dest->m_storage))
+   {
+      return false;
+   }
+
+   char* buffer;
+   if (m_storage)
+   {
+      if (m_strideBytes != elementSize)
       {
-         //find start, outside of start value
-         LowerBoundIndexTemplate<DataType>(startValue, start, data, strideBytes, count);
-         foundStart = true;
+         return false;
       }
-
-      //check that there's overlap, may be outside range entirely
-      if (lastValue > startValue && lastValue <= endValue)
+      buffer = (char*)m_buffer + pos*m_strideBytes;
+      if (dest->m_storage == m_storage && dest->m_buffer == buffer)
       {
-         end = count-1;
-         foundEnd = true;
+         return true;
       }
-      else if (lastValue > endValue)
+   }
+   else
+   {
+      //an unmanaged buffer changes under us, its remotes share one copy per new data
+      if (!m_snapshot || pos < m_snapshotStart || pos + count > m_snapshotStart + m_snapshotCount)
       {
-         //find end, outside of end value
-         UpperBoundIndexTemplate<DataType>(endValue, end, data, strideBytes, count);
-         foundEnd = true;
+         dropSnapshot();
+         m_snapshot = allocStorage(count*elementSize);
+         m_snapshot->pins = 1;
+         m_snapshotStart = pos;
+         m_snapshotCount = count;
+         ConvertElements(GetElementAddress(pos), m_dataType, m_strideBytes, m_snapshot->data, m_dataType, elementSize, count);
       }
+      buffer = m_snapshot->data + (pos - m_snapshotStart)*elementSize;
    }
 
-   return foundStart && foundEnd;
+   //the destination's old buffer may be freed
+   emit dest->BeforeBufferChange(dest);
+   dest->dropSnapshot();
+   dest->joinStorage(m_storage ? m_storage : m_snapshot, buffer);
+   dest->m_affine = false;
+   dest->m_strideBytes = elementSize;
+   dest->m_ringHead = 0;
+   return true;
 }
 
-bool DataSet::BoundingIndicies(double startValue, double endValue, size_t& start, size_t& end) const
+void DataSet::dropSnapshot()
 {
-   bool res = false;
+   unpinStorage(m_snapshot);
+   m_snapshot = NULL;
+}
 
-   switch (m_dataType)
-   {
-   case TERBIT_INT64:
-      res = BoundingIndiciesTemplate<int64_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT64:
-      res = BoundingIndiciesTemplate<uint64_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT32:
-      res = BoundingIndiciesTemplate<int32_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT32:
-      res = BoundingIndiciesTemplate<uint32_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT16:
-      res = BoundingIndiciesTemplate<int16_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT16:
-      res = BoundingIndiciesTemplate<uint16_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT8:
-      res = BoundingIndiciesTemplate<int8_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT8:
-      res = BoundingIndiciesTemplate<uint8_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_FLOAT:
-      res = BoundingIndiciesTemplate<float>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_DOUBLE:
-      res = BoundingIndiciesTemplate<double>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_SIZE_T:
-      res = BoundingIndiciesTemplate<size_t>(startValue, endValue, start, end, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   default:
-      if(TERBIT_DATA_TYPE_GUARD < m_dataType)
-      {
-         FatalError(g_log.general, QString("ClosestIndex Unknown data type - %1").arg(m_dataType));
-      }
-      else
-      {
-         LogWarning(g_log.general, tr("ClosestIndex invalid data type %1 (%2).").arg(m_dataType).arg(TerbitDataTypeStrs[m_dataType]));
-      }
-      break;
-   }
+void* DataSet::GetWriteAddress()
+{
+   detach(true);
+   dropSnapshot();
+   return m_buffer;
+}
 
-   return res;
+bool DataSet::IsBufferShared() const
+{
+   return (m_storage && (m_storage->holders.size() > 1 || m_storage->pins > 0)) || m_snapshot;
 }
 
+size_t DataSet::GetSpans(size_t start, size_t count, DataSetSpan_t spans[2]) const
+{
+   if (count == 0 || start >= m_count || count > m_count - start)
+   {
+      return 0;
+   }
 
-template<typename DataType, typename KeyDataType>
-bool ClosestIndexTemplate(KeyDataType key, size_t& index, char* data, size_t strideBytes, size_t count)
+   size_t n = std::min(count, GetContiguousCount(start));
+   spans[0].data = GetElementAddress(start);
+   spans[0].count = n;
+   if (spans[0].data == NULL)
+   {
+      return 0;
+   }
+   if (n == count)
+   {
+      return 1;
+   }
+   spans[1].data = m_buffer;
+   spans[1].count = count - n;
+   return 2;
+}
+
+size_t DataSet::GetContiguousCount(size_t index) const
 {
-   //assume data is ordered
-   //key must be within range
-   //binary search for left/right index
-   bool res = false;
+   if (index >= m_count)
+   {
+      return 0;
+   }
+   if (IsRing())
+   {
+      return std::min(m_count - index, m_ringCapacity - physicalIndex(index));
+   }
+   if (IsPaged())
+   {
+      //to the end of the page
+      size_t pageBytes = m_pager->GetPageBytes();
+      size_t inPage = (size_t)(((uint64_t)index*m_strideBytes) % pageBytes);
+      return std::min(m_count - index, (pageBytes - inPage)/m_strideBytes);
+   }
+   return m_count - index;
+}
 
-   if (count > 0)
+void* DataSet::GetElementAddress(size_t index) const
+{
+   if (m_affine || m_pager)
    {
-      DataType value;
+      return NULL;
+   }
+   return (char*)m_buffer + physicalIndex(index)*m_strideBytes;
+}
+
+const void* DataSet::GetElementAddress(size_t index, PagePin& pin) const
+{
+   if (m_pager)
+   {
+      uint64_t pos = (uint64_t)index*m_strideBytes;
+      size_t nBytes;
+      const char* page = m_pager->GetPage(pos / m_pager->GetPageBytes(), nBytes, pin);
+      return page ? page + pos % m_pager->GetPageBytes() : NULL;
+   }
+   return GetElementAddress(index);
+}
+
+bool DataSet::CopyElements(size_t start, size_t count, void* dest, TerbitDataType destType, size_t destStrideBytes,
+                           double scale, double offset, bool saturate) const
+{
+   if (start > m_count || count > m_count - start)
+   {
+      return false;
+   }
+
+   char* d = (char*)dest;
+   if (m_affine)
+   {
+      //computed a block at a time, converted like stored doubles
+      double block[256];
+      while (count > 0)
+      {
+         size_t n = std::min(count, sizeof(block)/sizeof(block[0]));
+         for (size_t i = 0; i < n; ++i)
+         {
+            block[i] = affineValue(start + i);
+         }
+         if (!ConvertElements(block, TERBIT_DOUBLE, sizeof(double), d, destType, destStrideBytes, n, scale, offset, saturate))
+         {
+            return false;
+         }
+         d += n*destStrideBytes;
+         start += n;
+         count -= n;
+      }
+      return true;
+   }
+
+   //a run at a time: the whole buffer, both halves of a wrapped ring or each page of a paged set
+   PagePin pin;
+   while (count > 0)
+   {
+      size_t n = std::min(count, GetContiguousCount(start));
+      const void* src = GetElementAddress(start, pin);
+      if (n == 0 || src == NULL ||
+          !ConvertElements(src, m_dataType, m_strideBytes, d, destType, destStrideBytes, n, scale, offset, saturate))
+      {
+         return false;
+      }
+      d += n*destStrideBytes;
+      start += n;
+      count -= n;
+   }
+   return true;
+}
+
+bool DataSet::WriteElements(size_t start, size_t count, const void* src, TerbitDataType srcType, size_t srcStrideBytes,
+                            double scale, double offset, bool saturate)
+{
+   if (IsPaged() || m_affine || m_buffer == NULL || start > m_count || count > m_count - start)
+   {
+      return false;
+   }
+
+   GetWriteAddress();
+
+   //a run at a time, a wrapped ring is written in two
+   const char* s = (const char*)src;
+   size_t first = start;
+   size_t remaining = count;
+   while (remaining > 0)
+   {
+      size_t n = std::min(remaining, GetContiguousCount(first));
+      void* dest = GetElementAddress(first);
+      if (n == 0 || dest == NULL ||
+          !ConvertElements(s, srcType, srcStrideBytes, dest, m_dataType, m_strideBytes, n, scale, offset, saturate))
+      {
+         InvalidateMinMaxSummary(start, count);
+         return false;
+      }
+      s += n*srcStrideBytes;
+      first += n;
+      remaining -= n;
+   }
+   InvalidateMinMaxSummary(start, count);
+   return true;
+}
+
+void DataSet::ReadRequest(uint64_t startIndex, size_t elementCount, DataClassAutoId_t dataSetId)
+{
+   if (GetHasData() == false)
+   {
+      LogWarning2(GetType()->GetLogCategory(),GetName(),tr("Read request on source with no data.  The data set/element count may be setup, but there is no valid data in the source data set to be read."));
+      return;
+   }
+
+   //validate start index
+   uint64_t sourceEndElement = GetFirstIndex() + GetCount();
+   if (!(startIndex >= GetFirstIndex() && startIndex < sourceEndElement))
+   {
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The start index is out of range. Start index %1 not in range of first index %2 count %3").arg(startIndex).arg(GetFirstIndex()).arg(GetCount()));
+      return;
+   }
+
+   //validate elementCount . . . we'll be nice and reduce if it's too big instead of error
+   //or should we error??
+   if (startIndex + elementCount > sourceEndElement)
+   {
+      LogWarning2(GetType()->GetLogCategory(),GetName(),tr("Read request element count is too long.  Returning less data than requested."));
+      elementCount = sourceEndElement - startIndex;
+   }
+
+   //get destination
+   DataSet* destDS = static_cast<DataSet*>(GetWorkspace()->FindInstance(dataSetId));
+   if (destDS == NULL)
+   {
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("Read Request destination data set not found.  Destination data set id: %1").arg(dataSetId));
+      return;
+   }
+
+   DataSet* dest =  destDS;
+   if (!dest->GetWritable())
+   {
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The destination data set is not writable.  Destination data set: %1").arg(destDS->GetName()));
+      return;
+   }
+
+   //a paged destination has no buffer to read into
+   if (dest->IsPaged())
+   {
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The destination data set is paged from a file.  Destination data set: %1").arg(destDS->GetName()));
+      return;
+   }
+
+   if (elementCount > dest->bufferCapacity())
+   {
+      LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  The destination data set buffer is too small for the requested read count.  Destination data set=%1 buffer elements=%2 Requested Read=%3").arg(destDS->GetName()).arg(dest->bufferCapacity()).arg(elementCount));
+      return;
+   }
+
+   size_t pos = (size_t)(startIndex-GetFirstIndex());
+
+   //same data type without a conversion: the destination shares the data instead of a copy
+   if (!shareInto(dest, pos, elementCount))
+   {
+      //the source is read a contiguous run at a time (one for a fixed buffer, two for a wrapped
+      //ring, a page at a time when paged, computed when affine), a ring destination is refilled from its start
+      if (!IsConvertibleDataType(GetDataType()) || !IsConvertibleDataType(dest->GetDataType()))
+      {
+         LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  Data type conversion from %1 to %2 is not supported.  Destination data set: %3").arg(TerbitDataTypeStrs[GetDataType()]).arg(TerbitDataTypeStrs[dest->GetDataType()]).arg(destDS->GetName()));
+         return;
+      }
+      if (dest->IsAffine())
+      {
+         //back to a buffer of its own, keeping the size it reads by default
+         size_t defaultElements = dest->m_defaultBufferElements;
+         dest->CreateBuffer(dest->GetDataType(), dest->GetFirstIndex(), dest->GetCount());
+         dest->m_defaultBufferElements = defaultElements;
+      }
+      dest->detach(false);
+      dest->dropSnapshot();
+      dest->m_ringHead = 0;
+
+      //copy the data, converting to the destination type and its read scale/offset
+      if (!CopyElements(pos, elementCount, dest->GetBufferAddress(), dest->GetDataType(), dest->GetStrideBytes(),
+                        dest->GetReadScale(), dest->GetReadOffset(), dest->GetReadSaturate()))
+      {
+         LogError2(GetType()->GetLogCategory(),GetName(),tr("ReadRequest error.  Unable to read the data from index %1.").arg(startIndex));
+         return;
+      }
+   }
+
+   //also read properties of data
+   //properties should by in sync with data so we read them together (implicitly shared)
+   dest->GetProperties() = m_properties;
+
+   //all of the destination was replaced, a ring's included
+   dest->m_stats.Clear();
+   dest->SetHasData(true);
+   dest->UpdateStructure(dest->GetDataType(),startIndex, elementCount);
+   emit dest->NewData(dest);
+}
+
+
+bool DataSet::ConvertInto(DataSet* dest, size_t start, size_t count, size_t destStart, double scale, double offset, bool saturate) const
+{
+   if (!dest || (!m_buffer && !m_pager && !m_affine) || !dest->GetBufferAddress() || start + count > GetCount() ||
+       destStart > dest->GetCount() || count > dest->GetCount() - destStart)
+   {
+      return false;
+   }
+   //the kernels work front to back in blocks, no overlapping copies within a data set
+   if (dest == this && start < destStart + count && destStart < start + count)
+   {
+      return false;
+   }
+
+   //the destination may wrap (ring), the source is read in any mode, convert run by run
+   dest->GetWriteAddress();
+   size_t pos = start;
+   size_t destPos = destStart;
+   size_t left = count;
+   bool res = true;
+   while (left > 0 && res)
+   {
+      size_t n = std::min(left, dest->GetContiguousCount(destPos));
+      res = n > 0 && CopyElements(pos, n, dest->GetElementAddress(destPos), dest->GetDataType(), dest->GetStrideBytes(),
+                                  scale, offset, saturate);
+      pos += n;
+      destPos += n;
+      left -= n;
+   }
+   if (res)
+   {
+      dest->InvalidateMinMaxSummary(destStart, count);
+   }
+   return res;
+}
+
+void DataSet::SetReadConversion(double scale, double offset, bool saturate)
+{
+   m_readScale = scale;
+   m_readOffset = offset;
+   m_readSaturate = saturate;
+}
+
+//unknown data types are fatal, non-numeric ones are warned about
+static void InvalidDataType(const char* operation, TerbitDataType type)
+{
+   if(TERBIT_DATA_TYPE_GUARD < type)
+   {
+      FatalError(g_log.general, QString("%1 Unknown data type - %2").arg(operation).arg(type));
+   }
+   else
+   {
+      LogWarning(g_log.general, QObject::tr("%1 invalid data type %2 (%3).").arg(operation).arg(type).arg(TerbitDataTypeStrs[type]));
+   }
+}
+
+class ValueAtIndexVisitor
+{
+public:
+   ValueAtIndexVisitor(const char* data) : m_data(data), m_value(0) {}
+   template<typename DataType> void Visit() { m_value = (double)*((const DataType*)m_data); }
+   double GetValue() const { return m_value; }
+private:
+   const char* m_data;
+   double m_value;
+};
+
+class SetValueAtIndexVisitor
+{
+public:
+   SetValueAtIndexVisitor(char* data, double value) : m_data(data), m_value(value) {}
+   template<typename DataType> void Visit() { *((DataType*)m_data) = (DataType)m_value; }
+private:
+   char* m_data;
+   double m_value;
+};
+
+double DataSet::GetValueAtIndex(size_t index) const
+{
+   if (m_affine)
+   {
+      return affineValue(index);
+   }
+
+   PagePin pin;
+   const char* data = (const char*)GetElementAddress(index, pin);
+   if (data == NULL)
+   {
+      return 0;
+   }
+
+   ValueAtIndexVisitor v(data);
+   if (!VisitDataType(m_dataType, v))
+   {
+      InvalidDataType("GetValueAtIndex", m_dataType);
+   }
+   return v.GetValue();
+}
+
+void DataSet::SetValueAtIndex(size_t index, double value)
+{
+   if (IsPaged())
+   {
+      LogWarning2(GetType()->GetLogCategory(),GetName(),tr("Paged data sets are read only."));
+      return;
+   }
+   if (IsAffine())
+   {
+      LogWarning2(GetType()->GetLogCategory(),GetName(),tr("Affine data sets are computed and read only."));
+      return;
+   }
+   GetWriteAddress();
+
+   SetValueAtIndexVisitor v((char*)GetElementAddress(index), value);
+   if (!VisitDataType(m_dataType, v))
+   {
+      InvalidDataType("SetValueAtIndex", m_dataType);
+   }
+
+   m_summary.Invalidate(index, 1);
+   m_stats.Invalidate(GetFirstIndex() + index, 1);
+}
+
+double DataSet::GetValueAtLogicalIndex(uint64_t index) const
+{
+   return GetValueAtIndex((size_t)(index - m_firstIndex));
+}
+
+void DataSet::SetValueAtLogicalIndex(uint64_t index, double value)
+{
+   SetValueAtIndex((size_t)(index - m_firstIndex), value);
+}
+
+template<typename DataType>
+void LowerBoundIndexTemplate(double key, size_t& index, const DataView<DataType>& data, size_t count)
+{
+   //find the bound
+   DataType value;
+   size_t left, right, mid;
+   left = 0;
+   right = count-1;
+   while (left < right)
+   {
+      mid = left + (right - left) / 2;
+      value = data[mid];
+      if (value < key)
+      {
+         left = mid + 1;
+      }
+      else
+      {
+         right = mid;
+      }
+   }
+
+   //now make sure value we found is on proper side
+   //left is set properly
+   //because values are not exact, could be before or after bound
+   value = data[left]; //ensure value is for left
+   if (value <= key)
+   {
+      index = left;
+   }
+   else
+   {
+      index = left - 1;
+   }
+}
+
+template<typename DataType>
+void UpperBoundIndexTemplate(double key, size_t& index, const DataView<DataType>& data, size_t count)
+{
+   //find the bound
+   DataType value;
+   size_t left, right, mid;
+   left = 0;
+   right = count-1;
+   while (left < right)
+   {
+      mid = left + (right - left) / 2;
+      value = data[mid];
+      if (value < key)
+      {
+         left = mid + 1;
+      }
+      else
+      {
+         right = mid;
+      }
+   }
+
+   //now make sure value we found is on proper side
+   //left is set properly
+   //because values are not exact, could be before or after bound
+   value = data[left]; //ensure value is for left
+   if (value >= key)
+   {
+      index = left;
+   }
+   else
+   {
+      index = left+1;
+   }
+}
+
+template<typename DataType>
+bool BoundingIndiciesTemplate(double startValue, double endValue, size_t& start, size_t& end, const DataView<DataType>& data, size_t count)
+{
+   //assume data is ordered
+   //find indicies that tightly cover given value range
+   //ensure that there's overlap with given value range
+   bool foundStart, foundEnd;
+   foundStart = foundEnd = false;
+
+   if (count > 0)
+   {
+      DataType firstValue, lastValue;
+      firstValue = data[0];
+      lastValue = data[count-1];
+
+      //check that there's overlap, may be outside range entirely
+      if (firstValue >= startValue && firstValue < endValue)
+      {
+         start = 0;
+         foundStart = true;
+      }
+      else if (firstValue < startValue)
+      {
+         //find start, outside of start value
+         LowerBoundIndexTemplate<DataType>(startValue, start, data, count);
+         foundStart = true;
+      }
+
+      //check that there's overlap, may be outside range entirely
+      if (lastValue > startValue && lastValue <= endValue)
+      {
+         end = count-1;
+         foundEnd = true;
+      }
+      else if (lastValue > endValue)
+      {
+         //find end, outside of end value
+         UpperBoundIndexTemplate<DataType>(endValue, end, data, count);
+         foundEnd = true;
+      }
+   }
+
+   return foundStart && foundEnd;
+}
+
+//largest index with a value <= key when the first value is below key
+static size_t AffineLowerBound(double key, double first, double step, size_t count)
+{
+   if (step <= 0.0)
+   {
+      return count-1;
+   }
+   double f = std::floor((key - first) / step);
+   size_t index = f >= (double)(count-1) ? count-1 : (size_t)f;
+   //the division rounds, settle on the exact bound
+   while (index+1 < count && first + step*(index+1) <= key)
+   {
+      ++index;
+   }
+   while (index > 0 && first + step*index > key)
+   {
+      --index;
+   }
+   return index;
+}
+
+//smallest index with a value >= key when the last value is above key
+static size_t AffineUpperBound(double key, double first, double step, size_t count)
+{
+   if (step <= 0.0)
+   {
+      return 0;
+   }
+   double f = std::ceil((key - first) / step);
+   size_t index = f <= 0.0 ? 0 : (f >= (double)(count-1) ? count-1 : (size_t)f);
+   while (index > 0 && first + step*(index-1) >= key)
+   {
+      --index;
+   }
+   while (index+1 < count && first + step*index < key)
+   {
+      ++index;
+   }
+   return index;
+}
+
+class BoundingIndiciesVisitor
+{
+public:
+   BoundingIndiciesVisitor(const DataSet* ds, double startValue, double endValue, size_t& start, size_t& end) :
+      res(false), m_ds(ds), m_startValue(startValue), m_endValue(endValue), m_start(start), m_end(end) {}
+   template<typename DataType> void Visit()
+   {
+      res = BoundingIndiciesTemplate<DataType>(m_startValue, m_endValue, m_start, m_end, DataView<DataType>(m_ds), m_ds->GetCount());
+   }
+   bool res;
+private:
+   const DataSet* m_ds;
+   double m_startValue;
+   double m_endValue;
+   size_t& m_start;
+   size_t& m_end;
+};
+
+bool DataSet::BoundingIndicies(double startValue, double endValue, size_t& start, size_t& end) const
+{
+   if (m_affine)
+   {
+      //same bounds as the search over ordered data, computed
+      bool foundStart = false;
+      bool foundEnd = false;
+      if (m_count > 0)
+      {
+         double firstValue = affineValue(0);
+         double lastValue = affineValue(m_count-1);
+         if (firstValue >= startValue && firstValue < endValue)
+         {
+            start = 0;
+            foundStart = true;
+         }
+         else if (firstValue < startValue)
+         {
+            start = AffineLowerBound(startValue, m_affineStart, m_affineStep, m_count);
+            foundStart = true;
+         }
+         if (lastValue > startValue && lastValue <= endValue)
+         {
+            end = m_count-1;
+            foundEnd = true;
+         }
+         else if (lastValue > endValue)
+         {
+            end = AffineUpperBound(endValue, m_affineStart, m_affineStep, m_count);
+            foundEnd = true;
+         }
+      }
+      return foundStart && foundEnd;
+   }
+
+   BoundingIndiciesVisitor v(this, startValue, endValue, start, end);
+   if (!VisitDataType(m_dataType, v))
+   {
+      InvalidDataType("BoundingIndicies", m_dataType);
+   }
+   return v.res;
+}
+
+
+template<typename DataType, typename KeyDataType>
+bool ClosestIndexTemplate(KeyDataType key, size_t& index, const DataView<DataType>& data, size_t count)
+{
+   //assume data is ordered
+   //key must be within range
+   //binary search for left/right index
+   bool res = false;
+
+   if (count > 0)
+   {
+      DataType value;
       size_t left, right, mid;
       left = 0;
       right = count-1;
       while (left < right)
       {
          mid = left + (right - left) / 2;
-         value = ValueAtIndexTemplate<DataType>(mid, data, strideBytes);
+         value = data[mid];
          if (value < key)
          {
             left = mid + 1;
@@ -697,7 +1287,7 @@ bool ClosestIndexTemplate(KeyDataType key, size_t& index, char* data, size_t str
       //now make sure key is within range and determine which is closest
       //left is set properly
       //because values are not exact, could be before or after value
-      value = ValueAtIndexTemplate<DataType>(left, data, strideBytes); //ensure value is for left
+      value = data[left]; //ensure value is for left
       size_t alt = left;
       if (value < key && left < count-1)
       {
@@ -710,7 +1300,7 @@ bool ClosestIndexTemplate(KeyDataType key, size_t& index, char* data, size_t str
 
       if (alt != left)
       {
-         DataType valueAlt = ValueAtIndexTemplate<DataType>(alt, data, strideBytes);
+         DataType valueAlt = data[alt];
 
          if (((value < valueAlt) && ((key - value) > (valueAlt - key))) ||
              ((value > valueAlt) && ((value - key) > (key - valueAlt))))
@@ -746,200 +1336,254 @@ bool ClosestIndexTemplate(KeyDataType key, size_t& index, char* data, size_t str
    return res;
 }
 
+//the key's type resolved for a data set of DataType elements
 template<typename DataType>
-bool ClosestIndexKeyTemplate(const TerbitValue& key, size_t& index, char* data, size_t strideBytes, size_t count)
+class ClosestIndexKeyVisitor
 {
-   bool res = false;
-   TerbitDataType t = key.GetDataType();
-
-   switch (t)
-   {
-   case TERBIT_INT64:
-      res = ClosestIndexTemplate<DataType, int64_t>(*((int64_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_UINT64:
-      res = ClosestIndexTemplate<DataType, uint64_t>(*((uint64_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_INT32:
-      res = ClosestIndexTemplate<DataType, int32_t>(*((int32_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_UINT32:
-      res = ClosestIndexTemplate<DataType, uint32_t>(*((uint32_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_INT16:
-      res = ClosestIndexTemplate<DataType, int16_t>(*((int16_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_UINT16:
-      res = ClosestIndexTemplate<DataType, uint16_t>(*((uint16_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_INT8:
-      res = ClosestIndexTemplate<DataType, int8_t>(*((int8_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_UINT8:
-      res = ClosestIndexTemplate<DataType, uint8_t>(*((uint8_t*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_FLOAT:
-      res = ClosestIndexTemplate<DataType, float>(*((float*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_DOUBLE:
-      res = ClosestIndexTemplate<DataType, double>(*((double*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   case TERBIT_SIZE_T:
-      res = ClosestIndexTemplate<DataType, size_t>(*((double*)key.GetValue()), index, data, strideBytes, count);
-      break;
-   default:
-      if(TERBIT_DATA_TYPE_GUARD < t)
+public:
+   ClosestIndexKeyVisitor(const TerbitValue& key, const DataView<DataType>& data, size_t& index) :
+      res(false), m_key(key), m_data(data), m_index(index) {}
+   template<typename KeyDataType> void Visit()
+   {
+      res = ClosestIndexTemplate<DataType, KeyDataType>(*((KeyDataType*)m_key.GetValue()), m_index, m_data, m_data.GetCount());
+   }
+   bool res;
+private:
+   const TerbitValue& m_key;
+   const DataView<DataType>& m_data;
+   size_t& m_index;
+};
+
+class ClosestIndexVisitor
+{
+public:
+   ClosestIndexVisitor(const DataSet* ds, const TerbitValue& key, size_t& index) : res(false), m_ds(ds), m_key(key), m_index(index) {}
+   template<typename DataType> void Visit()
+   {
+      DataView<DataType> data(m_ds);
+      ClosestIndexKeyVisitor<DataType> v(m_key, data, m_index);
+      if (!VisitDataType(m_key.GetDataType(), v))
+      {
+         InvalidDataType("ClosestIndex key", m_key.GetDataType());
+      }
+      res = v.res;
+   }
+   bool res;
+private:
+   const DataSet* m_ds;
+   const TerbitValue& m_key;
+   size_t& m_index;
+};
+
+bool DataSet::ClosestIndex(const TerbitValue& key, size_t& index) const
+{
+   if (m_affine)
+   {
+      if (m_count == 0)
+      {
+         return false;
+      }
+      double k = key.GetConvertedValue<double>();
+      double firstValue = affineValue(0);
+      double lastValue = affineValue(m_count-1);
+      double f = m_affineStep != 0.0 ? std::floor((k - m_affineStart) / m_affineStep + 0.5) : 0.0;
+      index = f <= 0.0 ? 0 : (f >= (double)(m_count-1) ? m_count-1 : (size_t)f);
+      return k >= std::min(firstValue, lastValue) && k <= std::max(firstValue, lastValue);
+   }
+
+   ClosestIndexVisitor v(this, key, index);
+   if (!VisitDataType(m_dataType, v))
+   {
+      InvalidDataType("ClosestIndex", m_dataType);
+   }
+   return v.res;
+}
+
+
+
+//min/max of each run combined, the contiguous runs use the vectorized kernels
+template<typename DataType>
+class MinMaxRuns
+{
+public:
+   MinMaxRuns() : found(false) {}
+   void operator()(const DataSpan<DataType>& span)
+   {
+      DataType runMin, runMax;
+      if (span.IsContiguous())
       {
-         FatalError(g_log.general, QString("ClosestIndex Unknown key data type - %1").arg(t));
+         MinMaxContiguous(span.GetData(), span.GetCount(), runMin, runMax);
       }
       else
       {
-         LogWarning(g_log.general, QObject::tr("ClosestIndex invalid key data type %1 (%2).").arg(t).arg(TerbitDataTypeStrs[t]));
+         // strided view (e.g. one channel of interleaved data), gathered
+         MinMaxStrided(span.GetData(), span.GetCount(), span.GetStrideBytes(), runMin, runMax);
+      }
+
+      if (!found)
+      {
+         mn = runMin;
+         mx = runMax;
+         found = true;
+      }
+      else
+      {
+         if (runMin < mn)
+         {
+            mn = runMin;
+         }
+         if (runMax > mx)
+         {
+            mx = runMax;
+         }
       }
-      break;
    }
+   bool found;
+   DataType mn;
+   DataType mx;
+};
 
-   return res;
+class MinMaxVisitor
+{
+public:
+   MinMaxVisitor(const DataSet* ds, size_t start, size_t count, TerbitValue& min, TerbitValue& max) :
+      m_ds(ds), m_start(start), m_count(count), m_min(min), m_max(max) {}
+   template<typename DataType> void Visit()
+   {
+      //a run at a time: the whole buffer, both halves of a wrapped ring or each page of a paged set
+      MinMaxRuns<DataType> runs;
+      VisitSpans<DataType>(m_ds, m_start, m_count, runs);
+      if (runs.found)
+      {
+         m_min.SetValue<DataType>(runs.mn);
+         m_max.SetValue<DataType>(runs.mx);
+      }
+   }
+private:
+   const DataSet* m_ds;
+   size_t m_start;
+   size_t m_count;
+   TerbitValue& m_min;
+   TerbitValue& m_max;
+};
+
+static void CalculateMinMaxBuffer(TerbitDataType dataType, const DataSet* ds, size_t start, size_t count, TerbitValue& min, TerbitValue& max)
+{
+   MinMaxVisitor v(ds, start, count, min, max);
+   if (!VisitDataType(dataType, v))
+   {
+      InvalidDataType("CalculateMinMax", dataType);
+   }
 }
 
-bool DataSet::ClosestIndex(const TerbitValue& key, size_t& index) const
-{
-   bool res = false;
+void DataSet::CalculateMinMax(TerbitValue& min, TerbitValue& max) const
+{
+   if (useSummary() || IsAffine())
+   {
+      CalculateMinMax(0, m_count, min, max);
+   }
+   else
+   {
+      CalculateMinMaxBuffer(m_dataType, this, 0, m_count, min, max);
+   }
+}
+
+//min/max of elements [start, start+count), O(log n) with the summary enabled
+bool DataSet::CalculateMinMax(size_t start, size_t count, TerbitValue& min, TerbitValue& max) const
+{
+   if (count == 0 || start >= m_count || count > m_count - start)
+   {
+      return false;
+   }
+
+   //the extremes of an affine range are its ends
+   if (m_affine)
+   {
+      double a = affineValue(start);
+      double b = affineValue(start + count - 1);
+      min.SetValue<double>(std::min(a, b));
+      max.SetValue<double>(std::max(a, b));
+      return true;
+   }
+
+   //the summary indexes a resident fixed buffer, a ring moves under it on every append
+   if (useSummary())
+   {
+      return m_summary.Query(m_dataType, m_buffer, m_strideBytes, m_count, start, count, min, max);
+   }
+   else
+   {
+      CalculateMinMaxBuffer(m_dataType, this, start, count, min, max);
+      return true;
+   }
+}
+
+//min/max per bin, bin b holding elements [bounds[b], bounds[b+1]), e.g. the samples landing on
+//each pixel column of a plot.  An empty bin gets NaN
+bool DataSet::CalculateMinMaxEnvelope(const size_t* bounds, size_t bins, double* mins, double* maxs) const
+{
+   if (bins == 0 || bounds[bins] > m_count)
+   {
+      return false;
+   }
+
+   TerbitValue mn, mx;
+   mn.SetDataType(TERBIT_DOUBLE);
+   mx.SetDataType(TERBIT_DOUBLE);
 
-   switch (m_dataType)
-   {
-   case TERBIT_INT64:
-      res = ClosestIndexKeyTemplate<int64_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT64:
-      res = ClosestIndexKeyTemplate<uint64_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT32:
-      res = ClosestIndexKeyTemplate<int32_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT32:
-      res = ClosestIndexKeyTemplate<uint32_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT16:
-      res = ClosestIndexKeyTemplate<int16_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT16:
-      res = ClosestIndexKeyTemplate<uint16_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT8:
-      res = ClosestIndexKeyTemplate<int8_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT8:
-      res = ClosestIndexKeyTemplate<uint8_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_FLOAT:
-      res = ClosestIndexKeyTemplate<float>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_DOUBLE:
-      res = ClosestIndexKeyTemplate<double>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_SIZE_T:
-      res = ClosestIndexKeyTemplate<size_t>(key, index, (char*)m_buffer, m_strideBytes, m_count);
-      break;
-   default:
-      if(TERBIT_DATA_TYPE_GUARD < m_dataType)
+   for (size_t b = 0; b < bins; ++b)
+   {
+      if (bounds[b + 1] < bounds[b])
       {
-         FatalError(g_log.general, QString("ClosestIndex Unknown data type - %1").arg(m_dataType));
+         return false;
       }
-      else
+      if (bounds[b + 1] == bounds[b])
+      {
+         mins[b] = maxs[b] = std::numeric_limits<double>::quiet_NaN();
+         continue;
+      }
+      if (!CalculateMinMax(bounds[b], bounds[b + 1] - bounds[b], mn, mx))
       {
-         LogWarning(g_log.general, tr("ClosestIndex invalid data type %1 (%2).").arg(m_dataType).arg(TerbitDataTypeStrs[m_dataType]));
+         return false;
       }
-      break;
+      mins[b] = *((double*)mn.GetValue());
+      maxs[b] = *((double*)mx.GetValue());
    }
-
-   return res;
+   return true;
 }
 
+bool DataSet::CalculateStats(size_t start, size_t count, SignalStats_t& stats) const
+{
+   return m_stats.Query(this, start, count, stats);
+}
 
-
-template<typename DataType>
-void CalculateMinMaxTemplate(TerbitValue& min, TerbitValue& max, char* buffer, size_t strideBytes, size_t count)
+void DataSet::SetMinMaxSummaryEnabled(bool enabled)
 {
-   if (count > 0)
+   m_summaryEnabled = enabled;
+   if (!enabled)
    {
-      char *d, *end;
-      DataType mn, mx, value;
-      d = buffer;
-      end = d+count*strideBytes;
-
-      mn = mx = *((DataType*)d);
-      d += strideBytes;
-
-      while (d!=end)
-      {
-         value = *((DataType*)d);
-         if (value < mn)
-         {
-            mn = value;
-         }
-         else if (value > mx)
-         {
-            mx = value;
-         }
-         d += strideBytes;
-      }
-      min.SetValue<DataType>(mn);
-      max.SetValue<DataType>(mx);
+      m_summary.Clear();
    }
 }
 
-void DataSet::CalculateMinMax(TerbitValue& min, TerbitValue& max) const
+//for writers that change part of the buffer without emitting NewData, the cached stats are updated too
+void DataSet::InvalidateMinMaxSummary(size_t start, size_t count)
 {
-   switch (m_dataType)
-   {
-   case TERBIT_INT64:
-      CalculateMinMaxTemplate<int64_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT64:
-      CalculateMinMaxTemplate<uint64_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT32:
-      CalculateMinMaxTemplate<int32_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT32:
-      CalculateMinMaxTemplate<uint32_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT16:
-      CalculateMinMaxTemplate<int16_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT16:
-      CalculateMinMaxTemplate<uint16_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_INT8:
-      CalculateMinMaxTemplate<int8_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_UINT8:
-      CalculateMinMaxTemplate<uint8_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_FLOAT:
-      CalculateMinMaxTemplate<float>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_DOUBLE:
-      CalculateMinMaxTemplate<double>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_SIZE_T:
-      CalculateMinMaxTemplate<size_t>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   case TERBIT_BOOL:
-      CalculateMinMaxTemplate<bool>(min, max, (char*) m_buffer, m_strideBytes, m_count);
-      break;
-   default:
-      if(TERBIT_DATA_TYPE_GUARD < m_dataType)
-      {
-         FatalError(g_log.general, QString("CalculateMinMax Unknown data type - %1").arg(m_dataType));
-      }
-      else
-      {
-         LogWarning(g_log.general, tr("CalculateMinMax invalid data type %1 (%2).").arg(m_dataType).arg(TerbitDataTypeStrs[m_dataType]));
-      }
-      break;
+   m_summary.Invalidate(start, count);
+   m_stats.Invalidate(GetFirstIndex() + start, count);
+}
+
+void DataSet::OnNewData(DataClass* dc)
+{
+   dc;
+   m_summary.Invalidate();
+   if (!IsRing())
+   {
+      //a ring's appends keep the stats of the blocks they didn't touch
+      m_stats.Clear();
    }
+   //the data under an unmanaged buffer changed, remotes need a fresh copy
+   dropSnapshot();
 }
 
 bool ClosestDataPoint(const DataSet* X, const DataSet* Y, double dataX, double& pointX, double& pointY)
@@ -1017,6 +1661,20 @@ ScriptDocumentation* BuildScriptDocumentationDataSet()
 
    d->AddScriptlet(new Scriptlet(QObject::tr("GetDisplayTypName"), "GetDisplayTypeName();",QObject::tr("Default display full type name string.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("CreateBuffer"), "CreateBuffer(dataType, firstIndex, elementCount);",QObject::tr("Create a managed buffer for the dataType (enum), firstIndex and elementCount.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("CreateRingBuffer"), "CreateRingBuffer(dataType, firstIndex, capacity);",QObject::tr("Create a managed ring buffer that holds the newest capacity elements.  The data set starts empty, appends add elements and once it is full the first index advances as the oldest elements fall off, e.g. a scrolling window of the last N samples.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("AppendValues"), "AppendValues(values);",QObject::tr("Append an array of values to a ring buffer data set.  Returns boolean.  Call EmitNewData() afterwards so consumers update.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("AppendFrom"), "AppendFrom(src, start, count);",QObject::tr("Append count elements of the src data set from its 0-based start to a ring buffer data set, converting to this data type.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("IsRing"), "IsRing();",QObject::tr("Returns boolean if the data set is a ring buffer.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetRingCapacity"), "GetRingCapacity();",QObject::tr("Returns the element capacity of a ring buffer, 0 for a fixed buffer.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("OpenPagedFile"), "OpenPagedFile(filename, dataType, headerBytes, firstIndex, pageBytes, budgetBytes);",QObject::tr("Make this a read only view of a raw capture file larger than memory.  The elements after headerBytes are mapped pageBytes at a time (optional, default 4 MB) and the least recently used pages are dropped beyond budgetBytes (optional, default 256 MB).  Scrolling reads ahead in the scroll direction.  Create a remote data set or values view to browse it.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("IsPaged"), "IsPaged();",QObject::tr("Returns boolean if the data set is paged from a file.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetPageBudget"), "SetPageBudget(budgetBytes);",QObject::tr("Set the memory budget of a paged data set's page cache.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetPageStats"), "GetPageStats();",QObject::tr("Returns an object with the page cache pageBytes, pageCount, mappedBytes, budgetBytes, hits, misses and prefetches of a paged data set.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("ReadWindow"), "ReadWindow(firstIndex, count);",QObject::tr("Move a remote data set to count elements of its source from firstIndex and read them, e.g. to scroll a plot through a paged capture.  The window is kept inside the source.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("CreateAffine"), "CreateAffine(dataType, firstIndex, count, start, step);",QObject::tr("Make this a read only data set of count elements where element i is start + i*step, e.g. a time or frequency axis.  The values are computed on access, nothing is stored.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("IsAffine"), "IsAffine();",QObject::tr("Returns boolean if the data set values are computed as start + i*step.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetAffineStart"), "GetAffineStart();",QObject::tr("Returns the value of element 0 of an affine data set.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetAffineStep"), "GetAffineStep();",QObject::tr("Returns the step between elements of an affine data set.")));
 
    d->AddScriptlet(new Scriptlet(QObject::tr("GetIndexDataSet"), "GetIndexDataSet();",QObject::tr("Returns a reference to the index data set.  If there is no index, then it returns undefined.  This allows indicies to represent values.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("SetIndexDataSet"), "SetIndexDataSet(ds);",QObject::tr("Set the data set to use for the index values.  The ds may be a reference or unique id string.")));
@@ -1027,9 +1685,26 @@ ScriptDocumentation* BuildScriptDocumentationDataSet()
    d->AddScriptlet(new Scriptlet(QObject::tr("GetValueLogicalIndex"), "GetValueLogicalIndex(index);",QObject::tr("Returns value for logical index in the data set based on the firstIndex offset for the data set.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("SetValueLogicalIndex"), "SetValueLogicalIndex(index, value);",QObject::tr("Sets the value at the logical index in the data set based on the firstIndex offset.")));
 
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetArrayView"), "GetArrayView();",QObject::tr("Returns a typed array (Int16Array, Float64Array, ...) viewing the data set's buffer without a copy.  Writes through it change the data set; call EmitNewData() afterwards so consumers update.  The view is only valid until the buffer changes (CreateBuffer, new data from a source), get a new one after that.  Fixed buffers of 8 to 32 bit integers, float and double up to 2 GB only.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetRange"), "GetRange(start, count);",QObject::tr("Returns a typed array with a copy of count elements from the 0-based start, in any data set mode.  64 bit integers are returned as a Float64Array.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetRange"), "SetRange(start, values);",QObject::tr("Write a typed array or array of values to the data set from the 0-based start, converting to the data type.  Returns boolean.  Call EmitNewData() afterwards so consumers update.")));
+
+   d->AddScriptlet(new Scriptlet(QObject::tr("CalculateMinMax"), "CalculateMinMax();",QObject::tr("Returns an array with the minimum and maximum value in the data set.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("CalculateMinMaxRange"), "CalculateMinMaxRange(start, count);",QObject::tr("Returns an array with the minimum and maximum value of count elements starting at the 0-based start index.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("CalculateStats"), "CalculateStats();",QObject::tr("Returns an object with the count, mean, rms, stdDev, sampleStdDev, min, max, peakToPeak and crestFactor of the data set, computed in one pass.  Results for full blocks are cached, so after a ring buffer append only the new elements are read.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("CalculateStatsRange"), "CalculateStatsRange(start, count);",QObject::tr("Returns the CalculateStats object for count elements starting at the 0-based start index.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetMinMaxSummaryEnabled"), "SetMinMaxSummaryEnabled(enabled);",QObject::tr("Keep a cached min/max summary so range min/max queries and autoscale do not rescan the whole data set.  Costs a little memory and an update after new data.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetMinMaxSummaryEnabled"), "GetMinMaxSummaryEnabled();",QObject::tr("Returns boolean if the cached min/max summary is enabled.")));
+
+   d->AddScriptlet(new Scriptlet(QObject::tr("ConvertInto"), "ConvertInto(dest, start, count, destStart, scale, offset, saturate);",QObject::tr("Copy count elements from the 0-based start into the dest data set at destStart, converting to the dest data type as value*scale + offset.  Scale, offset and saturate are optional (1, 0, true).  With saturate, values out of range clamp to the destination type limits, otherwise integers wrap.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetReadConversion"), "SetReadConversion(scale, offset, saturate);",QObject::tr("Scale and offset applied when data is read into this data set from its data source (value*scale + offset), e.g. converting ADC counts to volts.  A remote data set may use a different data type than its source; the data is converted on every read.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetReadScale"), "GetReadScale();",QObject::tr("Returns the scale applied to data read into this data set.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetReadOffset"), "GetReadOffset();",QObject::tr("Returns the offset applied to data read into this data set.")));
+
    d->AddScriptlet(new Scriptlet(QObject::tr("GetInputDataSource"), "GetInputDataSource();",QObject::tr("Returns a reference to the input data source for this data set.  This is a self-reference when the data set does not have a remote data source.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("SetInputDataSource"), "SetInputDataSource(source);",QObject::tr("Sets the input data source for this data set.  This may be a reference to the data source or the unique id string.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("IsRemote"), "IsRemote();",QObject::tr("Returns a boolean if this data set has a remote data source (i.e. a data source that is not itself)")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("IsBufferShared"), "IsBufferShared();",QObject::tr("Returns a boolean if the data set's buffer is shared with remotes instead of copied.  Remotes with the same data type and no read conversion share the data they read until either side writes to it.")));
 
    d->AddScriptlet(new Scriptlet(QObject::tr("CanRefreshData"), "CanRefreshData();",QObject::tr("Returns a boolean if this data set can request to refresh its data from its remote data source.  This validates permissions.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("RefreshData"), "RefreshData();",QObject::tr("Requests data from the data source to update the data set.  The NewData event will fire when the data arrives.")));
@@ -1049,6 +1724,145 @@ void DataSetSW::CreateBuffer(int dataType, double firstIndex, double elementCoun
    ds->CreateBuffer((TerbitDataType)dataType,firstIndex,elementCount);
 }
 
+void DataSetSW::CreateRingBuffer(int dataType, double firstIndex, double capacity)
+{
+   if (dataType < TERBIT_INT8 || dataType > TERBIT_BOOL || capacity < 1)
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("Invalid data type or capacity passed to CreateRingBuffer"));
+      return;
+   }
+   static_cast<DataSet*>(m_dataClass)->CreateRingBuffer((TerbitDataType)dataType, (uint64_t)firstIndex, (size_t)capacity);
+}
+
+bool DataSetSW::AppendValues(const QJSValue& values)
+{
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   if (!ds->IsRing())
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("AppendValues requires a ring buffer data set."));
+      return false;
+   }
+
+   std::vector<double> buf((size_t)values.property("length").toUInt());
+   for (size_t i = 0; i < buf.size(); ++i)
+   {
+      buf[i] = values.property((quint32)i).toNumber();
+   }
+   return ds->Append(buf.data(), TERBIT_DOUBLE, sizeof(double), buf.size());
+}
+
+bool DataSetSW::AppendFrom(const QJSValue& src, double start, double count)
+{
+   DataClass* dc = m_dataClass->GetWorkspace()->FindInstance(src);
+   if (!dc || !dc->IsDataSet())
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("Invalid 'src' parameter passed to AppendFrom"));
+      return false;
+   }
+
+   auto srcDs = static_cast<DataSet*>(dc);
+   if (start < 0 || count < 0 || start + count > srcDs->GetCount())
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("AppendFrom range is outside of the source data set."));
+      return false;
+   }
+
+   if (!static_cast<DataSet*>(m_dataClass)->AppendFrom(srcDs, (size_t)start, (size_t)count))
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("AppendFrom failed.  The data set must be a ring buffer and the data types convertible."));
+      return false;
+   }
+   return true;
+}
+
+bool DataSetSW::IsRing()
+{
+   return static_cast<DataSet*>(m_dataClass)->IsRing();
+}
+
+double DataSetSW::GetRingCapacity()
+{
+   return static_cast<DataSet*>(m_dataClass)->GetRingCapacity();
+}
+
+bool DataSetSW::OpenPagedFile(const QString& filename, int dataType, double headerBytes, double firstIndex, double pageBytes, double budgetBytes)
+{
+   if (dataType < TERBIT_INT8 || dataType > TERBIT_BOOL || headerBytes < 0 || firstIndex < 0 || pageBytes < 1 || budgetBytes < 0)
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("Invalid parameter passed to OpenPagedFile"));
+      return false;
+   }
+   return static_cast<DataSet*>(m_dataClass)->OpenPagedFile(filename, (TerbitDataType)dataType, (uint64_t)headerBytes, (uint64_t)firstIndex,
+                                                            (size_t)pageBytes, (uint64_t)budgetBytes);
+}
+
+bool DataSetSW::IsPaged()
+{
+   return static_cast<DataSet*>(m_dataClass)->IsPaged();
+}
+
+void DataSetSW::SetPageBudget(double budgetBytes)
+{
+   PageCache* pager = static_cast<DataSet*>(m_dataClass)->GetPageCache();
+   if (pager && budgetBytes >= 0)
+   {
+      pager->SetBudgetBytes((uint64_t)budgetBytes);
+   }
+}
+
+QJSValue DataSetSW::GetPageStats()
+{
+   QJSValue res;
+   PageCache* pager = static_cast<DataSet*>(m_dataClass)->GetPageCache();
+   if (pager)
+   {
+      res = m_scriptEngine->newObject();
+      res.setProperty("pageBytes", (double)pager->GetPageBytes());
+      res.setProperty("pageCount", (double)pager->GetPageCount());
+      res.setProperty("mappedBytes", (double)pager->GetMappedBytes());
+      res.setProperty("budgetBytes", (double)pager->GetBudgetBytes());
+      res.setProperty("hits", (double)pager->GetHits());
+      res.setProperty("misses", (double)pager->GetMisses());
+      res.setProperty("prefetches", (double)pager->GetPrefetches());
+   }
+   return res;
+}
+
+bool DataSetSW::ReadWindow(double firstIndex, double count)
+{
+   if (firstIndex < 0 || count < 1)
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("Invalid window passed to ReadWindow"));
+      return false;
+   }
+   return static_cast<DataSet*>(m_dataClass)->ReadWindow((uint64_t)firstIndex, (size_t)count);
+}
+
+void DataSetSW::CreateAffine(int dataType, double firstIndex, double count, double start, double step)
+{
+   if (dataType < TERBIT_INT8 || dataType > TERBIT_BOOL || !IsConvertibleDataType((TerbitDataType)dataType) || firstIndex < 0 || count < 0)
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("Invalid data type or count passed to CreateAffine"));
+      return;
+   }
+   static_cast<DataSet*>(m_dataClass)->CreateAffine((TerbitDataType)dataType, (uint64_t)firstIndex, (size_t)count, start, step);
+}
+
+bool DataSetSW::IsAffine()
+{
+   return static_cast<DataSet*>(m_dataClass)->IsAffine();
+}
+
+double DataSetSW::GetAffineStart()
+{
+   return static_cast<DataSet*>(m_dataClass)->GetAffineStart();
+}
+
+double DataSetSW::GetAffineStep()
+{
+   return static_cast<DataSet*>(m_dataClass)->GetAffineStep();
+}
+
 QJSValue DataSetSW::GetIndexDataSet()
 {
    //find public kid data set with that source
@@ -1111,6 +1925,159 @@ void DataSetSW::SetValueLogicalIndex(double index, double value)
    }
 }
 
+//script typed arrays and the element type each holds, the first entry for a type is the one created
+typedef struct
+{
+   const char* name;
+   TerbitDataType type;
+} DataSetTypedArray_t;
+
+static const DataSetTypedArray_t DATASET_TYPED_ARRAYS[] =
+{
+   {"Int8Array", TERBIT_INT8},
+   {"Uint8Array", TERBIT_UINT8},
+   {"Uint8Array", TERBIT_BOOL},
+   {"Uint8ClampedArray", TERBIT_UINT8},
+   {"Int16Array", TERBIT_INT16},
+   {"Uint16Array", TERBIT_UINT16},
+   {"Int32Array", TERBIT_INT32},
+   {"Uint32Array", TERBIT_UINT32},
+   {"Float32Array", TERBIT_FLOAT},
+   {"Float64Array", TERBIT_DOUBLE}
+};
+
+//NULL for the 64 bit integer types, scripts have no typed array for them
+static const char* TypedArrayName(TerbitDataType type)
+{
+   for (size_t i = 0; i < sizeof(DATASET_TYPED_ARRAYS)/sizeof(DATASET_TYPED_ARRAYS[0]); ++i)
+   {
+      if (DATASET_TYPED_ARRAYS[i].type == type)
+      {
+         return DATASET_TYPED_ARRAYS[i].name;
+      }
+   }
+   return NULL;
+}
+
+//count elements of bytes as a typed array, the array buffer references the bytes' data
+static QJSValue NewTypedArray(QJSEngine* se, const char* name, const QByteArray& bytes, size_t count)
+{
+   QJSValue buffer = se->toScriptValue(bytes);
+   return se->globalObject().property(name).callAsConstructor(QJSValueList() << buffer << QJSValue(0) << QJSValue((double)count));
+}
+
+QJSValue DataSetSW::GetArrayView()
+{
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   const char* name = TypedArrayName(ds->GetDataType());
+   if (ds->IsRing() || ds->IsPaged() || ds->IsAffine() || ds->GetBufferAddress() == NULL)
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("GetArrayView requires a fixed buffer.  Use GetRange to copy elements of a ring, paged or affine data set."));
+      return QJSValue();
+   }
+   if (name == NULL || ds->GetStrideBytes() != TerbitDataTypeSize(ds->GetDataType()))
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("GetArrayView has no typed array for this data type or element stride.  Use GetRange to copy the elements."));
+      return QJSValue();
+   }
+   //a QByteArray, and so the ArrayBuffer, holds at most INT_MAX bytes
+   if ((uint64_t)ds->GetCount()*ds->GetStrideBytes() > (uint64_t)std::numeric_limits<int>::max())
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("GetArrayView is limited to 2 GB.  Use GetRange to copy the elements in smaller ranges."));
+      return QJSValue();
+   }
+
+   //the view writes in place, remotes sharing the buffer get their copy now
+   char* data = (char*)ds->GetWriteAddress();
+   return NewTypedArray(m_scriptEngine, name, QByteArray::fromRawData(data, (int)(ds->GetCount()*ds->GetStrideBytes())), ds->GetCount());
+}
+
+QJSValue DataSetSW::GetRange(double start, double count)
+{
+   QJSValue res;
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   if (BoundsCheck(start) && count >= 1 && BoundsCheck(start + count - 1))
+   {
+      //64 bit integers come back as doubles
+      TerbitDataType type = ds->GetDataType();
+      const char* name = TypedArrayName(type);
+      if (name == NULL)
+      {
+         name = "Float64Array";
+         type = TERBIT_DOUBLE;
+      }
+
+      size_t elementBytes = TerbitDataTypeSize(type);
+      if (count*elementBytes > (double)std::numeric_limits<int>::max())
+      {
+         LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("GetRange is limited to 2 GB per call.  Request fewer elements."));
+         return res;
+      }
+      QByteArray bytes((int)(count*elementBytes), Qt::Uninitialized);
+      if (ds->CopyElements((size_t)start, (size_t)count, bytes.data(), type, elementBytes))
+      {
+         res = NewTypedArray(m_scriptEngine, name, bytes, (size_t)count);
+      }
+      else
+      {
+         LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("GetRange failed to read the elements."));
+      }
+   }
+   return res;
+}
+
+bool DataSetSW::SetRange(double start, const QJSValue& values)
+{
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   if (!BoundsCheck(start))
+   {
+      return false;
+   }
+
+   size_t count = (size_t)values.property("length").toUInt();
+   if (count > ds->GetCount() - (size_t)start)
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("SetRange values run past the end of the data set."));
+      return false;
+   }
+
+   const DataSetTypedArray_t* typed = NULL;
+   for (size_t i = 0; i < sizeof(DATASET_TYPED_ARRAYS)/sizeof(DATASET_TYPED_ARRAYS[0]) && values.isObject(); ++i)
+   {
+      if (values.instanceOf(m_scriptEngine->globalObject().property(DATASET_TYPED_ARRAYS[i].name)))
+      {
+         typed = &DATASET_TYPED_ARRAYS[i];
+         break;
+      }
+   }
+
+   bool res;
+   if (typed)
+   {
+      //written straight from the typed array's buffer
+      QByteArray bytes = values.property("buffer").toVariant().toByteArray();
+      size_t offset = (size_t)values.property("byteOffset").toUInt();
+      size_t elementBytes = TerbitDataTypeSize(typed->type);
+      res = offset + count*elementBytes <= (size_t)bytes.size() &&
+            ds->WriteElements((size_t)start, count, bytes.constData() + offset, typed->type, elementBytes);
+   }
+   else
+   {
+      std::vector<double> buf(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+         buf[i] = values.property((quint32)i).toNumber();
+      }
+      res = ds->WriteElements((size_t)start, count, buf.data(), TERBIT_DOUBLE, sizeof(double));
+   }
+
+   if (!res)
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("SetRange failed.  The data set must be a buffer (not paged or affine) and the values numeric."));
+   }
+   return res;
+}
+
 QJSValue DataSetSW::CalculateMinMax()
 {
    double min,max;
@@ -1122,12 +2089,127 @@ QJSValue DataSetSW::CalculateMinMax()
    max = *((double*)tmax.GetValue());
 
    QJSValue res = m_scriptEngine->newArray(2);
-   //TODO convert to array
-   //res.se = QJSValue(min);
-   //res[1] = QJSValue(max);
+   res.setProperty(0, min);
+   res.setProperty(1, max);
+   return res;
+}
+
+QJSValue DataSetSW::CalculateMinMaxRange(double start, double count)
+{
+   QJSValue res;
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   if (BoundsCheck(start) && count >= 1 && BoundsCheck(start + count - 1))
+   {
+      TerbitValue tmin, tmax;
+      tmin.SetDataType(TERBIT_DOUBLE);
+      tmax.SetDataType(TERBIT_DOUBLE);
+      if (ds->CalculateMinMax((size_t)start, (size_t)count, tmin, tmax))
+      {
+         res = m_scriptEngine->newArray(2);
+         res.setProperty(0, *((double*)tmin.GetValue()));
+         res.setProperty(1, *((double*)tmax.GetValue()));
+      }
+   }
+   return res;
+}
+
+QJSValue DataSetSW::statsValue(const SignalStats_t& stats)
+{
+   QJSValue res = m_scriptEngine->newObject();
+   res.setProperty("count", (double)stats.count);
+   res.setProperty("mean", SignalStatsMean(stats));
+   res.setProperty("rms", SignalStatsRms(stats));
+   res.setProperty("stdDev", SignalStatsStdDev(stats, false));
+   res.setProperty("sampleStdDev", SignalStatsStdDev(stats, true));
+   res.setProperty("min", stats.count > 0 ? stats.min : std::numeric_limits<double>::quiet_NaN());
+   res.setProperty("max", stats.count > 0 ? stats.max : std::numeric_limits<double>::quiet_NaN());
+   res.setProperty("peakToPeak", SignalStatsPeakToPeak(stats));
+   res.setProperty("crestFactor", SignalStatsCrestFactor(stats));
+   return res;
+}
+
+QJSValue DataSetSW::CalculateStats()
+{
+   QJSValue res;
+   SignalStats_t stats;
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   if (ds->CalculateStats(0, ds->GetCount(), stats))
+   {
+      res = statsValue(stats);
+   }
+   else
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("CalculateStats failed to read the data set."));
+   }
+   return res;
+}
+
+QJSValue DataSetSW::CalculateStatsRange(double start, double count)
+{
+   QJSValue res;
+   SignalStats_t stats;
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   if (BoundsCheck(start) && count >= 1 && BoundsCheck(start + count - 1))
+   {
+      if (ds->CalculateStats((size_t)start, (size_t)count, stats))
+      {
+         res = statsValue(stats);
+      }
+      else
+      {
+         LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("CalculateStatsRange failed to read the data set."));
+      }
+   }
    return res;
 }
 
+void DataSetSW::SetMinMaxSummaryEnabled(bool enabled)
+{
+   static_cast<DataSet*>(m_dataClass)->SetMinMaxSummaryEnabled(enabled);
+}
+
+bool DataSetSW::GetMinMaxSummaryEnabled()
+{
+   return static_cast<DataSet*>(m_dataClass)->GetMinMaxSummaryEnabled();
+}
+
+bool DataSetSW::ConvertInto(const QJSValue &dest, double start, double count, double destStart, double scale, double offset, bool saturate)
+{
+   DataClass* dc = m_dataClass->GetWorkspace()->FindInstance(dest);
+   if (!dc || !dc->IsDataSet())
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("Invalid 'dest' parameter passed to ConvertInto"));
+      return false;
+   }
+   if (count < 1 || !BoundsCheck(start) || !BoundsCheck(start + count - 1))
+   {
+      return false;
+   }
+
+   auto ds = static_cast<DataSet*>(m_dataClass);
+   if (!ds->ConvertInto(static_cast<DataSet*>(dc), (size_t)start, (size_t)count, destStart >= 0 ? (size_t)destStart : SIZE_MAX, scale, offset, saturate))
+   {
+      LogError2(m_dataClass->GetType()->GetLogCategory(), m_dataClass->GetName(), tr("ConvertInto failed.  Check the destination range and data type."));
+      return false;
+   }
+   return true;
+}
+
+void DataSetSW::SetReadConversion(double scale, double offset, bool saturate)
+{
+   static_cast<DataSet*>(m_dataClass)->SetReadConversion(scale, offset, saturate);
+}
+
+double DataSetSW::GetReadScale()
+{
+   return static_cast<DataSet*>(m_dataClass)->GetReadScale();
+}
+
+double DataSetSW::GetReadOffset()
+{
+   return static_cast<DataSet*>(m_dataClass)->GetReadOffset();
+}
+
 QJSValue DataSetSW::GetInputDataSource()
 {
    auto ds = static_cast<DataSet*>(m_dataClass);
@@ -1152,6 +2234,11 @@ bool DataSetSW::IsRemote()
    return static_cast<DataSet*>(m_dataClass)->IsRemote();
 }
 
+bool DataSetSW::IsBufferShared()
+{
+   return static_cast<DataSet*>(m_dataClass)->IsBufferShared();
+}
+
 bool DataSetSW::CanRefreshData()
 {
    return static_cast<DataSet*>(m_dataClass)->CanRefreshData();
@@ -17,15 +17,29 @@ limitations under the License.
 #pragma once
 
 #include <stdint.h>
+#include <vector>
 #include <tools/Tools.h>
 #include <tools/TerbitValue.h>
+#include <tools/PageCache.h>
 #include "DataSource.h"
+#include "MinMaxSummary.h"
+#include "StatsSummary.h"
 
 namespace terbit
 {
 
 static const char* DATASET_TYPENAME = "dataset";
 
+//window remotes of a paged data set read by default
+static const size_t DATASET_PAGED_WINDOW_ELEMENTS = 1024*1024;
+
+//contiguous run of elements in a data set buffer, stride is the data set's
+typedef struct
+{
+   void*  data;
+   size_t count;
+} DataSetSpan_t;
+
 class DataSet : public DataSource
 {
    Q_OBJECT
@@ -45,17 +59,91 @@ public:
    void CreateBuffer(TerbitDataType type, uint64_t firstIndex, size_t elementCount);
    void CreateBufferAsIndex(uint64_t firstIndex, size_t elementCount);
 
+   //ring buffer mode: appends keep the newest capacity elements, the first index advances
+   //as old elements fall off.  Elements are stored from a moving head, so the buffer address
+   //is only the start of the allocation; read through GetSpans/GetElementAddress.
+   void CreateRingBuffer(TerbitDataType type, uint64_t firstIndex, size_t capacity);
+   bool Append(const void* src, TerbitDataType srcType, size_t srcStrideBytes, size_t count);
+   bool AppendFrom(const DataSet* src, size_t start, size_t count);
+   bool IsRing() const { return m_ringCapacity != 0; }
+   size_t GetRingCapacity() const { return m_ringCapacity; }
+
+   //paged mode: a read only view of a file larger than memory, elements are mapped a page at
+   //a time through an LRU page cache under budgetBytes.  Remotes/views read windows of it.
+   //Element addresses come with a PagePin keeping their page mapped, hold it while the run
+   //is read; CopyElements and the DataSpan visitors pin for you.
+   bool OpenPagedFile(const QString& filename, TerbitDataType type, uint64_t headerBytes, uint64_t firstIndex,
+                      size_t pageBytes = PAGE_CACHE_DEFAULT_PAGE_BYTES, uint64_t budgetBytes = PAGE_CACHE_DEFAULT_BUDGET_BYTES);
+   bool IsPaged() const { return m_pager != NULL; }
+   PageCache* GetPageCache() const { return m_pager; }
+
+   //affine mode: element i is start + i*step, computed on access with no buffer, e.g. an index
+   //or frequency axis.  Read only; the data type is the type readers convert the values to.
+   void CreateAffine(TerbitDataType type, uint64_t firstIndex, size_t count, double start, double step);
+   bool IsAffine() const { return m_affine; }
+   double GetAffineStart() const { return m_affineStart; }
+   double GetAffineStep() const { return m_affineStep; }
+
+   //elements [start, start+count) as one span, or two when a ring wraps, returns the span count
+   //(0 for a paged data set, walk pinned GetContiguousCount runs instead, or an affine data set)
+   size_t GetSpans(size_t start, size_t count, DataSetSpan_t spans[2]) const;
+   //elements from index on that are contiguous in memory
+   size_t GetContiguousCount(size_t index) const;
+   //NULL for a paged data set (its pages are only mapped while pinned) or an affine data set
+   void* GetElementAddress(size_t index) const;
+   //any mode but affine, a paged element's page stays mapped while pin holds it.  NULL when
+   //the page can't be read
+   const void* GetElementAddress(size_t index, PagePin& pin) const;
+   //copy elements in any mode converting to destType, dest = value*scale + offset
+   bool CopyElements(size_t start, size_t count, void* dest, TerbitDataType destType, size_t destStrideBytes,
+                     double scale = 1.0, double offset = 0.0, bool saturate = true) const;
+   //write elements converting from srcType, src = value*scale + offset.  Not for a paged or
+   //affine data set; goes through the write address so remotes sharing the buffer keep their data
+   bool WriteElements(size_t start, size_t count, const void* src, TerbitDataType srcType, size_t srcStrideBytes,
+                      double scale = 1.0, double offset = 0.0, bool saturate = true);
+
    void* GetBufferAddress(void) const {return m_buffer;}
    size_t GetStrideBytes(void) const {return m_strideBytes;}
-   size_t GetAllocatedByteCount() const { return m_managedBufferSize; }
+   size_t GetAllocatedByteCount() const { return m_storage ? m_storage->bytes : 0; }
+
+   //remotes reading this data set without a conversion share its buffer (or, for an unmanaged
+   //buffer, one copy per new data) instead of each copying it.  Writing in place must go through
+   //the write address: remotes still holding the current data get their copy first, and the
+   //writer keeps its buffer address.  The sharing is not locked, share and write from the GUI
+   //thread; workers compute into their own buffers and hand the results back.
+   void* GetWriteAddress();
+   bool IsBufferShared() const;
 
    virtual void ReadRequest(uint64_t startIndex, size_t elementCount, DataClassAutoId_t bufferId);
 
+   //copy elements into another data set converting to its data type, dest = value*scale + offset
+   bool ConvertInto(DataSet* dest, size_t start, size_t count, size_t destStart, double scale = 1.0, double offset = 0.0, bool saturate = true) const;
+   //conversion applied to data read into this data set, e.g. ADC counts to volts for a remote
+   void SetReadConversion(double scale, double offset, bool saturate);
+   double GetReadScale() const { return m_readScale; }
+   double GetReadOffset() const { return m_readOffset; }
+   bool GetReadSaturate() const { return m_readSaturate; }
+
    void CalculateMinMax(TerbitValue& min, TerbitValue& max) const;
+   bool CalculateMinMax(size_t start, size_t count, TerbitValue& min, TerbitValue& max) const;
+   //min/max of each bin [bounds[b], bounds[b+1]) for b < bins, bounds holds bins+1 indices
+   bool CalculateMinMaxEnvelope(const size_t* bounds, size_t bins, double* mins, double* maxs) const;
+
+   //cached min/max pyramid for fast range queries, off by default.  Plots turn it on for the
+   //data sets they draw, rings, paged and affine data sets never use it
+   void SetMinMaxSummaryEnabled(bool enabled);
+   bool GetMinMaxSummaryEnabled() const { return m_summaryEnabled; }
+   void InvalidateMinMaxSummary(size_t start, size_t count);
+
+   //count, mean, RMS, deviation and min/max of a range in one pass, see SignalStats_t.  Full
+   //blocks are cached by logical index, so after a ring's appends only the new ones are computed
+   bool CalculateStats(size_t start, size_t count, SignalStats_t& stats) const;
+
    bool ClosestIndex(const TerbitValue& key, size_t& index) const;
    bool BoundingIndicies(double startValue, double endValue, size_t& start, size_t& end) const;
 
-   //TODO: make template, use TerbitValue or ideally get rid of this function
+   //one element converted to double, loops over elements should read them typed through
+   //DataSpan/VisitTyped (DataSpan.h) instead
    double GetValueAtIndex(size_t index) const;
    void SetValueAtIndex(size_t index, double value);
    double GetValueAtLogicalIndex(uint64_t index) const;
@@ -73,6 +161,8 @@ public:
 
    bool CanRefreshData();
    void RefreshData();
+   //move a remote to another window of its source and read it, e.g. scrolling a paged capture
+   bool ReadWindow(uint64_t firstIndex, size_t count);
 
    void SetInputSource(DataSource* source);
 
@@ -81,23 +171,70 @@ public:
 signals:
    void InputSourceAssigned(DataSet* ds);
    void IndexAssigned(DataSet* ds);
+   void BeforeBufferChange(DataSet* ds); //buffer is about to be freed or replaced
 
 private slots:
    void OnInputSourceNewData(DataClass* source);
    void OnBeforeInputSourceRemoved(DataClass* source);
    void OnBeforeIndexRemoved(DataClass* idx);
    void OnInputSourceStructureChanged(DataSource* source);
-
+   void OnNewData(DataClass* dc);
 
 private:
    DataSet(const DataSet& o); //disable copy ctor
 
+   size_t physicalIndex(size_t index) const
+   {
+      if (m_ringCapacity == 0)
+      {
+         return index;
+      }
+      index += m_ringHead;
+      return index >= m_ringCapacity ? index - m_ringCapacity : index;
+   }
+   size_t bufferCapacity() const { return IsRing() ? m_ringCapacity : m_count; }
+   bool useSummary() const { return m_summaryEnabled && !IsRing() && !IsPaged() && !IsAffine(); }
+   double affineValue(size_t index) const { return m_affineStart + m_affineStep*index; }
+   void closePager();
+
+   //managed buffer storage, shared by the data sets whose buffers point into it
+   typedef struct
+   {
+      char* data;
+      size_t bytes;
+      DataSet* owner;                //keeps its address on a detach, NULL once it let go
+      std::vector<DataSet*> holders;
+      int pins;                      //references from sources caching a snapshot
+   }Storage_t;
+
+   static Storage_t* allocStorage(size_t bytes);
+   static void unpinStorage(Storage_t* s);
+   void joinStorage(Storage_t* s, char* buffer);
+   void leaveStorage();
+   void detach(bool keepData);
+   bool shareInto(DataSet* dest, size_t pos, size_t count);
+   void dropSnapshot();
+
    void*  m_buffer;
    size_t m_strideBytes;
-   size_t m_managedBufferSize;
-   bool m_managedBuffer;
+   Storage_t* m_storage;  //NULL for an unmanaged or paged buffer
+   Storage_t* m_snapshot; //copy of an unmanaged buffer shared by remotes until its next new data
+   size_t m_snapshotStart;
+   size_t m_snapshotCount;
    DataSource* m_inputSource; //source for this data set
    DataSet* m_indexDataSet;
+   bool m_summaryEnabled;
+   mutable MinMaxSummary m_summary;
+   mutable StatsSummary m_stats;
+   double m_readScale;
+   double m_readOffset;
+   bool m_readSaturate;
+   size_t m_ringHead;     //buffer element holding index 0
+   size_t m_ringCapacity; //0 for a fixed buffer
+   PageCache* m_pager;    //paged mode, m_buffer is NULL
+   bool m_affine;         //affine mode, m_buffer is NULL
+   double m_affineStart;
+   double m_affineStep;
 };
 
 DataSet* CreateRemoteDataSet(DataSource* source, DataClass *owner, bool publicScope);
@@ -116,6 +253,20 @@ public:
    DataSet* GetDataSet() { return static_cast<DataSet*>(m_dataClass); }
 
    Q_INVOKABLE void CreateBuffer(int dataType, double firstIndex, double elementCount);
+   Q_INVOKABLE void CreateRingBuffer(int dataType, double firstIndex, double capacity);
+   Q_INVOKABLE bool AppendValues(const QJSValue& values);
+   Q_INVOKABLE bool AppendFrom(const QJSValue& src, double start, double count);
+   Q_INVOKABLE bool IsRing();
+   Q_INVOKABLE double GetRingCapacity();
+   Q_INVOKABLE bool OpenPagedFile(const QString& filename, int dataType, double headerBytes, double firstIndex, double pageBytes = PAGE_CACHE_DEFAULT_PAGE_BYTES, double budgetBytes = PAGE_CACHE_DEFAULT_BUDGET_BYTES);
+   Q_INVOKABLE bool IsPaged();
+   Q_INVOKABLE void SetPageBudget(double budgetBytes);
+   Q_INVOKABLE QJSValue GetPageStats();
+   Q_INVOKABLE bool ReadWindow(double firstIndex, double count);
+   Q_INVOKABLE void CreateAffine(int dataType, double firstIndex, double count, double start, double step);
+   Q_INVOKABLE bool IsAffine();
+   Q_INVOKABLE double GetAffineStart();
+   Q_INVOKABLE double GetAffineStep();
 
    Q_INVOKABLE QJSValue GetIndexDataSet();
    Q_INVOKABLE void SetIndexDataSet(const QJSValue& ds);
@@ -125,11 +276,26 @@ public:
    Q_INVOKABLE QJSValue GetValueLogicalIndex(double index);
    Q_INVOKABLE void SetValueLogicalIndex(double index, double value);
 
+   Q_INVOKABLE QJSValue GetArrayView();
+   Q_INVOKABLE QJSValue GetRange(double start, double count);
+   Q_INVOKABLE bool SetRange(double start, const QJSValue& values);
+
    Q_INVOKABLE QJSValue CalculateMinMax();
+   Q_INVOKABLE QJSValue CalculateMinMaxRange(double start, double count);
+   Q_INVOKABLE QJSValue CalculateStats();
+   Q_INVOKABLE QJSValue CalculateStatsRange(double start, double count);
+   Q_INVOKABLE void SetMinMaxSummaryEnabled(bool enabled);
+   Q_INVOKABLE bool GetMinMaxSummaryEnabled();
+
+   Q_INVOKABLE bool ConvertInto(const QJSValue& dest, double start, double count, double destStart, double scale = 1.0, double offset = 0.0, bool saturate = true);
+   Q_INVOKABLE void SetReadConversion(double scale, double offset, bool saturate = true);
+   Q_INVOKABLE double GetReadScale();
+   Q_INVOKABLE double GetReadOffset();
 
    Q_INVOKABLE QJSValue GetInputDataSource();
    Q_INVOKABLE void SetInputDataSource(const QJSValue& source);
    Q_INVOKABLE bool IsRemote();
+   Q_INVOKABLE bool IsBufferShared();
 
    Q_INVOKABLE bool CanRefreshData();
    Q_INVOKABLE void RefreshData();
@@ -138,6 +304,7 @@ public:
 private:
    bool BoundsCheck(double index);
    bool BoundsCheckLogical(double index);
+   QJSValue statsValue(const SignalStats_t& stats);
 
 
 };
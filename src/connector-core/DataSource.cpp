@@ -64,15 +64,7 @@ void DataSource::UpdateStructure(TerbitDataType dataType, uint64_t firstIndex, u
 QVariant DataSource::GetPropertyValue(const QString &key)
 {
    //returns invalid qvariant if key not found
-   QVariant res;
-
-   DataPropertiesMap::iterator i = m_properties.find(key);
-   if (i != m_properties.end())
-   {
-      res = i->second;
-   }
-
-   return res;
+   return m_properties.value(key);
 }
 
 void DataSource::ShowDisplayView()
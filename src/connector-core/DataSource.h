@@ -18,7 +18,7 @@ limitations under the License.
 
 #include <QString>
 #include <QVariant>
-#include <map>
+#include <QMap>
 
 #include "tools/TerbitDefs.h"
 #include "tools/Tools.h"
@@ -30,7 +30,8 @@ namespace terbit
 class DataSet;
 class Workspace;
 
-typedef std::map<QString, QVariant> DataPropertiesMap;
+//implicitly shared, remotes reading the properties share them until either side changes them
+typedef QMap<QString, QVariant> DataPropertiesMap;
 
 class DataSource : public DataClass
 {
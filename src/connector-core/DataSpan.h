@@ -0,0 +1,278 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <iterator>
+#include <tools/TerbitDefs.h>
+#include "DataSet.h"
+
+namespace terbit
+{
+
+//elements computed per block when an affine data set is visited
+static const size_t DATASPAN_AFFINE_BLOCK_ELEMENTS = 256;
+
+/*** Typed, strided view of a contiguous run of data set elements, e.g. one
+ * channel of interleaved samples.  Indexing and iterating read the element
+ * type directly, the type switch is done once by whoever made the span
+ * (VisitDataType/VisitSpans/VisitTyped) rather than per element.
+ * A span is only valid while the run it views is: until the data set's
+ * buffer changes, or for a paged data set while its page is pinned (for
+ * the visitors, during the call the span is passed to).
+ **************************************************************/
+template<typename T>
+class DataSpan
+{
+public:
+   class const_iterator
+   {
+   public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef T value_type;
+      typedef ptrdiff_t difference_type;
+      typedef const T* pointer;
+      typedef const T& reference;
+
+      const_iterator(const char* p, size_t strideBytes) : m_p(p), m_strideBytes(strideBytes) {}
+      const T& operator*() const { return *((const T*)m_p); }
+      const T* operator->() const { return (const T*)m_p; }
+      const_iterator& operator++() { m_p += m_strideBytes; return *this; }
+      const_iterator operator++(int) { const_iterator it(*this); m_p += m_strideBytes; return it; }
+      bool operator==(const const_iterator& o) const { return m_p == o.m_p; }
+      bool operator!=(const const_iterator& o) const { return m_p != o.m_p; }
+   private:
+      const char* m_p;
+      size_t m_strideBytes;
+   };
+
+   DataSpan() : m_data(NULL), m_count(0), m_strideBytes(sizeof(T)) {}
+   DataSpan(const void* data, size_t count, size_t strideBytes) : m_data((const char*)data), m_count(data ? count : 0), m_strideBytes(strideBytes) {}
+
+   const T& operator[](size_t i) const { return *((const T*)(m_data + i*m_strideBytes)); }
+   const_iterator begin() const { return const_iterator(m_data, m_strideBytes); }
+   const_iterator end() const { return const_iterator(m_data + m_count*m_strideBytes, m_strideBytes); }
+
+   const T* GetData() const { return (const T*)m_data; }
+   size_t GetCount() const { return m_count; }
+   size_t GetStrideBytes() const { return m_strideBytes; }
+   bool IsEmpty() const { return m_count == 0; }
+   //packed elements, e.g. for the vectorized kernels
+   bool IsContiguous() const { return m_strideBytes == sizeof(T); }
+
+private:
+   const char* m_data;
+   size_t m_count;
+   size_t m_strideBytes;
+};
+
+//the contiguous run of elements from start on (empty when it can't be read or the data set is
+//paged or affine, visit those with VisitSpans)
+template<typename T>
+DataSpan<T> GetDataSpan(const DataSet* ds, size_t start)
+{
+   return DataSpan<T>(ds->GetElementAddress(start), ds->GetContiguousCount(start), ds->GetStrideBytes());
+}
+
+/*** Random access to every element of a data set for the searches: one span
+ * for a fixed buffer, two for a wrapped ring, element addresses looked up
+ * for a paged data set, its last page kept pinned.  Not for affine data
+ * sets, they are computed.
+ **************************************************************/
+template<typename T>
+class DataView
+{
+public:
+   DataView(const DataSet* ds) : m_paged(ds->IsPaged() ? ds : NULL), m_count(ds->GetCount())
+   {
+      DataSetSpan_t spans[2];
+      size_t n = m_paged ? 0 : ds->GetSpans(0, m_count, spans);
+      if (n > 0)
+      {
+         m_head = DataSpan<T>(spans[0].data, spans[0].count, ds->GetStrideBytes());
+      }
+      if (n > 1)
+      {
+         m_tail = DataSpan<T>(spans[1].data, spans[1].count, ds->GetStrideBytes());
+      }
+   }
+
+   T operator[](size_t i) const
+   {
+      if (m_paged)
+      {
+         const T* p = (const T*)m_paged->GetElementAddress(i, m_pin);
+         return p ? *p : T();
+      }
+      return i < m_head.GetCount() ? m_head[i] : m_tail[i - m_head.GetCount()];
+   }
+   size_t GetCount() const { return m_count; }
+
+private:
+   const DataSet* m_paged;
+   size_t m_count;
+   DataSpan<T> m_head;
+   DataSpan<T> m_tail; //wrapped part of a ring
+   mutable PagePin m_pin;
+};
+
+/*** Calls visitor.Visit<T>() with T the C++ type of a numeric data type, so
+ * a whole buffer is processed with one type switch.  Visitors are classes
+ * with a member template:
+ *    template<typename T> void Visit();
+ * Returns false, without calling the visitor, for a type with no C++
+ * element type (utf8, datetime).
+ **************************************************************/
+template<typename Visitor>
+bool VisitDataType(TerbitDataType type, Visitor& visitor)
+{
+   switch (type)
+   {
+   case TERBIT_INT8:
+      visitor.template Visit<int8_t>();
+      return true;
+   case TERBIT_UINT8:
+      visitor.template Visit<uint8_t>();
+      return true;
+   case TERBIT_INT16:
+      visitor.template Visit<int16_t>();
+      return true;
+   case TERBIT_UINT16:
+      visitor.template Visit<uint16_t>();
+      return true;
+   case TERBIT_INT32:
+      visitor.template Visit<int32_t>();
+      return true;
+   case TERBIT_UINT32:
+      visitor.template Visit<uint32_t>();
+      return true;
+   case TERBIT_INT64:
+      visitor.template Visit<int64_t>();
+      return true;
+   case TERBIT_UINT64:
+      visitor.template Visit<uint64_t>();
+      return true;
+   case TERBIT_FLOAT:
+      visitor.template Visit<float>();
+      return true;
+   case TERBIT_DOUBLE:
+      visitor.template Visit<double>();
+      return true;
+   case TERBIT_SIZE_T:
+      visitor.template Visit<size_t>();
+      return true;
+   case TERBIT_BOOL:
+      visitor.template Visit<bool>();
+      return true;
+   default:
+      return false;
+   }
+}
+
+/*** Calls f(DataSpan<T>) for each contiguous run of elements [start,
+ * start+count): the whole range of a fixed buffer, both halves of a wrapped
+ * ring, a page at a time when paged.  T must be the data set's element type.
+ * Affine elements are computed a block at a time and converted to T.
+ * Returns false when the range is out of bounds or a run can't be read
+ * (the runs before it have been visited).
+ **************************************************************/
+template<typename T, typename F>
+bool VisitSpans(const DataSet* ds, size_t start, size_t count, F& f)
+{
+   if (start > ds->GetCount() || count > ds->GetCount() - start)
+   {
+      return false;
+   }
+
+   if (ds->IsAffine())
+   {
+      T block[DATASPAN_AFFINE_BLOCK_ELEMENTS];
+      while (count > 0)
+      {
+         size_t n = std::min(count, DATASPAN_AFFINE_BLOCK_ELEMENTS);
+         if (!ds->CopyElements(start, n, block, ds->GetDataType(), sizeof(T)))
+         {
+            return false;
+         }
+         f(DataSpan<T>(block, n, sizeof(T)));
+         start += n;
+         count -= n;
+      }
+      return true;
+   }
+
+   PagePin pin;
+   while (count > 0)
+   {
+      size_t n = std::min(count, ds->GetContiguousCount(start));
+      const void* data = ds->GetElementAddress(start, pin);
+      if (n == 0 || data == NULL)
+      {
+         return false;
+      }
+      f(DataSpan<T>(data, n, ds->GetStrideBytes()));
+      start += n;
+      count -= n;
+   }
+   return true;
+}
+
+template<typename Visitor>
+class DataSpanVisitor
+{
+public:
+   DataSpanVisitor(const DataSet* ds, size_t start, size_t count, Visitor& visitor) :
+      m_ds(ds), m_start(start), m_count(count), m_visitor(visitor), m_res(false) {}
+
+   template<typename T>
+   void Visit()
+   {
+      m_res = VisitSpans<T>(m_ds, m_start, m_count, m_visitor);
+   }
+   bool GetResult() const { return m_res; }
+
+private:
+   const DataSet* m_ds;
+   size_t m_start;
+   size_t m_count;
+   Visitor& m_visitor;
+   bool m_res;
+};
+
+/*** VisitSpans with the element type resolved from the data set.  The
+ * visitor's call operator is a member template (C++11 has no generic
+ * lambdas):
+ *    template<typename T> void operator()(const DataSpan<T>& span);
+ * Returns false for a non-numeric data type, an out of bounds range or a
+ * run that can't be read.
+ **************************************************************/
+template<typename Visitor>
+bool VisitTyped(const DataSet* ds, size_t start, size_t count, Visitor& visitor)
+{
+   DataSpanVisitor<Visitor> v(ds, start, count, visitor);
+   return VisitDataType(ds->GetDataType(), v) && v.GetResult();
+}
+
+template<typename Visitor>
+bool VisitTyped(const DataSet* ds, Visitor& visitor)
+{
+   return VisitTyped(ds, 0, ds->GetCount(), visitor);
+}
+
+}// namespace terbit
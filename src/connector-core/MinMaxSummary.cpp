@@ -0,0 +1,336 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "MinMaxSummary.h"
+#include <tools/MinMax.h>
+#include <string.h>
+
+namespace terbit
+{
+
+static const size_t MINMAX_SUMMARY_BLOCK = 256;
+
+// Invalidating more than this fraction of the blocks rebuilds everything
+static const size_t MINMAX_SUMMARY_FULL_REBUILD_DIV = 4;
+
+// Merge a candidate min/max into a running pair.  NaN compares false both
+// ways, so a NaN candidate is skipped and a NaN running value replaced.
+template<typename DataType>
+static inline void mergeMinMax(bool& have, DataType& mn, DataType& mx, DataType cmn, DataType cmx)
+{
+   if (!have)
+   {
+      mn = cmn;
+      mx = cmx;
+      have = true;
+   }
+   else
+   {
+      if (mn != mn || cmn < mn)
+      {
+         mn = cmn;
+      }
+      if (mx != mx || cmx > mx)
+      {
+         mx = cmx;
+      }
+   }
+}
+
+template<typename DataType>
+static void scanRange(const char* buffer, size_t strideBytes, size_t start, size_t end, bool& have, DataType& mn, DataType& mx)
+{
+   const char* d = buffer + start*strideBytes;
+   for (size_t i = start; i < end; ++i)
+   {
+      DataType value = *((const DataType*)d);
+      mergeMinMax(have, mn, mx, value, value);
+      d += strideBytes;
+   }
+}
+
+MinMaxSummary::MinMaxSummary() : m_dataType(TERBIT_DATA_TYPE_GUARD), m_buffer(NULL), m_strideBytes(0), m_count(0), m_allDirty(true)
+{
+}
+
+void MinMaxSummary::Clear()
+{
+   m_levels.clear();
+   m_dirty.clear();
+   m_dirtyBlocks.clear();
+   m_buffer = NULL;
+   m_count = 0;
+   m_allDirty = true;
+}
+
+void MinMaxSummary::Invalidate()
+{
+   m_allDirty = true;
+}
+
+void MinMaxSummary::Invalidate(size_t start, size_t count)
+{
+   if (!m_allDirty && count > 0 && start < m_count)
+   {
+      size_t first = start / MINMAX_SUMMARY_BLOCK;
+      size_t last = (start + count - 1) / MINMAX_SUMMARY_BLOCK;
+      if (last >= m_dirty.size())
+      {
+         last = m_dirty.size() - 1;
+      }
+
+      for (size_t b = first; b <= last && !m_allDirty; ++b)
+      {
+         if (!m_dirty[b])
+         {
+            m_dirty[b] = 1;
+            m_dirtyBlocks.push_back(b);
+            m_allDirty = (m_dirtyBlocks.size() > m_dirty.size() / MINMAX_SUMMARY_FULL_REBUILD_DIV);
+         }
+      }
+   }
+}
+
+size_t MinMaxSummary::GetAllocatedByteCount() const
+{
+   size_t bytes = m_dirty.capacity() + m_dirtyBlocks.capacity()*sizeof(size_t);
+   for (auto& level : m_levels)
+   {
+      bytes += level.capacity();
+   }
+   return bytes;
+}
+
+bool MinMaxSummary::checkStructure(TerbitDataType type, const void* buffer, size_t strideBytes, size_t bufferCount)
+{
+   if (type != m_dataType || buffer != m_buffer || strideBytes != m_strideBytes || bufferCount != m_count)
+   {
+      m_dataType = type;
+      m_buffer = buffer;
+      m_strideBytes = strideBytes;
+      m_count = bufferCount;
+      m_allDirty = true;
+   }
+   return m_count > 0 && NULL != m_buffer;
+}
+
+template<typename DataType>
+void MinMaxSummary::computeLeaf(const char* buffer, size_t block)
+{
+   size_t first = block*MINMAX_SUMMARY_BLOCK;
+   size_t n = m_count - first;
+   if (n > MINMAX_SUMMARY_BLOCK)
+   {
+      n = MINMAX_SUMMARY_BLOCK;
+   }
+
+   DataType mn, mx;
+   if (m_strideBytes == sizeof(DataType))
+   {
+      MinMaxContiguous((const DataType*)(buffer + first*sizeof(DataType)), n, mn, mx);
+   }
+   else
+   {
+      MinMaxStrided((const DataType*)(buffer + first*m_strideBytes), n, m_strideBytes, mn, mx);
+   }
+
+   if (mn != mn || mx != mx)
+   {
+      // block starts with a NaN, rescan skipping it
+      bool have = false;
+      scanRange<DataType>(buffer, m_strideBytes, first, first + n, have, mn, mx);
+   }
+
+   DataType* node = (DataType*)m_levels[0].data() + 2*block;
+   node[0] = mn;
+   node[1] = mx;
+}
+
+template<typename DataType>
+void MinMaxSummary::computeNode(size_t level, size_t node)
+{
+   const std::vector<char>& below = m_levels[level - 1];
+   size_t nBelow = below.size() / (2*sizeof(DataType));
+   const DataType* child = (const DataType*)below.data() + 4*node;
+
+   bool have = false;
+   DataType mn = DataType(), mx = DataType();
+   mergeMinMax(have, mn, mx, child[0], child[1]);
+   if (2*node + 1 < nBelow)
+   {
+      mergeMinMax(have, mn, mx, child[2], child[3]);
+   }
+
+   DataType* dst = (DataType*)m_levels[level].data() + 2*node;
+   dst[0] = mn;
+   dst[1] = mx;
+}
+
+template<typename DataType>
+void MinMaxSummary::rebuild(const char* buffer)
+{
+   if (m_allDirty)
+   {
+      size_t nBlocks = (m_count + MINMAX_SUMMARY_BLOCK - 1) / MINMAX_SUMMARY_BLOCK;
+
+      m_levels.clear();
+      size_t n = nBlocks;
+      do
+      {
+         m_levels.push_back(std::vector<char>(2*n*sizeof(DataType)));
+         n = (n + 1) / 2;
+      } while (m_levels.back().size() > 2*sizeof(DataType));
+
+      for (size_t b = 0; b < nBlocks; ++b)
+      {
+         computeLeaf<DataType>(buffer, b);
+      }
+      for (size_t l = 1; l < m_levels.size(); ++l)
+      {
+         size_t nodes = m_levels[l].size() / (2*sizeof(DataType));
+         for (size_t i = 0; i < nodes; ++i)
+         {
+            computeNode<DataType>(l, i);
+         }
+      }
+
+      m_dirty.assign(nBlocks, 0);
+      m_dirtyBlocks.clear();
+      m_allDirty = false;
+   }
+   else if (!m_dirtyBlocks.empty())
+   {
+      for (size_t b : m_dirtyBlocks)
+      {
+         computeLeaf<DataType>(buffer, b);
+         size_t node = b;
+         for (size_t l = 1; l < m_levels.size(); ++l)
+         {
+            node /= 2;
+            computeNode<DataType>(l, node);
+         }
+         m_dirty[b] = 0;
+      }
+      m_dirtyBlocks.clear();
+   }
+}
+
+template<typename DataType>
+bool MinMaxSummary::queryTemplate(const char* buffer, size_t start, size_t count, TerbitValue& min, TerbitValue& max)
+{
+   rebuild<DataType>(buffer);
+
+   size_t end = start + count;
+   size_t b0 = (start + MINMAX_SUMMARY_BLOCK - 1) / MINMAX_SUMMARY_BLOCK;
+   size_t b1 = end / MINMAX_SUMMARY_BLOCK;
+   bool have = false;
+   DataType mn = DataType(), mx = DataType();
+
+   if (b0 >= b1)
+   {
+      // no whole block in the range
+      scanRange<DataType>(buffer, m_strideBytes, start, end, have, mn, mx);
+   }
+   else
+   {
+      scanRange<DataType>(buffer, m_strideBytes, start, b0*MINMAX_SUMMARY_BLOCK, have, mn, mx);
+      scanRange<DataType>(buffer, m_strideBytes, b1*MINMAX_SUMMARY_BLOCK, end, have, mn, mx);
+
+      // nodes [b0, b1) at each level, stepping up while the ends are paired
+      for (size_t l = 0; b0 < b1; ++l)
+      {
+         const DataType* nodes = (const DataType*)m_levels[l].data();
+         if (b0 & 1)
+         {
+            mergeMinMax(have, mn, mx, nodes[2*b0], nodes[2*b0 + 1]);
+            ++b0;
+         }
+         if (b1 & 1)
+         {
+            --b1;
+            mergeMinMax(have, mn, mx, nodes[2*b1], nodes[2*b1 + 1]);
+         }
+         b0 /= 2;
+         b1 /= 2;
+      }
+   }
+
+   if (have)
+   {
+      min.SetValue<DataType>(mn);
+      max.SetValue<DataType>(mx);
+   }
+   return have;
+}
+
+bool MinMaxSummary::Query(TerbitDataType type, const void* buffer, size_t strideBytes, size_t bufferCount,
+                          size_t start, size_t count, TerbitValue& min, TerbitValue& max)
+{
+   bool res = false;
+
+   if (count == 0 || start >= bufferCount || count > bufferCount - start || !checkStructure(type, buffer, strideBytes, bufferCount))
+   {
+      return false;
+   }
+
+   const char* d = (const char*)buffer;
+   switch (type)
+   {
+   case TERBIT_INT64:
+      res = queryTemplate<int64_t>(d, start, count, min, max);
+      break;
+   case TERBIT_UINT64:
+      res = queryTemplate<uint64_t>(d, start, count, min, max);
+      break;
+   case TERBIT_INT32:
+      res = queryTemplate<int32_t>(d, start, count, min, max);
+      break;
+   case TERBIT_UINT32:
+      res = queryTemplate<uint32_t>(d, start, count, min, max);
+      break;
+   case TERBIT_INT16:
+      res = queryTemplate<int16_t>(d, start, count, min, max);
+      break;
+   case TERBIT_UINT16:
+      res = queryTemplate<uint16_t>(d, start, count, min, max);
+      break;
+   case TERBIT_INT8:
+      res = queryTemplate<int8_t>(d, start, count, min, max);
+      break;
+   case TERBIT_UINT8:
+      res = queryTemplate<uint8_t>(d, start, count, min, max);
+      break;
+   case TERBIT_FLOAT:
+      res = queryTemplate<float>(d, start, count, min, max);
+      break;
+   case TERBIT_DOUBLE:
+      res = queryTemplate<double>(d, start, count, min, max);
+      break;
+   case TERBIT_SIZE_T:
+      res = queryTemplate<size_t>(d, start, count, min, max);
+      break;
+   case TERBIT_BOOL:
+      res = queryTemplate<bool>(d, start, count, min, max);
+      break;
+   default:
+      break;
+   }
+
+   return res;
+}
+
+}// namespace terbit
@@ -0,0 +1,72 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <tools/TerbitDefs.h>
+#include <tools/TerbitValue.h>
+
+namespace terbit
+{
+
+/*** Multi-resolution min/max summary of a strided buffer.  Level 0 holds
+ * the min/max of each block of MINMAX_SUMMARY_BLOCK elements, each level
+ * above halves the previous one, up to a single root.  A range query scans
+ * at most two partial blocks and combines O(log n) summary nodes.
+ * The summary is rebuilt lazily on the next query: Invalidate() marks
+ * everything stale (new data), Invalidate(start, count) only the blocks
+ * touched, which are then rebuilt along with their parents.  A change of
+ * buffer, type, stride or count forces a full rebuild.  NaNs are ignored
+ * unless a range holds nothing else.
+ **************************************************************/
+class MinMaxSummary
+{
+public:
+   MinMaxSummary();
+
+   void Clear(void);
+   void Invalidate(void);
+   void Invalidate(size_t start, size_t count);
+
+   // min/max are converted to their own data types; false if the range is
+   // empty/out of bounds or the type has no ordering
+   bool Query(TerbitDataType type, const void* buffer, size_t strideBytes, size_t bufferCount,
+              size_t start, size_t count, TerbitValue& min, TerbitValue& max);
+
+   size_t GetLevelCount(void) const {return m_levels.size();}
+   size_t GetAllocatedByteCount(void) const;
+
+private:
+   template<typename DataType> bool queryTemplate(const char* buffer, size_t start, size_t count, TerbitValue& min, TerbitValue& max);
+   template<typename DataType> void rebuild(const char* buffer);
+   template<typename DataType> void computeLeaf(const char* buffer, size_t block);
+   template<typename DataType> void computeNode(size_t level, size_t node);
+   bool checkStructure(TerbitDataType type, const void* buffer, size_t strideBytes, size_t bufferCount);
+
+   TerbitDataType     m_dataType;
+   const void*        m_buffer;
+   size_t             m_strideBytes;
+   size_t             m_count;
+   bool               m_allDirty;
+   std::vector<uint8_t> m_dirty; // per level 0 block
+   std::vector<size_t>  m_dirtyBlocks;
+   std::vector<std::vector<char> > m_levels; // min,max pairs per node
+};
+
+}// namespace terbit
@@ -0,0 +1,156 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "StatsSummary.h"
+#include "DataSet.h"
+#include <algorithm>
+
+namespace terbit
+{
+
+static const uint64_t STATS_SUMMARY_BLOCK = 4096;
+
+//elements [start, start+count) converted to doubles a kernel block at a time, any data set mode
+static bool accumulateRange(const DataSet* ds, size_t start, size_t count, SignalStats_t& stats)
+{
+   double values[SIGNAL_STATS_BLOCK];
+   while (count > 0)
+   {
+      size_t n = std::min(count, SIGNAL_STATS_BLOCK);
+      if (!ds->CopyElements(start, n, values, TERBIT_DOUBLE, sizeof(double)))
+      {
+         return false;
+      }
+      SignalStatsAccumulate(stats, values, n);
+      start += n;
+      count -= n;
+   }
+   return true;
+}
+
+StatsSummary::StatsSummary() : m_firstBlock(0)
+{
+}
+
+void StatsSummary::Clear()
+{
+   m_blocks.clear();
+   m_firstBlock = 0;
+}
+
+void StatsSummary::Invalidate(uint64_t first, size_t count)
+{
+   if (count == 0 || m_blocks.empty())
+   {
+      return;
+   }
+
+   uint64_t b0 = std::max(first/STATS_SUMMARY_BLOCK, m_firstBlock);
+   uint64_t b1 = std::min((first + count - 1)/STATS_SUMMARY_BLOCK + 1, m_firstBlock + m_blocks.size());
+   for (uint64_t b = b0; b < b1; ++b)
+   {
+      SignalStatsInit(m_blocks[(size_t)(b - m_firstBlock)]);
+   }
+}
+
+void StatsSummary::Trim(uint64_t first)
+{
+   while (!m_blocks.empty() && m_firstBlock*STATS_SUMMARY_BLOCK < first)
+   {
+      m_blocks.pop_front();
+      ++m_firstBlock;
+   }
+}
+
+bool StatsSummary::block(const DataSet* ds, uint64_t b, SignalStats_t& stats)
+{
+   if (m_blocks.empty())
+   {
+      m_firstBlock = b;
+   }
+   while (b < m_firstBlock)
+   {
+      SignalStats_t empty;
+      SignalStatsInit(empty);
+      m_blocks.push_front(empty);
+      --m_firstBlock;
+   }
+   while (b >= m_firstBlock + m_blocks.size())
+   {
+      SignalStats_t empty;
+      SignalStatsInit(empty);
+      m_blocks.push_back(empty);
+   }
+
+   SignalStats_t& cached = m_blocks[(size_t)(b - m_firstBlock)];
+   if (cached.count == 0 &&
+       !accumulateRange(ds, (size_t)(b*STATS_SUMMARY_BLOCK - ds->GetFirstIndex()), STATS_SUMMARY_BLOCK, cached))
+   {
+      SignalStatsInit(cached);
+      return false;
+   }
+   stats = cached;
+   return true;
+}
+
+bool StatsSummary::Query(const DataSet* ds, size_t start, size_t count, SignalStats_t& stats)
+{
+   SignalStatsInit(stats);
+   if (start > ds->GetCount() || count > ds->GetCount() - start)
+   {
+      return false;
+   }
+
+   //blocks outside the data set can't be valid, e.g. a remote moved to another window
+   uint64_t dsFirst = ds->GetFirstIndex();
+   uint64_t dsEnd = dsFirst + ds->GetCount();
+   Trim(dsFirst);
+   while (!m_blocks.empty() && (m_firstBlock + m_blocks.size())*STATS_SUMMARY_BLOCK > dsEnd)
+   {
+      m_blocks.pop_back();
+   }
+
+   //full blocks [b0, b1) between the partial ends
+   uint64_t first = dsFirst + start;
+   uint64_t end = first + count;
+   uint64_t b0 = (first + STATS_SUMMARY_BLOCK - 1)/STATS_SUMMARY_BLOCK;
+   uint64_t b1 = end/STATS_SUMMARY_BLOCK;
+   if (b1 <= b0)
+   {
+      return accumulateRange(ds, start, count, stats);
+   }
+
+   if (!accumulateRange(ds, start, (size_t)(b0*STATS_SUMMARY_BLOCK - first), stats))
+   {
+      return false;
+   }
+   for (uint64_t b = b0; b < b1; ++b)
+   {
+      SignalStats_t s;
+      if (!block(ds, b, s))
+      {
+         return false;
+      }
+      SignalStatsMerge(stats, s);
+   }
+   return accumulateRange(ds, (size_t)(b1*STATS_SUMMARY_BLOCK - dsFirst), (size_t)(end - b1*STATS_SUMMARY_BLOCK), stats);
+}
+
+size_t StatsSummary::GetAllocatedByteCount() const
+{
+   return m_blocks.size()*sizeof(SignalStats_t);
+}
+
+}// namespace terbit
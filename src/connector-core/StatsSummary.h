@@ -0,0 +1,59 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <tools/SignalStats.h>
+
+namespace terbit
+{
+
+class DataSet;
+
+/*** Cached statistics of each STATS_SUMMARY_BLOCK elements of a data set,
+ * keyed by logical index (first index + i).  A ring's appends leave the
+ * cached blocks alone: new elements land in new blocks and the blocks the
+ * ring drops are trimmed.  A range query computes the partial blocks at its
+ * ends and merges the full blocks between them, computing the ones not
+ * cached yet.  Only full blocks inside the data set are cached.
+ **************************************************************/
+class StatsSummary
+{
+public:
+   StatsSummary();
+
+   void Clear(void);
+   //elements [first, first+count) by logical index changed
+   void Invalidate(uint64_t first, size_t count);
+   //elements before the logical index first are gone
+   void Trim(uint64_t first);
+
+   //false if the range is out of bounds or can't be read
+   bool Query(const DataSet* ds, size_t start, size_t count, SignalStats_t& stats);
+
+   size_t GetAllocatedByteCount(void) const;
+
+private:
+   bool block(const DataSet* ds, uint64_t b, SignalStats_t& stats);
+
+   std::deque<SignalStats_t> m_blocks; //count 0 until computed
+   uint64_t m_firstBlock;              //block number of m_blocks[0]
+};
+
+}// namespace terbit
@@ -30,6 +30,7 @@ limitations under the License.
 #include "tools/Script.h"
 #include "IDataClassFactory.h"
 #include "LogView.h"
+#include <tools/BufferPool.h>
 #include <QQmlContext>
 #include <set>
 #include "DataClassManager.h"
@@ -716,6 +717,10 @@ ScriptDocumentation *BuildScriptDocumentationWorkspace()
    d->AddScriptlet(new Scriptlet(QObject::tr("RunScript"), "RunScript(sourceCode);",QObject::tr("Executes the JavaScript source code in another context.  Variables defined in the current context are not accesible in the new script context.  Communication may be done through instances in the workspace.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("RunScriptFile"), "RunScriptFile(fileName);",QObject::tr("Executes the JavaScript code from the file in another context.  The file name is fully pathed.  Variables defined in the current context are not accesible in the new script context.  Communication may be done through instances in the workspace.")));
 
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetBufferPoolStats"), "GetBufferPoolStats();",QObject::tr("Returns an object describing the pool that holds data set buffers: bytesInUse, bytesCached (freed buffers kept for reuse), cacheLimit, hits, misses, hitRate (0-1) and hugePages.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetBufferPoolOptions"), "SetBufferPoolOptions(cacheLimitBytes, hugePages);",QObject::tr("Sets the most bytes of freed data set buffers kept for reuse and the huge page mode for buffers of 1 MB and up: 0 off, 1 transparent huge pages (default), 2 reserved huge pages (falls back to 1 when none are free).")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("TrimBufferPool"), "TrimBufferPool();",QObject::tr("Returns every cached data set buffer to the operating system.")));
+
    return d;
 }
 
@@ -875,6 +880,36 @@ void WorkspaceSW::RunScriptFile(const QString &fileName)
    }
 }
 
+QJSValue WorkspaceSW::GetBufferPoolStats()
+{
+   BufferPool::Stats_t stats = BufferPool::Instance().GetStats();
+   QJSValue res = m_scriptEngine->newObject();
+   res.setProperty("bytesInUse", (double)stats.bytesInUse);
+   res.setProperty("bytesCached", (double)stats.bytesCached);
+   res.setProperty("cacheLimit", (double)stats.cacheLimit);
+   res.setProperty("hits", (double)stats.hits);
+   res.setProperty("misses", (double)stats.misses);
+   res.setProperty("hitRate", stats.hitRate);
+   res.setProperty("hugePages", (int)stats.hugePages);
+   return res;
+}
+
+void WorkspaceSW::SetBufferPoolOptions(double cacheLimitBytes, int hugePages)
+{
+   if (cacheLimitBytes < 0 || hugePages < BufferPool::HugeOff || hugePages > BufferPool::HugeExplicit)
+   {
+      LogError(g_log.general,tr("Invalid options passed to SetBufferPoolOptions"));
+      return;
+   }
+   BufferPool::Instance().SetCacheLimit((uint64_t)cacheLimitBytes);
+   BufferPool::Instance().SetHugePages((BufferPool::HugePages_t)hugePages);
+}
+
+void WorkspaceSW::TrimBufferPool()
+{
+   BufferPool::Instance().Trim();
+}
+
 QJSValue WorkspaceSW::FindDock(const QString &objectName)
 {
    QJSValue res;
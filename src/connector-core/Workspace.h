@@ -190,6 +190,10 @@ public:
    Q_INVOKABLE void RunScript(const QString& sourceCode);
    Q_INVOKABLE void RunScriptFile(const QString& fileName);
 
+   Q_INVOKABLE QJSValue GetBufferPoolStats();
+   Q_INVOKABLE void SetBufferPoolOptions(double cacheLimitBytes, int hugePages);
+   Q_INVOKABLE void TrimBufferPool();
+
 protected:
    Workspace* m_workspace;
    QJSEngine* m_scriptEngine;
@@ -30,6 +30,12 @@ SOURCES += \
     Block.cpp \
     WorkspaceDockWidget.cpp \
     ../tools/TerbitValue.cpp \
+    ../tools/MinMax.cpp \
+    ../tools/TypeConvert.cpp \
+    ../tools/PageCache.cpp \
+    ../tools/BufferPool.cpp \
+    ../tools/VecMath.cpp \
+    ../tools/SignalStats.cpp \
     ../tools/Script.cpp \
     LogView.cpp \
     OptionsDLView.cpp \
@@ -40,6 +46,8 @@ SOURCES += \
     PluginsView.cpp \
     SystemView.cpp \
     DataSet.cpp \
+    MinMaxSummary.cpp \
+    StatsSummary.cpp \
     DataSetListView.cpp \
     ../tools/widgets/BigScrollbar.cpp \
     ScriptDocumentation.cpp \
@@ -66,6 +74,12 @@ HEADERS += \
     Block.h \
     WorkspaceDockWidget.h \
     ../tools/TerbitValue.h \
+    ../tools/MinMax.h \
+    ../tools/TypeConvert.h \
+    ../tools/PageCache.h \
+    ../tools/BufferPool.h \
+    ../tools/VecMath.h \
+    ../tools/SignalStats.h \
     ../tools/Script.h \
     LogView.h \
     OptionsDLView.h \
@@ -76,6 +90,9 @@ HEADERS += \
     PluginsView.h \
     SystemView.h \
     DataSet.h \
+    DataSpan.h \
+    MinMaxSummary.h \
+    StatsSummary.h \
     DataSetListView.h \
     ../tools/TerbitDefs.h \
     Event.h \
@@ -18,8 +18,10 @@ limitations under the License.
 #include "DataSetValues.h"
 #include "DataSetValuesView.h"
 #include "connector-core/DataSet.h"
+#include "connector-core/DataSpan.h"
 #include "connector-core/Workspace.h"
 #include "connector-core/LogDL.h"
+#include "tools/TypeConvert.h"
 
 namespace terbit
 {
@@ -296,44 +298,45 @@ QString FormatValueFloatDouble(char* buf)
    return res;
 }
 
+//formats the value at buf as the display type, resolved once per value
+class FormatValueVisitor
+{
+public:
+   FormatValueVisitor(char* buf, DataSetValues::DisplayFormat valueFormat, int valueSize) :
+      m_buf(buf), m_valueFormat(valueFormat), m_valueSize(valueSize) {}
+   template<typename DataType> void Visit()
+   {
+      m_res = FormatValueTemplate<DataType>(m_buf, m_valueFormat, m_valueSize);
+   }
+   const QString& GetResult() const { return m_res; }
+private:
+   char* m_buf;
+   DataSetValues::DisplayFormat m_valueFormat;
+   int m_valueSize;
+   QString m_res;
+};
+
+template<>
+void FormatValueVisitor::Visit<float>()
+{
+   m_res = FormatValueFloatDouble<float>(m_buf);
+}
+
+template<>
+void FormatValueVisitor::Visit<double>()
+{
+   m_res = FormatValueFloatDouble<double>(m_buf);
+}
+
 QString DataSetValues::FormatValue(char* buf, TerbitDataType valueType, DataSetValues::DisplayFormat valueFormat, int valueSize) const
 {
-   switch (valueType)
+   FormatValueVisitor v(buf, valueFormat, valueSize);
+   if (VisitDataType(valueType, v))
    {
-   case TERBIT_INT8:
-      return FormatValueTemplate<int8_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_INT16:
-      return FormatValueTemplate<int16_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_INT32:
-      return FormatValueTemplate<int32_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_INT64:
-      return FormatValueTemplate<int64_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_UINT8:
-      return FormatValueTemplate<uint8_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_UINT16:
-      return FormatValueTemplate<uint16_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_UINT32:
-      return FormatValueTemplate<uint32_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_UINT64:
-      return FormatValueTemplate<uint64_t>(buf,valueFormat, valueSize);
-      break;
-   case TERBIT_FLOAT:
-      return FormatValueFloatDouble<float>(buf);
-      break;
-   case TERBIT_DOUBLE:
-      return FormatValueFloatDouble<double>(buf);
-      break;
-   };
+      return v.GetResult();
+   }
    LogError2(GetType()->GetLogCategory(), GetName(),tr("Data Set Values can't format value %1.").arg(valueType));
    return QString("");
-
 }
 
 void DataSetValues::SetDataType(TerbitDataType dataType)
@@ -554,22 +557,43 @@ QString DataSetValues::GetDisplayValue(uint64_t row, uint64_t col)
       size_t valueSize = TerbitDataTypeSize(m_dataType);
       size_t bufferElementSize = TerbitDataTypeSize(m_dataSet->GetDataType());
       size_t bufferStride = m_dataSet->GetStrideBytes();
+      size_t element = (size_t)(index - m_dataSet->GetFirstIndex());
+
+      //an affine data set is computed, materialize the elements the value covers
+      if (m_dataSet->IsAffine())
+      {
+         size_t pieces = (size_t)ceil(valueSize/(double)bufferElementSize);
+         char* tempBuf = CreateTempBuf(pieces*bufferElementSize);
+         if (!m_dataSet->CopyElements(element, pieces, tempBuf, m_dataSet->GetDataType(), bufferElementSize))
+         {
+            return QString("");
+         }
+         size_t displayByteStart = 0;
+         if (valueSize < bufferElementSize)
+         {
+            displayByteStart = ((row*valueSize*m_cols+col*valueSize)- m_dataSet->GetInputSource().GetFirstIndex()) % bufferElementSize;
+         }
+         return FormatValue(tempBuf + displayByteStart, m_dataType, m_format, valueSize);
+      }
 
-      if (valueSize == bufferElementSize || (valueSize > bufferElementSize && bufferElementSize == bufferStride))
+      //a ring wraps and a paged data set is resident a page at a time, the elements after
+      //this one are only contiguous up to there
+      bool contiguous = bufferElementSize == bufferStride && m_dataSet->GetContiguousCount(element)*bufferElementSize >= valueSize;
+
+      //keeps a paged element's page mapped while it is formatted
+      PagePin pin;
+      if (valueSize == bufferElementSize || (valueSize > bufferElementSize && contiguous))
       {
          //same size or display is greater and data is contiguous
-         size_t offset = (index - m_dataSet->GetFirstIndex()) * bufferStride;
-         char* buf = (char*)m_dataSet->GetBufferAddress() + offset;
-         return FormatValue(buf, m_dataType, m_format, valueSize);
+         char* buf = (char*)m_dataSet->GetElementAddress(element, pin);
+         return buf ? FormatValue(buf, m_dataType, m_format, valueSize) : QString("");
       }
       else if (valueSize < bufferElementSize)
       {
          //find out where in the buffer element bytes we are interested in
          size_t displayByteStart = ((row*valueSize*m_cols+col*valueSize)- m_dataSet->GetInputSource().GetFirstIndex()) % bufferElementSize;
-         size_t offset = (index - m_dataSet->GetFirstIndex()) * bufferStride + displayByteStart;
-
-         char* buf = (char*)m_dataSet->GetBufferAddress() + offset;
-         return FormatValue(buf, m_dataType, m_format, valueSize);
+         char* buf = (char*)m_dataSet->GetElementAddress(element, pin);
+         return buf ? FormatValue(buf + displayByteStart, m_dataType, m_format, valueSize) : QString("");
       }
       else
       {
@@ -582,12 +606,25 @@ QString DataSetValues::GetDisplayValue(uint64_t row, uint64_t col)
          char* tempBuf = CreateTempBuf(pieces*bufferElementSize);
          char* pieceBuf = tempBuf;
 
-         size_t offset = (index - m_dataSet->GetFirstIndex()) * bufferStride;
-         char* buf = (char*)m_dataSet->GetBufferAddress() + offset;
-
-         for(size_t piece = 0; piece < pieces; ++piece, buf += bufferStride, pieceBuf += bufferElementSize)
+         //a run at a time, the buffer may wrap or change pages between elements
+         if (IsConvertibleDataType(m_dataSet->GetDataType()))
+         {
+            if (!m_dataSet->CopyElements(element, pieces, tempBuf, m_dataSet->GetDataType(), bufferElementSize))
+            {
+               return QString("");
+            }
+         }
+         else
          {
-            memcpy(pieceBuf,buf,bufferElementSize);
+            for(size_t piece = 0; piece < pieces; ++piece, ++element, pieceBuf += bufferElementSize)
+            {
+               char* buf = element < m_dataSet->GetCount() ? (char*)m_dataSet->GetElementAddress(element, pin) : NULL;
+               if (buf == NULL)
+               {
+                  return QString("");
+               }
+               memcpy(pieceBuf,buf,bufferElementSize);
+            }
          }
 
          QString res;
@@ -0,0 +1,151 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "DataRing.h"
+#include <new>
+
+namespace terbit
+{
+
+static const uint32_t MIN_RING_SLOTS = 3;
+
+DataRing::DataRing() : m_latest(-1), m_reading(-1), m_published(0), m_delivered(0), m_dropped(0), m_overruns(0)
+{
+}
+
+DataRing::~DataRing()
+{
+   freeSlots();
+}
+
+void DataRing::freeSlots(void)
+{
+   for(auto& it : m_slots)
+   {
+      delete[] it.pStorage;
+   }
+   m_slots.clear();
+}
+
+bool DataRing::Init(uint32_t nSlots)
+{
+   if(nSlots < MIN_RING_SLOTS)
+   {
+      nSlots = MIN_RING_SLOTS;
+   }
+
+   freeSlots();
+   Slot_t s = {NULL, 0, NULL, TERBIT_UINT8, 0, 0};
+   m_slots.resize(nSlots, s);
+
+   m_latest   = -1;
+   m_reading  = -1;
+   m_writeIdx = -1;
+   return true;
+}
+
+void DataRing::Reset(void)
+{
+   m_latest = -1;
+}
+
+void DataRing::ResetCounters(void)
+{
+   m_published = 0;
+   m_delivered = 0;
+   m_dropped   = 0;
+   m_overruns  = 0;
+}
+
+// Returns the next slot that is neither the newest published nor held by
+// the consumer, with at least bytes of storage.  NULL on allocation failure.
+DataRing::Slot_t* DataRing::AcquireWrite(size_t bytes)
+{
+   Slot_t* retVal = NULL;
+   int n = (int)m_slots.size();
+   int latest = m_latest;
+   int reading = m_reading;
+
+   for(int i = 1; i <= n && NULL == retVal; ++i)
+   {
+      int idx = (m_writeIdx + i) % n;
+      if(idx != latest && idx != reading)
+      {
+         m_writeIdx = idx;
+         retVal = &m_slots[idx];
+      }
+   }
+
+   if(NULL != retVal && retVal->storageBytes < bytes)
+   {
+      delete[] retVal->pStorage;
+      retVal->pStorage = new(std::nothrow) char[bytes];
+      retVal->storageBytes = (NULL != retVal->pStorage) ? bytes : 0;
+      if(NULL == retVal->pStorage)
+      {
+         retVal = NULL;
+      }
+   }
+
+   if(NULL != retVal)
+   {
+      retVal->pData = retVal->pStorage;
+   }
+   return retVal;
+}
+
+void DataRing::Publish(Slot_t* slot)
+{
+   slot->seq = ++m_writeSeq;
+   m_latest = (int)(slot - &m_slots[0]);
+   ++m_published;
+}
+
+const DataRing::Slot_t* DataRing::AcquireRead(void)
+{
+   const Slot_t* retVal = NULL;
+   int latest;
+
+   // Claim the newest slot, then make sure it is still the newest.  If the
+   // producer published in between it may already be writing to the slot we
+   // claimed, so try again.  Once the claim is confirmed the producer skips
+   // the slot until we claim another.
+   do
+   {
+      latest = m_latest;
+      if(latest < 0)
+      {
+         return NULL;
+      }
+      m_reading = latest;
+   }while(latest != m_latest);
+
+   const Slot_t& s = m_slots[latest];
+   if(s.seq > m_lastReadSeq)
+   {
+      if(s.seq > m_lastReadSeq + 1)
+      {
+         m_dropped += s.seq - m_lastReadSeq - 1;
+         ++m_overruns;
+      }
+      m_lastReadSeq = s.seq;
+      ++m_delivered;
+      retVal = &s;
+   }
+   return retVal;
+}
+
+}// namespace terbit
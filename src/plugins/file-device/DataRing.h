@@ -0,0 +1,96 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include "tools/TerbitDefs.h"
+
+namespace terbit
+{
+
+/*** Single producer, single consumer ring of data buffers.  The producer
+ * (FileDevice processing thread) fills a slot and publishes it with a
+ * sequence number.  The consumer (GUI thread) always takes the newest
+ * published slot and holds it until it takes the next one.  The producer
+ * never writes to the newest published slot or the held slot, so a consumer
+ * never sees a buffer being overwritten, and a slow consumer skips stale
+ * slots instead of stalling the producer.  Needs at least 3 slots.
+ *
+ * Counters:
+ * o Published - buffers published by the producer.
+ * o Delivered - buffers taken by the consumer.
+ * o Dropped   - buffers superseded before the consumer took them.
+ * o Overruns  - number of times the consumer fell behind (took a buffer
+ *   and one or more older ones had been dropped).
+ **************************************************************/
+class DataRing
+{
+public:
+   typedef struct
+   {
+      char*          pStorage;     // owned by the ring
+      size_t         storageBytes;
+      const void*    pData;        // published data, pStorage or an external buffer (e.g. file mapping)
+      TerbitDataType dataType;
+      uint64_t       nElts;
+      uint64_t       seq;
+   }Slot_t;
+
+   DataRing();
+   ~DataRing();
+
+   // Not thread safe.  Only call while the producer is paused and the
+   // consumer does not reference slot memory.
+   bool Init(uint32_t nSlots);
+   uint32_t GetNumSlots(void){return (uint32_t)m_slots.size();}
+
+   // Forget published slots that have not been consumed.  Not thread safe,
+   // only call while the producer is paused.
+   void Reset(void);
+
+   // producer side
+   Slot_t* AcquireWrite(size_t bytes);
+   void Publish(Slot_t* slot);
+
+   // consumer side, NULL if nothing newer than the last slot taken
+   const Slot_t* AcquireRead(void);
+
+   uint64_t GetPublishedCount(void){return m_published;}
+   uint64_t GetDeliveredCount(void){return m_delivered;}
+   uint64_t GetDroppedCount(void){return m_dropped;}
+   uint64_t GetOverrunCount(void){return m_overruns;}
+   void     ResetCounters(void);
+
+private:
+   DataRing(const DataRing& o); //disable copy ctor
+   void freeSlots(void);
+
+   std::vector<Slot_t>   m_slots;
+   std::atomic<int>      m_latest;      // newest published slot, -1 for none
+   std::atomic<int>      m_reading;     // slot held by the consumer, -1 for none
+   int                   m_writeIdx    = -1; // producer only
+   uint64_t              m_writeSeq    = 0;  // producer only
+   uint64_t              m_lastReadSeq = 0;  // consumer only
+   std::atomic<uint64_t> m_published;
+   std::atomic<uint64_t> m_delivered;
+   std::atomic<uint64_t> m_dropped;
+   std::atomic<uint64_t> m_overruns;
+};
+
+}// namespace terbit
@@ -51,19 +51,55 @@ limitations under the License.
  * o Buffer size in number of elements - this option is staged until the next
  *   stop->start transition.
  * o Data type of input data - this option can take effect immediately.
+ * o Number of channels - for interleaved files, one extra output DataSet per
+ *   channel.  Each is a strided view into the same buffer as the interleaved
+ *   output, nothing is copied.  Set while stopped.
  * o File name - This option is staged until the next stop->start transition.
- * o Data buffer transmission frequency.  Note that very low frequencies
- *   could cause the processing thread to sleep for many minutes.  The
- *   sleep code is therefore implemented in a helper function that breaks
- *   long sleeps into multiple sleeps of a maximum allowable time (~1s).
- *   This loop will break if a command such as stop, pause, or single is
- *   received.  This option can take effect immediately.
+ * o Data buffer transmission frequency.  Buffers are paced against absolute
+ *   deadlines (see Pacer) so read and emit time does not cause drift, and
+ *   rates well above the OS sleep granularity are possible.  Note that very
+ *   low frequencies could cause the processing thread to wait for many
+ *   minutes.  The wait is therefore broken into steps of a maximum
+ *   allowable time (MAX_PACER_WAIT_MS) and will break if a command such as
+ *   stop, pause, or single is received.  This option can take effect
+ *   immediately.
+ * o Pacing policy - what to do when a deadline is missed, catch up or skip.
  * o Loop - whether to loop the file input continuously.  This option can
  *   be set immediately.
+ * o Mapped - memory-map the file instead of caching it through fread.  The
+ *   output DataSet then points straight into the mapping (no copy) for every
+ *   buffer that is contiguous in the file.  The last partial buffer and the
+ *   wrap-around in loop mode are copied into a ring slot.  This option is
+ *   staged until the next file update.  Ignored for a list of files.
+ * o File list - several files played back to back as one continuous source
+ *   (see FileDvcReadAhead).  A worker thread reads ahead across the file
+ *   boundaries; loop wraps from the last file back to the first.  This
+ *   option is staged until the next stop->start transition.
+ * o Capture file - a single file in the chunked capture format (see
+ *   CaptureCodec.h) is recognized by its header and decoded ahead of the
+ *   reader by a pool of threads (see FileDvcChunked), so far fewer bytes
+ *   come off the disk.  The data type and sample rate are taken from the
+ *   header.  Mapped doesn't apply.
+ * o Sample format - digitizer files with 12, 14 or 24 bit packed samples
+ *   or big-endian samples (see SampleUnpack.h).  Each buffer is read as file
+ *   bytes and unpacked into the native data type before it is published, so
+ *   mapped files are copied.  A packed width picks the data type (16 or 32
+ *   bit, keeping the signedness) and rounds the buffer size up to whole
+ *   packed groups.  The ADC resolution is published to the outputs as the
+ *   sampling bits property (SetSamplingBits() overrides it).  Staged until
+ *   the next UpdateSrc().
+ * o Sample rate - samples per second per channel of the recording, used to
+ *   turn a time into a sample for SeekToTime().  When not set, the playback
+ *   rate (frequency x samples per buffer) is used.
  * These configuration items have accessor functions for the GUI.  Another
  * item available to the GUI is "FilePos", which is the current file pointer
  * position.  This allows the GUI to show progress through a file.
  *
+ * SeekToSample() and SeekToTime() jump straight to a file offset (a sample
+ * is one element of every channel) instead of reading up to it like
+ * SkipBytes(), across file boundaries for a file list.  The buffer at the
+ * new position is shown right away and playback continues after it.
+ *
  * ----------------------------- Object Creation ----------------------------
  * The default construction initializes many member variables, but does not
  * initialize default values and start the processing thread.  In order to do
@@ -85,11 +121,16 @@ limitations under the License.
  * Inter-thread communication within this class (such as in UpdateFile() or
  * UpdateSrc() is protected against "locking up" by implementing timeouts.
  *
+ * Data is handed from the processing thread to the GUI thread through a
+ * DataRing.  The processing thread fills a ring slot, publishes it and queues
+ * OnRingData() on the GUI thread (at most one call pending at a time).
+ * OnRingData() points the output DataSet at the newest published slot and
+ * emits NewData, so consumers never see a buffer that is being overwritten.
+ * Consumers that are slower than the device skip slots, which shows up in
+ * the ring's dropped/overrun counters.
+ *
  * ------------------------ Future Features -----------------------
  * o Multiple channels (each with its own data source) within a single file.
- * o Multiple files - a sequence of files instead of just a single file.
- *   The file management portion of this should be implemented in the FileDvc
- *   class.
  *
  * NOTE: certain functions use a uint64_t type instead of size_t so
  *       that 32-bit builds can access large files.  size_t would resolve
@@ -97,6 +138,7 @@ limitations under the License.
  **************************************************************************/
 //#include <QtConcurrent/QtConcurrent>
 #include <QFileInfo>
+#include <algorithm>
 #include "FileDevice.h"
 #include "FileDeviceView.h"
 #include "connector-core/Workspace.h"
@@ -108,7 +150,8 @@ namespace terbit
 {
 
 static const uint32_t FD_THREAD_TIMEOUT_MS = 500;
-static const double   MIN_FREQ_SLEEP_HZ    = 1.0;
+static const uint32_t MAX_PACER_WAIT_MS    = 100;
+static const uint32_t CONFIG_UPDATE_MS     = 50; // limit GUI updates while running
 static const size_t   START_NELTS          = 2048;
 
 static void convertToDouble(char* src, double* dst, size_t nDstElts, TerbitDataType t);
@@ -117,6 +160,8 @@ FileDevice::FileDevice()
 {
    m_nEltsPerBuf     = START_NELTS;
    m_bufferSizeBytes = m_nEltsPerBuf * TerbitDataTypeSize(TERBIT_DOUBLE);
+   m_notifyPending   = false;
+   m_ring.Init(m_ringSlots);
 }
 
 
@@ -200,6 +245,13 @@ bool FileDevice::Shutdown(void)
 {
    bool term = terminate();
 
+   for(size_t ch = m_chBufs.size(); ch > 0; --ch)
+   {
+      RemoveOutput(ChannelData + ch - 1);
+      GetWorkspace()->DeleteInstance(m_chBufs[ch - 1]->GetAutoId());
+   }
+   m_chBufs.clear();
+
    if(m_buf)
    {
       RemoveOutput(FileData);
@@ -227,6 +279,7 @@ bool FileDevice::initSource()
       m_buf->CreateBuffer(m_dataType, 0, m_nEltsPerBuf);
       m_buf->SetDisplayViewTypeName(TERBIT_TYPE_XYPLOT);
       AddOutput(FileData, m_buf);
+      updateChannelOutputs();
 
       m_bufStatus = FDSOk;
       retVal = true;
@@ -359,6 +412,31 @@ void FileDevice::SetLoop(bool loop)
    }
 }
 
+void FileDevice::SetMapped(bool mapped)
+{
+   m_mapped = mapped;
+   emit ConfigUpdated();
+}
+
+// staged until the next UpdateSrc()
+void FileDevice::SetRingSlots(uint32_t n)
+{
+   if(n > 0)
+   {
+      m_ringSlots = n;
+      emit ConfigUpdated();
+   }
+}
+
+void FileDevice::SetPacingPolicy(Pacer::Policy_t p)
+{
+   if(p == Pacer::PacerCatchUp || p == Pacer::PacerSkip)
+   {
+      m_pacer.SetPolicy(p);
+      emit ConfigUpdated();
+   }
+}
+
 void FileDevice::SetFreq(double f)
 {
    if(f>0)
@@ -369,15 +447,89 @@ void FileDevice::SetFreq(double f)
 }
 
 
+void FileDevice::SetSampleRate(double hz)
+{
+   if(hz >= 0)
+   {
+      m_sampleRateHz = hz;
+      updateSampleProperties();
+      emit ConfigUpdated();
+   }
+}
+
+double FileDevice::GetSampleRate(void)
+{
+   if(m_sampleRateHz > 0)
+   {
+      return m_sampleRateHz;
+   }
+   else
+   {
+      return m_freqHz * m_nEltsPerBuf / m_nCh;
+   }
+}
+
+uint64_t FileDevice::GetSamplePos(void)
+{
+   return SampleFormatElts(m_dataType, m_packedBits, GetFilePos()) / m_nCh;
+}
+
 void FileDevice::SetNumCh(size_t n)
 {
    if(n > 0)
    {
       m_nCh = n;
+      if(m_buf)
+      {
+         updateChannelOutputs();
+      }
       emit ConfigUpdated();
    }
 }
 
+// Add or remove per-channel outputs to match m_nCh.  A single channel file
+// only has the FileData output.
+void FileDevice::updateChannelOutputs(void)
+{
+   size_t nCh = (m_nCh > 1) ? m_nCh : 0;
+
+   while(m_chBufs.size() > nCh)
+   {
+      RemoveOutput(ChannelData + m_chBufs.size() - 1);
+      GetWorkspace()->DeleteInstance(m_chBufs.back()->GetAutoId());
+      m_chBufs.pop_back();
+   }
+
+   while(m_chBufs.size() < nCh)
+   {
+      DataSet* ds = GetWorkspace()->CreateDataSet(this);
+      if(NULL == ds)
+      {
+         LogError2(GetType()->GetLogCategory(), GetName(), tr("Unable to create the channel data set."));
+         break;
+      }
+      ds->SetName(QString("%1 Ch%2").arg(GetName()).arg(m_chBufs.size() + 1));
+      ds->SetDisplayViewTypeName(TERBIT_TYPE_XYPLOT);
+      AddOutput(ChannelData + m_chBufs.size(), ds);
+      m_chBufs.push_back(ds);
+   }
+
+   pointChannels(m_buf->GetBufferAddress(), m_buf->GetDataType(), m_buf->GetCount());
+   updateSampleProperties();
+}
+
+// Point each channel data set at its first sample in an interleaved buffer,
+// stride is one full frame of all channels.
+void FileDevice::pointChannels(void* pData, TerbitDataType type, size_t nElts)
+{
+   size_t eltBytes = TerbitDataTypeSize(type);
+   size_t nCh = m_chBufs.size();
+   for(size_t ch = 0; ch < nCh; ++ch)
+   {
+      m_chBufs[ch]->SetBuffer(type, 0, nElts / nCh, (char*)pData + ch * eltBytes, eltBytes * nCh);
+   }
+}
+
 void FileDevice::SetDataType(TerbitDataType t)
 {
    if(t >= TERBIT_INT8 && t <= TERBIT_DOUBLE)
@@ -387,6 +539,89 @@ void FileDevice::SetDataType(TerbitDataType t)
    }
 }
 
+// A packed width needs a 16 or 32 bit data type, keep the signedness of
+// the current one.
+bool FileDevice::SetSampleFormat(uint32_t packedBits, bool bigEndian)
+{
+   TerbitDataType t = m_dataType;
+   bool isUnsigned = (TERBIT_UINT8 == t || TERBIT_UINT16 == t || TERBIT_UINT32 == t || TERBIT_UINT64 == t);
+
+   if(12 == packedBits || 14 == packedBits)
+   {
+      t = isUnsigned ? TERBIT_UINT16 : TERBIT_INT16;
+   }
+   else if(24 == packedBits)
+   {
+      t = isUnsigned ? TERBIT_UINT32 : TERBIT_INT32;
+   }
+
+   if(!SampleFormatSupported(t, packedBits, bigEndian))
+   {
+      return false;
+   }
+   m_packedBits = packedBits;
+   m_bigEndian  = bigEndian;
+   m_dataType   = t;
+   updateSampleProperties();
+   emit ConfigUpdated();
+   return true;
+}
+
+void FileDevice::SetSamplingBits(uint32_t bits)
+{
+   m_samplingBits = bits;
+   updateSampleProperties();
+   emit ConfigUpdated();
+}
+
+// Packed and swapped samples come from an ADC of that width, native ones
+// are only known when set
+uint32_t FileDevice::GetSamplingBits(void)
+{
+   if(m_samplingBits > 0)
+   {
+      return m_samplingBits;
+   }
+   else if(m_packedBits > 0)
+   {
+      return m_packedBits;
+   }
+   else if(m_bigEndian && m_dataType <= TERBIT_UINT64)
+   {
+      return 8 * (uint32_t)TerbitDataTypeSize(m_dataType);
+   }
+   return 0;
+}
+
+// Sampling rate and ADC resolution for the processors downstream (e.g.
+// dBFS and ENOB in signal analysis).  The interleaved output only gets the
+// rate when it holds a single channel.
+void FileDevice::updateSampleProperties(void)
+{
+   uint32_t bits = GetSamplingBits();
+   std::vector<DataSet*> outputs(m_chBufs);
+
+   if(m_buf)
+   {
+      outputs.push_back(m_buf);
+   }
+   for(auto ds : outputs)
+   {
+      if(m_sampleRateHz > 0 && (ds != m_buf || m_chBufs.empty()))
+      {
+         ds->GetProperties()[TERBIT_DATA_PROPERTY_SAMPLING_RATE] = m_sampleRateHz;
+      }
+      if(bits > 0)
+      {
+         ds->GetProperties()[TERBIT_DATA_PROPERTY_SAMPLING_BITS] = bits;
+      }
+      else
+      {
+         ds->GetProperties().remove(TERBIT_DATA_PROPERTY_SAMPLING_BITS);
+      }
+   }
+}
+
 void FileDevice::SetNumElts(uint64_t n)
 {
    if(n > 0)
@@ -457,6 +692,14 @@ FileDvcDPStatus_t FileDevice::GetStatus(void)
 }
 
 bool FileDevice::UpdateFile(const QString& p)
+{
+   return UpdateFiles(QStringList(p));
+}
+
+// A single file goes through FileDvc (cached or mapped), or FileDvcChunked
+// for a capture file.  A list of files is played back to back as one stream
+// through FileDvcReadAhead.
+bool FileDevice::UpdateFiles(const QStringList& files)
 {
    bool retVal = true;
 
@@ -473,28 +716,27 @@ bool FileDevice::UpdateFile(const QString& p)
    {
       if(m_pFile)
       {
+         releaseMappedBuffer();
+         // published slots may point into the old file mapping
+         m_ring.Reset();
          delete m_pFile;
          m_pFile = NULL;
       }
 
       // Try to create new file and buffer based on params
-      m_pFile = new(std::nothrow) FileDvc();
-      if(m_pFile->Open(p, m_loop) && m_pFile->IsValid())
+      m_pFile = openFiles(files);
+      if(NULL != m_pFile)
       {
-         QFileInfo fi(p);
+         QFileInfo fi(files.first());
          QString str("Terbit.FileDvc.");
          str.append(fi.fileName());
          // TODO: m_svcs->SetDataSetName(m_srcId, str);
-         m_filePathName = p;
+         m_filePathName = files.first();
+         m_filePathNames = files;
          m_fileStatus = FDSOk;
       }
       else
       {
-         if(NULL != m_pFile)
-         {
-            delete m_pFile;
-            m_pFile = NULL;
-         }
          retVal = false;
          m_fileStatus = FDSErrFile;
       }
@@ -508,6 +750,79 @@ bool FileDevice::UpdateFile(const QString& p)
    return retVal;
 }
 
+IFileDvc* FileDevice::openFiles(const QStringList& files)
+{
+   IFileDvc* retVal = NULL;
+
+   if(1 == files.size() && IsCaptureFile(files.first()))
+   {
+      FileDvcChunked* pFile = new(std::nothrow) FileDvcChunked();
+      if(NULL != pFile && pFile->Open(files.first(), m_loop) && pFile->IsValid())
+      {
+         applyCaptureHeader(pFile->GetHeader());
+         retVal = pFile;
+      }
+      else
+      {
+         delete pFile;
+      }
+   }
+   else if(1 == files.size())
+   {
+      FileDvc* pFile = new(std::nothrow) FileDvc();
+      if(NULL != pFile && pFile->Open(files.first(), m_loop, m_mapped) && pFile->IsValid())
+      {
+         retVal = pFile;
+      }
+      else
+      {
+         delete pFile;
+      }
+   }
+   else if(files.size() > 1)
+   {
+      FileDvcReadAhead* pFile = new(std::nothrow) FileDvcReadAhead();
+      if(NULL != pFile && pFile->Open(files, m_loop) && pFile->IsValid())
+      {
+         retVal = pFile;
+      }
+      else
+      {
+         delete pFile;
+      }
+   }
+   return retVal;
+}
+
+// A capture file describes its own data, adopt the type and sampling rate.
+// Called while the processing thread waits for the file update, so the
+// buffer can be rebuilt the same way UpdateSrc() does.
+void FileDevice::applyCaptureHeader(const CaptureHeader_t& header)
+{
+   TerbitDataType t = (TerbitDataType)header.dataType;
+
+   if(header.samplingRate > 0)
+   {
+      m_sampleRateHz = header.samplingRate;
+   }
+   if(header.samplingBits > 0)
+   {
+      m_samplingBits = header.samplingBits;
+   }
+   // samples are stored native
+   m_packedBits = 0;
+   m_bigEndian  = false;
+
+   if(t >= TERBIT_INT8 && t <= TERBIT_DOUBLE && TerbitDataTypeSize(t) == header.eltBytes && t != m_dataType)
+   {
+      m_dataType = t;
+      m_buf->CreateBuffer(m_dataType, 0, m_nEltsPerBuf);
+      pointChannels(m_buf->GetBufferAddress(), m_dataType, m_nEltsPerBuf);
+      m_ring.Init(m_ringSlots);
+   }
+   updateSampleProperties();
+}
+
 // Sets a variable to tell processing thread that we want to skip a
 // certain number of bytes before the next read.  This function is
 // not thread safe, because the member variable can be accessed asynch.
@@ -518,6 +833,86 @@ void FileDevice::SkipBytes(size_t n)
    m_skipBytes = n;
 }
 
+// Call from the GUI thread.  Pauses the processing thread the same way a
+// file update does, moves the file position and refills the outputs.
+// Returns false for a sample past the end of the data.
+bool FileDevice::SeekToSample(uint64_t index)
+{
+   bool retVal = false;
+   int32_t timeout = 100;
+
+   if(NULL == m_pFile || FDSOk != m_fileStatus)
+   {
+      return false;
+   }
+
+   m_updateFile = true;
+   while(timeout > 0 && m_procWaiting == false)
+   {
+      timeout--;
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+   }
+
+   if(m_procWaiting)
+   {
+      // packed groups may hold several samples, start on a group that
+      // begins with channel 0
+      while(0 != (index * m_nCh) % SampleFormatGroupElts(m_packedBits))
+      {
+         --index;
+      }
+      uint64_t pos = SampleFormatBytes(m_dataType, m_packedBits, index * m_nCh);
+      if(pos < m_pFile->GetFileBytes())
+      {
+         m_skipBytes = 0;
+         m_pFile->Seek(pos);
+         refillOutput();
+         retVal = true;
+      }
+   }
+
+   emit ConfigUpdated();
+   m_updateFile = false;
+   return retVal;
+}
+
+bool FileDevice::SeekToTime(double seconds)
+{
+   bool retVal = false;
+   double rate = GetSampleRate();
+   if(seconds >= 0 && rate > 0)
+   {
+      retVal = SeekToSample((uint64_t)(seconds * rate));
+   }
+   return retVal;
+}
+
+// Read one buffer at the current position into the ring and hand it to the
+// outputs without waiting for the processing thread.  Only call while the
+// processing thread is waiting in pauseForUpdate().
+void FileDevice::refillOutput(void)
+{
+   size_t xfrBytes = m_nEltsPerBuf * TerbitDataTypeSize(m_dataType);
+   DataRing::Slot_t* slot = m_ring.AcquireWrite(xfrBytes);
+
+   if(NULL != slot && NULL != m_buf)
+   {
+      size_t tmp = readSlot(slot, xfrBytes);
+
+      if(tmp)
+      {
+         if(tmp < xfrBytes)
+         {
+            memset(slot->pStorage + tmp, 0, xfrBytes - tmp);
+         }
+         slot->dataType = m_dataType;
+         slot->nElts    = m_nEltsPerBuf;
+         m_ring.Publish(slot);
+         OnRingData();
+      }
+   }
+}
+
 // helper function to update source when only nElts changed
 bool FileDevice::UpdateSrc(size_t nElts)
 {
@@ -536,6 +931,15 @@ bool FileDevice::UpdateSrc(size_t nElts, TerbitDataType type)
 {
    bool retVal = true;
    int32_t timeout = 100;
+   uint32_t group = SampleFormatGroupElts(m_packedBits);
+
+   if(!SampleFormatSupported(type, m_packedBits, m_bigEndian))
+   {
+      LogError2(GetType()->GetLogCategory(), GetName(), tr("The data type can't hold %1 bit packed samples.").arg(m_packedBits));
+      return false;
+   }
+   // a buffer holds whole packed groups
+   nElts = (nElts + group - 1) / group * group;
 
    // Sync with processing thread
    m_updateSrc = true;
@@ -555,6 +959,10 @@ bool FileDevice::UpdateSrc(size_t nElts, TerbitDataType type)
          m_dataType    =  type;
          m_bufStatus   = FDSOk;         
          m_buf->CreateBuffer(m_dataType, 0, m_nEltsPerBuf);
+         pointChannels(m_buf->GetBufferAddress(), m_dataType, m_nEltsPerBuf);
+         // output data sets no longer reference the ring, safe to rebuild
+         m_ring.Init(m_ringSlots);
+         updateSampleProperties();
       }
       else
       {
@@ -581,6 +989,7 @@ void FileDevice::processLoop(void)
    FileDvcDPCmd_t lastCmd = FDCUnknown;
    size_t xfrBytes = 0;
    uint32_t noActSleepMs = 50;
+   boost::chrono::steady_clock::time_point lastConfigUpdate;
    //processParams_t locParms;
 
    m_threadActive = true;
@@ -595,6 +1004,10 @@ void FileDevice::processLoop(void)
 
          if(FDSOk == m_fileStatus && FDSOk == m_bufStatus)
          {
+            if(FDCRun != lastCmd)
+            {
+               m_pacer.Start(m_freqHz);
+            }
             m_mode = FDMRunning;
             if(m_skipBytes)
             {
@@ -606,7 +1019,16 @@ void FileDevice::processLoop(void)
                delete[] tmpBuf;
                m_skipBytes = 0;
             }
-            size_t tmp = m_pFile->Read(m_buf->GetBufferAddress(), 1, xfrBytes, NULL);
+            DataRing::Slot_t* slot = m_ring.AcquireWrite(xfrBytes);
+            if(NULL == slot)
+            {
+               m_bufStatus  = FDSErrAlloc;
+               m_cmd        = FDCStop;
+               m_singleShot = false;
+               break;
+            }
+
+            size_t tmp = readSlot(slot, xfrBytes);
             if(xfrBytes != tmp)
             {
                // did we expect to get less?
@@ -618,7 +1040,7 @@ void FileDevice::processLoop(void)
                   // If no data was transferred, leave final buffer alone
                   if(tmp)
                   {
-                     memset((char*)(m_buf->GetBufferAddress()) + tmp, 0, xfrBytes - tmp);
+                     memset(slot->pStorage + tmp, 0, xfrBytes - tmp);
                   }
                   m_cmd = FDCStop;
                   m_singleShot = false;
@@ -637,8 +1059,13 @@ void FileDevice::processLoop(void)
                m_singleShot = false;
             }
             // Send data to be graphed.
-            m_buf->SetHasData(true);
-            emit m_buf->NewData(m_buf);
+            if(tmp)
+            {
+               slot->dataType = m_dataType;
+               slot->nElts    = m_nEltsPerBuf;
+               m_ring.Publish(slot);
+               notifyNewData();
+            }
             if(m_singleShot)
             {
                m_singleShot = false;
@@ -649,7 +1076,11 @@ void FileDevice::processLoop(void)
                freqSleep(m_freqHz);
             }
 
-            emit ConfigUpdated();
+            if(FDCRun != m_cmd || boost::chrono::steady_clock::now() - lastConfigUpdate >= boost::chrono::milliseconds(CONFIG_UPDATE_MS))
+            {
+               lastConfigUpdate = boost::chrono::steady_clock::now();
+               emit ConfigUpdated();
+            }
          }
          lastCmd = FDCRun;
          break;
@@ -703,26 +1134,116 @@ void FileDevice::processLoop(void)
 }
 
 
-// this helper function is called while running to sleep the amount
-// required to generate the update frequency.  For long sleeps, this
-// function will also return early if a stop or pause command is recieved.
-// Also returns early if frequency is changed
-void FileDevice::freqSleep(double hz)
+// Zero-copy read for mapped files.  The slot is pointed straight into the
+// file mapping when a full buffer is contiguous in the file.  The last
+// partial buffer and loop wrap-around are copied into the slot instead.
+size_t FileDevice::readMapped(DataRing::Slot_t* slot, size_t xfrBytes)
 {
-   double dtemp = hz;
-   int32_t i = 1;
+   size_t retVal = xfrBytes;
+   const void* pData = m_pFile->ReadMapped(xfrBytes);
 
-   if(hz < MIN_FREQ_SLEEP_HZ)
+   if(NULL != pData)
+   {
+      slot->pData = pData;
+   }
+   else
+   {
+      retVal = m_pFile->Read(slot->pStorage, 1, xfrBytes, NULL);
+   }
+   return retVal;
+}
+
+// Reads the next buffer of xfrBytes (in elements of the data type) into the
+// slot.  Packed samples go through a staging buffer, byte swapped ones are
+// swapped in the slot.  Returns the bytes of whole elements filled.
+size_t FileDevice::readSlot(DataRing::Slot_t* slot, size_t xfrBytes)
+{
+   size_t retVal;
+   size_t eltBytes = TerbitDataTypeSize(m_dataType);
+
+   if(0 != m_packedBits)
+   {
+      uint64_t nElts = xfrBytes / eltBytes;
+      m_packed.resize(SampleFormatBytes(m_dataType, m_packedBits, nElts));
+      size_t tmp = m_pFile->Read(&m_packed[0], 1, m_packed.size(), NULL);
+      nElts = std::min(nElts, SampleFormatElts(m_dataType, m_packedBits, tmp));
+      SampleUnpack(&m_packed[0], slot->pStorage, nElts, m_dataType, m_packedBits, m_bigEndian);
+      retVal = nElts * eltBytes;
+   }
+   else if(m_pFile->IsMapped() && !m_bigEndian)
+   {
+      retVal = readMapped(slot, xfrBytes);
+   }
+   else
+   {
+      retVal = m_pFile->Read(slot->pStorage, 1, xfrBytes, NULL);
+      if(m_bigEndian)
+      {
+         SampleUnpack(slot->pStorage, slot->pStorage, retVal / eltBytes, m_dataType, 0, true);
+      }
+   }
+   return retVal;
+}
+
+// Called from the processing thread after publishing a slot.  Only one
+// OnRingData() is queued at a time, it always picks up the newest slot.
+void FileDevice::notifyNewData(void)
+{
+   if(!m_notifyPending.exchange(true))
+   {
+      QMetaObject::invokeMethod(this, "OnRingData", Qt::QueuedConnection);
+   }
+}
+
+// GUI thread: point the output data set at the newest slot and notify
+void FileDevice::OnRingData()
+{
+   m_notifyPending = false;
+
+   const DataRing::Slot_t* slot = m_ring.AcquireRead();
+   if(NULL != slot && NULL != m_buf)
+   {
+      m_buf->SetBuffer(slot->dataType, 0, slot->nElts, const_cast<void*>(slot->pData), TerbitDataTypeSize(slot->dataType));
+      pointChannels(const_cast<void*>(slot->pData), slot->dataType, slot->nElts);
+      m_buf->SetHasData(true);
+      emit m_buf->NewData(m_buf);
+      for(auto ds : m_chBufs)
+      {
+         ds->SetHasData(true);
+         emit ds->NewData(ds);
+      }
+   }
+}
+
+// The output data set may point into the file mapping.  Copy the last buffer
+// into a managed buffer before the mapping goes away so consumers holding
+// the data set never see unmapped memory.
+void FileDevice::releaseMappedBuffer(void)
+{
+   if(m_buf && m_pFile && m_pFile->IsMapped())
    {
-      i = MIN_FREQ_SLEEP_HZ/hz;
-      // Set sleep freq near MinFreqSleep.  Account for rounding error.
-      dtemp = hz * i;
+      void* pOld = m_buf->GetBufferAddress();
+      size_t nBytes = m_buf->GetCount() * TerbitDataTypeSize(m_buf->GetDataType());
+
+      m_buf->CreateBuffer(m_buf->GetDataType(), m_buf->GetFirstIndex(), m_buf->GetCount());
+      if(NULL != pOld && pOld != m_buf->GetBufferAddress())
+      {
+         memcpy(m_buf->GetBufferAddress(), pOld, nBytes);
+      }
+      pointChannels(m_buf->GetBufferAddress(), m_buf->GetDataType(), m_buf->GetCount());
    }
+}
 
-   while(FDCRun == m_cmd && i > 0 && hz == m_freqHz)
+// this helper function is called while running to wait for the next
+// buffer deadline.  Long waits are broken into steps so this function
+// returns early if a stop or pause command is recieved.
+// Also returns early if frequency is changed
+void FileDevice::freqSleep(double hz)
+{
+   m_pacer.SetRate(hz);
+   while(FDCRun == m_cmd && hz == m_freqHz && !m_pacer.WaitStep(MAX_PACER_WAIT_MS))
    {
-      boost::this_thread::sleep(boost::posix_time::milliseconds((long)(1000/dtemp)));
-      --i;
+      ;
    }
 }
 
@@ -840,9 +1361,41 @@ ScriptDocumentation *BuildScriptDocumentationFileDevice()
 
    d->AddScriptlet(new Scriptlet(QObject::tr("SetFilePathName"), "SetFilePathName(fileName);",QObject::tr("The fully pathed file name.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("GetFilePathName"), "GetFilePathName();",QObject::tr("Returns the fully pathed file name.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetFilePathNames"), "SetFilePathNames([fileName1, fileName2]);",QObject::tr("Set a list of fully pathed file names that are played back to back as one continuous source.  Only allowed while stopped.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetFilePathNames"), "GetFilePathNames();",QObject::tr("Returns the list of fully pathed file names.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("SetFreq"), "SetFreq(freq);",QObject::tr("Set the frequency.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("SetLoop"), "SetLoop(loop);",QObject::tr("Set boolean option to loop back to the beginning of the file.  When set to false, the device stops playing when the end of file is reached.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetMapped"), "SetMapped(mapped);",QObject::tr("Set boolean option to memory-map the file.  Buffers are then passed on without copying.  Takes effect the next time the file is set.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetMapped"), "GetMapped();",QObject::tr("Returns boolean if the file is memory-mapped.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetRingSlots"), "SetRingSlots(n);",QObject::tr("Set the number of buffers (minimum 3) handed between the file reader and the displays.  Only allowed while stopped.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetRingSlots"), "GetRingSlots();",QObject::tr("Returns the number of buffers handed between the file reader and the displays.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetDeliveredCount"), "GetDeliveredCount();",QObject::tr("Returns the number of buffers delivered to the displays.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetDroppedCount"), "GetDroppedCount();",QObject::tr("Returns the number of buffers read from the file but skipped because the displays could not keep up.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetOverrunCount"), "GetOverrunCount();",QObject::tr("Returns the number of times the displays fell behind and buffers were skipped.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("ResetRingCounters"), "ResetRingCounters();",QObject::tr("Resets the delivered, dropped and overrun counters.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetPacingPolicy"), "SetPacingPolicy(policy);",QObject::tr("Set what happens when a buffer deadline is missed.  0 - catch up by sending the missed buffers back to back, 1 - skip the missed deadlines.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetPacingPolicy"), "GetPacingPolicy();",QObject::tr("Returns the pacing policy (0 catch up, 1 skip).")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetAchievedRate"), "GetAchievedRate();",QObject::tr("Returns the achieved buffer rate in Hz since the last start.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetAchievedSampleRate"), "GetAchievedSampleRate();",QObject::tr("Returns the achieved rate in elements per second since the last start.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetJitterMeanUs"), "GetJitterMeanUs();",QObject::tr("Returns the mean lateness of buffer deadlines in microseconds.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetJitterMaxUs"), "GetJitterMaxUs();",QObject::tr("Returns the maximum lateness of buffer deadlines in microseconds.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetLateCount"), "GetLateCount();",QObject::tr("Returns the number of times a full buffer period was missed.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetSkippedCount"), "GetSkippedCount();",QObject::tr("Returns the number of buffer deadlines skipped.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("ResetPacingStats"), "ResetPacingStats();",QObject::tr("Resets the achieved rate and jitter statistics.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SeekToSample"), "SeekToSample(index);",QObject::tr("Jumps to a sample (one element of every channel) without reading the data before it and refreshes the output data sets.  Works across a list of files.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SeekToTime"), "SeekToTime(seconds);",QObject::tr("Jumps to a time in the recording using the sample rate and refreshes the output data sets.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetSamplePos"), "GetSamplePos();",QObject::tr("Returns the sample the next buffer starts at.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetSampleRate"), "SetSampleRate(hz);",QObject::tr("Sets the sample rate of the recording (per channel) used by SeekToTime.  0 uses the playback rate.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetSampleRate"), "GetSampleRate();",QObject::tr("Returns the sample rate used by SeekToTime.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("SetDataType"), "SetDataType(dataType);",QObject::tr("Sets the data type (enum) to use for the binary file data.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetSampleFormat"), "SetSampleFormat(packedBits, bigEndian);",QObject::tr("Sets how samples are stored in the file.  packedBits 0 for samples of the data type, or 12, 14 or 24 for packed samples that are unpacked into a 16 or 32 bit data type.  bigEndian swaps the byte order (for packed samples, the bits are filled from the most significant end).  Only allowed while stopped.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetPackedBits"), "GetPackedBits();",QObject::tr("Returns the packed sample width in bits, 0 when samples are not packed.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetBigEndian"), "GetBigEndian();",QObject::tr("Returns boolean if samples are big-endian.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetSamplingBits"), "SetSamplingBits(bits);",QObject::tr("Sets the ADC resolution in bits published with the output data sets (used for dBFS and ENOB).  0 uses the packed width, or the data type width for big-endian samples.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetSamplingBits"), "GetSamplingBits();",QObject::tr("Returns the ADC resolution in bits published with the output data sets, 0 when unknown.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetNumCh"), "SetNumCh(n);",QObject::tr("Set the number of interleaved channels in the file.  With more than one channel there is an output data set per channel that views the channel samples without copying.  Only allowed while stopped.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetNumCh"), "GetNumCh();",QObject::tr("Returns the number of interleaved channels in the file.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetChannelDataSet"), "GetChannelDataSet(ch);",QObject::tr("Returns the data set for a channel.  The channel is 0-based.  Only available with more than one channel.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("SetNumElts"), "SetNumElts(value);",QObject::tr("The number of elements to read at a time.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("Start"), "Start();",QObject::tr("Starts reading file data.  Returns boolean.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("Pause"), "Pause();",QObject::tr("Pauses reading file data.  Returns boolean.")));
@@ -859,11 +1412,42 @@ QObject *FileDevice::CreateScriptWrapper(QJSEngine *se)
 
 void FileDevice::BuildRestoreScript(ScriptBuilder &script, const QString& variableName)
 {
-   script.add(QString("%1.SetFilePathName(%2);\n").arg(variableName).arg(ScriptEncode(GetFilePathName())));
+   script.add(QString("%1.SetMapped(%2);\n").arg(variableName).arg(GetMapped()));
+   if(GetFilePathNames().size() > 1)
+   {
+      QStringList files;
+      for(auto& f : GetFilePathNames())
+      {
+         files.append(ScriptEncode(f));
+      }
+      script.add(QString("%1.SetFilePathNames([%2]);\n").arg(variableName).arg(files.join(", ")));
+   }
+   else
+   {
+      script.add(QString("%1.SetFilePathName(%2);\n").arg(variableName).arg(ScriptEncode(GetFilePathName())));
+   }
    script.add(QString("%1.SetFreq(%2);\n").arg(variableName).arg(GetFreq()));
    script.add(QString("%1.SetLoop(%2);\n").arg(variableName).arg(GetLoop()));
+   script.add(QString("%1.SetPacingPolicy(%2);\n").arg(variableName).arg(GetPacingPolicy()));
    script.add(QString("%1.SetDataType(%2);\n").arg(variableName).arg(GetDataType()));
+   if(GetPackedBits() > 0 || GetBigEndian())
+   {
+      script.add(QString("%1.SetSampleFormat(%2, %3);\n").arg(variableName).arg(GetPackedBits()).arg(GetBigEndian()));
+   }
+   if(m_samplingBits > 0)
+   {
+      script.add(QString("%1.SetSamplingBits(%2);\n").arg(variableName).arg(m_samplingBits));
+   }
    script.add(QString("%1.SetNumElts(%2);\n").arg(variableName).arg(GetNumElts()));
+   if(GetNumCh() > 1)
+   {
+      script.add(QString("%1.SetNumCh(%2);\n").arg(variableName).arg(GetNumCh()));
+   }
+   script.add(QString("%1.SetRingSlots(%2);\n").arg(variableName).arg(GetRingSlots()));
+   if(m_sampleRateHz > 0)
+   {
+      script.add(QString("%1.SetSampleRate(%2);\n").arg(variableName).arg(m_sampleRateHz));
+   }
    if(m_view)
    {
       script.add(QString("%1.ShowPropertiesWindow();").arg(variableName));
@@ -883,11 +1467,194 @@ void FileDeviceSW::SetLoop(bool loop)
    m_fileDvc->SetLoop(loop);
 }
 
+void FileDeviceSW::SetMapped(bool mapped)
+{
+   m_fileDvc->SetMapped(mapped);
+}
+
+bool FileDeviceSW::GetMapped()
+{
+   return m_fileDvc->GetMapped();
+}
+
 bool FileDeviceSW::SetDataType(int t)
 {
    return m_fileDvc->UpdateSrc((TerbitDataType)t);
 }
 
+bool FileDeviceSW::SetRingSlots(int n)
+{
+   if(n > 0 && (m_fileDvc->GetMode() == FDMInitialized || m_fileDvc->GetMode() == FDMStopped))
+   {
+      m_fileDvc->SetRingSlots(n);
+      return m_fileDvc->UpdateSrc(m_fileDvc->GetNumElts());
+   }
+   else
+   {
+      return false;
+   }
+}
+
+bool FileDeviceSW::SetNumCh(int n)
+{
+   if(n > 0 && (m_fileDvc->GetMode() == FDMInitialized || m_fileDvc->GetMode() == FDMStopped))
+   {
+      m_fileDvc->SetNumCh(n);
+      return true;
+   }
+   else
+   {
+      return false;
+   }
+}
+
+int FileDeviceSW::GetNumCh()
+{
+   return (int)m_fileDvc->GetNumCh();
+}
+
+QJSValue FileDeviceSW::GetChannelDataSet(int ch)
+{
+   QJSValue res;
+   DataSet* ds = (ch >= 0) ? m_fileDvc->GetChannelDataSet(ch) : NULL;
+   if(ds)
+   {
+      res = m_scriptEngine->newQObject(ds->CreateScriptWrapper(m_scriptEngine));
+   }
+   return res;
+}
+
+bool FileDeviceSW::SeekToSample(double index)
+{
+   return index >= 0 && m_fileDvc->SeekToSample((uint64_t)index);
+}
+
+bool FileDeviceSW::SeekToTime(double seconds)
+{
+   return m_fileDvc->SeekToTime(seconds);
+}
+
+double FileDeviceSW::GetSamplePos()
+{
+   return (double)m_fileDvc->GetSamplePos();
+}
+
+void FileDeviceSW::SetSampleRate(double hz)
+{
+   m_fileDvc->SetSampleRate(hz);
+}
+
+double FileDeviceSW::GetSampleRate()
+{
+   return m_fileDvc->GetSampleRate();
+}
+
+bool FileDeviceSW::SetSampleFormat(int packedBits, bool bigEndian)
+{
+   if(packedBits >= 0 && (m_fileDvc->GetMode() == FDMInitialized || m_fileDvc->GetMode() == FDMStopped) &&
+      m_fileDvc->SetSampleFormat(packedBits, bigEndian))
+   {
+      return m_fileDvc->UpdateSrc(m_fileDvc->GetNumElts(), m_fileDvc->GetDataType());
+   }
+   else
+   {
+      return false;
+   }
+}
+
+int FileDeviceSW::GetPackedBits()
+{
+   return (int)m_fileDvc->GetPackedBits();
+}
+
+bool FileDeviceSW::GetBigEndian()
+{
+   return m_fileDvc->GetBigEndian();
+}
+
+void FileDeviceSW::SetSamplingBits(int bits)
+{
+   if(bits >= 0)
+   {
+      m_fileDvc->SetSamplingBits(bits);
+   }
+}
+
+int FileDeviceSW::GetSamplingBits()
+{
+   return (int)m_fileDvc->GetSamplingBits();
+}
+
+int FileDeviceSW::GetRingSlots()
+{
+   return m_fileDvc->GetRingSlots();
+}
+
+double FileDeviceSW::GetDeliveredCount()
+{
+   return m_fileDvc->GetRing().GetDeliveredCount();
+}
+
+double FileDeviceSW::GetDroppedCount()
+{
+   return m_fileDvc->GetRing().GetDroppedCount();
+}
+
+double FileDeviceSW::GetOverrunCount()
+{
+   return m_fileDvc->GetRing().GetOverrunCount();
+}
+
+void FileDeviceSW::ResetRingCounters()
+{
+   m_fileDvc->GetRing().ResetCounters();
+}
+
+void FileDeviceSW::SetPacingPolicy(int p)
+{
+   m_fileDvc->SetPacingPolicy((Pacer::Policy_t)p);
+}
+
+int FileDeviceSW::GetPacingPolicy()
+{
+   return m_fileDvc->GetPacingPolicy();
+}
+
+double FileDeviceSW::GetAchievedRate()
+{
+   return m_fileDvc->GetPacer().GetAchievedRate();
+}
+
+double FileDeviceSW::GetAchievedSampleRate()
+{
+   return m_fileDvc->GetPacer().GetAchievedRate() * m_fileDvc->GetNumElts();
+}
+
+double FileDeviceSW::GetJitterMeanUs()
+{
+   return m_fileDvc->GetPacer().GetJitterMeanUs();
+}
+
+double FileDeviceSW::GetJitterMaxUs()
+{
+   return m_fileDvc->GetPacer().GetJitterMaxUs();
+}
+
+double FileDeviceSW::GetLateCount()
+{
+   return m_fileDvc->GetPacer().GetLateCount();
+}
+
+double FileDeviceSW::GetSkippedCount()
+{
+   return m_fileDvc->GetPacer().GetSkippedCount();
+}
+
+void FileDeviceSW::ResetPacingStats()
+{
+   m_fileDvc->GetPacer().ResetStats();
+}
+
 bool FileDeviceSW::SetFilePathName(const QString &p)
 {
    if(m_fileDvc->GetMode() == FDMInitialized || m_fileDvc->GetMode() == FDMStopped)
@@ -905,6 +1672,23 @@ QString FileDeviceSW::GetFilePathName()
    return m_fileDvc->GetFilePathName();
 }
 
+bool FileDeviceSW::SetFilePathNames(const QStringList& files)
+{
+   if(!files.isEmpty() && (m_fileDvc->GetMode() == FDMInitialized || m_fileDvc->GetMode() == FDMStopped))
+   {
+      return m_fileDvc->UpdateFiles(files);
+   }
+   else
+   {
+      return false;
+   }
+}
+
+QStringList FileDeviceSW::GetFilePathNames()
+{
+   return m_fileDvc->GetFilePathNames();
+}
+
 #ifdef TERBIT_32BIT
 bool FileDeviceSW::SetNumElts(quint32 n)
 #else
@@ -23,7 +23,14 @@ limitations under the License.
 #include "connector-core/DataSource.h"
 #include "tools/Tools.h"
 #include "tools/device/filedvc/filedvc.h"
+#include "tools/device/filedvc/FileDvcReadAhead.h"
+#include "tools/device/filedvc/FileDvcChunked.h"
+#include "tools/device/filedvc/SampleUnpack.h"
+#include "DataRing.h"
+#include "Pacer.h"
 #include <string>
+#include <vector>
+#include <atomic>
 
 namespace terbit
 {
@@ -73,7 +80,8 @@ public:
    FileDevice();
    ~FileDevice();
 
-   typedef enum {FileData}FileDvcData_t;
+   // channel n (0-based) is output ChannelData + n
+   typedef enum {FileData, ChannelData}FileDvcData_t;
 
    // ----------- DataClass/Device Interface --------------
    bool Init();
@@ -103,17 +111,35 @@ public:
    void SetDataType(TerbitDataType t);
    //void SetFilePathName(const QString& p){m_filePathName = p;}
    void SetNumElts(uint64_t n);
+   void SetMapped(bool mapped);
+   void SetRingSlots(uint32_t n);
+   void SetPacingPolicy(Pacer::Policy_t p);
+   void SetSampleRate(double hz);
+   bool SetSampleFormat(uint32_t packedBits, bool bigEndian);
+   void SetSamplingBits(uint32_t bits);
 
    double GetFreq(void){return m_freqHz;}
    bool   GetLoop(void){return m_loop;}
+   bool   GetMapped(void){return m_mapped;}
+   uint32_t GetRingSlots(void){return m_ringSlots;}
+   DataRing& GetRing(void){return m_ring;}
+   Pacer::Policy_t GetPacingPolicy(void){return m_pacer.GetPolicy();}
+   Pacer& GetPacer(void){return m_pacer;}
    size_t GetNumCh(void){return m_nCh;}
    TerbitDataType   GetDataType(void){return m_dataType;}
    const QString&    GetFilePathName(void){return m_filePathName;}
+   const QStringList& GetFilePathNames(void){return m_filePathNames;}
+   DataSet*          GetChannelDataSet(size_t ch){return (ch < m_chBufs.size()) ? m_chBufs[ch] : NULL;}
    uint64_t          GetNumElts(void){return m_nEltsPerBuf;}
    FileDvcDPStatus_t GetStatus(void);
    FileDvcDPMode_t   GetMode(void) {return m_mode;}
    uint64_t          GetFileBytes(void);
    uint64_t          GetFilePos(void);
+   double            GetSampleRate(void);
+   uint64_t          GetSamplePos(void);
+   uint32_t          GetPackedBits(void){return m_packedBits;}
+   bool              GetBigEndian(void){return m_bigEndian;}
+   uint32_t          GetSamplingBits(void);
 
    // -------------------- Device control ------------------
    bool Start(void);
@@ -122,10 +148,13 @@ public:
    bool Single(void);
 
    bool UpdateFile(const QString& p);
+   bool UpdateFiles(const QStringList& files);
    bool UpdateSrc(size_t nElts, TerbitDataType type);
    bool UpdateSrc(size_t nElts);
    bool UpdateSrc(TerbitDataType type);
    void SkipBytes(size_t n);
+   bool SeekToSample(uint64_t index);
+   bool SeekToTime(double seconds);
 
    // ---------------- Test functions ----------------
    // DO NOT USE these in application code
@@ -137,6 +166,7 @@ signals:
 
 private slots:
    void OnPropertiesViewClosed();
+   void OnRingData();
 
 private:
    void processLoop(void);
@@ -145,14 +175,30 @@ private:
    bool terminate(void);
    void freqSleep(double hz);
    void pauseForUpdate();
+   size_t readMapped(DataRing::Slot_t* slot, size_t xfrBytes);
+   size_t readSlot(DataRing::Slot_t* slot, size_t xfrBytes);
+   void notifyNewData(void);
+   void releaseMappedBuffer(void);
+   IFileDvc* openFiles(const QStringList& files);
+   void applyCaptureHeader(const CaptureHeader_t& header);
+   void updateChannelOutputs(void);
+   void pointChannels(void* pData, TerbitDataType type, size_t nElts);
+   void refillOutput(void);
+   void updateSampleProperties(void);
 
    double   m_freqHz     = 10;
+   double   m_sampleRateHz = 0; // 0 - derive from playback rate
+   uint32_t m_packedBits = 0;   // 0 - byte aligned samples of m_dataType
+   bool     m_bigEndian  = false;
+   uint32_t m_samplingBits = 0; // ADC resolution, 0 - derive from the sample format
    bool     m_loop       = false;
+   bool     m_mapped     = false;
    bool     m_singleShot = false;
    size_t               m_nCh = 1;
    TerbitDataType      m_dataType = TERBIT_UINT8;
    QString              m_filePathName;
-   terbit::FileDvc*     m_pFile      = NULL;
+   QStringList          m_filePathNames;
+   terbit::IFileDvc*    m_pFile      = NULL;
    FileDvcDPStatus_t    m_fileStatus = FDSUnknown;
    FileDvcDPStatus_t    m_bufStatus  = FDSUnknown;
    FileDvcDPCmd_t       m_cmd        = FDCUnknown;
@@ -169,7 +215,14 @@ private:
    bool                 m_procWaiting = false;
    size_t               m_skipBytes   = 0;
    DataSet               *m_buf        = NULL;
+   std::vector<DataSet*> m_chBufs;     // per-channel strided views of m_buf
+   std::vector<char>    m_packed;      // file samples before unpacking
    FileDeviceView      *m_view       = NULL;
+   // proc-GUI data hand off
+   DataRing             m_ring;
+   uint32_t             m_ringSlots   = 4;
+   std::atomic<bool>    m_notifyPending;
+   Pacer                m_pacer;
 
 };
 
@@ -186,9 +239,41 @@ public:
 
    Q_INVOKABLE void SetFreq(double f);
    Q_INVOKABLE void SetLoop(bool loop);
+   Q_INVOKABLE void SetMapped(bool mapped);
+   Q_INVOKABLE bool GetMapped();
    Q_INVOKABLE bool SetDataType(int t);
+   Q_INVOKABLE bool SetNumCh(int n);
+   Q_INVOKABLE int GetNumCh();
+   Q_INVOKABLE QJSValue GetChannelDataSet(int ch);
+   Q_INVOKABLE bool SetRingSlots(int n);
+   Q_INVOKABLE int GetRingSlots();
+   Q_INVOKABLE double GetDeliveredCount();
+   Q_INVOKABLE double GetDroppedCount();
+   Q_INVOKABLE double GetOverrunCount();
+   Q_INVOKABLE void ResetRingCounters();
+   Q_INVOKABLE void SetPacingPolicy(int p);
+   Q_INVOKABLE int GetPacingPolicy();
+   Q_INVOKABLE double GetAchievedRate();
+   Q_INVOKABLE double GetAchievedSampleRate();
+   Q_INVOKABLE double GetJitterMeanUs();
+   Q_INVOKABLE double GetJitterMaxUs();
+   Q_INVOKABLE double GetLateCount();
+   Q_INVOKABLE double GetSkippedCount();
+   Q_INVOKABLE void ResetPacingStats();
    Q_INVOKABLE bool SetFilePathName(const QString& p);
    Q_INVOKABLE QString GetFilePathName();
+   Q_INVOKABLE bool SetFilePathNames(const QStringList& files);
+   Q_INVOKABLE QStringList GetFilePathNames();
+   Q_INVOKABLE bool SeekToSample(double index);
+   Q_INVOKABLE bool SeekToTime(double seconds);
+   Q_INVOKABLE double GetSamplePos();
+   Q_INVOKABLE void SetSampleRate(double hz);
+   Q_INVOKABLE double GetSampleRate();
+   Q_INVOKABLE bool SetSampleFormat(int packedBits, bool bigEndian);
+   Q_INVOKABLE int GetPackedBits();
+   Q_INVOKABLE bool GetBigEndian();
+   Q_INVOKABLE void SetSamplingBits(int bits);
+   Q_INVOKABLE int GetSamplingBits();
  #ifdef TERBIT_32BIT
    Q_INVOKABLE bool SetNumElts(quint32 n);
  #else
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "FileDeviceFactory.h"
 #include "FileDevice.h"
+#include "Recorder.h"
 
 //resource init  must be outside namespace and needed when used in a library
 void TerbitFileDvcResourceInitialize()
@@ -32,7 +33,7 @@ FileDeviceFactory::FileDeviceFactory()
 
    m_provider = "Terbit";
    m_name     = "FilePlayer";
-   m_description = QObject::tr("Access data in a binary file.");
+   m_description = QObject::tr("Access and record data in a binary file.");
 
    QString display, description;
 
@@ -40,6 +41,10 @@ FileDeviceFactory::FileDeviceFactory()
    description = QObject::tr("A basic file playback device.");
    m_typeList.push_back(new FactoryTypeInfo(FILE_DEVICE_TYPENAME, DATA_CLASS_KIND_DEVICE, QIcon(":/images/32x32/network_adapter.png"),display,description,BuildScriptDocumentationFileDevice()));
 
+   display = QObject::tr("Recorder");
+   description = QObject::tr("Records a data set to a binary file.");
+   m_typeList.push_back(new FactoryTypeInfo(RECORDER_TYPENAME, DATA_CLASS_KIND_PROCESSOR, QIcon(":/images/32x32/disk.png"),display,description,BuildScriptDocumentationRecorder()));
+
 }
 
 FileDeviceFactory::~FileDeviceFactory()
@@ -71,6 +76,10 @@ DataClass* FileDeviceFactory::CreateInstance(const QString& typeName)
    {
       return new(std::nothrow) FileDevice();
    }
+   else if (typeName == RECORDER_TYPENAME)
+   {
+      return new(std::nothrow) Recorder();
+   }
    else
    {
       return NULL;
@@ -160,7 +160,6 @@ void FileDeviceView::OnRun(void)
       }
       m_pDvc->SetFreq(m_advDlg->GetFreqBox()->value());
       m_pDvc->SetLoop(m_qCtrlWin->GetLoopEnabled());
-      m_pDvc->SetNumCh(1);
       m_pDvc->SetDataType(type);
       if(localInit)
       {
@@ -200,7 +199,6 @@ void FileDeviceView::OnSingle(void)
    }
    m_pDvc->SetFreq(m_advDlg->GetFreqBox()->value());
    m_pDvc->SetLoop(m_qCtrlWin->GetLoopEnabled());
-   m_pDvc->SetNumCh(1);
    m_pDvc->SetDataType(type);
 
    if(localInit && m_pDvc->Single())
@@ -44,7 +44,7 @@ FileDeviceViewAdvanced::FileDeviceViewAdvanced(QWidget *parent) :
    QGridLayout* pLayout = new QGridLayout(m_optionsDlg);
    pLayout->addWidget(new QLabel(tr("Update Freqency (Hz)")), 1,0,1,1,0);
    m_pSpinFreq->setDecimals(3);
-   m_pSpinFreq->setMaximum(240.0);
+   m_pSpinFreq->setMaximum(100000.0);
    m_pSpinFreq->setMinimum(.01);
    m_pSpinFreq->setValue(10.0);
    m_pSpinFreq->setSingleStep(10.0);
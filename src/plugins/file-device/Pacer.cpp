@@ -0,0 +1,174 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Pacer.h"
+#include <boost/thread.hpp>
+
+namespace terbit
+{
+
+// Sleep until this long before a deadline, then spin.  Covers the typical
+// wake-up latency of a sleeping thread.
+#if _WINDOWS
+static const int64_t  PACER_SPIN_US = 2000;
+#else
+static const int64_t  PACER_SPIN_US = 200;
+#endif
+static const uint32_t MAX_CATCHUP_PERIODS = 100;
+
+Pacer::Pacer()
+{
+   m_policy = PacerCatchUp;
+   Start(1.0);
+}
+
+void Pacer::Start(double hz)
+{
+   m_hz = hz;
+   m_period = boost::chrono::duration_cast<Clock_t::duration>(boost::chrono::duration<double>(1.0/hz));
+   m_deadline = Clock_t::now() + m_period;
+   ResetStats();
+}
+
+// keeps the phase of the last deadline so a rate change doesn't restart the schedule
+void Pacer::SetRate(double hz)
+{
+   if(hz != m_hz && hz > 0)
+   {
+      m_deadline -= m_period;
+      m_hz = hz;
+      m_period = boost::chrono::duration_cast<Clock_t::duration>(boost::chrono::duration<double>(1.0/hz));
+      m_deadline += m_period;
+   }
+}
+
+void Pacer::SetPolicy(Policy_t p)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   m_policy = p;
+}
+
+Pacer::Policy_t Pacer::GetPolicy(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   return m_policy;
+}
+
+void Pacer::ResetStats(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   m_statsStart  = Clock_t::now();
+   m_ticks       = 0;
+   m_late        = 0;
+   m_skipped     = 0;
+   m_jitterSumNs = 0;
+   m_jitterMaxNs = 0;
+}
+
+bool Pacer::WaitStep(uint32_t maxWaitMs)
+{
+   Clock_t::time_point now = Clock_t::now();
+   Clock_t::duration remaining = m_deadline - now;
+   Clock_t::duration maxWait = boost::chrono::milliseconds(maxWaitMs);
+   Clock_t::duration spin = boost::chrono::microseconds(PACER_SPIN_US);
+
+   if(remaining > spin)
+   {
+      Clock_t::duration sleep = remaining - spin;
+      if(sleep > maxWait)
+      {
+         boost::this_thread::sleep_for(maxWait);
+         return false;
+      }
+      boost::this_thread::sleep_for(sleep);
+   }
+
+   now = Clock_t::now();
+   while(now < m_deadline)
+   {
+      boost::this_thread::yield();
+      now = Clock_t::now();
+   }
+
+   tick(now);
+   return true;
+}
+
+// record stats for the deadline just reached and schedule the next one
+void Pacer::tick(Clock_t::time_point now)
+{
+   double lateNs = (double)boost::chrono::duration_cast<boost::chrono::nanoseconds>(now - m_deadline).count();
+
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   ++m_ticks;
+   m_jitterSumNs += lateNs;
+   if(lateNs > m_jitterMaxNs)
+   {
+      m_jitterMaxNs = lateNs;
+   }
+
+   m_deadline += m_period;
+   if(now >= m_deadline)
+   {
+      // we missed at least one full period
+      ++m_late;
+      uint64_t behind = (now - m_deadline) / m_period + 1;
+      if(PacerSkip == m_policy || behind > MAX_CATCHUP_PERIODS)
+      {
+         m_skipped  += behind;
+         m_deadline += m_period * behind;
+      }
+   }
+}
+
+double Pacer::GetAchievedRate(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   double secs = boost::chrono::duration<double>(Clock_t::now() - m_statsStart).count();
+   return (secs > 0) ? m_ticks / secs : 0;
+}
+
+double Pacer::GetJitterMeanUs(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   return m_ticks ? m_jitterSumNs / m_ticks / 1000.0 : 0;
+}
+
+double Pacer::GetJitterMaxUs(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   return m_jitterMaxNs / 1000.0;
+}
+
+uint64_t Pacer::GetTickCount(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   return m_ticks;
+}
+
+uint64_t Pacer::GetLateCount(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   return m_late;
+}
+
+uint64_t Pacer::GetSkippedCount(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_statsMutex);
+   return m_skipped;
+}
+
+}// namespace terbit
@@ -0,0 +1,90 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <boost/chrono.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace terbit
+{
+
+/*** Deadline based pacing for the FileDevice processing thread.  Deadlines
+ * are absolute steady clock times (start + n * period) so the time spent
+ * reading and emitting a buffer does not add up as drift.  Waits sleep
+ * until shortly before the deadline and then spin, which allows periods
+ * well below the OS sleep granularity.
+ * When a deadline is missed the policy decides what happens:
+ * o PacerCatchUp - keep the original schedule, the following ticks run back
+ *   to back until the schedule is met again.  If we fall more than
+ *   MAX_CATCHUP_PERIODS behind, the schedule is restarted from now.
+ * o PacerSkip - drop the missed ticks and continue at the next deadline
+ *   in the future.
+ * Statistics (achieved rate, wake-up jitter, late and skipped ticks) are
+ * collected for every tick by the pacing thread and may be read or reset
+ * from any thread, they and the policy are guarded by m_statsMutex.
+ **************************************************************/
+class Pacer
+{
+public:
+   typedef enum
+   {
+      PacerCatchUp,
+      PacerSkip
+   }Policy_t;
+
+   Pacer();
+
+   void Start(double hz);
+   void SetRate(double hz);
+   double GetRate(void){return m_hz;}
+   void SetPolicy(Policy_t p);
+   Policy_t GetPolicy(void);
+
+   // Waits for the next deadline, but at most maxWaitMs.  Returns true when
+   // the deadline has been reached (tick), false if the wait was cut short so
+   // the caller can check for commands and call again.
+   bool WaitStep(uint32_t maxWaitMs);
+
+   double   GetAchievedRate(void);
+   double   GetJitterMeanUs(void);
+   double   GetJitterMaxUs(void);
+   uint64_t GetTickCount(void);
+   uint64_t GetLateCount(void);
+   uint64_t GetSkippedCount(void);
+   void     ResetStats(void);
+
+private:
+   typedef boost::chrono::steady_clock Clock_t;
+
+   void tick(Clock_t::time_point now);
+
+   double              m_hz;
+   Policy_t            m_policy;
+   Clock_t::duration   m_period;
+   Clock_t::time_point m_deadline;
+   Clock_t::time_point m_statsStart;
+
+   boost::mutex m_statsMutex;
+   uint64_t m_ticks;
+   uint64_t m_late;
+   uint64_t m_skipped;
+   double   m_jitterSumNs;
+   double   m_jitterMaxNs;
+};
+
+}// namespace terbit
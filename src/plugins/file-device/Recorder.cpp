@@ -0,0 +1,498 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/**************************************************************************
+ * Recorder streams every new buffer of its input data set to a raw binary
+ * file, the same layout the FileDevice plays back.
+ *
+ * The NewData handler runs on the GUI thread and only copies the buffer
+ * into the AsyncFileWriter pool (strided data sets, such as a FileDevice
+ * channel output, are packed while copying).  The disk writes happen on the
+ * writer's thread.  If the disk falls behind, the pool grows up to the
+ * buffer size; past that the handler waits for the disk rather than drop
+ * data, which shows up as stalls in the stats.
+ *
+ * Options (staged until the next Start()):
+ * o File path name - with a rotate size this is the base name, files are
+ *   numbered name_0000.ext, name_0001.ext, ...
+ * o Rotate bytes - start a new file after this many bytes, 0 for one file.
+ * o Buffer bytes - memory that may be queued for the disk.
+ * o Format - raw, or the chunked capture container (see CaptureCodec.h).
+ *   A capture file carries the data type, sampling rate and bits in its
+ *   header (the rate and bits come from the data set properties) and is
+ *   compressed chunk by chunk on a pool of threads before the writer sees
+ *   it.  The data set must be set before Start() since the header is
+ *   written first.  Rotation applies to raw recordings only.
+ *
+ * The first buffer fixes the data type of a raw recording, a capture
+ * recording takes the type at Start().  A buffer of a different type stops
+ * the recording.
+ **************************************************************************/
+#include "Recorder.h"
+#include "connector-core/Workspace.h"
+#include "connector-core/DataSet.h"
+#include "connector-core/LogDL.h"
+#include "tools/Script.h"
+#include <algorithm>
+
+namespace terbit
+{
+
+Recorder::Recorder()
+{
+}
+
+Recorder::~Recorder()
+{
+   Stop();
+   SetDataSet(NULL);
+}
+
+void Recorder::ApplyInputDataClass(DataClass* dc)
+{
+   if (dc && dc->IsDataSet())
+   {
+      Block::ApplyInputDataClass(dc);
+      SetDataSet(static_cast<DataSet*>(dc));
+   }
+}
+
+void Recorder::SetDataSet(DataSet *ds)
+{
+   if (m_dsIn)
+   {
+      disconnect(m_dsIn,SIGNAL(BeforeDeletion(DataClass*)),this,SLOT(OnBeforeDeleteInput(DataClass*)));
+      disconnect(m_dsIn,SIGNAL(NewData(DataClass*)), this, SLOT(OnNewData(DataClass*)));
+      disconnect(m_dsIn,SIGNAL(NameChanged(DataClass*)),this,SLOT(OnInputDataSetNameChanged(DataClass*)));
+   }
+   m_dsIn = ds;
+   if (m_dsIn)
+   {
+      connect(m_dsIn,SIGNAL(BeforeDeletion(DataClass*)),this,SLOT(OnBeforeDeleteInput(DataClass*)));
+      connect(m_dsIn,SIGNAL(NewData(DataClass*)), this, SLOT(OnNewData(DataClass*)));
+      connect(m_dsIn,SIGNAL(NameChanged(DataClass*)),this,SLOT(OnInputDataSetNameChanged(DataClass*)));
+      OnInputDataSetNameChanged(m_dsIn);
+   }
+}
+
+void Recorder::SetBufferBytes(uint64_t n)
+{
+   if (n >= 2 * WRITER_DEFAULT_BLOCK_BYTES)
+   {
+      m_bufferBytes = n;
+   }
+}
+
+void Recorder::SetFormat(Format_t f)
+{
+   if (f == RecorderRaw || f == RecorderCapture)
+   {
+      m_format = f;
+   }
+}
+
+bool Recorder::Start(void)
+{
+   bool retVal = false;
+
+   if (IsRecording())
+   {
+      retVal = true;
+   }
+   else if (m_filePathName.isEmpty())
+   {
+      LogError2(GetType()->GetLogCategory(), GetName(), tr("No file name to record to."));
+   }
+   else if (RecorderCapture == m_format && !m_dsIn)
+   {
+      LogError2(GetType()->GetLogCategory(), GetName(), tr("Set the data set before recording a capture file."));
+   }
+   else if (RecorderCapture == m_format)
+   {
+      double rate = 0.0;
+      uint32_t bits = 0;
+      QVariant value = m_dsIn->GetPropertyValue(TERBIT_DATA_PROPERTY_SAMPLING_RATE);
+      if (value.isValid() && value.canConvert(QVariant::Double))
+      {
+         rate = value.toDouble();
+      }
+      value = m_dsIn->GetPropertyValue(TERBIT_DATA_PROPERTY_SAMPLING_BITS);
+      if (value.isValid() && value.canConvert(QVariant::UInt))
+      {
+         bits = value.toUInt();
+      }
+
+      m_recordType = m_dsIn->GetDataType();
+      m_typeKnown = true;
+      m_captureActive = true;
+      m_ringNext = 0;
+      retVal = m_capture.Open(m_filePathName, m_recordType, TerbitDataTypeSize(m_recordType), rate, bits, true,
+                              (uint32_t)(m_bufferBytes / WRITER_DEFAULT_BLOCK_BYTES));
+      if (!retVal)
+      {
+         LogError2(GetType()->GetLogCategory(), GetName(), tr("Unable to open %1 for recording.").arg(m_filePathName));
+      }
+   }
+   else
+   {
+      m_typeKnown = false;
+      m_captureActive = false;
+      m_ringNext = 0;
+      retVal = m_writer.Open(m_filePathName, m_rotateBytes, true, WRITER_DEFAULT_BLOCK_BYTES,
+                             (uint32_t)(m_bufferBytes / WRITER_DEFAULT_BLOCK_BYTES));
+      if (!retVal)
+      {
+         LogError2(GetType()->GetLogCategory(), GetName(), tr("Unable to open %1 for recording.").arg(m_filePathName));
+      }
+   }
+   return retVal;
+}
+
+// waits for everything queued to reach the disk
+void Recorder::Stop(void)
+{
+   if (IsRecording())
+   {
+      m_writer.Close();
+      m_capture.Close();
+      if (GetError())
+      {
+         LogError2(GetType()->GetLogCategory(), GetName(), tr("Error writing to %1, the recording is incomplete.").arg(GetWriter().GetCurFilePathName()));
+      }
+   }
+}
+
+bool Recorder::GetError(void)
+{
+   return m_captureActive ? m_capture.GetError() : m_writer.GetError();
+}
+
+uint64_t Recorder::GetRecordedBytes(void)
+{
+   return m_captureActive ? m_capture.GetQueuedBytes() : m_writer.GetQueuedBytes();
+}
+
+// the capture encoders falling behind count as stalls too
+uint64_t Recorder::GetStallCount(void)
+{
+   uint64_t n = GetWriter().GetStats().stallCount;
+   if (m_captureActive)
+   {
+      n += m_capture.GetStallCount();
+   }
+   return n;
+}
+
+// bytes after compression, the same as recorded for a raw recording
+uint64_t Recorder::GetEncodedBytes(void)
+{
+   return m_captureActive ? m_capture.GetEncodedBytes() : m_writer.GetQueuedBytes();
+}
+
+void Recorder::OnNewData(DataClass* source)
+{
+   source;
+   if (IsRecording() && m_dsIn && m_dsIn->GetHasData() && m_dsIn->GetCount() > 0)
+   {
+      if (!m_typeKnown)
+      {
+         m_recordType = m_dsIn->GetDataType();
+         m_typeKnown = true;
+      }
+
+      if (m_dsIn->GetDataType() != m_recordType)
+      {
+         LogError2(GetType()->GetLogCategory(), GetName(), tr("The data type changed while recording, recording stopped."));
+         Stop();
+      }
+      else
+      {
+         size_t start = 0;
+         size_t count = m_dsIn->GetCount();
+         if (m_dsIn->IsRing())
+         {
+            //a ring keeps its history, only record elements appended since the last block
+            uint64_t first = std::max<uint64_t>(m_dsIn->GetFirstIndex(), m_ringNext);
+            uint64_t end = m_dsIn->GetFirstIndex() + m_dsIn->GetCount();
+            start = (size_t)(first - m_dsIn->GetFirstIndex());
+            count = first < end ? (size_t)(end - first) : 0;
+            m_ringNext = end;
+         }
+
+         //an affine input is computed, recorded a block at a time
+         char block[4096];
+         size_t blockElements = sizeof(block) / TerbitDataTypeSize(m_recordType);
+         while (count > 0 && m_dsIn->IsAffine())
+         {
+            size_t n = std::min(count, blockElements);
+            if (!m_dsIn->CopyElements(start, n, block, m_recordType, TerbitDataTypeSize(m_recordType)) || !writeSpan(block, n))
+            {
+               Stop();
+               break;
+            }
+            start += n;
+            count -= n;
+         }
+
+         //a contiguous run at a time, a ring may wrap and a paged input changes pages
+         PagePin pin;
+         while (count > 0)
+         {
+            size_t n = std::min(count, m_dsIn->GetContiguousCount(start));
+            const void* data = m_dsIn->GetElementAddress(start, pin);
+            if (data == NULL || !writeSpan(data, n))
+            {
+               Stop();
+               break;
+            }
+            start += n;
+            count -= n;
+         }
+      }
+   }
+}
+
+bool Recorder::writeSpan(const void* data, size_t count)
+{
+   if (m_captureActive)
+   {
+      return m_capture.WriteStrided(data, TerbitDataTypeSize(m_recordType), count, m_dsIn->GetStrideBytes());
+   }
+   return m_writer.WriteStrided(data, TerbitDataTypeSize(m_recordType), count, m_dsIn->GetStrideBytes());
+}
+
+void Recorder::OnBeforeDeleteInput(DataClass *dc)
+{
+   if (m_dsIn == dc)
+   {
+      //our input source is being removed
+      Stop();
+      SetDataSet(NULL);
+   }
+}
+
+void Recorder::OnBeforeDeleteOwner(DataClass *dc)
+{
+   Block::OnBeforeDeleteOwner(dc);
+   //remove ourself if they owned us
+   GetWorkspace()->DeleteInstance(this->GetAutoId());
+}
+
+void Recorder::OnInputDataSetNameChanged(DataClass *dc)
+{
+   dc;
+   SetName(QString(tr("Recorder (%1)").arg(m_dsIn->GetName())));
+}
+
+QObject *Recorder::CreateScriptWrapper(QJSEngine *se)
+{
+   return new RecorderSW(se, this);
+}
+
+void Recorder::BuildRestoreScript(ScriptBuilder &script, const QString &variableName)
+{
+   if (m_dsIn)
+   {
+      script.add(QString("%1.SetDataSet(%2);\n").arg(variableName).arg(ScriptEncode(m_dsIn->GetUniqueId())));
+   }
+   script.add(QString("%1.SetFilePathName(%2);\n").arg(variableName).arg(ScriptEncode(GetFilePathName())));
+   if (m_rotateBytes > 0)
+   {
+      script.add(QString("%1.SetRotateBytes(%2);\n").arg(variableName).arg(m_rotateBytes));
+   }
+   script.add(QString("%1.SetBufferBytes(%2);\n").arg(variableName).arg(m_bufferBytes));
+   if (RecorderRaw != m_format)
+   {
+      script.add(QString("%1.SetFormat(%2);\n").arg(variableName).arg(m_format));
+   }
+}
+
+ScriptDocumentation *BuildScriptDocumentationRecorder()
+{
+   ScriptDocumentation* d = BuildScriptDocumentationBlock();
+
+   d->SetSummary(QObject::tr("Records every new buffer of a data set to a binary file."));
+
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetDataSet"), "SetDataSet(ds);",QObject::tr("Sets the data set to record.  The ds variable may be a reference or unique id string.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetFilePathName"), "SetFilePathName(fileName);",QObject::tr("The fully pathed file name to record to.  With a rotate size, files are numbered name_0000.ext, name_0001.ext and so on.  Takes effect on the next Start.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetFilePathName"), "GetFilePathName();",QObject::tr("Returns the file name to record to.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetCurFilePathName"), "GetCurFilePathName();",QObject::tr("Returns the file currently being written.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetRotateBytes"), "SetRotateBytes(bytes);",QObject::tr("Start a new file after this many bytes, 0 records to a single file.  Takes effect on the next Start.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetRotateBytes"), "GetRotateBytes();",QObject::tr("Returns the file rotation size in bytes.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetBufferBytes"), "SetBufferBytes(bytes);",QObject::tr("Memory that may be queued waiting for the disk.  Takes effect on the next Start.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetBufferBytes"), "GetBufferBytes();",QObject::tr("Returns the memory that may be queued waiting for the disk.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetFormat"), "SetFormat(format);",QObject::tr("0 - raw binary, 1 - compressed capture file that stores the data type, sampling rate and bits and can be played back by the file device.  Rotation applies to raw only.  Takes effect on the next Start.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetFormat"), "GetFormat();",QObject::tr("Returns the recording format (0 raw, 1 capture).")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("Start"), "Start();",QObject::tr("Start recording.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("Stop"), "Stop();",QObject::tr("Stop recording.  Waits until all recorded data is written.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("IsRecording"), "IsRecording();",QObject::tr("Returns true while recording.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetError"), "GetError();",QObject::tr("Returns true if a disk write failed.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetRecordedBytes"), "GetRecordedBytes();",QObject::tr("Returns the bytes recorded since start, including bytes not written to disk yet.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetWrittenBytes"), "GetWrittenBytes();",QObject::tr("Returns the bytes written to disk.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetEncodedBytes"), "GetEncodedBytes();",QObject::tr("Returns the recorded bytes after compression.  The same as the recorded bytes for the raw format.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetBacklogBytes"), "GetBacklogBytes();",QObject::tr("Returns the bytes queued and waiting for the disk.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetMaxBacklogBytes"), "GetMaxBacklogBytes();",QObject::tr("Returns the largest backlog in bytes.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetStallCount"), "GetStallCount();",QObject::tr("Returns the number of times recording had to wait for the disk because the buffer was full.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetFileCount"), "GetFileCount();",QObject::tr("Returns the number of files written.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetLastWriteMs"), "GetLastWriteMs();",QObject::tr("Returns the duration of the last disk write in milliseconds.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetMaxWriteMs"), "GetMaxWriteMs();",QObject::tr("Returns the longest disk write in milliseconds.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetMeanWriteMs"), "GetMeanWriteMs();",QObject::tr("Returns the mean disk write duration in milliseconds.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("ResetStats"), "ResetStats();",QObject::tr("Resets the write statistics.")));
+
+   return d;
+}
+
+RecorderSW::RecorderSW(QJSEngine *se, Recorder *rec) : BlockSW(se, rec), m_rec(rec)
+{
+}
+
+void RecorderSW::SetDataSet(const QJSValue& valueDS)
+{
+   DataClass* dc = m_rec->GetWorkspace()->FindInstance(valueDS);
+   if (dc && dc->IsDataSet())
+   {
+      m_rec->SetDataSet(static_cast<DataSet*>(dc));
+   }
+   else
+   {
+      LogError2(m_rec->GetType()->GetLogCategory(), m_rec->GetName(),tr("Script Recorder SetDataSet invalid argument"));
+   }
+}
+
+void RecorderSW::SetFilePathName(const QString& p)
+{
+   m_rec->SetFilePathName(p);
+}
+
+QString RecorderSW::GetFilePathName()
+{
+   return m_rec->GetFilePathName();
+}
+
+QString RecorderSW::GetCurFilePathName()
+{
+   return m_rec->GetWriter().GetCurFilePathName();
+}
+
+void RecorderSW::SetRotateBytes(double n)
+{
+   m_rec->SetRotateBytes(n > 0 ? (uint64_t)n : 0);
+}
+
+double RecorderSW::GetRotateBytes()
+{
+   return (double)m_rec->GetRotateBytes();
+}
+
+void RecorderSW::SetBufferBytes(double n)
+{
+   if (n > 0)
+   {
+      m_rec->SetBufferBytes((uint64_t)n);
+   }
+}
+
+double RecorderSW::GetBufferBytes()
+{
+   return (double)m_rec->GetBufferBytes();
+}
+
+void RecorderSW::SetFormat(int f)
+{
+   m_rec->SetFormat((Recorder::Format_t)f);
+}
+
+int RecorderSW::GetFormat()
+{
+   return m_rec->GetFormat();
+}
+
+bool RecorderSW::Start()
+{
+   return m_rec->Start();
+}
+
+void RecorderSW::Stop()
+{
+   m_rec->Stop();
+}
+
+bool RecorderSW::IsRecording()
+{
+   return m_rec->IsRecording();
+}
+
+bool RecorderSW::GetError()
+{
+   return m_rec->GetError();
+}
+
+double RecorderSW::GetRecordedBytes()
+{
+   return (double)m_rec->GetRecordedBytes();
+}
+
+double RecorderSW::GetWrittenBytes()
+{
+   return (double)m_rec->GetWriter().GetStats().bytesWritten;
+}
+
+double RecorderSW::GetEncodedBytes()
+{
+   return (double)m_rec->GetEncodedBytes();
+}
+
+double RecorderSW::GetBacklogBytes()
+{
+   return (double)m_rec->GetWriter().GetStats().backlogBytes;
+}
+
+double RecorderSW::GetMaxBacklogBytes()
+{
+   return (double)m_rec->GetWriter().GetStats().maxBacklogBytes;
+}
+
+double RecorderSW::GetStallCount()
+{
+   return (double)m_rec->GetStallCount();
+}
+
+int RecorderSW::GetFileCount()
+{
+   return (int)m_rec->GetWriter().GetStats().fileCount;
+}
+
+double RecorderSW::GetLastWriteMs()
+{
+   return m_rec->GetWriter().GetStats().lastWriteMs;
+}
+
+double RecorderSW::GetMaxWriteMs()
+{
+   return m_rec->GetWriter().GetStats().maxWriteMs;
+}
+
+double RecorderSW::GetMeanWriteMs()
+{
+   return m_rec->GetWriter().GetStats().meanWriteMs;
+}
+
+void RecorderSW::ResetStats()
+{
+   m_rec->GetWriter().ResetStats();
+}
+
+}// namespace terbit
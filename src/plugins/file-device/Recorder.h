@@ -0,0 +1,142 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <stdint.h>
+#include "connector-core/Block.h"
+#include "tools/Tools.h"
+#include "tools/device/filedvc/AsyncFileWriter.h"
+#include "tools/device/filedvc/ChunkedCaptureWriter.h"
+
+namespace terbit
+{
+
+class DataSet;
+
+static const char* RECORDER_TYPENAME = "recorder";
+
+class Recorder : public Block
+{
+   Q_OBJECT
+
+   friend class RecorderSW;
+
+public:
+   typedef enum
+   {
+      RecorderRaw,
+      RecorderCapture
+   }Format_t;
+
+   Recorder();
+   ~Recorder();
+
+   QObject* CreateScriptWrapper(QJSEngine* se);
+   void BuildRestoreScript(ScriptBuilder& script, const QString& variableName);
+   void ApplyInputDataClass(DataClass* dc);
+
+   void SetDataSet(DataSet* ds);
+   DataSet* GetDataSet(void){return m_dsIn;}
+
+   // staged until the next Start()
+   void SetFilePathName(const QString& p){m_filePathName = p;}
+   const QString& GetFilePathName(void){return m_filePathName;}
+   void SetRotateBytes(uint64_t n){m_rotateBytes = n;}
+   uint64_t GetRotateBytes(void){return m_rotateBytes;}
+   void SetBufferBytes(uint64_t n);
+   uint64_t GetBufferBytes(void){return m_bufferBytes;}
+   void SetFormat(Format_t f);
+   Format_t GetFormat(void){return m_format;}
+
+   bool Start(void);
+   void Stop(void);
+   bool IsRecording(void){return m_writer.IsOpen() || m_capture.IsOpen();}
+   bool GetError(void);
+   uint64_t GetRecordedBytes(void);
+   uint64_t GetEncodedBytes(void);
+   uint64_t GetStallCount(void);
+   // the writer doing the disk writes of the current or last recording
+   AsyncFileWriter& GetWriter(void){return m_captureActive ? m_capture.GetFileWriter() : m_writer;}
+
+protected slots:
+   virtual void OnBeforeDeleteOwner(DataClass *dc);
+
+private slots:
+   void OnBeforeDeleteInput(DataClass* dc);
+   void OnInputDataSetNameChanged(DataClass* dc);
+   void OnNewData(DataClass* source);
+
+private:
+   bool writeSpan(const void* data, size_t count);
+
+   DataSet*        m_dsIn        = NULL;
+   QString         m_filePathName;
+   uint64_t        m_rotateBytes = 0;
+   uint64_t        m_bufferBytes = (uint64_t)WRITER_DEFAULT_BLOCK_BYTES * WRITER_DEFAULT_MAX_BLOCKS;
+   Format_t        m_format      = RecorderRaw;
+   bool            m_captureActive = false;
+   TerbitDataType  m_recordType  = TERBIT_UINT8; // type of the first buffer recorded
+   bool            m_typeKnown   = false;
+   uint64_t        m_ringNext    = 0; // next index to record from a ring buffer input
+   AsyncFileWriter m_writer;
+   ChunkedCaptureWriter m_capture;
+};
+
+ScriptDocumentation *BuildScriptDocumentationRecorder();
+
+class RecorderSW : public BlockSW
+{
+   Q_OBJECT
+
+public:
+   RecorderSW(QJSEngine* se, Recorder* rec);
+   virtual ~RecorderSW() {}
+
+   Q_INVOKABLE void SetDataSet(const QJSValue& ds);
+   Q_INVOKABLE void SetFilePathName(const QString& p);
+   Q_INVOKABLE QString GetFilePathName();
+   Q_INVOKABLE QString GetCurFilePathName();
+   Q_INVOKABLE void SetRotateBytes(double n);
+   Q_INVOKABLE double GetRotateBytes();
+   Q_INVOKABLE void SetBufferBytes(double n);
+   Q_INVOKABLE double GetBufferBytes();
+   Q_INVOKABLE void SetFormat(int f);
+   Q_INVOKABLE int GetFormat();
+
+   Q_INVOKABLE bool Start();
+   Q_INVOKABLE void Stop();
+   Q_INVOKABLE bool IsRecording();
+   Q_INVOKABLE bool GetError();
+
+   Q_INVOKABLE double GetRecordedBytes();
+   Q_INVOKABLE double GetWrittenBytes();
+   Q_INVOKABLE double GetEncodedBytes();
+   Q_INVOKABLE double GetBacklogBytes();
+   Q_INVOKABLE double GetMaxBacklogBytes();
+   Q_INVOKABLE double GetStallCount();
+   Q_INVOKABLE int GetFileCount();
+   Q_INVOKABLE double GetLastWriteMs();
+   Q_INVOKABLE double GetMaxWriteMs();
+   Q_INVOKABLE double GetMeanWriteMs();
+   Q_INVOKABLE void ResetStats();
+
+private:
+   Recorder* m_rec;
+};
+
+}// namespace terbit
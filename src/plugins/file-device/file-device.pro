@@ -24,17 +24,45 @@ SOURCES += \
     FileDeviceViewWin.cpp \
     FileDeviceViewAdvanced.cpp \
     FileDeviceFactory.cpp \
-    ../../tools/device/filedvc/filedvc.cpp
+    Recorder.cpp \
+    DataRing.cpp \
+    Pacer.cpp \
+    ../../tools/device/filedvc/filedvc.cpp \
+    ../../tools/device/filedvc/FileDvcNoBuf.cpp \
+    ../../tools/device/filedvc/FileDvcReadAhead.cpp \
+    ../../tools/device/filedvc/AsyncFileReader.cpp \
+    ../../tools/device/filedvc/AsyncFileWriter.cpp \
+    ../../tools/device/filedvc/CaptureCodec.cpp \
+    ../../tools/device/filedvc/FileDvcChunked.cpp \
+    ../../tools/device/filedvc/ChunkedCaptureWriter.cpp \
+    ../../tools/device/filedvc/SampleUnpack.cpp
 
 HEADERS += \
     ProgressLineEdit.h \
     ../../tools/device/filedvc/filedvc.h \
+    ../../tools/device/filedvc/IFileDvc.h \
+    ../../tools/device/filedvc/FileDvcNoBuf.h \
+    ../../tools/device/filedvc/FileDvcReadAhead.h \
+    ../../tools/device/filedvc/AsyncFileReader.h \
+    ../../tools/device/filedvc/AsyncFileWriter.h \
+    ../../tools/device/filedvc/CaptureCodec.h \
+    ../../tools/device/filedvc/FileDvcChunked.h \
+    ../../tools/device/filedvc/ChunkedCaptureWriter.h \
+    ../../tools/device/filedvc/SampleUnpack.h \
     FileDevice.h \
     FileDevice_global.h \
     FileDeviceView.h \
     FileDeviceViewWin.h \
     FileDeviceViewAdvanced.h \
-    FileDeviceFactory.h
+    FileDeviceFactory.h \
+    Recorder.h \
+    DataRing.h \
+    Pacer.h
+
+# POSIX AIO (AsyncFileReader) is in librt before glibc 2.34
+linux-g++*{
+   LIBS += -lrt
+}
 
 #QMAKE_CXXFLAGS += /showIncludes
 
@@ -161,7 +161,7 @@ bool MicrophoneDevice::Init()
    AddOutput(OUTPUT_MIC, m_ds);
 
    m_volume = 0.05;
-   m_bufferSize = m_ds->GetAllocatedByteCount();
+   m_bufferSize = m_ds->GetCount()*TerbitDataTypeSize(m_ds->GetDataType());
 
    connect(&m_rawBuffer,SIGNAL(readyRead()), this, SLOT(OnRawBufferReady()));
 
@@ -460,7 +460,7 @@ bool MicrophoneDevice::AdjustDataSetToFormat(const QAudioFormat& format)
    {
       size_t nelts = m_ds->GetCount();
       m_ds->CreateBuffer(dataType, 0, nelts);
-      m_bufferSize = m_ds->GetAllocatedByteCount();
+      m_bufferSize = m_ds->GetCount()*TerbitDataTypeSize(m_ds->GetDataType());
    }
 
    return res;
@@ -481,7 +481,7 @@ void MicrophoneDevice::OnRawBufferReady()
    {
       qint64 leftOvers = m_rawBuffer.pos();
       m_rawBuffer.seek(0);
-      char* buf = (char*)m_ds->GetBufferAddress();
+      char* buf = (char*)m_ds->GetWriteAddress();
       qint64 read = m_rawBuffer.read(buf,m_bufferSize);
       leftOvers -= read;
 
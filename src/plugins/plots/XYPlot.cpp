@@ -18,6 +18,7 @@ limitations under the License.
 #include "XYPlotPropertiesView.h"
 #include "XYSeries.h"
 #include "XYPlotRenderer.h"
+#include "XYPlotRenderWorker.h"
 #include "connector-core/Workspace.h"
 #include "tools/widgets/ZoomScrollbar.h"
 #include "connector-core/LogDL.h"
@@ -26,7 +27,8 @@ limitations under the License.
 namespace terbit
 {
 
-XYPlot::XYPlot() : Block(), m_view(NULL), m_propertiesView(NULL), m_autoScale(true), m_showTitle(false)
+XYPlot::XYPlot() : Block(), m_view(NULL), m_propertiesView(NULL), m_autoScale(true), m_showTitle(false),
+   m_maxFrameRate(60), m_refreshPending(false), m_refreshInitScale(false), m_skippedFrameCount(0)
 {
    m_renderer = new XYPlotRenderer(this);
 
@@ -40,6 +42,10 @@ XYPlot::XYPlot() : Block(), m_view(NULL), m_propertiesView(NULL), m_autoScale(tr
    connect(this, SIGNAL(CloseView()),this, SLOT(OnCloseView()));
 
    connect(this,SIGNAL(RemoveSeries(DataSet*)),this,SLOT(OnRemoveSeries(DataSet*)));
+
+   m_refreshTimer.setSingleShot(true);
+   connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(OnRefreshTimer()));
+   m_sinceRefresh.start();
 }
 
 XYPlot::~XYPlot()
@@ -86,6 +92,7 @@ void XYPlot::OnNewData(DataClass* source)
    //NOTE: already in GUI thread
    //if one of the buffers with new data is displayed on the plot, then replot entire plot
    //replot entire plot to avoid dealing with series that overlap each other, autoscaling, etc.
+   //the replot itself is deferred so new data from many series within a frame is one autoscale and one replot
 
    if (m_view != NULL)
    {
@@ -99,24 +106,107 @@ void XYPlot::OnNewData(DataClass* source)
          {
             //if X has new data, then redo the scales
             //don't redo scales if Y has new data because then scales can jump around
-            bool initScale = (!m_hasData || series->GetX() == source);
+            m_refreshInitScale = m_refreshInitScale || !m_hasData || series->GetX() == source;
             m_hasData = true;
-            if (m_autoScale)
-            {
-               AutoScale(initScale);
-            }
-            else if (initScale)
-            {
-               m_view->RebuildAxis();
-            }
-
-            m_view->Replot();
+            ScheduleRefresh();
             break;
          }
       }
    }
 }
 
+void XYPlot::ScheduleRefresh()
+{
+   if (m_refreshPending)
+   {
+      //already have a frame coming that will include this data
+      ++m_skippedFrameCount;
+      return;
+   }
+
+   m_refreshPending = true;
+   int delayMs = 0;
+   if (m_maxFrameRate > 0)
+   {
+      delayMs = (int)(1000.0/m_maxFrameRate - m_sinceRefresh.elapsed());
+      if (delayMs < 0)
+      {
+         delayMs = 0;
+      }
+   }
+
+   if (delayMs > 0)
+   {
+      m_refreshTimer.start(delayMs);
+   }
+   else
+   {
+      OnRefreshTimer();
+   }
+}
+
+void XYPlot::OnRefreshTimer()
+{
+   bool initScale = m_refreshInitScale;
+   m_refreshPending = false;
+   m_refreshInitScale = false;
+   m_sinceRefresh.restart();
+
+   if (m_view != NULL)
+   {
+      if (m_autoScale)
+      {
+         AutoScale(initScale);
+      }
+      else if (initScale)
+      {
+         m_view->RebuildAxis();
+      }
+
+      m_view->Replot();
+   }
+}
+
+void XYPlot::SetMaxFrameRate(double fps)
+{
+   m_maxFrameRate = (fps > 0) ? fps : 0;
+}
+
+quint64 XYPlot::GetSkippedFrameCount()
+{
+   //coalesced here plus requests the render worker dropped because it was busy
+   quint64 count = m_skippedFrameCount;
+   if (m_view)
+   {
+      count += m_view->GetRenderWorker()->GetDroppedFrameCount();
+   }
+   return count;
+}
+
+quint64 XYPlot::GetFrameCount()
+{
+   return (m_view) ? m_view->GetRenderWorker()->GetFrameCount() : 0;
+}
+
+double XYPlot::GetLastRenderMs()
+{
+   return (m_view) ? m_view->GetRenderWorker()->GetLastRenderMs() : 0;
+}
+
+double XYPlot::GetAverageRenderMs()
+{
+   return (m_view) ? m_view->GetRenderWorker()->GetAverageRenderMs() : 0;
+}
+
+void XYPlot::ResetFrameStats()
+{
+   m_skippedFrameCount = 0;
+   if (m_view)
+   {
+      m_view->GetRenderWorker()->ResetStats();
+   }
+}
+
 void XYPlot::OnBeforeBufferRemovedSlot(DataClass *dc)
 {
    if (RemoveSeries(static_cast<DataSet*>(dc)))
@@ -204,6 +294,10 @@ XYSeries* XYPlot::AddSeries(DataSet *X, DataSet *Y)
       connect(X,SIGNAL(BeforeDeletion(DataClass*)),this,SLOT(OnBeforeBufferRemovedSlot(DataClass*)));
       connect(Y,SIGNAL(BeforeDeletion(DataClass*)),this,SLOT(OnBeforeBufferRemovedSlot(DataClass*)));
 
+      //decimated frames and auto scale query min/max per range, the summary answers in O(log n)
+      X->SetMinMaxSummaryEnabled(true);
+      Y->SetMinMaxSummaryEnabled(true);
+
       series = new XYSeries(GetWorkspace(), X, Y, this, managedX);
 
       bool initScale = !m_hasData;
@@ -1263,6 +1357,10 @@ void XYPlot::BuildRestoreScript(ScriptBuilder& script, const QString& variableNa
       }
       const QColor& c = series->GetColor();
       script.add(QString("series.SetRGB(%1, %2, %3);").arg(c.red()).arg(c.green()).arg(c.blue()));
+      if (!series->GetDecimate())
+      {
+         script.add(QString("series.SetDecimate(false);"));
+      }
       script.add("}");
    }
 
@@ -1281,6 +1379,10 @@ void XYPlot::BuildRestoreScript(ScriptBuilder& script, const QString& variableNa
    script.add(QString("%1.SetGridLinesY(%2);").arg(variableName).arg(m_gridLinesY));
 
    script.add(QString("%1.SetAutoIncreaseRange(%2);").arg(variableName).arg(m_autoScale));
+   if (m_maxFrameRate != 60)
+   {
+      script.add(QString("%1.SetMaxFrameRate(%2);").arg(variableName).arg(DoubleToStringComplete(m_maxFrameRate)));
+   }
    if (!m_autoScale)
    {
       script.add(QString("%1.SetRangeX(%2,%3);").arg(variableName).arg(DoubleToStringComplete(m_minX)).arg(DoubleToStringComplete(m_maxX)));
@@ -1338,6 +1440,14 @@ ScriptDocumentation *BuildScriptDocumentationXYPlot()
    d->AddScriptlet(new Scriptlet(QObject::tr("SetGridLinesX"), "SetGridLinesX(value);",QObject::tr("Boolean option to display gridlines for the X-axis.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("GetGridLinesX"), "GetGridLinesX();",QObject::tr("Returns boolean option to display gridlines for the X-axis.")));
 
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetMaxFrameRate"), "SetMaxFrameRate(fps);",QObject::tr("Set the maximum number of times per second the plot redraws for new data.  New data arriving faster is combined into the next redraw.  Use 0 to redraw for every new data.  The default is 60.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetMaxFrameRate"), "GetMaxFrameRate();",QObject::tr("Returns the maximum number of redraws per second for new data.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetSkippedFrameCount"), "GetSkippedFrameCount();",QObject::tr("Returns the number of redraws skipped because newer data replaced them before they were drawn.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetFrameCount"), "GetFrameCount();",QObject::tr("Returns the number of redraws of the series area.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetLastRenderMs"), "GetLastRenderMs();",QObject::tr("Returns the time in milliseconds to draw the series for the last redraw.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetAverageRenderMs"), "GetAverageRenderMs();",QObject::tr("Returns the average time in milliseconds to draw the series.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("ResetFrameStats"), "ResetFrameStats();",QObject::tr("Resets the frame, skipped frame and render time statistics.")));
+
    d->AddScriptlet(new Scriptlet(QObject::tr("ShowPropertiesWindow"), "ShowPropertiesWindow();",QObject::tr("Show the plot properties window.")));
    d->AddScriptlet(new Scriptlet(QObject::tr("ClosePropertiesWindow"), "ClosePropertiesWindow();",QObject::tr("Close the plot properties window.")));
 
@@ -1585,4 +1695,39 @@ void XYPlotSW::RemoveSeries(const QJSValue &dataSet)
    }
 }
 
+void XYPlotSW::SetMaxFrameRate(double fps)
+{
+   m_plot->SetMaxFrameRate(fps);
+}
+
+double XYPlotSW::GetMaxFrameRate()
+{
+   return m_plot->GetMaxFrameRate();
+}
+
+double XYPlotSW::GetSkippedFrameCount()
+{
+   return (double)m_plot->GetSkippedFrameCount();
+}
+
+double XYPlotSW::GetFrameCount()
+{
+   return (double)m_plot->GetFrameCount();
+}
+
+double XYPlotSW::GetLastRenderMs()
+{
+   return m_plot->GetLastRenderMs();
+}
+
+double XYPlotSW::GetAverageRenderMs()
+{
+   return m_plot->GetAverageRenderMs();
+}
+
+void XYPlotSW::ResetFrameStats()
+{
+   m_plot->ResetFrameStats();
+}
+
 }
@@ -95,6 +95,15 @@ public:
 
    bool IsDataSetOnPlot(DataClassAutoId_t bufferId);
 
+   //new data replots are coalesced to at most this many per second, 0 for every new data
+   void SetMaxFrameRate(double fps);
+   double GetMaxFrameRate() { return m_maxFrameRate; }
+   quint64 GetSkippedFrameCount();
+   quint64 GetFrameCount();
+   double GetLastRenderMs();
+   double GetAverageRenderMs();
+   void ResetFrameStats();
+
    virtual void GetDirectDependencies(std::list<DataClass *> &dependsOn);
 
    void BuildRestoreScript(ScriptBuilder& script, const QString& variableName);
@@ -169,6 +178,7 @@ private slots:
 
    void OnBeforeBufferRemovedSlot(DataClass* dc);
    void OnNewData(DataClass* source);
+   void OnRefreshTimer();
 
    bool OnRemoveSeries(DataSet* buf);
 
@@ -181,6 +191,7 @@ private:
    void ZoomY(double point, double deltaPercent);
    void SetVisibleX(double start, double end);
    void SetVisibleY(double start, double end);
+   void ScheduleRefresh();
 
 
    std::list<XYSeries*> m_list;
@@ -195,6 +206,13 @@ private:
    bool m_gridLinesX, m_gridLinesY;
    int m_defaultColorIndex;
    QColor m_seriesAreaBackgroundColor;
+
+   //new data refresh coalescing
+   QTimer m_refreshTimer;
+   QElapsedTimer m_sinceRefresh;
+   double m_maxFrameRate;
+   bool m_refreshPending, m_refreshInitScale;
+   quint64 m_skippedFrameCount;
 };
 
 ScriptDocumentation *BuildScriptDocumentationXYPlot();
@@ -231,6 +249,13 @@ public:
    Q_INVOKABLE void SetGridLinesY(bool value);
    Q_INVOKABLE bool GetGridLinesX();
    Q_INVOKABLE void SetGridLinesX(bool value);
+   Q_INVOKABLE void SetMaxFrameRate(double fps);
+   Q_INVOKABLE double GetMaxFrameRate();
+   Q_INVOKABLE double GetSkippedFrameCount();
+   Q_INVOKABLE double GetFrameCount();
+   Q_INVOKABLE double GetLastRenderMs();
+   Q_INVOKABLE double GetAverageRenderMs();
+   Q_INVOKABLE void ResetFrameStats();
 
    Q_INVOKABLE void ShowPropertiesWindow();
    Q_INVOKABLE void ClosePropertiesWindow();
@@ -0,0 +1,184 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <utility>
+#include <QPainter>
+#include "XYPlotRenderWorker.h"
+#include "XYPlot.h"
+#include "XYPlotRenderer.h"
+
+namespace terbit
+{
+
+XYPlotRenderWorker::XYPlotRenderWorker(XYPlot* plot) : QThread(), m_plot(plot), m_pending(NULL), m_spare(NULL), m_stop(false),
+   m_width(0), m_height(0), m_front(NULL), m_back(NULL), m_frameCount(0), m_droppedFrameCount(0),
+   m_lastRenderMs(0), m_totalRenderMs(0)
+{
+}
+
+XYPlotRenderWorker::~XYPlotRenderWorker()
+{
+   Stop();
+   delete m_pending;
+   delete m_spare;
+   delete m_front;
+   delete m_back;
+}
+
+void XYPlotRenderWorker::RequestFrame(int width, int height)
+{
+   //copied outside the lock, the worker only takes the frame once it is complete
+   m_lock.lock();
+   XYPlotFrame* frame = m_spare;
+   m_spare = NULL;
+   m_lock.unlock();
+   if (!frame)
+   {
+      frame = new XYPlotFrame();
+   }
+   m_plot->GetRenderer()->BuildFrame(*frame);
+
+   QMutexLocker lock(&m_lock);
+   if (m_pending)
+   {
+      //previous request never started, this one replaces it
+      ++m_droppedFrameCount;
+      std::swap(frame, m_pending);
+      if (!m_spare)
+      {
+         std::swap(frame, m_spare);
+      }
+      delete frame;
+   }
+   else
+   {
+      m_pending = frame;
+   }
+   m_width = width;
+   m_height = height;
+   m_wake.wakeOne();
+}
+
+void XYPlotRenderWorker::Stop()
+{
+   m_lock.lock();
+   m_stop = true;
+   m_wake.wakeOne();
+   m_lock.unlock();
+
+   wait();
+}
+
+quint64 XYPlotRenderWorker::GetFrameCount()
+{
+   QMutexLocker lock(&m_lock);
+   return m_frameCount;
+}
+
+quint64 XYPlotRenderWorker::GetDroppedFrameCount()
+{
+   QMutexLocker lock(&m_lock);
+   return m_droppedFrameCount;
+}
+
+double XYPlotRenderWorker::GetLastRenderMs()
+{
+   QMutexLocker lock(&m_lock);
+   return m_lastRenderMs;
+}
+
+double XYPlotRenderWorker::GetAverageRenderMs()
+{
+   QMutexLocker lock(&m_lock);
+   return (m_frameCount > 0) ? m_totalRenderMs/m_frameCount : 0;
+}
+
+void XYPlotRenderWorker::ResetStats()
+{
+   QMutexLocker lock(&m_lock);
+   m_frameCount = m_droppedFrameCount = 0;
+   m_lastRenderMs = m_totalRenderMs = 0;
+}
+
+void XYPlotRenderWorker::DrawFrame(QPainter* painter, int width, int height)
+{
+   QMutexLocker lock(&m_frontLock);
+   if (m_front && m_front->width() == width && m_front->height() == height)
+   {
+      painter->drawImage(0, 0, *m_front);
+   }
+}
+
+void XYPlotRenderWorker::run()
+{
+   int width, height;
+   double renderMs;
+   QElapsedTimer timer;
+   XYPlotFrame* frame;
+
+   m_lock.lock();
+   while (!m_stop)
+   {
+      if (!m_pending)
+      {
+         m_wake.wait(&m_lock);
+         continue;
+      }
+
+      frame = m_pending;
+      m_pending = NULL;
+      width = m_width;
+      height = m_height;
+      m_lock.unlock();
+
+      if (!m_back || m_back->width() != width || m_back->height() != height)
+      {
+         delete m_back;
+         //same format as the background so blitting is a straight copy
+         m_back = new QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+      }
+      timer.start();
+      m_back->fill(Qt::transparent);
+
+      QPainter painter;
+      painter.begin(m_back);
+      painter.setRenderHint(QPainter::Antialiasing);
+      XYPlotRenderer::RenderFrame(&painter, *frame);
+      painter.end();
+      renderMs = timer.nsecsElapsed()/1.0e6;
+
+      m_frontLock.lock();
+      std::swap(m_front, m_back);
+      m_frontLock.unlock();
+
+      m_lock.lock();
+      if (!m_spare)
+      {
+         m_spare = frame;
+      }
+      else
+      {
+         delete frame;
+      }
+      ++m_frameCount;
+      m_lastRenderMs = renderMs;
+      m_totalRenderMs += renderMs;
+
+      emit FrameReady();
+   }
+   m_lock.unlock();
+}
+
+}
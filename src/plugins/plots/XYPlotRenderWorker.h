@@ -0,0 +1,87 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+#include <QElapsedTimer>
+
+class QPainter;
+
+namespace terbit
+{
+
+class XYPlot;
+class XYPlotFrame;
+
+//Rasterizes the series area of a plot into a back buffer image on its own thread.
+//The GUI thread requests frames and blits the latest finished one.  A request copies the
+//series area, scales, colors and visible elements of every series into a frame the worker
+//owns, so the plot, its series and their data sets can change (or be deleted) at any time
+//without waiting for the worker.  Requests made while a frame is rendering collapse into
+//one, so a slow render drops intermediate frames.
+class XYPlotRenderWorker : public QThread
+{
+   Q_OBJECT
+public:
+   XYPlotRenderWorker(XYPlot* plot);
+   virtual ~XYPlotRenderWorker();
+
+   //GUI thread
+   void RequestFrame(int width, int height);
+   void Stop();
+
+   //draw the latest finished frame, skipped if it doesn't match the size
+   void DrawFrame(QPainter* painter, int width, int height);
+
+   quint64 GetFrameCount();
+   quint64 GetDroppedFrameCount();
+   double GetLastRenderMs();
+   double GetAverageRenderMs();
+   void ResetStats();
+
+signals:
+   void FrameReady();
+
+protected:
+   void run();
+
+private:
+   XYPlotRenderWorker(const XYPlotRenderWorker& o); //disable copy ctor
+
+   XYPlot* m_plot;
+
+   //request state
+   QMutex m_lock;
+   QWaitCondition m_wake;
+   XYPlotFrame* m_pending; //next frame to render, NULL for none
+   XYPlotFrame* m_spare;   //finished frame kept to reuse its buffers
+   bool m_stop;
+   int m_width, m_height;
+
+   //front is only touched under m_frontLock, back only by the worker
+   QMutex m_frontLock;
+   QImage* m_front;
+   QImage* m_back;
+
+   //stats, under m_lock
+   quint64 m_frameCount, m_droppedFrameCount;
+   double m_lastRenderMs, m_totalRenderMs;
+};
+
+}
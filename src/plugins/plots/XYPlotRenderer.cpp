@@ -275,53 +275,50 @@ void XYPlotRenderer::CalcDisplayTicks(std::list<DisplayTick>& displayValues, int
    }
 }
 
-void XYPlotRenderer::RenderSeriesArea(QPainter* painter)
+void XYPlotRenderer::BuildFrame(XYPlotFrame& frame)
 {
-   //draw white background
-   XYSeriesRenderArea& a = m_seriesArea;
-
-   if (m_plot->GetHasData())
+   frame.area = m_seriesArea;
+   frame.seriesCount = 0;
+   if (!m_plot->GetHasData())
    {
-      //rendering may need to draw lines to points outside series area (e.g. zoomed)
-      //but only paint portion of lines inside series area
-      painter->setClipRect(a.rectX,a.rectY,a.rectW,a.rectH);
-
-      std::list<XYSeries*>& list = m_plot->GetSeriesList();
-      std::list<XYSeries*>::iterator its;
-
-      //render the series
-      //qint64 ms = QDateTime::currentMSecsSinceEpoch();
+      return;
+   }
 
-      for(its=list.begin(); its!=list.end(); ++its)
+   std::list<XYSeries*>& list = m_plot->GetSeriesList();
+   if (frame.series.size() < list.size())
+   {
+      frame.series.resize(list.size());
+   }
+   for(std::list<XYSeries*>::iterator its=list.begin(); its!=list.end(); ++its)
+   {
+      if ((*its)->GetRenderer()->BuildFrame(m_seriesArea, frame.series[frame.seriesCount]))
       {
-         XYSeries* series = (*its);
-
-         if (series->GetShowOnPlot() && series->HasData())
-         {                        
-            DataSet* X = series->GetX();
-            DataSet* Y = series->GetY();
-
-            //get bounding indicies that overlap the visible range
-            //assumes X data is ordered
-            size_t start, end;
-            if (X->BoundingIndicies(a.startX,a.endX,start, end))
-            {
-               series->GetRenderer()->Render(painter, a, X, Y, start, end);
-            }
-         }
+         ++frame.seriesCount;
       }
+   }
+}
 
-      //done clipping
-      painter->setClipping(false);
+void XYPlotRenderer::RenderFrame(QPainter* painter, const XYPlotFrame& frame)
+{
+   const XYSeriesRenderArea& a = frame.area;
+   if (frame.seriesCount == 0)
+   {
+      return;
+   }
 
+   //rendering may need to draw lines to points outside series area (e.g. zoomed)
+   //but only paint portion of lines inside series area
+   painter->setClipRect(a.rectX,a.rectY,a.rectW,a.rectH);
 
-      //finally done processing new data . . . update GUI plot latency
-//      ms = QDateTime::currentMSecsSinceEpoch() - ms;
-//      QString displayLatency = QObject::tr("%1 ms").arg(QString::number(ms));
-//      painter->setPen(Qt::black);
-//      painter->drawText(a.rectW+a.rectX-50,a.rectY-2,displayLatency);
+   for (size_t i = 0; i < frame.seriesCount; ++i)
+   {
+      XYSeriesRenderer::Render(painter, a, frame.series[i]);
    }
+
+   //done clipping
+   painter->setClipping(false);
 }
+
 bool XYPlotRenderer::ScreenToDataPoint(int mouseX, int mouseY, double& dataX, double& dataY)
 {
    //screen position to interpolated data point (not necessarily exact data point)
@@ -16,6 +16,7 @@ limitations under the License.
 #pragma once
 
 #include <list>
+#include <vector>
 #include <QFontMetrics>
 #include "XYSeriesRenderer.h"
 
@@ -26,6 +27,18 @@ namespace terbit
 
 class XYPlot;
 
+//render parameters and series data of one frame, copied on the GUI thread when the frame is
+//requested, the render worker reads nothing else
+class XYPlotFrame
+{
+public:
+   XYPlotFrame() : seriesCount(0) {}
+
+   XYSeriesRenderArea area;
+   std::vector<XYSeriesFrame> series; //may hold more than seriesCount to reuse their buffers
+   size_t seriesCount;
+};
+
 class XYPlotRenderer
 {
 public:
@@ -33,7 +46,10 @@ public:
    virtual ~XYPlotRenderer();
 
    void RenderBackgroundAndAxis(QPainter* painter, int plotWidth, int plotHeight);
-   void RenderSeriesArea(QPainter* painter);
+   //GUI thread, copies the visible elements of each series shown
+   void BuildFrame(XYPlotFrame& frame);
+   //render worker
+   static void RenderFrame(QPainter* painter, const XYPlotFrame& frame);
    void RenderOverlay(QPainter* painter, int mouseX, int mouseY);
    bool ScreenToDataPoint(int posX, int posY, double& dataX, double& dataY);
    bool SeriesAreaContainsPoint(int posX, int posY);
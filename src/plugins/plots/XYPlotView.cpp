@@ -19,6 +19,7 @@ limitations under the License.
 #include "XYPlotView.h"
 #include "XYPlot.h"
 #include "XYPlotRenderer.h"
+#include "XYPlotRenderWorker.h"
 #include "tools/widgets/ZoomScrollbar.h"
 #include "connector-core/Workspace.h"
 
@@ -31,6 +32,10 @@ namespace terbit
 XYPlotViewArea::XYPlotViewArea(QWidget* parent, XYPlot* plot)
    : QWidget(parent), m_state(STATE_IDLE), m_plot(plot), m_backgroundAndAxis(NULL), m_rebuildAxis(false)
 {
+   m_renderWorker = new XYPlotRenderWorker(plot);
+   connect(m_renderWorker, SIGNAL(FrameReady()), this, SLOT(update()));
+   m_renderWorker->start();
+
    this->setAttribute(Qt::WA_DeleteOnClose);
    setAutoFillBackground(false);
    setAttribute(Qt::WA_OpaquePaintEvent, true);
@@ -42,6 +47,7 @@ XYPlotViewArea::XYPlotViewArea(QWidget* parent, XYPlot* plot)
 }
 XYPlotViewArea::~XYPlotViewArea()
 {
+   delete m_renderWorker;
    delete m_backgroundAndAxis;
 }
 
@@ -50,6 +56,19 @@ void XYPlotViewArea::RebuildAxis()
    m_rebuildAxis = true;
 }
 
+void XYPlotViewArea::Replot()
+{
+   if (m_rebuildAxis)
+   {
+      //series area changes with the axis, frame is requested after the axis is built
+      update();
+   }
+   else
+   {
+      m_renderWorker->RequestFrame(this->width(), this->height());
+   }
+}
+
 void XYPlotViewArea::paintEvent(QPaintEvent *)
 {
    if (m_rebuildAxis)
@@ -58,11 +77,12 @@ void XYPlotViewArea::paintEvent(QPaintEvent *)
       BuildAxis(this->width(), this->height());
    }
 
+   //series are rasterized by the render worker, only blit the latest frame here
    QPainter painter;
    painter.begin(this);
    painter.setRenderHint(QPainter::Antialiasing);
    painter.drawImage(0,0,*m_backgroundAndAxis);
-   m_plot->GetRenderer()->RenderSeriesArea(&painter);
+   m_renderWorker->DrawFrame(&painter, this->width(), this->height());
    QPoint mousePos = this->mapFromGlobal(QCursor::pos());
    m_plot->GetRenderer()->RenderOverlay(&painter, mousePos.x(), mousePos.y());
    painter.end();
@@ -147,6 +167,8 @@ void XYPlotViewArea::BuildAxis(int plotWidth, int plotHeight)
    painter.setRenderHint(QPainter::Antialiasing);
    m_plot->GetRenderer()->RenderBackgroundAndAxis(&painter, plotWidth, plotHeight);
    painter.end();
+
+   m_renderWorker->RequestFrame(plotWidth, plotHeight);
 }
 
 
@@ -275,9 +297,13 @@ void XYPlotView::OnScrollbarY()
 
 void XYPlotView::Replot()
 {
-   //update is thread-safe (pushes event to main gui loop for processing), repaint calls paintEvent directly
-   //had issues calling repaint from drag/drop (other xy plot event) so call update even if in gui thread
-   m_viewArea->update();
+   //series are drawn by the render worker which updates the view area when the frame is ready
+   m_viewArea->Replot();
+}
+
+XYPlotRenderWorker* XYPlotView::GetRenderWorker()
+{
+   return m_viewArea->GetRenderWorker();
 }
 
 void XYPlotView::RebuildAxis()
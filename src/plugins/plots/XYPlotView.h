@@ -27,6 +27,7 @@ class XYPlot;
 class ZoomScrollbar;
 class XYSeries;
 class DataSet;
+class XYPlotRenderWorker;
 
 class XYPlotView: public WorkspaceDockWidget
 {
@@ -39,6 +40,7 @@ public:
 
    void RebuildAxis();
    void Replot();
+   XYPlotRenderWorker* GetRenderWorker();
 
    void dragEnterEvent(QDragEnterEvent *event);
    void dropEvent(QDropEvent *event);
@@ -94,6 +96,8 @@ public:
    ~XYPlotViewArea();
 
    void RebuildAxis();
+   void Replot();
+   XYPlotRenderWorker* GetRenderWorker() { return m_renderWorker; }
 
 protected:
    void paintEvent(QPaintEvent *event);
@@ -115,6 +119,7 @@ private:
    State m_state;
    XYPlot *m_plot;
    QImage* m_backgroundAndAxis;
+   XYPlotRenderWorker* m_renderWorker;
    QPoint m_lastMousePos;
    bool m_rebuildAxis;
 };
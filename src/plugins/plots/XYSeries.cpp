@@ -23,7 +23,7 @@ namespace terbit
 {
 
 XYSeries::XYSeries(Workspace* workspace, DataSet* X, DataSet* Y, XYPlot* plot, bool managedX)
-   : QObject(), m_workspace(workspace), m_X(X), m_Y(Y), m_plot(plot), m_managedX(managedX), m_renderer(NULL), m_showOnPlot(false), m_lastNewDataCounterX(0), m_lastNewDataCounterY(0)
+   : QObject(), m_workspace(workspace), m_X(X), m_Y(Y), m_plot(plot), m_managedX(managedX), m_renderer(NULL), m_showOnPlot(false), m_decimate(true), m_lastNewDataCounterX(0), m_lastNewDataCounterY(0)
 {   
    m_color = m_plot->GetDefaultSeriesColor();
    m_plot->GetSeriesList().push_back(this);
@@ -64,7 +64,12 @@ bool XYSeries::TestPlotNewData(DataClass* source)
       if (Y == source || (X == source && Y->GetHasData()))
       {
          //see if we have to reconfigure X
-         if (m_managedX && (X->GetCount() != Y->GetCount() || X->GetFirstIndex() != Y->GetFirstIndex() ))
+         if (m_managedX && Y->IsRing())
+         {
+            //the logical indices so the window scrolls along the X axis
+            X->CreateAffine(TERBIT_UINT64, Y->GetFirstIndex(), Y->GetCount(), (double)Y->GetFirstIndex(), 1.0);
+         }
+         else if (m_managedX && (X->GetCount() != Y->GetCount() || X->GetFirstIndex() != Y->GetFirstIndex() ))
          {
             X->CreateBufferAsIndex(Y->GetFirstIndex(), Y->GetCount());
          }
@@ -91,6 +96,11 @@ void XYSeries::SetColor(const QColor& color)
    }
 }
 
+void XYSeries::SetDecimate(bool decimate)
+{
+   m_decimate = decimate;
+}
+
 QString XYSeries::GetDescription()
 {
    QString s;
@@ -132,6 +142,8 @@ ScriptDocumentation *BuildScriptDocumentationXYSeries()
    d->AddScriptlet(new Scriptlet(QObject::tr("GetRed"), "GetRed();",QObject::tr("Returns the red component of the color for the series")));
    d->AddScriptlet(new Scriptlet(QObject::tr("GetGreen"), "GetGreen();",QObject::tr("Returns the green component of the color for the series")));
    d->AddScriptlet(new Scriptlet(QObject::tr("GetBlue"), "GetBlue();",QObject::tr("Returns the blue component of the color for the series")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("SetDecimate"), "SetDecimate(value);",QObject::tr("Set boolean option to draw the min/max of each pixel column instead of every sample.  The image is the same and drawing is much faster for large data sets.  On by default.")));
+   d->AddScriptlet(new Scriptlet(QObject::tr("GetDecimate"), "GetDecimate();",QObject::tr("Returns boolean if the series is drawn decimated to the pixel columns.")));
 
    return d;
 }
@@ -177,4 +189,14 @@ int XYSeriesSW::GetBlue()
    return m_series->GetColor().blue();
 }
 
+void XYSeriesSW::SetDecimate(bool decimate)
+{
+   m_series->SetDecimate(decimate);
+}
+
+bool XYSeriesSW::GetDecimate()
+{
+   return m_series->GetDecimate();
+}
+
 }
@@ -43,6 +43,10 @@ public:
    void SetColor(const QColor& color);
    const QColor& GetColor() { return m_color; }
 
+   //draw min/max per pixel column instead of every sample, same image
+   void SetDecimate(bool decimate);
+   bool GetDecimate() { return m_decimate; }
+
    QString GetDescription();
 
    XYSeriesRenderer* GetRenderer() { return m_renderer; }
@@ -76,6 +80,7 @@ private:
 
    QColor m_color;
    bool m_showOnPlot;
+   bool m_decimate;
 
 };
 
@@ -94,6 +99,8 @@ public:
    Q_INVOKABLE int GetRed();
    Q_INVOKABLE int GetGreen();
    Q_INVOKABLE int GetBlue();
+   Q_INVOKABLE void SetDecimate(bool decimate);
+   Q_INVOKABLE bool GetDecimate();
 
 private:
    QJSEngine* m_scriptEngine;
@@ -15,6 +15,10 @@ limitations under the License.
 */
 #include "XYSeriesRenderer.h"
 #include "connector-core/LogDL.h"
+#include <QVector>
+#include <QLine>
+#include <algorithm>
+#include <cmath>
 
 namespace terbit
 {
@@ -23,170 +27,237 @@ XYSeriesRenderer::XYSeriesRenderer(XYSeries* series) : m_series(series)
 {
 }
 
-template<typename DataTypeX, typename DataTypeY>
-void XYSeriesRenderLayer2(QPainter* painter, const XYSeriesRenderArea& area, DataTypeX* X, size_t strideX, DataTypeY* Y, size_t strideY, size_t start, size_t end)
+bool XYSeriesAxisData::Copy(const DataSet* ds, size_t first, size_t count)
 {
+   affine = ds->IsAffine();
+   if (affine)
+   {
+      values.clear();
+      start = ds->GetValueAtIndex(first);
+      step = ds->GetAffineStep();
+      return first + count <= ds->GetCount();
+   }
+   //any mode (a wrapped ring, paged) comes out as one contiguous run
+   values.resize(count);
+   return ds->CopyElements(first, count, values.data(), TERBIT_DOUBLE, sizeof(double));
+}
 
-   int x1, y1, x2, y2;
-   //TODO improve on this . . . . TerbitValues or something . . . .
-   //convert everything to double for the time being in case we are mix/matching data types between series
-   double valueCurrentX, startX;
-   double valueCurrentY, startY;
-   double rangeX, rangeY; //kept range as double because it's used for scaling and value difference (e.g. int8 64 - -100 = 164 overflow for int8)
-
-
-   startX = area.startX;
-   rangeX = area.rangeX;
-   startY = area.startY;
-   rangeY = area.rangeY;
+//the render templates index X and Y from the first visible element: the copied values, or
+//this for an affine axis, which has no buffer
+class XYAffineAxis
+{
+public:
+   XYAffineAxis(double start, double step) : m_start(start), m_step(step) {}
+   double operator[](size_t i) const { return m_start + m_step*i; }
+private:
+   double m_start;
+   double m_step;
+};
 
-   if (sizeof(DataTypeX) == strideX && sizeof(DataTypeY) == strideY)
+//first index in [lo, hi) whose X scales to pixel column x or right of it, hi when there is none.
+//Binned with the same scaling the worker draws with so a sample never lands in a neighbouring
+//column, X is ordered
+static size_t XYColumnStart(const DataSet* X, const XYSeriesRenderArea& area, int x, size_t lo, size_t hi)
+{
+   if (X->IsAffine() && X->GetAffineStep() > 0)
    {
-      size_t i = start;
-      X = (DataTypeX*)((char*)X + i*strideX);
-      Y = (DataTypeY*)((char*)Y + i*strideY);
+      //narrow the search to the estimate, the scaling decides the last index or two
+      double edge = area.startX + area.rangeX*(x - area.rectX)/area.rectW;
+      double i = ceil((edge - X->GetValueAtIndex(0))/X->GetAffineStep());
+      if (i - 2 > (double)lo)
+      {
+         lo = (i - 2 >= (double)hi) ? hi : (size_t)(i - 2);
+      }
+      if (i + 2 < (double)hi)
+      {
+         hi = (i + 2 <= (double)lo) ? lo : (size_t)(i + 2);
+      }
+   }
 
-      valueCurrentX = (double)*X;
-      valueCurrentY = (double)*Y;
+   while (lo < hi)
+   {
+      size_t mid = lo + (hi - lo)/2;
+      if (ScaleDataToLogical(X->GetValueAtIndex(mid), area.rectX, area.rectW, area.startX, area.rangeX) < x)
+      {
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid;
+      }
+   }
+   return lo;
+}
 
-      x1 = ScaleDataToLogical(valueCurrentX, area.rectX, area.rectW, startX, rangeX);
-      y1 = ScaleDataToLogicalReverse(valueCurrentY, area.rectY, area.rectH, startY, rangeY);
+//The connected segments within a pixel column cover exactly the pixels from its min to max, so
+//one vertical line plus the line into the next column's first sample draws the same image as
+//every segment
+static void XYSeriesRenderColumns(QPainter* painter, const XYSeriesRenderArea& area, const std::vector<XYSeriesColumn>& columns)
+{
+   int x1, y1, x2, y2;
+   double startX = area.startX;
+   double rangeX = area.rangeX;
+   double startY = area.startY;
+   double rangeY = area.rangeY;
 
-      ++X;
-      ++Y;
-      ++i;
+   //two lines per column, drawn in one call
+   QVector<QLine> lines;
+   lines.reserve(2*columns.size());
 
-      while(i <= end)
+   for (size_t i = 0; i < columns.size(); ++i)
+   {
+      const XYSeriesColumn& col = columns[i];
+      x2 = ScaleDataToLogical(col.firstX, area.rectX, area.rectW, startX, rangeX);
+      y2 = ScaleDataToLogicalReverse(col.firstY, area.rectY, area.rectH, startY, rangeY);
+      if (i > 0)
       {
-         valueCurrentX = (double)*X;
-         valueCurrentY = (double)*Y;
+         lines.append(QLine(x1, y1, x2, y2));
+      }
+      if (col.minY != col.maxY)
+      {
+         lines.append(QLine(x2, ScaleDataToLogicalReverse(col.minY, area.rectY, area.rectH, startY, rangeY),
+                            x2, ScaleDataToLogicalReverse(col.maxY, area.rectY, area.rectH, startY, rangeY)));
+      }
+      x1 = ScaleDataToLogical(col.lastX, area.rectX, area.rectW, startX, rangeX);
+      y1 = ScaleDataToLogicalReverse(col.lastY, area.rectY, area.rectH, startY, rangeY);
+   }
 
-         x2 = ScaleDataToLogical(valueCurrentX, area.rectX, area.rectW, startX, rangeX);
-         y2 = ScaleDataToLogicalReverse(valueCurrentY, area.rectY, area.rectH, startY, rangeY);
+   painter->drawLines(lines);
+}
 
-         painter->drawLine(x1, y1, x2, y2);
+//draws elements 0 to end of the axes
+template<typename AxisX, typename AxisY>
+void XYSeriesRenderLayer2(QPainter* painter, const XYSeriesRenderArea& area, const AxisX& X, const AxisY& Y, size_t end)
+{
+   int x1, y1, x2, y2;
+   //convert everything to double in case we are mix/matching data types between series
+   //kept range as double because it's used for scaling and value difference (e.g. int8 64 - -100 = 164 overflow for int8)
+   double startX = area.startX;
+   double rangeX = area.rangeX;
+   double startY = area.startY;
+   double rangeY = area.rangeY;
 
-         ++X;
-         ++Y;
-         ++i;
+   x1 = ScaleDataToLogical(X[0], area.rectX, area.rectW, startX, rangeX);
+   y1 = ScaleDataToLogicalReverse(Y[0], area.rectY, area.rectH, startY, rangeY);
 
-         x1 = x2;
-         y1 = y2;
-      }
-   }
-   else
+   for (size_t i = 1; i <= end; ++i)
    {
-      size_t i = start;
-      X = (DataTypeX*)((char*)X + i*strideX);
-      Y = (DataTypeY*)((char*)Y + i*strideY);
+      x2 = ScaleDataToLogical(X[i], area.rectX, area.rectW, startX, rangeX);
+      y2 = ScaleDataToLogicalReverse(Y[i], area.rectY, area.rectH, startY, rangeY);
 
-      valueCurrentX = (double)*X;
-      valueCurrentY = (double)*Y;
+      painter->drawLine(x1, y1, x2, y2);
 
-      x1 = ScaleDataToLogical(valueCurrentX, area.rectX, area.rectW, startX, rangeX);
-      y1 = ScaleDataToLogicalReverse(valueCurrentY, area.rectY, area.rectH, startY, rangeY);
-
-      X = (DataTypeX*)((char*)X + strideX);
-      Y = (DataTypeY*)((char*)Y + strideY);
-      ++i;
+      x1 = x2;
+      y1 = y2;
+   }
+}
 
-      while(i <= end)
-      {
-         valueCurrentX = (double)*X;
-         valueCurrentY = (double)*Y;
+//resolves how Y is stored and draws it against X
+template<typename AxisX>
+void XYSeriesRenderLayer1(QPainter* painter, const XYSeriesRenderArea& area, const AxisX& X, const XYSeriesAxisData& Y, size_t end)
+{
+   if (Y.affine)
+   {
+      XYSeriesRenderLayer2(painter,area,X,XYAffineAxis(Y.start,Y.step),end);
+   }
+   else
+   {
+      XYSeriesRenderLayer2(painter,area,X,Y.values.data(),end);
+   }
+}
 
-         x2 = ScaleDataToLogical(valueCurrentX, area.rectX, area.rectW, startX, rangeX);
-         y2 = ScaleDataToLogicalReverse(valueCurrentY, area.rectY, area.rectH, startY, rangeY);
+bool XYSeriesRenderer::BuildFrame(const XYSeriesRenderArea& area, XYSeriesFrame& frame)
+{
+   if (!m_series->GetShowOnPlot() || !m_series->HasData())
+   {
+      return false;
+   }
 
-         painter->drawLine(x1, y1, x2, y2);
+   DataSet* X = m_series->GetX();
+   DataSet* Y = m_series->GetY();
 
-         X = (DataTypeX*)((char*)X + strideX);
-         Y = (DataTypeY*)((char*)Y + strideY);
-         ++i;
+   //get bounding indicies that overlap the visible range
+   //assumes X data is ordered
+   size_t start, end;
+   if (!X->BoundingIndicies(area.startX,area.endX,start, end) || start >= end)
+   {
+      return false;
+   }
 
-         x1 = x2;
-         y1 = y2;
-      }
+   frame.color = m_series->GetColor();
+   //decimating only pays off when there are more samples than pixel columns
+   frame.decimate = m_series->GetDecimate() && area.rectW > 0 && (end - start) > (size_t)(2*area.rectW);
+   if (frame.decimate)
+   {
+      return buildColumns(area, start, end, frame);
    }
+   frame.count = end - start + 1;
+   return frame.X.Copy(X, start, frame.count) && frame.Y.Copy(Y, start, frame.count);
 }
 
-template<typename DataTypeX>
-void XYSeriesRenderLayer1(QPainter* painter, const XYSeriesRenderArea& area, DataTypeX* X, size_t strideX, DataSet* Y, size_t start, size_t end)
+//reduces the samples to min/max/first/last per pixel column, with the min/max summary the
+//work here is O(log n) per column rather than per sample
+bool XYSeriesRenderer::buildColumns(const XYSeriesRenderArea& area, size_t start, size_t end, XYSeriesFrame& frame)
 {
-   switch (Y->GetDataType())
-   {
-   case TERBIT_DOUBLE:
-      XYSeriesRenderLayer2<DataTypeX,double>(painter,area,X,strideX,(double*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_FLOAT:
-      XYSeriesRenderLayer2<DataTypeX,float>(painter,area,X,strideX,(float*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_INT8:
-      XYSeriesRenderLayer2<DataTypeX,int8_t>(painter,area,X,strideX,(int8_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_INT16:
-      XYSeriesRenderLayer2<DataTypeX,int16_t>(painter,area,X,strideX,(int16_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_INT32:
-      XYSeriesRenderLayer2<DataTypeX,int32_t>(painter,area,X,strideX,(int32_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_INT64:
-      XYSeriesRenderLayer2<DataTypeX,int64_t>(painter,area,X,strideX,(int64_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_UINT8:
-      XYSeriesRenderLayer2<DataTypeX,uint8_t>(painter,area,X,strideX,(uint8_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_UINT16:
-      XYSeriesRenderLayer2<DataTypeX,uint16_t>(painter,area,X,strideX,(uint16_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_UINT32:
-      XYSeriesRenderLayer2<DataTypeX,uint32_t>(painter,area,X,strideX,(uint32_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
-   case TERBIT_UINT64:
-      XYSeriesRenderLayer2<DataTypeX,uint64_t>(painter,area,X,strideX,(uint64_t*)Y->GetBufferAddress(),Y->GetStrideBytes(),start,end);
-      break;
+   DataSet* X = m_series->GetX();
+   DataSet* Y = m_series->GetY();
+
+   //bin 0 holds the samples left of the area, bins 1 to rectW+1 its pixel columns and the last
+   //bin the samples right of it
+   size_t columns = area.rectW + 1;
+   size_t bins = columns + 2;
+   m_bounds.resize(bins + 1);
+   m_mins.resize(bins);
+   m_maxs.resize(bins);
+
+   m_bounds[0] = start;
+   for (size_t c = 0; c <= columns; ++c)
+   {
+      m_bounds[c + 1] = XYColumnStart(X, area, area.rectX + (int)c, m_bounds[c], end + 1);
    }
-}
+   m_bounds[bins] = end + 1;
 
-void XYSeriesRenderer::Render(QPainter* painter, XYSeriesRenderArea& area, DataSet* X, DataSet* Y, size_t start, size_t end)
-{
-   if (start < end)
+   if (!Y->CalculateMinMaxEnvelope(m_bounds.data(), bins, m_mins.data(), m_maxs.data()))
    {
-      painter->setPen(m_series->GetColor());
+      return false;
+   }
 
-      switch (X->GetDataType())
+   frame.columns.clear();
+   for (size_t b = 0; b < bins; ++b)
+   {
+      if (m_bounds[b] == m_bounds[b + 1])
       {
-      case TERBIT_DOUBLE:
-         XYSeriesRenderLayer1<double>(painter,area,(double*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_FLOAT:
-         XYSeriesRenderLayer1<float>(painter,area,(float*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_INT8:
-         XYSeriesRenderLayer1<int8_t>(painter,area,(int8_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_INT16:
-         XYSeriesRenderLayer1<int16_t>(painter,area,(int16_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_INT32:
-         XYSeriesRenderLayer1<int32_t>(painter,area,(int32_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_INT64:
-         XYSeriesRenderLayer1<int64_t>(painter,area,(int64_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_UINT8:
-         XYSeriesRenderLayer1<uint8_t>(painter,area,(uint8_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_UINT16:
-         XYSeriesRenderLayer1<uint16_t>(painter,area,(uint16_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_UINT32:
-         XYSeriesRenderLayer1<uint32_t>(painter,area,(uint32_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
-      case TERBIT_UINT64:
-         XYSeriesRenderLayer1<uint64_t>(painter,area,(uint64_t*)X->GetBufferAddress(),X->GetStrideBytes(), Y, start,end);
-         break;
+         continue;
       }
+      size_t first = m_bounds[b];
+      size_t last = m_bounds[b + 1] - 1;
+
+      XYSeriesColumn col;
+      col.firstX = X->GetValueAtIndex(first);
+      col.lastX = X->GetValueAtIndex(last);
+      col.firstY = Y->GetValueAtIndex(first);
+      col.lastY = Y->GetValueAtIndex(last);
+      col.minY = m_mins[b];
+      col.maxY = m_maxs[b];
+      frame.columns.push_back(col);
+   }
+   return !frame.columns.empty();
+}
+
+void XYSeriesRenderer::Render(QPainter* painter, const XYSeriesRenderArea& area, const XYSeriesFrame& frame)
+{
+   painter->setPen(frame.color);
+   if (frame.decimate)
+   {
+      XYSeriesRenderColumns(painter,area,frame.columns);
+   }
+   else if (frame.X.affine)
+   {
+      XYSeriesRenderLayer1(painter,area,XYAffineAxis(frame.X.start,frame.X.step),frame.Y,frame.count - 1);
+   }
+   else
+   {
+      XYSeriesRenderLayer1(painter,area,frame.X.values.data(),frame.Y,frame.count - 1);
    }
 }
 
@@ -15,6 +15,7 @@ limitations under the License.
 */
 #pragma once
 
+#include <vector>
 #include <QPainter>
 #include <tools/Tools.h>
 #include "XYSeries.h"
@@ -38,16 +39,65 @@ public:
    double rangeY;
 };
 
+//one axis of a series as copied for a frame: the visible elements as doubles, or
+//start + i*step for an affine data set
+class XYSeriesAxisData
+{
+public:
+   XYSeriesAxisData() : affine(false), start(0), step(0) {}
+
+   bool Copy(const DataSet* ds, size_t first, size_t count);
+
+   std::vector<double> values;
+   bool affine;
+   double start;
+   double step;
+};
+
+//the samples of a decimated series landing on one pixel column: X of the first and last of
+//them, which the lines into and out of the column connect to, and their Y extremes
+class XYSeriesColumn
+{
+public:
+   double firstX, lastX;
+   double firstY, lastY;
+   double minY, maxY;
+};
+
+//everything a frame draws of one series, owned by the frame so the render worker never
+//reads the series or its data sets.  A decimated series is reduced to its pixel columns,
+//otherwise the visible elements are copied
+class XYSeriesFrame
+{
+public:
+   XYSeriesFrame() : decimate(false), count(0) {}
+
+   QColor color;
+   bool decimate;
+   size_t count;
+   XYSeriesAxisData X;
+   XYSeriesAxisData Y;
+   std::vector<XYSeriesColumn> columns;
+};
+
 class XYSeriesRenderer
 {
 public:
    XYSeriesRenderer(XYSeries* series);
    ~XYSeriesRenderer() {}
 
-   void Render(QPainter* painter, XYSeriesRenderArea& area, DataSet* X, DataSet* Y, size_t start, size_t end);
+   //GUI thread: copy or reduce the elements visible in area, false when there is nothing to draw
+   bool BuildFrame(const XYSeriesRenderArea& area, XYSeriesFrame& frame);
+   //render worker: draw a frame built by BuildFrame
+   static void Render(QPainter* painter, const XYSeriesRenderArea& area, const XYSeriesFrame& frame);
 
 protected:
+   bool buildColumns(const XYSeriesRenderArea& area, size_t start, size_t end, XYSeriesFrame& frame);
+
    XYSeries* m_series;
+   std::vector<size_t> m_bounds; //column index bounds, kept to reuse the allocation
+   std::vector<double> m_mins;
+   std::vector<double> m_maxs;
 };
 
 }
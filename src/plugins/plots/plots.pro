@@ -21,6 +21,7 @@ SOURCES += \
     XYPlot.cpp \
     XYPlotPropertiesView.cpp \
     XYPlotRenderer.cpp \
+    XYPlotRenderWorker.cpp \
     XYPlotView.cpp \
     XYSeries.cpp \
     XYSeriesRenderer.cpp \
@@ -34,6 +35,7 @@ HEADERS += \
     XYPlot.h \
     XYPlotPropertiesView.h \
     XYPlotRenderer.h \
+    XYPlotRenderWorker.h \
     XYPlotView.h \
     XYSeries.h \
     XYSeriesRenderer.h \
@@ -48,7 +48,20 @@ void FrequencyMetricsLibSW::Calculate(const QJSValue &dataSet)
             m_fftDb = new double[m_fftDbLen];
          }
 
-         m_metrics->Calculate((double*)ds->GetBufferAddress(),m_fftDb, ds->GetCount(),m_maxHarmonicCount,m_binsDC,m_binsFundamental,m_binsHarmonics,m_fullScale,m_bits,m_noiseDb);
+         //a ring (may wrap), paged or affine data set is copied in index order first
+         double* input = (double*)ds->GetBufferAddress();
+         if (ds->IsRing() || ds->IsPaged() || ds->IsAffine() || input == NULL)
+         {
+            m_input.resize(ds->GetCount());
+            if (!ds->CopyElements(0, ds->GetCount(), m_input.data(), TERBIT_DOUBLE, sizeof(double)))
+            {
+               LogError(g_log.general,tr("FrequencyMetrics calculate unable to read the input data set: %1").arg(ds->GetName()));
+               return;
+            }
+            input = m_input.data();
+         }
+
+         m_metrics->Calculate(input,m_fftDb, ds->GetCount(),m_maxHarmonicCount,m_binsDC,m_binsFundamental,m_binsHarmonics,m_fullScale,m_bits,m_noiseDb);
          auto idx = ds->GetIndexDataSet();
          if (idx)
          {
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <QObject>
 #include <QJSValue>
+#include <vector>
 
 namespace terbit
 {
@@ -69,6 +70,7 @@ private:
   FrequencySignalMetrics* m_metrics;
   double* m_fftDb = NULL;
   size_t m_fftDbLen = 0;
+  std::vector<double> m_input; // contiguous copy of a ring, paged or affine input
   double m_fundamental;
   Workspace* m_workspace;
   int m_maxHarmonicCount = 6;
@@ -23,6 +23,7 @@ limitations under the License.
 #include <connector-core/Workspace.h>
 #include "plugins/scripting/TimerLibSW.h"
 #include "plugins/scripting/FileIOLibSW.h"
+#include "plugins/scripting/VecLibSW.h"
 
 namespace terbit
 {
@@ -78,6 +79,7 @@ ScriptDocumentation * BuildScriptEnvironmentDocumentation()
    res->AddSubDocumentation(BuildScriptDocumentationWorkspace());
    res->AddSubDocumentation(BuildScriptDocumentationFileIOLibSW());
    res->AddSubDocumentation(BuildScriptDocumentationTimerLibSW());
+   res->AddSubDocumentation(BuildScriptDocumentationVecLibSW());
 
    return res;
 }
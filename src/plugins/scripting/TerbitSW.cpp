@@ -17,6 +17,7 @@ limitations under the License.
 #include "FrequencyMetricsLibSW.h"
 #include "FileIOLibSW.h"
 #include "TimerLibSW.h"
+#include "VecLibSW.h"
 #include "ScriptProcessor.h"
 #include "ScriptingUtils.h"
 #include <connector-core/Workspace.h>
@@ -29,6 +30,7 @@ TerbitSW::TerbitSW(QJSEngine *engine, ScriptProcessor *ide, Workspace *w)
    : m_scriptEngine(engine), m_ide(ide), m_workspace(w)
 {
    m_ws = m_scriptEngine->newQObject(new WorkspaceSW(engine,w, ide->GetSourceProcessor()));
+   m_vec = m_scriptEngine->newQObject(new VecLibSW(w, ide, engine));
 }
 
 #undef LogError
@@ -90,6 +92,7 @@ ScriptDocumentation *BuildScriptDocumentationTerbit()
    d->AddScriptlet(new Scriptlet(TerbitSW::tr("PrintBr"),ScriptBuilder::GeneratePrintBrScript(),TerbitSW::tr("Displays the message specified by the string msg in the color specified by the string color.  The br tag is automatically added to the end.")));
    d->AddScriptlet(new Scriptlet(TerbitSW::tr("CreateFileIO"),"CreateFileIO();",TerbitSW::tr("Create an instance of a FileIOLibSW object, which allows reading and writing of files.")));
    d->AddScriptlet(new Scriptlet(TerbitSW::tr("CreateTimer"),"CreateTimer();",TerbitSW::tr("Create an instance of a TimerLibSW object, which provides QTimer functionality.")));
+   d->AddScriptlet(new Scriptlet("Vec","terbit.Vec",TerbitSW::tr("Native math over whole data sets: element-wise arithmetic, comparisons, reductions, cumulative sum and type cast.  See the Vec Lib documentation for more information.")));
 
 
    ScriptDocumentation* dt = new ScriptDocumentation();
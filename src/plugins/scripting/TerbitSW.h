@@ -47,6 +47,9 @@ public:
    Q_PROPERTY(QJSValue workspace READ GetWorkspace)
    QJSValue GetWorkspace() { return m_ws; }
 
+   Q_PROPERTY(QJSValue Vec READ GetVec)
+   QJSValue GetVec() { return m_vec; }
+
    Q_PROPERTY(QJSValue UINT8 READ GetUINT8)
    QJSValue GetUINT8() { return TERBIT_UINT8; }
 
@@ -86,6 +89,7 @@ private:
    ScriptProcessor *m_ide;
    Workspace* m_workspace;
    QJSValue m_ws;
+   QJSValue m_vec;
 };
 
 
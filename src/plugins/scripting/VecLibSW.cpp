@@ -0,0 +1,689 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "VecLibSW.h"
+#include "ScriptProcessor.h"
+#include "connector-core/Workspace.h"
+#include "connector-core/DataSet.h"
+#include "connector-core/LogDL.h"
+#include "connector-core/ScriptDocumentation.h"
+#include "tools/TypeConvert.h"
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace terbit
+{
+
+//doubles per kernel pass, the blocks of a chunk stay in L1
+static const size_t VEC_BLOCK_ELEMENTS = 512;
+//smallest range worth handing to another thread
+static const size_t VEC_MIN_CHUNK_ELEMENTS = 65536;
+static const size_t VEC_MAX_INPUTS = 3;
+
+typedef enum
+{
+   VEC_JOB_BINARY,
+   VEC_JOB_UNARY,
+   VEC_JOB_COMPARE,
+   VEC_JOB_SCALE,
+   VEC_JOB_CLIP,
+   VEC_JOB_SELECT,
+   VEC_JOB_CUMSUM,
+   VEC_JOB_REDUCE,
+   VEC_JOB_DOT,
+   VEC_JOB_CAST
+}VecJobKind;
+
+//a data set, or a number used for every element when ds is NULL
+typedef struct
+{
+   DataSet* ds;
+   double value;
+}VecOperand_t;
+
+//one operation over [0, count) of the inputs, run a chunk per thread
+typedef struct
+{
+   VecJobKind kind;
+   int op;
+   VecOperand_t in[VEC_MAX_INPUTS];
+   size_t inputCount;
+   double p0;
+   double p1;
+   DataSet* dest;
+   std::vector<double> carries;       //cumsum start of each chunk
+   std::vector<VecReduce_t> partials; //reduce result of each chunk
+   std::vector<double> dots;          //dot result of each chunk
+}VecJob_t;
+
+//n doubles to dest elements [start, start+n), converted run by run
+//(no write address here, the caller detached dest before the threads started)
+static bool vecStoreBlock(DataSet* dest, size_t start, size_t n, const double* block)
+{
+   while (n > 0)
+   {
+      size_t c = std::min(n, dest->GetContiguousCount(start));
+      void* d = dest->GetElementAddress(start);
+      if (c == 0 || d == NULL ||
+          !ConvertElements(block, TERBIT_DOUBLE, sizeof(double), d, dest->GetDataType(), dest->GetStrideBytes(), c))
+      {
+         return false;
+      }
+      block += c;
+      start += c;
+      n -= c;
+   }
+   return true;
+}
+
+//source elements straight into dest's type, no doubles in between
+static bool vecCastChunk(VecJob_t* job, size_t start, size_t count)
+{
+   DataSet* dest = job->dest;
+   while (count > 0)
+   {
+      size_t n = std::min(count, dest->GetContiguousCount(start));
+      if (n == 0 || !job->in[0].ds->CopyElements(start, n, dest->GetElementAddress(start), dest->GetDataType(), dest->GetStrideBytes()))
+      {
+         return false;
+      }
+      start += n;
+      count -= n;
+   }
+   return true;
+}
+
+static bool vecRunChunk(VecJob_t* job, size_t start, size_t count, size_t chunk)
+{
+   if (job->kind == VEC_JOB_CAST)
+   {
+      return vecCastChunk(job, start, count);
+   }
+
+   double in[VEC_MAX_INPUTS][VEC_BLOCK_ELEMENTS];
+   double out[VEC_BLOCK_ELEMENTS];
+   for (size_t k = 0; k < job->inputCount; ++k)
+   {
+      if (job->in[k].ds == NULL)
+      {
+         std::fill(in[k], in[k] + VEC_BLOCK_ELEMENTS, job->in[k].value);
+      }
+   }
+
+   double carry = job->kind == VEC_JOB_CUMSUM ? job->carries[chunk] : 0.0;
+   double dot = 0.0;
+   VecReduce_t partial;
+   VecReduceInit(partial);
+
+   while (count > 0)
+   {
+      size_t n = std::min(count, VEC_BLOCK_ELEMENTS);
+      for (size_t k = 0; k < job->inputCount; ++k)
+      {
+         if (job->in[k].ds && !job->in[k].ds->CopyElements(start, n, in[k], TERBIT_DOUBLE, sizeof(double)))
+         {
+            return false;
+         }
+      }
+
+      switch (job->kind)
+      {
+      case VEC_JOB_BINARY:
+         VecBinary((VecBinaryOp)job->op, in[0], in[1], out, n);
+         break;
+      case VEC_JOB_UNARY:
+         VecUnary((VecUnaryOp)job->op, in[0], out, n);
+         break;
+      case VEC_JOB_COMPARE:
+         VecCompare((VecCompareOp)job->op, in[0], in[1], out, n);
+         break;
+      case VEC_JOB_SCALE:
+         VecScaleOffset(in[0], job->p0, job->p1, out, n);
+         break;
+      case VEC_JOB_CLIP:
+         VecClip(in[0], job->p0, job->p1, out, n);
+         break;
+      case VEC_JOB_SELECT:
+         VecSelect(in[0], in[1], in[2], out, n);
+         break;
+      case VEC_JOB_CUMSUM:
+         carry = VecCumSum(in[0], carry, out, n);
+         break;
+      case VEC_JOB_REDUCE:
+         VecReduce(in[0], n, partial);
+         break;
+      case VEC_JOB_DOT:
+         dot += VecDot(in[0], in[1], n);
+         break;
+      default:
+         return false;
+      }
+
+      if (job->dest && !vecStoreBlock(job->dest, start, n, out))
+      {
+         return false;
+      }
+      start += n;
+      count -= n;
+   }
+
+   if (job->kind == VEC_JOB_REDUCE)
+   {
+      job->partials[chunk] = partial;
+   }
+   else if (job->kind == VEC_JOB_DOT)
+   {
+      job->dots[chunk] = dot;
+   }
+   return true;
+}
+
+//first element of chunk c when count elements are split in chunks
+static size_t vecChunkStart(size_t count, size_t chunks, size_t c)
+{
+   return count/chunks*c + std::min(c, count%chunks);
+}
+
+//paged inputs split too, each chunk's CopyElements pins the pages it reads
+static size_t vecChunkCount(size_t count, int threads)
+{
+   return std::max((size_t)1, std::min((size_t)threads, count/VEC_MIN_CHUNK_ELEMENTS));
+}
+
+//chunk 0 runs on the calling thread, the others on the global thread pool
+static bool vecRun(VecJob_t& job, size_t count, size_t chunks)
+{
+   job.partials.resize(chunks);
+   job.dots.resize(chunks);
+   job.carries.resize(chunks);
+
+   QList<QFuture<bool> > futures;
+   for (size_t c = 1; c < chunks; ++c)
+   {
+      size_t start = vecChunkStart(count, chunks, c);
+      futures.append(QtConcurrent::run(vecRunChunk, &job, start, vecChunkStart(count, chunks, c + 1) - start, c));
+   }
+   bool res = vecRunChunk(&job, 0, vecChunkStart(count, chunks, 1), 0);
+   for (int i = 0; i < futures.size(); ++i)
+   {
+      res = futures[i].result() && res;
+   }
+   return res;
+}
+
+VecLibSW::VecLibSW(Workspace *w, ScriptProcessor *ide, QJSEngine *engine) : m_workspace(w), m_ide(ide), m_se(engine)
+{
+   m_threadCount = std::max(1, QThread::idealThreadCount());
+}
+
+VecLibSW::~VecLibSW()
+{
+}
+
+void VecLibSW::error(const QString& msg)
+{
+   LogError2(m_ide->GetType()->GetLogCategory(), m_ide->GetName(), msg);
+}
+
+bool VecLibSW::operand(const QJSValue& v, const char* name, DataSet*& ds, double& value)
+{
+   ds = NULL;
+   value = 0.0;
+   if (v.isNumber())
+   {
+      value = v.toNumber();
+      return true;
+   }
+
+   DataClass* dc = m_workspace->FindInstance(v);
+   if (!dc || !dc->IsDataSet())
+   {
+      error(tr("Vec.%1 input must be a data set or a number.").arg(name));
+      return false;
+   }
+   ds = static_cast<DataSet*>(dc);
+   if (!IsConvertibleDataType(ds->GetDataType()) || (!ds->GetBufferAddress() && !ds->IsPaged() && !ds->IsAffine()))
+   {
+      error(tr("Vec.%1 input %2 has no numeric data.").arg(name).arg(ds->GetName()));
+      return false;
+   }
+   return true;
+}
+
+DataSet* VecLibSW::output(const QJSValue& dest, const char* name, TerbitDataType type, uint64_t firstIndex, size_t count,
+                          DataSet* const* inputs, size_t inputCount)
+{
+   DataClass* dc = m_workspace->FindInstance(dest);
+   if (!dc || !dc->IsDataSet())
+   {
+      error(tr("Vec.%1 invalid 'dest' data set.").arg(name));
+      return NULL;
+   }
+   auto ds = static_cast<DataSet*>(dc);
+   if (!IsConvertibleDataType(type))
+   {
+      error(tr("Vec.%1 'dest' must have a numeric data type.").arg(name));
+      return NULL;
+   }
+
+   if (ds->IsPaged() || ds->IsAffine() || ds->GetBufferAddress() == NULL || ds->GetDataType() != type || ds->GetCount() != count)
+   {
+      if (std::find(inputs, inputs + inputCount, ds) != inputs + inputCount)
+      {
+         error(tr("Vec.%1 'dest' is also an input and would have to be recreated.").arg(name));
+         return NULL;
+      }
+      ds->CreateBuffer(type, firstIndex, count);
+   }
+
+   //remotes sharing dest's buffer get their copy before the threads write it
+   ds->GetWriteAddress();
+   return ds;
+}
+
+bool VecLibSW::elementwise(const char* name, int kind, int op, const QJSValue* in, size_t inputCount,
+                           double p0, double p1, const QJSValue& dest)
+{
+   VecJob_t job;
+   job.kind = (VecJobKind)kind;
+   job.op = op;
+   job.inputCount = inputCount;
+   job.p0 = p0;
+   job.p1 = p1;
+   job.dest = NULL;
+
+   DataSet* inputs[VEC_MAX_INPUTS];
+   size_t dataSets = 0;
+   for (size_t k = 0; k < inputCount; ++k)
+   {
+      if (!operand(in[k], name, job.in[k].ds, job.in[k].value))
+      {
+         return false;
+      }
+      if (job.in[k].ds)
+      {
+         if (dataSets > 0 && job.in[k].ds->GetCount() != inputs[0]->GetCount())
+         {
+            error(tr("Vec.%1 input data sets must have the same count.").arg(name));
+            return false;
+         }
+         inputs[dataSets++] = job.in[k].ds;
+      }
+   }
+   if (dataSets == 0)
+   {
+      error(tr("Vec.%1 needs at least one data set input.").arg(name));
+      return false;
+   }
+
+   size_t count = inputs[0]->GetCount();
+   DataClass* dc = m_workspace->FindInstance(dest);
+   TerbitDataType type = (dc && dc->IsDataSet()) ? static_cast<DataSet*>(dc)->GetDataType() : TERBIT_DOUBLE;
+   job.dest = output(dest, name, type, inputs[0]->GetFirstIndex(), count, inputs, dataSets);
+   if (!job.dest)
+   {
+      return false;
+   }
+
+   bool res = true;
+   size_t chunks = vecChunkCount(count, m_threadCount);
+   if (job.kind == VEC_JOB_CUMSUM && chunks > 1)
+   {
+      //the chunk sums first, then each chunk runs from the total before it
+      job.kind = VEC_JOB_REDUCE;
+      DataSet* dest = job.dest;
+      job.dest = NULL;
+      res = vecRun(job, count, chunks);
+      job.kind = VEC_JOB_CUMSUM;
+      job.dest = dest;
+      double carry = 0.0;
+      for (size_t c = 0; c < chunks; ++c)
+      {
+         job.carries[c] = carry;
+         carry += job.partials[c].sum;
+      }
+   }
+   res = res && vecRun(job, count, chunks);
+
+   job.dest->InvalidateMinMaxSummary(0, count);
+   job.dest->SetHasData(true);
+   if (!res)
+   {
+      error(tr("Vec.%1 failed to read or write the data sets.").arg(name));
+   }
+   return res;
+}
+
+bool VecLibSW::reduce(const char* name, const QJSValue& a, VecReduce_t& r)
+{
+   VecJob_t job;
+   job.kind = VEC_JOB_REDUCE;
+   job.op = 0;
+   job.inputCount = 1;
+   job.p0 = job.p1 = 0.0;
+   job.dest = NULL;
+   VecReduceInit(r);
+
+   if (!operand(a, name, job.in[0].ds, job.in[0].value))
+   {
+      return false;
+   }
+   if (!job.in[0].ds)
+   {
+      error(tr("Vec.%1 input must be a data set.").arg(name));
+      return false;
+   }
+
+   size_t count = job.in[0].ds->GetCount();
+   size_t chunks = vecChunkCount(count, m_threadCount);
+   if (!vecRun(job, count, chunks))
+   {
+      error(tr("Vec.%1 failed to read the data set.").arg(name));
+      return false;
+   }
+   for (size_t c = 0; c < chunks; ++c)
+   {
+      VecReduceMerge(r, job.partials[c]);
+   }
+   return true;
+}
+
+bool VecLibSW::Add(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Add", VEC_JOB_BINARY, VEC_ADD, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Sub(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Sub", VEC_JOB_BINARY, VEC_SUB, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Mul(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Mul", VEC_JOB_BINARY, VEC_MUL, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Div(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Div", VEC_JOB_BINARY, VEC_DIV, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Minimum(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Minimum", VEC_JOB_BINARY, VEC_MIN, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Maximum(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Maximum", VEC_JOB_BINARY, VEC_MAX, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Scale(const QJSValue& a, double scale, double offset, const QJSValue& dest)
+{
+   return elementwise("Scale", VEC_JOB_SCALE, 0, &a, 1, scale, offset, dest);
+}
+
+bool VecLibSW::Clip(const QJSValue& a, double lo, double hi, const QJSValue& dest)
+{
+   if (lo > hi)
+   {
+      error(tr("Vec.Clip lo is above hi."));
+      return false;
+   }
+   return elementwise("Clip", VEC_JOB_CLIP, 0, &a, 1, lo, hi, dest);
+}
+
+bool VecLibSW::Abs(const QJSValue& a, const QJSValue& dest)
+{
+   return elementwise("Abs", VEC_JOB_UNARY, VEC_ABS, &a, 1, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Negate(const QJSValue& a, const QJSValue& dest)
+{
+   return elementwise("Negate", VEC_JOB_UNARY, VEC_NEG, &a, 1, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Sqrt(const QJSValue& a, const QJSValue& dest)
+{
+   return elementwise("Sqrt", VEC_JOB_UNARY, VEC_SQRT, &a, 1, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Square(const QJSValue& a, const QJSValue& dest)
+{
+   return elementwise("Square", VEC_JOB_UNARY, VEC_SQUARE, &a, 1, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Db(const QJSValue& a, const QJSValue& dest)
+{
+   return elementwise("Db", VEC_JOB_UNARY, VEC_DB20, &a, 1, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::DbPower(const QJSValue& a, const QJSValue& dest)
+{
+   return elementwise("DbPower", VEC_JOB_UNARY, VEC_DB10, &a, 1, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Less(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Less", VEC_JOB_COMPARE, VEC_LT, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::LessEqual(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("LessEqual", VEC_JOB_COMPARE, VEC_LE, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Greater(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Greater", VEC_JOB_COMPARE, VEC_GT, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::GreaterEqual(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("GreaterEqual", VEC_JOB_COMPARE, VEC_GE, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Equal(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("Equal", VEC_JOB_COMPARE, VEC_EQ, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::NotEqual(const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {a, b};
+   return elementwise("NotEqual", VEC_JOB_COMPARE, VEC_NE, in, 2, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Select(const QJSValue& mask, const QJSValue& a, const QJSValue& b, const QJSValue& dest)
+{
+   QJSValue in[] = {mask, a, b};
+   return elementwise("Select", VEC_JOB_SELECT, 0, in, 3, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::CumSum(const QJSValue& a, const QJSValue& dest)
+{
+   return elementwise("CumSum", VEC_JOB_CUMSUM, 0, &a, 1, 0.0, 0.0, dest);
+}
+
+bool VecLibSW::Cast(const QJSValue& a, const QJSValue& dest, int dataType)
+{
+   VecJob_t job;
+   job.kind = VEC_JOB_CAST;
+   job.op = 0;
+   job.inputCount = 1;
+   job.p0 = job.p1 = 0.0;
+   if (!operand(a, "Cast", job.in[0].ds, job.in[0].value))
+   {
+      return false;
+   }
+   if (!job.in[0].ds)
+   {
+      error(tr("Vec.Cast input must be a data set."));
+      return false;
+   }
+   if (dataType < 0 || dataType >= TERBIT_DATA_TYPE_GUARD)
+   {
+      error(tr("Vec.Cast invalid data type %1.").arg(dataType));
+      return false;
+   }
+
+   size_t count = job.in[0].ds->GetCount();
+   job.dest = output(dest, "Cast", (TerbitDataType)dataType, job.in[0].ds->GetFirstIndex(), count, &job.in[0].ds, 1);
+   if (!job.dest)
+   {
+      return false;
+   }
+
+   bool res = vecRun(job, count, vecChunkCount(count, m_threadCount));
+   job.dest->InvalidateMinMaxSummary(0, count);
+   job.dest->SetHasData(true);
+   if (!res)
+   {
+      error(tr("Vec.Cast failed to convert the data set."));
+   }
+   return res;
+}
+
+double VecLibSW::Sum(const QJSValue& a)
+{
+   VecReduce_t r;
+   return reduce("Sum", a, r) ? r.sum : std::numeric_limits<double>::quiet_NaN();
+}
+
+double VecLibSW::Mean(const QJSValue& a)
+{
+   VecReduce_t r;
+   return reduce("Mean", a, r) && r.count > 0 ? r.sum/r.count : std::numeric_limits<double>::quiet_NaN();
+}
+
+double VecLibSW::Min(const QJSValue& a)
+{
+   VecReduce_t r;
+   return reduce("Min", a, r) && r.count > 0 ? r.min : std::numeric_limits<double>::quiet_NaN();
+}
+
+double VecLibSW::Max(const QJSValue& a)
+{
+   VecReduce_t r;
+   return reduce("Max", a, r) && r.count > 0 ? r.max : std::numeric_limits<double>::quiet_NaN();
+}
+
+double VecLibSW::CountNonZero(const QJSValue& a)
+{
+   VecReduce_t r;
+   return reduce("CountNonZero", a, r) ? (double)r.nonZero : std::numeric_limits<double>::quiet_NaN();
+}
+
+double VecLibSW::Dot(const QJSValue& a, const QJSValue& b)
+{
+   VecJob_t job;
+   job.kind = VEC_JOB_DOT;
+   job.op = 0;
+   job.inputCount = 2;
+   job.p0 = job.p1 = 0.0;
+   job.dest = NULL;
+   if (!operand(a, "Dot", job.in[0].ds, job.in[0].value) || !operand(b, "Dot", job.in[1].ds, job.in[1].value))
+   {
+      return std::numeric_limits<double>::quiet_NaN();
+   }
+   if (!job.in[0].ds || !job.in[1].ds || job.in[0].ds->GetCount() != job.in[1].ds->GetCount())
+   {
+      error(tr("Vec.Dot inputs must be data sets with the same count."));
+      return std::numeric_limits<double>::quiet_NaN();
+   }
+
+   size_t count = job.in[0].ds->GetCount();
+   size_t chunks = vecChunkCount(count, m_threadCount);
+   if (!vecRun(job, count, chunks))
+   {
+      error(tr("Vec.Dot failed to read the data sets."));
+      return std::numeric_limits<double>::quiet_NaN();
+   }
+   double dot = 0.0;
+   for (size_t c = 0; c < chunks; ++c)
+   {
+      dot += job.dots[c];
+   }
+   return dot;
+}
+
+void VecLibSW::SetThreadCount(int threads)
+{
+   m_threadCount = threads > 0 ? threads : std::max(1, QThread::idealThreadCount());
+}
+
+QString VecLibSW::GetKernelName()
+{
+   return GetVecKernelName();
+}
+
+ScriptDocumentation* BuildScriptDocumentationVecLibSW()
+{
+   ScriptDocumentation* d = new ScriptDocumentation();
+
+   d->SetName(VecLibSW::tr("Vec Lib"));
+   d->SetSummary(VecLibSW::tr("terbit.Vec runs math over whole data sets in native code instead of per element script loops.  Inputs are data sets or numbers used for every element, data set inputs must have the same count.  Results are written to dest, which keeps its data type and is recreated as a buffer of the input count when needed.  dest may be one of the inputs.  Call EmitNewData() on dest afterwards so consumers update."));
+
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Add"), "terbit.Vec.Add(a, b, dest);", VecLibSW::tr("dest = a + b.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Sub"), "terbit.Vec.Sub(a, b, dest);", VecLibSW::tr("dest = a - b.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Mul"), "terbit.Vec.Mul(a, b, dest);", VecLibSW::tr("dest = a * b.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Div"), "terbit.Vec.Div(a, b, dest);", VecLibSW::tr("dest = a / b.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Minimum"), "terbit.Vec.Minimum(a, b, dest);", VecLibSW::tr("dest = the smaller of a and b per element.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Maximum"), "terbit.Vec.Maximum(a, b, dest);", VecLibSW::tr("dest = the larger of a and b per element.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Scale"), "terbit.Vec.Scale(a, scale, offset, dest);", VecLibSW::tr("dest = a*scale + offset.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Clip"), "terbit.Vec.Clip(a, lo, hi, dest);", VecLibSW::tr("dest = a clamped to lo..hi.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Abs"), "terbit.Vec.Abs(a, dest);", VecLibSW::tr("dest = |a|.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Negate"), "terbit.Vec.Negate(a, dest);", VecLibSW::tr("dest = -a.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Sqrt"), "terbit.Vec.Sqrt(a, dest);", VecLibSW::tr("dest = square root of a.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Square"), "terbit.Vec.Square(a, dest);", VecLibSW::tr("dest = a*a.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Db"), "terbit.Vec.Db(a, dest);", VecLibSW::tr("dest = 20*log10(|a|), magnitude to decibels.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("DbPower"), "terbit.Vec.DbPower(a, dest);", VecLibSW::tr("dest = 10*log10(|a|), power to decibels.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Less"), "terbit.Vec.Less(a, b, dest);", VecLibSW::tr("dest = 1 where a < b, otherwise 0.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("LessEqual"), "terbit.Vec.LessEqual(a, b, dest);", VecLibSW::tr("dest = 1 where a <= b, otherwise 0.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Greater"), "terbit.Vec.Greater(a, b, dest);", VecLibSW::tr("dest = 1 where a > b, otherwise 0.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("GreaterEqual"), "terbit.Vec.GreaterEqual(a, b, dest);", VecLibSW::tr("dest = 1 where a >= b, otherwise 0.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Equal"), "terbit.Vec.Equal(a, b, dest);", VecLibSW::tr("dest = 1 where a == b, otherwise 0.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("NotEqual"), "terbit.Vec.NotEqual(a, b, dest);", VecLibSW::tr("dest = 1 where a != b, otherwise 0.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Select"), "terbit.Vec.Select(mask, a, b, dest);", VecLibSW::tr("dest = a where mask is non-zero, otherwise b, e.g. with a mask from Greater.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("CumSum"), "terbit.Vec.CumSum(a, dest);", VecLibSW::tr("dest = running sum of a.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Cast"), "terbit.Vec.Cast(a, dest, dataType);", VecLibSW::tr("Recreate dest as the data type (e.g. terbit.INT16) and convert a into it.  Out of range values saturate.  Returns boolean.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Sum"), "terbit.Vec.Sum(a);", VecLibSW::tr("Returns the sum of the elements of a.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Mean"), "terbit.Vec.Mean(a);", VecLibSW::tr("Returns the mean of the elements of a.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Min"), "terbit.Vec.Min(a);", VecLibSW::tr("Returns the smallest element of a, NaN elements are skipped.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Max"), "terbit.Vec.Max(a);", VecLibSW::tr("Returns the largest element of a, NaN elements are skipped.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("CountNonZero"), "terbit.Vec.CountNonZero(a);", VecLibSW::tr("Returns the number of non-zero elements of a, e.g. the matches of a mask.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("Dot"), "terbit.Vec.Dot(a, b);", VecLibSW::tr("Returns the sum of a*b.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("SetThreadCount"), "terbit.Vec.SetThreadCount(threads);", VecLibSW::tr("Most threads an operation is split across, 0 for one per core (the default).  Data sets under 64K elements use one thread.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("GetThreadCount"), "terbit.Vec.GetThreadCount();", VecLibSW::tr("Returns the most threads an operation is split across.")));
+   d->AddScriptlet(new Scriptlet(VecLibSW::tr("GetKernelName"), "terbit.Vec.GetKernelName();", VecLibSW::tr("Returns the name of the kernels in use, \"avx2\" or \"scalar\".")));
+
+   return d;
+}
+
+} // end terbit
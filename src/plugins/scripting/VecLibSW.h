@@ -0,0 +1,102 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <QObject>
+#include <QtQml/QJSEngine>
+#include <stdint.h>
+#include "tools/TerbitDefs.h"
+#include "tools/VecMath.h"
+
+namespace terbit
+{
+
+class Workspace;
+class ScriptProcessor;
+class ScriptDocumentation;
+class DataSet;
+
+/*** terbit.Vec, whole data set math for scripts instead of per element
+ * loops.  Inputs are data sets (reference or unique id) or numbers used for
+ * every element; data set inputs must have the same count.  Results go to a
+ * dest data set, which keeps its data type and is recreated as a buffer of
+ * the input count when it doesn't already hold that many elements.  dest
+ * may be one of the inputs.  Large data sets are split across threads.
+ **************************************************************/
+class VecLibSW : public QObject
+{
+   Q_OBJECT
+public:
+   explicit VecLibSW(Workspace *w, ScriptProcessor *ide, QJSEngine *engine);
+   virtual ~VecLibSW();
+
+   Q_INVOKABLE bool Add(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Sub(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Mul(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Div(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Minimum(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Maximum(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Scale(const QJSValue& a, double scale, double offset, const QJSValue& dest);
+   Q_INVOKABLE bool Clip(const QJSValue& a, double lo, double hi, const QJSValue& dest);
+
+   Q_INVOKABLE bool Abs(const QJSValue& a, const QJSValue& dest);
+   Q_INVOKABLE bool Negate(const QJSValue& a, const QJSValue& dest);
+   Q_INVOKABLE bool Sqrt(const QJSValue& a, const QJSValue& dest);
+   Q_INVOKABLE bool Square(const QJSValue& a, const QJSValue& dest);
+   Q_INVOKABLE bool Db(const QJSValue& a, const QJSValue& dest);
+   Q_INVOKABLE bool DbPower(const QJSValue& a, const QJSValue& dest);
+
+   Q_INVOKABLE bool Less(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool LessEqual(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Greater(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool GreaterEqual(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Equal(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool NotEqual(const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+   Q_INVOKABLE bool Select(const QJSValue& mask, const QJSValue& a, const QJSValue& b, const QJSValue& dest);
+
+   Q_INVOKABLE bool CumSum(const QJSValue& a, const QJSValue& dest);
+   Q_INVOKABLE bool Cast(const QJSValue& a, const QJSValue& dest, int dataType);
+
+   Q_INVOKABLE double Sum(const QJSValue& a);
+   Q_INVOKABLE double Mean(const QJSValue& a);
+   Q_INVOKABLE double Min(const QJSValue& a);
+   Q_INVOKABLE double Max(const QJSValue& a);
+   Q_INVOKABLE double CountNonZero(const QJSValue& a);
+   Q_INVOKABLE double Dot(const QJSValue& a, const QJSValue& b);
+
+   Q_INVOKABLE void SetThreadCount(int threads);
+   Q_INVOKABLE int GetThreadCount() { return m_threadCount; }
+   Q_INVOKABLE QString GetKernelName();
+
+private:
+   void error(const QString& msg);
+   bool operand(const QJSValue& v, const char* name, DataSet*& ds, double& value);
+   DataSet* output(const QJSValue& dest, const char* name, TerbitDataType type, uint64_t firstIndex, size_t count,
+                   DataSet* const* inputs, size_t inputCount);
+   bool elementwise(const char* name, int kind, int op, const QJSValue* in, size_t inputCount,
+                    double p0, double p1, const QJSValue& dest);
+   bool reduce(const char* name, const QJSValue& a, VecReduce_t& r);
+
+private:
+   Workspace       *m_workspace = NULL;
+   ScriptProcessor *m_ide   = NULL;
+   QJSEngine       *m_se    = NULL;
+   int              m_threadCount;
+};
+
+ScriptDocumentation* BuildScriptDocumentationVecLibSW();
+
+} // end terbit
@@ -30,7 +30,8 @@ SOURCES += \
     ScriptDisplay.cpp \
     ScriptDisplayView.cpp \
     ScriptDialogView.cpp \
-    TimerLibSW.cpp
+    TimerLibSW.cpp \
+    VecLibSW.cpp
 
 HEADERS += \
     ScriptProcessor.h \
@@ -48,7 +49,8 @@ HEADERS += \
     ScriptDisplay.h \
     ScriptDisplayView.h \
     ScriptDialogView.h \
-    TimerLibSW.h
+    TimerLibSW.h \
+    VecLibSW.h
 
 #QMAKE_CXXFLAGS += /showIncludes
 
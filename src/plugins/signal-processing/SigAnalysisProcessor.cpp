@@ -147,18 +147,11 @@ void SigAnalysisProcessor::SetAutoUpdateSamplingRate(bool en)
 
 void SigAnalysisProcessor::UpdateFrequencyXValues()
 {
-   DataSet* buf = m_dsFFTHz;
-   size_t i, freqs;
-   freqs = m_dsFFTHz->GetCount();
+   size_t freqs = m_fft->GetFrequencyN();
    if (freqs > 0)
    {
-      double* freqBuf = (double*)buf->GetBufferAddress();
-      double freqScale = m_samplingRateHz/2.0/freqs;
-      for(i=0; i<freqs; ++i, ++freqBuf)
-      {
-         *freqBuf = i*freqScale;
-      }
-      m_dsFFTHz->SetHasData(true);
+      //bin i is at i*fs/2/freqs Hz, computed rather than stored
+      m_dsFFTHz->CreateAffine(TERBIT_DOUBLE, 0, freqs, 0.0, m_samplingRateHz/2.0/freqs);
       emit m_dsFFTHz->NewData(m_dsFFTHz);
    }
 }
@@ -329,31 +322,56 @@ void SigAnalysisProcessor::Refresh()
 {
    if(m_dsIn)
    {
+      //input properties are read here, the worker only computes
+      m_mutex.lock();
+      if (m_autoUpdateSamplingRate)
+      {
+         updateSampleRateFromDataSet();
+      }
+      if(m_autoUpdateBitsPerSamp)
+      {
+         updateBitsPerSampleFromDataSet();
+      }
+      m_mutex.unlock();
       QtConcurrent::run(this, &SigAnalysisProcessor::performCalc);
    }
 }
 
+//runs on the worker, the FFT output is in m_mtrx
 void SigAnalysisProcessor::calculateMetrics()
 {
-   if (m_dsMtrx)
+   m_metricsOut.resize(m_mtrx.size());
+   m_sigMetrx->Calculate(m_mtrx.data(), m_metricsOut.data(), m_mtrx.size(), m_maxHarmonics, m_nBinsExclDC,m_nBinsExclFunda,m_nBinsExclHarm, (m_dBScale == dBFS), m_nBitsSample, m_noiseRange);
+   // m_mtrx has FFT output  Convert for display
+   // copyLinear2dB(m_dsMtrx, m_dsFFTOut, m_dBScaleFFT);
+}
+
+//Writing the output data sets detaches them from the remotes sharing their buffers, that
+//copy-on-write bookkeeping belongs to the GUI thread.  The worker's results are copied in here.
+void SigAnalysisProcessor::OnResultsReady()
+{
+   m_mutex.lock();
+   size_t freqN = m_mtrx.size();
+   bool ready = freqN > 0 && m_metricsOut.size() == freqN;
+   if (ready)
    {
-      DataSet& b = *m_dsMtrx;
-      if (b.GetHasData() && b.GetCount() > 0)
+      if (m_dsMtrx->GetCount() != freqN || m_dsFFTOut->GetCount() != freqN)
       {
-         if (b.GetDataType() == TERBIT_DOUBLE && b.GetStrideBytes() == sizeof(double))
-         {
-            m_sigMetrx->Calculate((double*)b.GetBufferAddress(),(double*)m_dsFFTOut->GetBufferAddress(), b.GetCount(),m_maxHarmonics, m_nBinsExclDC,m_nBinsExclFunda,m_nBinsExclHarm, (m_dBScale == dBFS), m_nBitsSample, m_noiseRange);
-
-            // m_dsMtrx has FFT output  Convert for display
-            // copyLinear2dB(m_dsMtrx, m_dsFFTOut, m_dBScaleFFT);
-            m_dsFFTOut->SetHasData(true);
-            emit m_dsFFTOut->NewData(m_dsFFTOut);
-         }
-         else
-         {
-            LogError2(GetType()->GetLogCategory(), GetName(), tr("The frequency metrics display requires contiguous data of the double data type.  The input data set is not compatible.  Input data set: %1").arg(m_dsIn->GetName()));
-         }
+         m_dsFFTOut->CreateBuffer(TERBIT_DOUBLE, 0, freqN);
+         m_dsMtrx->CreateBuffer(TERBIT_DOUBLE, 0, freqN);
+         UpdateFrequencyXValues();
       }
+      memcpy(m_dsMtrx->GetWriteAddress(), m_mtrx.data(), freqN*sizeof(double));
+      memcpy(m_dsFFTOut->GetWriteAddress(), m_metricsOut.data(), freqN*sizeof(double));
+      m_dsMtrx->SetHasData(true);
+      m_dsFFTOut->SetHasData(true);
+   }
+   m_mutex.unlock();
+
+   if (ready)
+   {
+      emit m_dsFFTOut->NewData(m_dsFFTOut);
+      processorUpdated();
    }
 }
 
@@ -371,7 +389,6 @@ bool SigAnalysisProcessor::UpdateBuffers()
       {
          size_t freqN = m_fft->GetFrequencyN();
          m_dsFFTOut->CreateBuffer(TERBIT_DOUBLE, 0, freqN);
-         m_dsFFTHz->CreateBuffer(TERBIT_DOUBLE,0, freqN);
          m_dsMtrx->CreateBuffer(TERBIT_DOUBLE, 0, freqN);
          UpdateFrequencyXValues();         
       }
@@ -483,65 +500,87 @@ void SigAnalysisProcessor::performCalc()
 {
    if (m_dsIn && m_dsIn->GetHasData()) //paranoid check
    {
+      bool copied = false;
       m_mutex.lock();
       try
       {
-         //ensure we have latest sampling rate
-         if (m_autoUpdateSamplingRate)
-         {
-            updateSampleRateFromDataSet();
-         }
-         if(m_autoUpdateBitsPerSamp)
-         {
-            updateBitsPerSampleFromDataSet();
-         }
+         //the output data sets are resized and written by OnResultsReady on the GUI thread
          m_fft->SetSamplingRate(m_samplingRateHz);
-         if (UpdateBuffers())
+         size_t len = m_dsIn->GetCount();
+         if (len == m_fft->GetInputLen() || m_fft->SetInputLen(len, m_adjustWindowToInputSize))
          {
-            switch (m_dsIn->GetDataType())
+            m_mtrx.resize(m_fft->GetFrequencyN());
+            double* mtrx = m_mtrx.data();
+            //the FFT reads one contiguous buffer, a ring (may wrap), paged or affine
+            //input is copied in index order to a scratch buffer of doubles first
+            copied = true;
+            if (m_dsIn->IsRing() || m_dsIn->IsPaged() || m_dsIn->IsAffine() || m_dsIn->GetBufferAddress() == NULL)
+            {
+               m_input.resize(m_fft->GetInputLen());
+               copied = m_dsIn->CopyElements(0, m_input.size(), m_input.data(), TERBIT_DOUBLE, sizeof(double));
+               if (copied)
+               {
+                  m_fft->FFT(m_input.data(), mtrx, sizeof(double));
+               }
+               else
+               {
+                  LogError2(GetType()->GetLogCategory(), GetName(), tr("Unable to read the FFT input data set: %1").arg(m_dsIn->GetName()));
+               }
+            }
+            else
+            {
+               switch (m_dsIn->GetDataType())
+               {
+               case TERBIT_DOUBLE:
+                  m_fft->FFT((double*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_FLOAT:
+                  m_fft->FFT((float*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_INT8:
+                  m_fft->FFT((int8_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_UINT8:
+                  m_fft->FFT((uint8_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_INT16:
+                  m_fft->FFT((int16_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_UINT16:
+                  m_fft->FFT((uint16_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_INT32:
+                  m_fft->FFT((int32_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_UINT32:
+                  m_fft->FFT((uint32_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_INT64:
+                  m_fft->FFT((int64_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               case TERBIT_UINT64:
+                  m_fft->FFT((uint64_t*)m_dsIn->GetBufferAddress(),mtrx, m_dsIn->GetStrideBytes());
+                  break;
+               };
+            }
+            if (copied)
             {
-            case TERBIT_DOUBLE:
-               m_fft->FFT((double*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_FLOAT:
-               m_fft->FFT((float*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_INT8:
-               m_fft->FFT((int8_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_UINT8:
-               m_fft->FFT((uint8_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_INT16:
-               m_fft->FFT((int16_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_UINT16:
-               m_fft->FFT((uint16_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_INT32:
-               m_fft->FFT((int32_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_UINT32:
-               m_fft->FFT((uint32_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_INT64:
-               m_fft->FFT((int64_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            case TERBIT_UINT64:
-               m_fft->FFT((uint64_t*)m_dsIn->GetBufferAddress(),(double*)m_dsMtrx->GetBufferAddress());
-               break;
-            };
-            m_dsMtrx->SetHasData(true);
-            // Perform metrics
-            calculateMetrics();
-            processorUpdated();
+               // Perform metrics
+               calculateMetrics();
+            }
          }
       }
       catch(...)
       {
+         copied = false;
          LogError2(GetType()->GetLogCategory(),GetName(),tr("An exception occured while calculating the FFT."));
       }
       m_mutex.unlock();
+
+      if (copied)
+      {
+         QMetaObject::invokeMethod(this, "OnResultsReady", Qt::QueuedConnection);
+      }
    }
    else
    {
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tools/DisplayFFT.h"
 #include "tools/FrequencySignalMetrics.h"
 #include <QMutex>
+#include <vector>
 
 
 namespace terbit
@@ -145,6 +146,7 @@ private slots:
    void OnInputDataSetNameChanged(DataClass* dc);
    void OnNewData(DataClass* source);
    void OnPropertiesViewClosed();
+   void OnResultsReady();
 
 signals:
    void ProcUpdated();
@@ -167,6 +169,9 @@ private:
    DataSet* m_dsMtrx   = NULL;
    DataSet* m_dsFFTHz  = NULL;
    DataSet* m_dsFFTOut = NULL;
+   std::vector<double> m_input; // contiguous copy of an input that isn't one buffer
+   std::vector<double> m_mtrx;       // worker's FFT output, copied to m_dsMtrx on the GUI thread
+   std::vector<double> m_metricsOut; // worker's metrics output, copied to m_dsFFTOut
    SigMtrxScaleUnits_t m_dBScaleFFT = dBc;
    bool m_autoUpdateSamplingRate = false;
    double m_samplingRateHz = 100000000;
@@ -0,0 +1,259 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "BufferPool.h"
+#include <stdlib.h>
+#include <iterator>
+
+#if _WINDOWS
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace terbit
+{
+
+BufferPool& BufferPool::Instance(void)
+{
+   // never deleted, data sets may release their buffers during static destruction
+   static BufferPool* pool = new BufferPool();
+   return *pool;
+}
+
+BufferPool::BufferPool()
+{
+}
+
+// up to 4 KB in steps of 64 bytes, then 4 classes per power of two
+size_t BufferPool::SizeClass(size_t bytes)
+{
+   if(bytes <= 4096)
+   {
+      return bytes <= BUFFER_POOL_ALIGN_BYTES ? BUFFER_POOL_ALIGN_BYTES : (bytes + BUFFER_POOL_ALIGN_BYTES - 1) & ~(BUFFER_POOL_ALIGN_BYTES - 1);
+   }
+
+   // 2^s < bytes <= 2^(s+1)
+   size_t s = 0;
+   for(size_t n = bytes - 1; n > 1; n >>= 1)
+   {
+      ++s;
+   }
+   size_t step = (size_t)1 << (s - 2);
+   return (bytes + step - 1) & ~(step - 1);
+}
+
+void* BufferPool::Allocate(size_t bytes, size_t& capacity)
+{
+   Block_t b;
+   b.bytes = SizeClass(bytes);
+
+   QMutexLocker lock(&m_mutex);
+   auto it = m_cache.find(b.bytes);
+   if(it != m_cache.end())
+   {
+      b = it->second.back();
+      it->second.pop_back();
+      if(it->second.empty())
+      {
+         m_cache.erase(it);
+      }
+      m_bytesCached -= b.bytes;
+      ++m_hits;
+   }
+   else
+   {
+      ++m_misses;
+      if(!osAlloc(b))
+      {
+         // the cache may be holding the memory we need
+         trimTo(0);
+         if(!osAlloc(b))
+         {
+            capacity = 0;
+            return NULL;
+         }
+      }
+   }
+
+   m_inUse[b.data] = b;
+   m_bytesInUse += b.bytes;
+   capacity = b.bytes;
+   return b.data;
+}
+
+void BufferPool::Release(void* p)
+{
+   if(NULL == p)
+   {
+      return;
+   }
+
+   QMutexLocker lock(&m_mutex);
+   auto it = m_inUse.find(p);
+   if(it == m_inUse.end())
+   {
+      return;
+   }
+   Block_t b = it->second;
+   m_inUse.erase(it);
+   m_bytesInUse -= b.bytes;
+
+   if(b.bytes > m_cacheLimit)
+   {
+      osFree(b);
+      return;
+   }
+   trimTo(m_cacheLimit - b.bytes);
+   m_cache[b.bytes].push_back(b);
+   m_bytesCached += b.bytes;
+}
+
+void BufferPool::Trim(void)
+{
+   QMutexLocker lock(&m_mutex);
+   trimTo(0);
+}
+
+void BufferPool::SetCacheLimit(uint64_t bytes)
+{
+   QMutexLocker lock(&m_mutex);
+   m_cacheLimit = bytes;
+   trimTo(bytes);
+}
+
+void BufferPool::SetHugePages(HugePages_t h)
+{
+   QMutexLocker lock(&m_mutex);
+   m_huge = h;
+}
+
+BufferPool::Stats_t BufferPool::GetStats(void)
+{
+   Stats_t s;
+   QMutexLocker lock(&m_mutex);
+   s.bytesInUse  = m_bytesInUse;
+   s.bytesCached = m_bytesCached;
+   s.cacheLimit  = m_cacheLimit;
+   s.hits        = m_hits;
+   s.misses      = m_misses;
+   s.hugePages   = m_huge;
+   uint64_t n = m_hits + m_misses;
+   s.hitRate = n ? (double)m_hits / n : 0.0;
+   return s;
+}
+
+// frees cached blocks, largest first, until at most bytes are cached
+void BufferPool::trimTo(uint64_t bytes)
+{
+   while(m_bytesCached > bytes && !m_cache.empty())
+   {
+      auto it = std::prev(m_cache.end());
+      osFree(it->second.back());
+      m_bytesCached -= it->second.back().bytes;
+      it->second.pop_back();
+      if(it->second.empty())
+      {
+         m_cache.erase(it);
+      }
+   }
+}
+
+bool BufferPool::osAlloc(Block_t& b)
+{
+   b.data = NULL;
+   b.mapBytes = 0;
+
+#if _WINDOWS
+   b.data = _aligned_malloc(b.bytes, BUFFER_POOL_ALIGN_BYTES);
+   return NULL != b.data;
+#else
+   if(b.bytes < BUFFER_POOL_MAP_BYTES)
+   {
+      if(0 != posix_memalign(&b.data, BUFFER_POOL_ALIGN_BYTES, b.bytes))
+      {
+         b.data = NULL;
+      }
+      return NULL != b.data;
+   }
+
+#ifdef MAP_HUGETLB
+   if(HugeExplicit == m_huge)
+   {
+      // the length has to be whole huge pages
+      size_t n = (b.bytes + BUFFER_POOL_HUGE_PAGE_BYTES - 1) & ~(BUFFER_POOL_HUGE_PAGE_BYTES - 1);
+      void* p = mmap(NULL, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if(MAP_FAILED != p)
+      {
+         b.data = p;
+         b.mapBytes = n;
+         return true;
+      }
+   }
+#endif
+
+   // map an extra huge page and trim it so the block starts on a huge page
+   // boundary, otherwise only its interior could use huge pages
+   bool thp = HugeOff != m_huge && b.bytes >= BUFFER_POOL_HUGE_PAGE_BYTES;
+   size_t n = b.bytes + (thp ? BUFFER_POOL_HUGE_PAGE_BYTES : 0);
+   char* p = (char*)mmap(NULL, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if(MAP_FAILED == (void*)p)
+   {
+      return false;
+   }
+
+   if(thp)
+   {
+      char* aligned = (char*)(((uintptr_t)p + BUFFER_POOL_HUGE_PAGE_BYTES - 1) & ~(uintptr_t)(BUFFER_POOL_HUGE_PAGE_BYTES - 1));
+      size_t head = aligned - p;
+      size_t tail = n - head - b.bytes;
+      if(head)
+      {
+         munmap(p, head);
+      }
+      if(tail)
+      {
+         munmap(aligned + b.bytes, tail);
+      }
+      p = aligned;
+      n = b.bytes;
+#ifdef MADV_HUGEPAGE
+      madvise(p, n, MADV_HUGEPAGE);
+#endif
+   }
+
+   b.data = p;
+   b.mapBytes = n;
+   return true;
+#endif
+}
+
+void BufferPool::osFree(const Block_t& b)
+{
+#if _WINDOWS
+   _aligned_free(b.data);
+#else
+   if(b.mapBytes)
+   {
+      munmap(b.data, b.mapBytes);
+   }
+   else
+   {
+      free(b.data);
+   }
+#endif
+}
+
+}// namespace terbit
@@ -0,0 +1,109 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <QMutex>
+
+namespace terbit
+{
+
+static const size_t   BUFFER_POOL_ALIGN_BYTES     = 64;
+static const size_t   BUFFER_POOL_MAP_BYTES       = 1024*1024;
+static const size_t   BUFFER_POOL_HUGE_PAGE_BYTES = 2*1024*1024;
+static const uint64_t BUFFER_POOL_DEFAULT_CACHE   = 256*1024*1024;
+
+/*** Process wide allocator for large, long lived buffers such as the
+ * managed data set buffers.  Requests round up to a size class (4 classes
+ * per power of two, at most 25% slack) and released blocks are kept per
+ * class for the next allocation of that class, up to the cache limit, so a
+ * source that keeps changing structure stops going back to the OS.
+ * Blocks are 64 byte aligned.  Blocks of BUFFER_POOL_MAP_BYTES and up are
+ * mapped straight from the OS (page aligned) and may use huge pages:
+ * o HugeOff      - normal pages
+ * o HugeAdvise   - transparent huge pages, 2 MB aligned with madvise(MADV_HUGEPAGE)
+ * o HugeExplicit - MAP_HUGETLB from the reserved huge page pool, falls back
+ *                  to HugeAdvise when none are free
+ * Windows uses aligned heap blocks of the same size classes.
+ **************************************************************/
+class BufferPool
+{
+public:
+   typedef enum
+   {
+      HugeOff,
+      HugeAdvise,
+      HugeExplicit
+   }HugePages_t;
+
+   typedef struct
+   {
+      uint64_t    bytesInUse;
+      uint64_t    bytesCached;
+      uint64_t    cacheLimit;
+      uint64_t    hits;
+      uint64_t    misses;
+      double      hitRate;   // 0-1
+      HugePages_t hugePages;
+   }Stats_t;
+
+   static BufferPool& Instance(void);
+
+   // capacity returns the usable size (the size class), NULL when out of memory
+   void* Allocate(size_t bytes, size_t& capacity);
+   void  Release(void* p);
+   // return every cached block to the OS
+   void  Trim(void);
+
+   void    SetCacheLimit(uint64_t bytes);
+   void    SetHugePages(HugePages_t h);
+   // one consistent snapshot, the counters change on any thread
+   Stats_t GetStats(void);
+
+   static size_t SizeClass(size_t bytes);
+
+private:
+   BufferPool();
+   BufferPool(const BufferPool& o); //disable copy ctor
+
+   typedef struct
+   {
+      void*  data;
+      size_t bytes;    // size class
+      size_t mapBytes; // length of the mapping, 0 for a heap block
+   }Block_t;
+
+   bool osAlloc(Block_t& b);
+   void osFree(const Block_t& b);
+   void trimTo(uint64_t bytes);
+
+   QMutex      m_mutex;
+   uint64_t    m_cacheLimit  = BUFFER_POOL_DEFAULT_CACHE;
+   HugePages_t m_huge        = HugeAdvise;
+   uint64_t    m_bytesInUse  = 0;
+   uint64_t    m_bytesCached = 0;
+   uint64_t    m_hits        = 0;
+   uint64_t    m_misses      = 0;
+
+   std::unordered_map<void*, Block_t>          m_inUse;
+   std::map<size_t, std::vector<Block_t>>      m_cache; // by size class
+};
+
+}// namespace terbit
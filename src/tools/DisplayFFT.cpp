@@ -205,7 +205,7 @@ void CalcOutput(DisplayFFT::OutputType type, size_t N, kiss_fft_cpx*out, DataTyp
 }
 
 template<typename DataType>
-void DisplayFFT::CalcFFT(const DataType* input)
+void DisplayFFT::CalcFFT(const DataType* input, size_t strideBytes)
 {   
    size_t i, len;
    double* dataScalar;
@@ -225,10 +225,22 @@ void DisplayFFT::CalcFFT(const DataType* input)
 
    //copy input data to buffer
    double mean = 0;
-   for(i=0, dataScalar = in, dataInput = input ; i < len; ++i, ++dataInput, ++dataScalar)
+   if (strideBytes == sizeof(DataType))
    {
-      *dataScalar = (double)*dataInput;
-      mean += *dataScalar;
+      for(i=0, dataScalar = in, dataInput = input ; i < len; ++i, ++dataInput, ++dataScalar)
+      {
+         *dataScalar = (double)*dataInput;
+         mean += *dataScalar;
+      }
+   }
+   else
+   {
+      //strided view, deinterleave while copying
+      for(i=0, dataScalar = in, dataInput = input ; i < len; ++i, dataInput = (const DataType*)((const char*)dataInput + strideBytes), ++dataScalar)
+      {
+         *dataScalar = (double)*dataInput;
+         mean += *dataScalar;
+      }
    }
    mean /= len;
    if (m_removeDC)
@@ -247,117 +259,117 @@ void DisplayFFT::CalcFFT(const DataType* input)
    kiss_fftr(m_cfg, m_in, m_out);
 }
 
-void DisplayFFT::FFT(const float *input, float *output)
+void DisplayFFT::FFT(const float *input, float *output, size_t strideBytes)
 {
-   CalcFFT<float>(input);
+   CalcFFT<float>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int8_t *input, float *output)
+void DisplayFFT::FFT(const int8_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<int8_t>(input);
+   CalcFFT<int8_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint8_t *input, float *output)
+void DisplayFFT::FFT(const uint8_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<uint8_t>(input);
+   CalcFFT<uint8_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int16_t *input, float *output)
+void DisplayFFT::FFT(const int16_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<int16_t>(input);
+   CalcFFT<int16_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint16_t *input, float *output)
+void DisplayFFT::FFT(const uint16_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<uint16_t>(input);
+   CalcFFT<uint16_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int32_t *input, float *output)
+void DisplayFFT::FFT(const int32_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<int32_t>(input);
+   CalcFFT<int32_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint32_t *input, float *output)
+void DisplayFFT::FFT(const uint32_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<uint32_t>(input);
+   CalcFFT<uint32_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int64_t *input, float *output)
+void DisplayFFT::FFT(const int64_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<int64_t>(input);
+   CalcFFT<int64_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint64_t *input, float *output)
+void DisplayFFT::FFT(const uint64_t *input, float *output, size_t strideBytes)
 {
-   CalcFFT<uint64_t>(input);
+   CalcFFT<uint64_t>(input, strideBytes);
    CalcOutput<float>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int8_t *input, double *output)
+void DisplayFFT::FFT(const int8_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<int8_t>(input);
+   CalcFFT<int8_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint8_t *input, double *output)
+void DisplayFFT::FFT(const uint8_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<uint8_t>(input);
+   CalcFFT<uint8_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int16_t *input, double *output)
+void DisplayFFT::FFT(const int16_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<int16_t>(input);
+   CalcFFT<int16_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint16_t *input, double *output)
+void DisplayFFT::FFT(const uint16_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<uint16_t>(input);
+   CalcFFT<uint16_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int32_t *input, double *output)
+void DisplayFFT::FFT(const int32_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<int32_t>(input);
+   CalcFFT<int32_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint32_t *input, double *output)
+void DisplayFFT::FFT(const uint32_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<uint32_t>(input);
+   CalcFFT<uint32_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const int64_t *input, double *output)
+void DisplayFFT::FFT(const int64_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<int64_t>(input);
+   CalcFFT<int64_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const uint64_t *input, double *output)
+void DisplayFFT::FFT(const uint64_t *input, double *output, size_t strideBytes)
 {
-   CalcFFT<uint64_t>(input);
+   CalcFFT<uint64_t>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const float *input, double *output)
+void DisplayFFT::FFT(const float *input, double *output, size_t strideBytes)
 {
-   CalcFFT<float>(input);
+   CalcFFT<float>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
-void DisplayFFT::FFT(const double *input, double *output)
+void DisplayFFT::FFT(const double *input, double *output, size_t strideBytes)
 {
-   CalcFFT<double>(input);
+   CalcFFT<double>(input, strideBytes);
    CalcOutput<double>(m_outputType,m_N, m_out,output, m_samplingRate);
 }
 
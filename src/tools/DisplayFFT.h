@@ -41,6 +41,9 @@ namespace terbit
  *  y=20*log10(2*abs(fft(data))/N)
  *
  *
+ *  Input may be strided (e.g. one channel of interleaved data), it is copied into the FFT buffer anyway.
+ *
+ *
  *  Power Spectral Density output
  *  --------------------------------------------------------------------------------------------------
  *  y=10*log10(abs(fft(data))^2/(N*SamplingRate))
@@ -89,30 +92,30 @@ public:
    OutputType GetOutputType() { return m_outputType; }
    void SetOutputType(OutputType outputType) { m_outputType = outputType; }
 
-   void FFT(const int8_t* input, float* output);
-   void FFT(const uint8_t* input, float* output);
-   void FFT(const int16_t* input, float* output);
-   void FFT(const uint16_t* input, float* output);
-   void FFT(const int32_t* input, float* output);
-   void FFT(const uint32_t* input, float* output);
-   void FFT(const int64_t* input, float* output);
-   void FFT(const uint64_t* input, float* output);
-   void FFT(const float* input, float* output);
-
-   void FFT(const int8_t* input, double* output);
-   void FFT(const uint8_t* input, double* output);
-   void FFT(const int16_t* input, double* output);
-   void FFT(const uint16_t* input, double* output);
-   void FFT(const int32_t* input, double* output);
-   void FFT(const uint32_t* input, double* output);
-   void FFT(const int64_t* input, double* output);
-   void FFT(const uint64_t* input, double* output);
-   void FFT(const float* input, double* output);
-   void FFT(const double* input, double* output);
+   void FFT(const int8_t* input, float* output, size_t strideBytes = sizeof(int8_t));
+   void FFT(const uint8_t* input, float* output, size_t strideBytes = sizeof(uint8_t));
+   void FFT(const int16_t* input, float* output, size_t strideBytes = sizeof(int16_t));
+   void FFT(const uint16_t* input, float* output, size_t strideBytes = sizeof(uint16_t));
+   void FFT(const int32_t* input, float* output, size_t strideBytes = sizeof(int32_t));
+   void FFT(const uint32_t* input, float* output, size_t strideBytes = sizeof(uint32_t));
+   void FFT(const int64_t* input, float* output, size_t strideBytes = sizeof(int64_t));
+   void FFT(const uint64_t* input, float* output, size_t strideBytes = sizeof(uint64_t));
+   void FFT(const float* input, float* output, size_t strideBytes = sizeof(float));
+
+   void FFT(const int8_t* input, double* output, size_t strideBytes = sizeof(int8_t));
+   void FFT(const uint8_t* input, double* output, size_t strideBytes = sizeof(uint8_t));
+   void FFT(const int16_t* input, double* output, size_t strideBytes = sizeof(int16_t));
+   void FFT(const uint16_t* input, double* output, size_t strideBytes = sizeof(uint16_t));
+   void FFT(const int32_t* input, double* output, size_t strideBytes = sizeof(int32_t));
+   void FFT(const uint32_t* input, double* output, size_t strideBytes = sizeof(uint32_t));
+   void FFT(const int64_t* input, double* output, size_t strideBytes = sizeof(int64_t));
+   void FFT(const uint64_t* input, double* output, size_t strideBytes = sizeof(uint64_t));
+   void FFT(const float* input, double* output, size_t strideBytes = sizeof(float));
+   void FFT(const double* input, double* output, size_t strideBytes = sizeof(double));
 
 private:
    template<typename DataType>
-   void CalcFFT(const DataType* input);
+   void CalcFFT(const DataType* input, size_t strideBytes);
    bool UpdateBuffers();
 
    size_t m_N, m_inputLen;
@@ -0,0 +1,767 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "MinMax.h"
+#include <vector>
+#include <boost/thread.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TERBIT_MINMAX_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 code is compiled per function so the rest of the build keeps its
+// baseline instruction set; MSVC allows the intrinsics without flags.
+#if defined(__GNUC__) || defined(__clang__)
+#define TERBIT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TERBIT_TARGET_AVX2
+#endif
+
+namespace terbit
+{
+
+// Buffers at least this big are split across threads, each thread getting
+// at least MINMAX_MIN_CHUNK_BYTES.
+static const size_t MINMAX_PARALLEL_BYTES  = 8*1024*1024;
+static const size_t MINMAX_MIN_CHUNK_BYTES = 2*1024*1024;
+
+// Strided data that can't be gathered is copied out this many elements at
+// a time (stays in L1) and run through the contiguous kernel.
+static const size_t MINMAX_PACK_ELTS = 512;
+// Gather indices are 32 bit lane offsets
+static const size_t MINMAX_MAX_GATHER_STRIDE = 0x7fffffff / 8;
+
+typedef enum
+{
+   MinMaxScalar,
+   MinMaxSse2,
+   MinMaxAvx2
+}MinMaxLevel_t;
+
+// Kernels update mn/mx in place; callers seed them with the first element
+// of the whole buffer so every chunk sees the same NaN behavior.
+template<typename T>
+struct MinMaxKernel
+{
+   typedef void (*Fn)(const T* data, size_t count, T& mn, T& mx);
+};
+
+template<typename T>
+struct MinMaxGatherKernel
+{
+   typedef void (*Fn)(const T* data, size_t count, size_t strideElts, T& mn, T& mx);
+};
+
+template<typename T>
+static void minMaxScalar(const T* data, size_t count, T& mn, T& mx)
+{
+   for(size_t i = 0; i < count; ++i)
+   {
+      T value = data[i];
+      if(value < mn)
+      {
+         mn = value;
+      }
+      if(value > mx)
+      {
+         mx = value;
+      }
+   }
+}
+
+#if TERBIT_MINMAX_X86
+
+// Two accumulator pairs to hide the min/max latency, then a scalar pass over
+// the lanes and the tail.  Ops::Min/Max take the new data first so NaN data
+// leaves the float accumulators alone.
+#define TERBIT_MINMAX_SIMD_KERNEL(NAME, ATTR) \
+template<typename Ops> ATTR \
+static void NAME(const typename Ops::T* data, size_t count, typename Ops::T& mn, typename Ops::T& mx) \
+{ \
+   typedef typename Ops::T T; \
+   typedef typename Ops::V V; \
+   const size_t lanes = sizeof(V) / sizeof(T); \
+   size_t i = 0; \
+   if(count >= 2 * lanes) \
+   { \
+      V mn0 = Ops::Set1(mn), mx0 = Ops::Set1(mx); \
+      V mn1 = mn0, mx1 = mx0; \
+      for(; i + 2 * lanes <= count; i += 2 * lanes) \
+      { \
+         V a = Ops::Load(data + i); \
+         V b = Ops::Load(data + i + lanes); \
+         mn0 = Ops::Min(a, mn0); \
+         mx0 = Ops::Max(a, mx0); \
+         mn1 = Ops::Min(b, mn1); \
+         mx1 = Ops::Max(b, mx1); \
+      } \
+      mn0 = Ops::Min(mn1, mn0); \
+      mx0 = Ops::Max(mx1, mx0); \
+      T lmn[sizeof(V) / sizeof(T)], lmx[sizeof(V) / sizeof(T)]; \
+      Ops::Store(lmn, mn0); \
+      Ops::Store(lmx, mx0); \
+      minMaxScalar(lmn, lanes, mn, mx); \
+      minMaxScalar(lmx, lanes, mn, mx); \
+   } \
+   minMaxScalar(data + i, count - i, mn, mx); \
+}
+
+TERBIT_MINMAX_SIMD_KERNEL(minMaxSse2, )
+TERBIT_MINMAX_SIMD_KERNEL(minMaxAvx2, TERBIT_TARGET_AVX2)
+
+// ---------------------------------- SSE2 ----------------------------------
+// SSE2 only has unsigned 8 bit and signed 16 bit min/max, other small
+// integers are biased into those; 32 bit integers use compare and select.
+
+static inline __m128i sse2Select(__m128i mask, __m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+struct Sse2U8
+{
+   typedef uint8_t T;
+   typedef __m128i V;
+   static V Set1(T v){return _mm_set1_epi8((char)v);}
+   static V Load(const T* p){return _mm_loadu_si128((const __m128i*)p);}
+   static void Store(T* p, V v){_mm_storeu_si128((__m128i*)p, v);}
+   static V Min(V a, V b){return _mm_min_epu8(a, b);}
+   static V Max(V a, V b){return _mm_max_epu8(a, b);}
+};
+
+struct Sse2I8
+{
+   typedef int8_t T;
+   typedef __m128i V;
+   static V Bias(){return _mm_set1_epi8((char)0x80);}
+   static V Set1(T v){return _mm_xor_si128(_mm_set1_epi8(v), Bias());}
+   static V Load(const T* p){return _mm_xor_si128(_mm_loadu_si128((const __m128i*)p), Bias());}
+   static void Store(T* p, V v){_mm_storeu_si128((__m128i*)p, _mm_xor_si128(v, Bias()));}
+   static V Min(V a, V b){return _mm_min_epu8(a, b);}
+   static V Max(V a, V b){return _mm_max_epu8(a, b);}
+};
+
+struct Sse2I16
+{
+   typedef int16_t T;
+   typedef __m128i V;
+   static V Set1(T v){return _mm_set1_epi16(v);}
+   static V Load(const T* p){return _mm_loadu_si128((const __m128i*)p);}
+   static void Store(T* p, V v){_mm_storeu_si128((__m128i*)p, v);}
+   static V Min(V a, V b){return _mm_min_epi16(a, b);}
+   static V Max(V a, V b){return _mm_max_epi16(a, b);}
+};
+
+struct Sse2U16
+{
+   typedef uint16_t T;
+   typedef __m128i V;
+   static V Bias(){return _mm_set1_epi16((short)0x8000);}
+   static V Set1(T v){return _mm_xor_si128(_mm_set1_epi16((short)v), Bias());}
+   static V Load(const T* p){return _mm_xor_si128(_mm_loadu_si128((const __m128i*)p), Bias());}
+   static void Store(T* p, V v){_mm_storeu_si128((__m128i*)p, _mm_xor_si128(v, Bias()));}
+   static V Min(V a, V b){return _mm_min_epi16(a, b);}
+   static V Max(V a, V b){return _mm_max_epi16(a, b);}
+};
+
+struct Sse2I32
+{
+   typedef int32_t T;
+   typedef __m128i V;
+   static V Set1(T v){return _mm_set1_epi32(v);}
+   static V Load(const T* p){return _mm_loadu_si128((const __m128i*)p);}
+   static void Store(T* p, V v){_mm_storeu_si128((__m128i*)p, v);}
+   static V Min(V a, V b){return sse2Select(_mm_cmpgt_epi32(a, b), b, a);}
+   static V Max(V a, V b){return sse2Select(_mm_cmpgt_epi32(a, b), a, b);}
+};
+
+struct Sse2U32
+{
+   typedef uint32_t T;
+   typedef __m128i V;
+   static V Bias(){return _mm_set1_epi32((int)0x80000000);}
+   static V Set1(T v){return _mm_xor_si128(_mm_set1_epi32((int)v), Bias());}
+   static V Load(const T* p){return _mm_xor_si128(_mm_loadu_si128((const __m128i*)p), Bias());}
+   static void Store(T* p, V v){_mm_storeu_si128((__m128i*)p, _mm_xor_si128(v, Bias()));}
+   static V Min(V a, V b){return sse2Select(_mm_cmpgt_epi32(a, b), b, a);}
+   static V Max(V a, V b){return sse2Select(_mm_cmpgt_epi32(a, b), a, b);}
+};
+
+struct Sse2F32
+{
+   typedef float T;
+   typedef __m128 V;
+   static V Set1(T v){return _mm_set1_ps(v);}
+   static V Load(const T* p){return _mm_loadu_ps(p);}
+   static void Store(T* p, V v){_mm_storeu_ps(p, v);}
+   static V Min(V a, V b){return _mm_min_ps(a, b);}
+   static V Max(V a, V b){return _mm_max_ps(a, b);}
+};
+
+struct Sse2F64
+{
+   typedef double T;
+   typedef __m128d V;
+   static V Set1(T v){return _mm_set1_pd(v);}
+   static V Load(const T* p){return _mm_loadu_pd(p);}
+   static void Store(T* p, V v){_mm_storeu_pd(p, v);}
+   static V Min(V a, V b){return _mm_min_pd(a, b);}
+   static V Max(V a, V b){return _mm_max_pd(a, b);}
+};
+
+// ---------------------------------- AVX2 ----------------------------------
+// Native min/max for 8-32 bit integers; 64 bit integers use compare and
+// blend (unsigned biased into signed).
+
+struct Avx2U8
+{
+   typedef uint8_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_epi8((char)v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_si256((const __m256i*)p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_epu8(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_epu8(a, b);}
+};
+
+struct Avx2I8
+{
+   typedef int8_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_epi8(v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_si256((const __m256i*)p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_epi8(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_epi8(a, b);}
+};
+
+struct Avx2U16
+{
+   typedef uint16_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_epi16((short)v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_si256((const __m256i*)p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_epu16(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_epu16(a, b);}
+};
+
+struct Avx2I16
+{
+   typedef int16_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_epi16(v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_si256((const __m256i*)p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_epi16(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_epi16(a, b);}
+};
+
+struct Avx2U32
+{
+   typedef uint32_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_epi32((int)v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_si256((const __m256i*)p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_epu32(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_epu32(a, b);}
+};
+
+struct Avx2I32
+{
+   typedef int32_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_epi32(v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_si256((const __m256i*)p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_epi32(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_epi32(a, b);}
+};
+
+struct Avx2I64
+{
+   typedef int64_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_epi64x(v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_si256((const __m256i*)p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));}
+};
+
+struct Avx2U64
+{
+   typedef uint64_t T;
+   typedef __m256i V;
+   TERBIT_TARGET_AVX2 static V Bias(){return _mm256_set1_epi64x((long long)0x8000000000000000ULL);}
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_xor_si256(_mm256_set1_epi64x((long long)v), Bias());}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)p), Bias());}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_si256((__m256i*)p, _mm256_xor_si256(v, Bias()));}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));}
+};
+
+struct Avx2F32
+{
+   typedef float T;
+   typedef __m256 V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_ps(v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_ps(p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_ps(p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_ps(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_ps(a, b);}
+};
+
+struct Avx2F64
+{
+   typedef double T;
+   typedef __m256d V;
+   TERBIT_TARGET_AVX2 static V Set1(T v){return _mm256_set1_pd(v);}
+   TERBIT_TARGET_AVX2 static V Load(const T* p){return _mm256_loadu_pd(p);}
+   TERBIT_TARGET_AVX2 static void Store(T* p, V v){_mm256_storeu_pd(p, v);}
+   TERBIT_TARGET_AVX2 static V Min(V a, V b){return _mm256_min_pd(a, b);}
+   TERBIT_TARGET_AVX2 static V Max(V a, V b){return _mm256_max_pd(a, b);}
+};
+
+// Gather versions load one lane per element at data + lane*stride.  Same
+// accumulator scheme as the contiguous kernels.
+template<typename Ops> TERBIT_TARGET_AVX2
+static void minMaxGatherAvx2(const typename Ops::T* data, size_t count, size_t strideElts, typename Ops::T& mn, typename Ops::T& mx)
+{
+   typedef typename Ops::T T;
+   typedef typename Ops::V V;
+   const size_t lanes = sizeof(V) / sizeof(T);
+   size_t i = 0;
+   if(count >= 2 * lanes)
+   {
+      __m256i idx = Ops::Index(strideElts);
+      V mn0 = Ops::Set1(mn), mx0 = Ops::Set1(mx);
+      V mn1 = mn0, mx1 = mx0;
+      for(; i + 2 * lanes <= count; i += 2 * lanes)
+      {
+         V a = Ops::Gather(data + i * strideElts, idx);
+         V b = Ops::Gather(data + (i + lanes) * strideElts, idx);
+         mn0 = Ops::Min(a, mn0);
+         mx0 = Ops::Max(a, mx0);
+         mn1 = Ops::Min(b, mn1);
+         mx1 = Ops::Max(b, mx1);
+      }
+      mn0 = Ops::Min(mn1, mn0);
+      mx0 = Ops::Max(mx1, mx0);
+      T lmn[sizeof(V) / sizeof(T)], lmx[sizeof(V) / sizeof(T)];
+      Ops::Store(lmn, mn0);
+      Ops::Store(lmx, mx0);
+      minMaxScalar(lmn, lanes, mn, mx);
+      minMaxScalar(lmx, lanes, mn, mx);
+   }
+   for(; i < count; ++i)
+   {
+      T value = data[i * strideElts];
+      minMaxScalar(&value, 1, mn, mx);
+   }
+}
+
+struct Avx2Index32
+{
+   TERBIT_TARGET_AVX2 static __m256i Index(size_t s){return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int)s));}
+};
+
+struct Avx2Index64
+{
+   TERBIT_TARGET_AVX2 static __m256i Index(size_t s){return _mm256_setr_epi64x(0, (long long)s, (long long)(2 * s), (long long)(3 * s));}
+};
+
+struct Avx2GatherI32 : Avx2I32, Avx2Index32
+{
+   TERBIT_TARGET_AVX2 static V Gather(const T* p, __m256i idx){return _mm256_i32gather_epi32((const int*)p, idx, 4);}
+};
+
+struct Avx2GatherU32 : Avx2U32, Avx2Index32
+{
+   TERBIT_TARGET_AVX2 static V Gather(const T* p, __m256i idx){return _mm256_i32gather_epi32((const int*)p, idx, 4);}
+};
+
+struct Avx2GatherF32 : Avx2F32, Avx2Index32
+{
+   TERBIT_TARGET_AVX2 static V Gather(const T* p, __m256i idx){return _mm256_i32gather_ps(p, idx, 4);}
+};
+
+struct Avx2GatherI64 : Avx2I64, Avx2Index64
+{
+   TERBIT_TARGET_AVX2 static V Gather(const T* p, __m256i idx){return _mm256_i64gather_epi64((const long long*)p, idx, 8);}
+};
+
+struct Avx2GatherU64 : Avx2U64, Avx2Index64
+{
+   TERBIT_TARGET_AVX2 static V Gather(const T* p, __m256i idx){return _mm256_xor_si256(_mm256_i64gather_epi64((const long long*)p, idx, 8), Bias());}
+};
+
+struct Avx2GatherF64 : Avx2F64, Avx2Index64
+{
+   TERBIT_TARGET_AVX2 static V Gather(const T* p, __m256i idx){return _mm256_i64gather_pd(p, idx, 8);}
+};
+
+#define MINMAX_SSE2(ops) &minMaxSse2<ops>
+#define MINMAX_AVX2(ops) &minMaxAvx2<ops>
+#define MINMAX_GATHER(ops) &minMaxGatherAvx2<ops>
+
+static MinMaxLevel_t detectLevel()
+{
+#if defined(_MSC_VER)
+   int info[4];
+   __cpuid(info, 0);
+   if(info[0] >= 7)
+   {
+      __cpuid(info, 1);
+      bool osxsave = 0 != (info[2] & (1 << 27));
+      __cpuidex(info, 7, 0);
+      bool avx2 = 0 != (info[1] & (1 << 5));
+      // the OS also has to save the YMM registers
+      if(avx2 && osxsave && 6 == (_xgetbv(0) & 6))
+      {
+         return MinMaxAvx2;
+      }
+   }
+   return MinMaxSse2;
+#else
+   __builtin_cpu_init();
+   if(__builtin_cpu_supports("avx2"))
+   {
+      return MinMaxAvx2;
+   }
+   return __builtin_cpu_supports("sse2") ? MinMaxSse2 : MinMaxScalar;
+#endif
+}
+
+#else // TERBIT_MINMAX_X86
+
+#define MINMAX_SSE2(ops) NULL
+#define MINMAX_AVX2(ops) NULL
+#define MINMAX_GATHER(ops) NULL
+
+static MinMaxLevel_t detectLevel()
+{
+   return MinMaxScalar;
+}
+
+#endif // TERBIT_MINMAX_X86
+
+static MinMaxLevel_t getLevel()
+{
+   static const MinMaxLevel_t level = detectLevel();
+   return level;
+}
+
+const char* GetMinMaxKernelName()
+{
+   switch(getLevel())
+   {
+   case MinMaxAvx2:
+      return "avx2";
+   case MinMaxSse2:
+      return "sse2";
+   default:
+      return "scalar";
+   }
+}
+
+template<typename T>
+static typename MinMaxKernel<T>::Fn selectKernel(typename MinMaxKernel<T>::Fn sse2, typename MinMaxKernel<T>::Fn avx2)
+{
+   typename MinMaxKernel<T>::Fn retVal = &minMaxScalar<T>;
+   if(MinMaxAvx2 == getLevel() && NULL != avx2)
+   {
+      retVal = avx2;
+   }
+   else if(MinMaxScalar != getLevel() && NULL != sse2)
+   {
+      retVal = sse2;
+   }
+   return retVal;
+}
+
+template<typename T>
+static typename MinMaxGatherKernel<T>::Fn selectGather(typename MinMaxGatherKernel<T>::Fn avx2)
+{
+   return (MinMaxAvx2 == getLevel()) ? avx2 : NULL;
+}
+
+template<typename T>
+static void minMaxRun(const T* data, size_t count, T& mn, T& mx, typename MinMaxKernel<T>::Fn kernel)
+{
+   mn = mx = data[0];
+
+   size_t bytes = count * sizeof(T);
+   size_t nChunks = boost::thread::hardware_concurrency();
+   if(nChunks > bytes / MINMAX_MIN_CHUNK_BYTES)
+   {
+      nChunks = bytes / MINMAX_MIN_CHUNK_BYTES;
+   }
+
+   if(bytes >= MINMAX_PARALLEL_BYTES && nChunks > 1)
+   {
+      std::vector<T> mns(nChunks, mn), mxs(nChunks, mx);
+      size_t chunk = count / nChunks;
+      boost::thread_group threads;
+      for(size_t c = 1; c < nChunks; ++c)
+      {
+         size_t n = (c + 1 == nChunks) ? count - c * chunk : chunk;
+         threads.create_thread(boost::bind(kernel, data + c * chunk, n, boost::ref(mns[c]), boost::ref(mxs[c])));
+      }
+      kernel(data, chunk, mns[0], mxs[0]);
+      threads.join_all();
+
+      minMaxScalar(mns.data(), nChunks, mn, mx);
+      minMaxScalar(mxs.data(), nChunks, mn, mx);
+   }
+   else
+   {
+      kernel(data, count, mn, mx);
+   }
+}
+
+void MinMaxContiguous(const int8_t* data, size_t count, int8_t& mn, int8_t& mx)
+{
+   static const MinMaxKernel<int8_t>::Fn k = selectKernel<int8_t>(MINMAX_SSE2(Sse2I8), MINMAX_AVX2(Avx2I8));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const uint8_t* data, size_t count, uint8_t& mn, uint8_t& mx)
+{
+   static const MinMaxKernel<uint8_t>::Fn k = selectKernel<uint8_t>(MINMAX_SSE2(Sse2U8), MINMAX_AVX2(Avx2U8));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const int16_t* data, size_t count, int16_t& mn, int16_t& mx)
+{
+   static const MinMaxKernel<int16_t>::Fn k = selectKernel<int16_t>(MINMAX_SSE2(Sse2I16), MINMAX_AVX2(Avx2I16));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const uint16_t* data, size_t count, uint16_t& mn, uint16_t& mx)
+{
+   static const MinMaxKernel<uint16_t>::Fn k = selectKernel<uint16_t>(MINMAX_SSE2(Sse2U16), MINMAX_AVX2(Avx2U16));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const int32_t* data, size_t count, int32_t& mn, int32_t& mx)
+{
+   static const MinMaxKernel<int32_t>::Fn k = selectKernel<int32_t>(MINMAX_SSE2(Sse2I32), MINMAX_AVX2(Avx2I32));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const uint32_t* data, size_t count, uint32_t& mn, uint32_t& mx)
+{
+   static const MinMaxKernel<uint32_t>::Fn k = selectKernel<uint32_t>(MINMAX_SSE2(Sse2U32), MINMAX_AVX2(Avx2U32));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+// SSE2 has no 64 bit compare, those use scalar below AVX2
+void MinMaxContiguous(const int64_t* data, size_t count, int64_t& mn, int64_t& mx)
+{
+   static const MinMaxKernel<int64_t>::Fn k = selectKernel<int64_t>(NULL, MINMAX_AVX2(Avx2I64));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const uint64_t* data, size_t count, uint64_t& mn, uint64_t& mx)
+{
+   static const MinMaxKernel<uint64_t>::Fn k = selectKernel<uint64_t>(NULL, MINMAX_AVX2(Avx2U64));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const float* data, size_t count, float& mn, float& mx)
+{
+   static const MinMaxKernel<float>::Fn k = selectKernel<float>(MINMAX_SSE2(Sse2F32), MINMAX_AVX2(Avx2F32));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+void MinMaxContiguous(const double* data, size_t count, double& mn, double& mx)
+{
+   static const MinMaxKernel<double>::Fn k = selectKernel<double>(MINMAX_SSE2(Sse2F64), MINMAX_AVX2(Avx2F64));
+   minMaxRun(data, count, mn, mx, k);
+}
+
+// bool is stored as a 0/1 byte
+void MinMaxContiguous(const bool* data, size_t count, bool& mn, bool& mx)
+{
+   uint8_t bmn, bmx;
+   MinMaxContiguous((const uint8_t*)data, count, bmn, bmx);
+   mn = (0 != bmn);
+   mx = (0 != bmx);
+}
+
+template<typename T>
+static void minMaxStridedRun(const T* data, size_t count, size_t strideBytes, T& mn, T& mx,
+                             typename MinMaxKernel<T>::Fn kernel, typename MinMaxGatherKernel<T>::Fn gather)
+{
+   mn = mx = data[0];
+
+   if(NULL != gather && 0 == strideBytes % sizeof(T) && strideBytes / sizeof(T) <= MINMAX_MAX_GATHER_STRIDE)
+   {
+      gather(data, count, strideBytes / sizeof(T), mn, mx);
+   }
+   else
+   {
+      T block[MINMAX_PACK_ELTS];
+      const char* p = (const char*)data;
+      for(size_t i = 0; i < count; i += MINMAX_PACK_ELTS)
+      {
+         size_t n = (count - i < MINMAX_PACK_ELTS) ? count - i : MINMAX_PACK_ELTS;
+         for(size_t k = 0; k < n; ++k)
+         {
+            block[k] = *((const T*)p);
+            p += strideBytes;
+         }
+         kernel(block, n, mn, mx);
+      }
+   }
+}
+
+void MinMaxStrided(const int8_t* data, size_t count, size_t strideBytes, int8_t& mn, int8_t& mx)
+{
+   if(strideBytes == sizeof(int8_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<int8_t>::Fn k = selectKernel<int8_t>(MINMAX_SSE2(Sse2I8), MINMAX_AVX2(Avx2I8));
+   static const MinMaxGatherKernel<int8_t>::Fn g = selectGather<int8_t>(NULL);
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const uint8_t* data, size_t count, size_t strideBytes, uint8_t& mn, uint8_t& mx)
+{
+   if(strideBytes == sizeof(uint8_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<uint8_t>::Fn k = selectKernel<uint8_t>(MINMAX_SSE2(Sse2U8), MINMAX_AVX2(Avx2U8));
+   static const MinMaxGatherKernel<uint8_t>::Fn g = selectGather<uint8_t>(NULL);
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const int16_t* data, size_t count, size_t strideBytes, int16_t& mn, int16_t& mx)
+{
+   if(strideBytes == sizeof(int16_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<int16_t>::Fn k = selectKernel<int16_t>(MINMAX_SSE2(Sse2I16), MINMAX_AVX2(Avx2I16));
+   static const MinMaxGatherKernel<int16_t>::Fn g = selectGather<int16_t>(NULL);
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const uint16_t* data, size_t count, size_t strideBytes, uint16_t& mn, uint16_t& mx)
+{
+   if(strideBytes == sizeof(uint16_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<uint16_t>::Fn k = selectKernel<uint16_t>(MINMAX_SSE2(Sse2U16), MINMAX_AVX2(Avx2U16));
+   static const MinMaxGatherKernel<uint16_t>::Fn g = selectGather<uint16_t>(NULL);
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const int32_t* data, size_t count, size_t strideBytes, int32_t& mn, int32_t& mx)
+{
+   if(strideBytes == sizeof(int32_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<int32_t>::Fn k = selectKernel<int32_t>(MINMAX_SSE2(Sse2I32), MINMAX_AVX2(Avx2I32));
+   static const MinMaxGatherKernel<int32_t>::Fn g = selectGather<int32_t>(MINMAX_GATHER(Avx2GatherI32));
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const uint32_t* data, size_t count, size_t strideBytes, uint32_t& mn, uint32_t& mx)
+{
+   if(strideBytes == sizeof(uint32_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<uint32_t>::Fn k = selectKernel<uint32_t>(MINMAX_SSE2(Sse2U32), MINMAX_AVX2(Avx2U32));
+   static const MinMaxGatherKernel<uint32_t>::Fn g = selectGather<uint32_t>(MINMAX_GATHER(Avx2GatherU32));
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const int64_t* data, size_t count, size_t strideBytes, int64_t& mn, int64_t& mx)
+{
+   if(strideBytes == sizeof(int64_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<int64_t>::Fn k = selectKernel<int64_t>(NULL, MINMAX_AVX2(Avx2I64));
+   static const MinMaxGatherKernel<int64_t>::Fn g = selectGather<int64_t>(MINMAX_GATHER(Avx2GatherI64));
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const uint64_t* data, size_t count, size_t strideBytes, uint64_t& mn, uint64_t& mx)
+{
+   if(strideBytes == sizeof(uint64_t))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<uint64_t>::Fn k = selectKernel<uint64_t>(NULL, MINMAX_AVX2(Avx2U64));
+   static const MinMaxGatherKernel<uint64_t>::Fn g = selectGather<uint64_t>(MINMAX_GATHER(Avx2GatherU64));
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const float* data, size_t count, size_t strideBytes, float& mn, float& mx)
+{
+   if(strideBytes == sizeof(float))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<float>::Fn k = selectKernel<float>(MINMAX_SSE2(Sse2F32), MINMAX_AVX2(Avx2F32));
+   static const MinMaxGatherKernel<float>::Fn g = selectGather<float>(MINMAX_GATHER(Avx2GatherF32));
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const double* data, size_t count, size_t strideBytes, double& mn, double& mx)
+{
+   if(strideBytes == sizeof(double))
+   {
+      MinMaxContiguous(data, count, mn, mx);
+      return;
+   }
+   static const MinMaxKernel<double>::Fn k = selectKernel<double>(MINMAX_SSE2(Sse2F64), MINMAX_AVX2(Avx2F64));
+   static const MinMaxGatherKernel<double>::Fn g = selectGather<double>(MINMAX_GATHER(Avx2GatherF64));
+   minMaxStridedRun(data, count, strideBytes, mn, mx, k, g);
+}
+
+void MinMaxStrided(const bool* data, size_t count, size_t strideBytes, bool& mn, bool& mx)
+{
+   uint8_t bmn, bmx;
+   MinMaxStrided((const uint8_t*)data, count, strideBytes, bmn, bmx);
+   mn = (0 != bmn);
+   mx = (0 != bmx);
+}
+
+}// namespace terbit
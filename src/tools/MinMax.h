@@ -0,0 +1,82 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+
+namespace terbit
+{
+
+/*** Min/max of a contiguous buffer.  Uses AVX2 or SSE2 kernels picked at
+ * runtime on x86 (scalar elsewhere) and splits very large buffers across
+ * threads.  Results match a scalar scan, including NaNs being skipped
+ * unless the first float/double element is a NaN.  count must be > 0.
+ **************************************************************/
+void MinMaxContiguous(const int8_t*   data, size_t count, int8_t&   mn, int8_t&   mx);
+void MinMaxContiguous(const uint8_t*  data, size_t count, uint8_t&  mn, uint8_t&  mx);
+void MinMaxContiguous(const int16_t*  data, size_t count, int16_t&  mn, int16_t&  mx);
+void MinMaxContiguous(const uint16_t* data, size_t count, uint16_t& mn, uint16_t& mx);
+void MinMaxContiguous(const int32_t*  data, size_t count, int32_t&  mn, int32_t&  mx);
+void MinMaxContiguous(const uint32_t* data, size_t count, uint32_t& mn, uint32_t& mx);
+void MinMaxContiguous(const int64_t*  data, size_t count, int64_t&  mn, int64_t&  mx);
+void MinMaxContiguous(const uint64_t* data, size_t count, uint64_t& mn, uint64_t& mx);
+void MinMaxContiguous(const float*    data, size_t count, float&    mn, float&    mx);
+void MinMaxContiguous(const double*   data, size_t count, double&   mn, double&   mx);
+void MinMaxContiguous(const bool*     data, size_t count, bool&     mn, bool&     mx);
+
+// Unsigned types that are distinct from the fixed width ones on some
+// platforms (size_t on macOS)
+template<typename T>
+inline void MinMaxContiguous(const T* data, size_t count, T& mn, T& mx)
+{
+   static_assert(std::is_unsigned<T>::value && (sizeof(T) == 4 || sizeof(T) == 8), "MinMaxContiguous unsupported type");
+   typedef typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type U;
+   MinMaxContiguous((const U*)data, count, (U&)mn, (U&)mx);
+}
+
+/*** Min/max of every strideBytes in a buffer, e.g. one channel of
+ * interleaved data.  32 and 64 bit types use AVX2 gathers when the stride
+ * is a whole number of elements, others are packed a block at a time into
+ * the contiguous kernels.  Same results as MinMaxContiguous.
+ **************************************************************/
+void MinMaxStrided(const int8_t*   data, size_t count, size_t strideBytes, int8_t&   mn, int8_t&   mx);
+void MinMaxStrided(const uint8_t*  data, size_t count, size_t strideBytes, uint8_t&  mn, uint8_t&  mx);
+void MinMaxStrided(const int16_t*  data, size_t count, size_t strideBytes, int16_t&  mn, int16_t&  mx);
+void MinMaxStrided(const uint16_t* data, size_t count, size_t strideBytes, uint16_t& mn, uint16_t& mx);
+void MinMaxStrided(const int32_t*  data, size_t count, size_t strideBytes, int32_t&  mn, int32_t&  mx);
+void MinMaxStrided(const uint32_t* data, size_t count, size_t strideBytes, uint32_t& mn, uint32_t& mx);
+void MinMaxStrided(const int64_t*  data, size_t count, size_t strideBytes, int64_t&  mn, int64_t&  mx);
+void MinMaxStrided(const uint64_t* data, size_t count, size_t strideBytes, uint64_t& mn, uint64_t& mx);
+void MinMaxStrided(const float*    data, size_t count, size_t strideBytes, float&    mn, float&    mx);
+void MinMaxStrided(const double*   data, size_t count, size_t strideBytes, double&   mn, double&   mx);
+void MinMaxStrided(const bool*     data, size_t count, size_t strideBytes, bool&     mn, bool&     mx);
+
+template<typename T>
+inline void MinMaxStrided(const T* data, size_t count, size_t strideBytes, T& mn, T& mx)
+{
+   static_assert(std::is_unsigned<T>::value && (sizeof(T) == 4 || sizeof(T) == 8), "MinMaxStrided unsupported type");
+   typedef typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type U;
+   MinMaxStrided((const U*)data, count, strideBytes, (U&)mn, (U&)mx);
+}
+
+// Name of the kernel set in use ("avx2", "sse2" or "scalar")
+const char* GetMinMaxKernelName();
+
+}// namespace terbit
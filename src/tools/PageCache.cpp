@@ -0,0 +1,315 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "PageCache.h"
+#include <algorithm>
+#include <iterator>
+
+#if !_WINDOWS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace terbit
+{
+
+PageCache::PageCache()
+{
+}
+
+PageCache::~PageCache()
+{
+   Close();
+}
+
+// length 0 maps to the end of the file
+bool PageCache::Open(const QString& filename, uint64_t offset, uint64_t length, size_t pageBytes, uint64_t budgetBytes)
+{
+   Close();
+
+   QMutexLocker lock(&m_mutex);
+   m_file.setFileName(filename);
+   if(0 == pageBytes || !m_file.open(QIODevice::ReadOnly))
+   {
+      return false;
+   }
+
+   uint64_t fileBytes = (uint64_t)m_file.size();
+   if(offset > fileBytes)
+   {
+      m_file.close();
+      return false;
+   }
+   if(0 == length || length > fileBytes - offset)
+   {
+      length = fileBytes - offset;
+   }
+
+   m_offset      = offset;
+   m_length      = length;
+   m_pageBytes   = pageBytes;
+   m_pageCount   = (length + pageBytes - 1) / pageBytes;
+   m_budgetBytes = budgetBytes;
+   return true;
+}
+
+void PageCache::Close(void)
+{
+   QMutexLocker lock(&m_mutex);
+   // readers on other threads finish with their pages first
+   while(m_pins > 0)
+   {
+      m_unpinned.wait(&m_mutex);
+   }
+   while(!m_lru.empty())
+   {
+      unmapPage(m_lru.back());
+   }
+   if(m_file.isOpen())
+   {
+      m_file.close();
+   }
+   m_offset = m_length = m_pageCount = 0;
+   m_pageBytes = 0;
+   m_mappedBytes = 0;
+   m_haveLast = false;
+   m_hits = m_misses = m_prefetches = 0;
+}
+
+const char* PageCache::GetPage(uint64_t page, size_t& nBytes, PagePin& pin)
+{
+   if(pin.m_cache != this)
+   {
+      pin.Release();
+   }
+
+   QMutexLocker lock(&m_mutex);
+   Page_t* p;
+
+   // the new page is pinned before the old one is let go, walking within a
+   // page never leaves it unpinned
+   uint64_t oldPage = pin.m_page;
+   bool hadPin = pin.m_cache != NULL;
+   pin.m_cache = NULL;
+
+   if(page >= m_pageCount)
+   {
+      if(hadPin)
+      {
+         unpin(oldPage);
+      }
+      return NULL;
+   }
+
+   auto it = m_pages.find(page);
+   if(it != m_pages.end())
+   {
+      ++m_hits;
+      p = &it->second;
+      m_lru.splice(m_lru.begin(), m_lru, p->lru);
+   }
+   else
+   {
+      ++m_misses;
+      p = mapPage(page, m_lru.begin());
+      if(NULL == p)
+      {
+         if(hadPin)
+         {
+            unpin(oldPage);
+         }
+         return NULL;
+      }
+   }
+
+   ++p->pins;
+   ++m_pins;
+   pin.m_cache = this;
+   pin.m_page  = page;
+   if(hadPin)
+   {
+      unpin(oldPage);
+   }
+
+   // moving to a neighbor page is scrolling, read ahead that way
+   if(m_haveLast && page == m_lastPage + 1)
+   {
+      prefetch(page, 1);
+   }
+   else if(m_haveLast && page + 1 == m_lastPage)
+   {
+      prefetch(page, -1);
+   }
+   m_lastPage = page;
+   m_haveLast = true;
+
+   evict();
+   nBytes = p->nBytes;
+   return (const char*)p->data;
+}
+
+void PageCache::SetBudgetBytes(uint64_t n)
+{
+   QMutexLocker lock(&m_mutex);
+   m_budgetBytes = n;
+   evict();
+}
+
+uint64_t PageCache::GetMappedBytes(void)
+{
+   QMutexLocker lock(&m_mutex);
+   return m_mappedBytes;
+}
+
+uint64_t PageCache::GetHits(void)
+{
+   QMutexLocker lock(&m_mutex);
+   return m_hits;
+}
+
+uint64_t PageCache::GetMisses(void)
+{
+   QMutexLocker lock(&m_mutex);
+   return m_misses;
+}
+
+uint64_t PageCache::GetPrefetches(void)
+{
+   QMutexLocker lock(&m_mutex);
+   return m_prefetches;
+}
+
+PageCache::Page_t* PageCache::mapPage(uint64_t page, std::list<uint64_t>::iterator lruPos)
+{
+   uint64_t pos = page * m_pageBytes;
+   size_t n = (size_t)std::min<uint64_t>(m_pageBytes, m_length - pos);
+
+   uchar* data = m_file.map(m_offset + pos, n);
+   if(NULL == data)
+   {
+      return NULL;
+   }
+#if !_WINDOWS
+   // start reading the whole page now instead of faulting it in piecemeal,
+   // madvise wants a page aligned start
+   static const uintptr_t sysPage = (uintptr_t)sysconf(_SC_PAGESIZE);
+   uintptr_t start = (uintptr_t)data & ~(sysPage - 1);
+   madvise((void*)start, n + ((uintptr_t)data - start), MADV_WILLNEED);
+#endif
+
+   Page_t& p = m_pages[page];
+   p.data   = data;
+   p.nBytes = n;
+   p.pins   = 0;
+   p.lru    = m_lru.insert(lruPos, page);
+   m_mappedBytes += n;
+   return &p;
+}
+
+void PageCache::unmapPage(uint64_t page)
+{
+   auto it = m_pages.find(page);
+   if(it != m_pages.end())
+   {
+      m_file.unmap(it->second.data);
+      m_mappedBytes -= it->second.nBytes;
+      m_lru.erase(it->second.lru);
+      m_pages.erase(it);
+   }
+}
+
+// drop least recently used pages over the budget, keeping the current one
+// and the pinned ones
+void PageCache::evict(void)
+{
+   auto it = m_lru.end();
+   while(m_mappedBytes > m_budgetBytes && m_lru.size() > 1 && std::prev(it) != m_lru.begin())
+   {
+      --it;
+      if(0 == m_pages[*it].pins)
+      {
+         // it moves past the page so it stays valid once the page is unmapped
+         uint64_t page = *it++;
+         unmapPage(page);
+      }
+   }
+}
+
+// map the pages after (dir 1) or before (dir -1) the current page, queued
+// in the LRU right behind it so they outlive older pages
+void PageCache::prefetch(uint64_t page, int dir)
+{
+   uint64_t fit = m_budgetBytes / m_pageBytes;
+   uint64_t n = std::min<uint64_t>(m_prefetchPages, fit > 0 ? fit - 1 : 0);
+   auto pos = std::next(m_lru.begin());
+
+   for(uint64_t k = 1; k <= n; ++k)
+   {
+      if(dir < 0 && k > page)
+      {
+         break;
+      }
+      uint64_t q = dir > 0 ? page + k : page - k;
+      if(q >= m_pageCount)
+      {
+         break;
+      }
+
+      auto it = m_pages.find(q);
+      if(it != m_pages.end())
+      {
+         if(it->second.lru != pos)
+         {
+            m_lru.splice(pos, m_lru, it->second.lru);
+         }
+         pos = std::next(it->second.lru);
+      }
+      else
+      {
+         Page_t* p = mapPage(q, pos);
+         if(NULL == p)
+         {
+            break;
+         }
+         ++m_prefetches;
+         pos = std::next(p->lru);
+      }
+   }
+}
+
+void PageCache::unpin(uint64_t page)
+{
+   auto it = m_pages.find(page);
+   if(it != m_pages.end() && it->second.pins > 0)
+   {
+      --it->second.pins;
+      if(0 == --m_pins)
+      {
+         m_unpinned.wakeAll();
+      }
+   }
+}
+
+void PagePin::Release(void)
+{
+   if(m_cache)
+   {
+      QMutexLocker lock(&m_cache->m_mutex);
+      m_cache->unpin(m_page);
+      m_cache = NULL;
+   }
+}
+
+}// namespace terbit
@@ -0,0 +1,136 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <list>
+#include <unordered_map>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace terbit
+{
+
+static const size_t   PAGE_CACHE_DEFAULT_PAGE_BYTES   = 4*1024*1024;
+static const uint64_t PAGE_CACHE_DEFAULT_BUDGET_BYTES = 256*1024*1024;
+static const uint32_t PAGE_CACHE_DEFAULT_PREFETCH     = 4;
+
+class PageCache;
+
+/*** Keeps one page of a PageCache mapped while its data is read, from any
+ * thread.  Filled by PageCache::GetPage() and released when it goes out of
+ * scope or pins another page; hold it for the whole run being read.
+ **************************************************************/
+class PagePin
+{
+public:
+   PagePin() : m_cache(NULL), m_page(0) {}
+   ~PagePin() { Release(); }
+
+   void Release(void);
+
+private:
+   PagePin(const PagePin& o); //disable copy ctor
+   PagePin& operator=(const PagePin& o);
+
+   friend class PageCache;
+   PageCache* m_cache;
+   uint64_t   m_page;
+};
+
+/*** Read-only window onto a file too large to hold in memory.  The data
+ * (length bytes from offset) is split into fixed size pages that are mapped
+ * on demand and kept in LRU order; once the mapped pages exceed the memory
+ * budget the least recently used are unmapped.
+ * Walking the pages forward or backward maps the next pages in that
+ * direction ahead of time and asks the OS to start reading them, so a
+ * scrolling view finds its data resident.
+ * A page stays mapped while a PagePin holds it: eviction skips pinned pages,
+ * so the mapping may run over budget until they are released.  Close()
+ * waits for the pins to be released.
+ **************************************************************/
+class PageCache
+{
+public:
+   PageCache();
+   ~PageCache();
+
+   bool Open(const QString& filename, uint64_t offset, uint64_t length,
+             size_t pageBytes = PAGE_CACHE_DEFAULT_PAGE_BYTES, uint64_t budgetBytes = PAGE_CACHE_DEFAULT_BUDGET_BYTES);
+   void Close(void);
+
+   // page data and its size (the last page may be short), NULL past the end
+   // or when the page can't be mapped.  The data is valid while pin holds the
+   // page, pin is released from the page it held before
+   const char* GetPage(uint64_t page, size_t& nBytes, PagePin& pin);
+
+   void     SetBudgetBytes(uint64_t n);
+   uint64_t GetBudgetBytes(void){return m_budgetBytes;}
+   void     SetPrefetchPages(uint32_t n){m_prefetchPages = n;}
+   uint32_t GetPrefetchPages(void){return m_prefetchPages;}
+
+   bool     IsOpen(void){return m_file.isOpen();}
+   uint64_t GetLength(void){return m_length;}
+   size_t   GetPageBytes(void){return m_pageBytes;}
+   uint64_t GetPageCount(void){return m_pageCount;}
+   uint64_t GetMappedBytes(void);
+   uint64_t GetHits(void);
+   uint64_t GetMisses(void);
+   uint64_t GetPrefetches(void);
+
+private:
+   PageCache(const PageCache& o); //disable copy ctor
+
+   friend class PagePin;
+
+   typedef struct
+   {
+      uchar*                        data;
+      size_t                        nBytes;
+      uint32_t                      pins;
+      std::list<uint64_t>::iterator lru;
+   }Page_t;
+
+   Page_t* mapPage(uint64_t page, std::list<uint64_t>::iterator lruPos);
+   void    unmapPage(uint64_t page);
+   void    evict(void);
+   void    prefetch(uint64_t page, int dir);
+   void    unpin(uint64_t page);
+
+   QFile    m_file;
+   QMutex   m_mutex;
+   QWaitCondition m_unpinned; // signaled when the last pin is released
+   uint32_t m_pins          = 0;
+   uint64_t m_offset        = 0;
+   uint64_t m_length        = 0;
+   size_t   m_pageBytes     = 0;
+   uint64_t m_pageCount     = 0;
+   uint64_t m_budgetBytes   = PAGE_CACHE_DEFAULT_BUDGET_BYTES;
+   uint32_t m_prefetchPages = PAGE_CACHE_DEFAULT_PREFETCH;
+   uint64_t m_mappedBytes   = 0;
+   uint64_t m_lastPage      = 0;
+   bool     m_haveLast      = false;
+   uint64_t m_hits          = 0;
+   uint64_t m_misses        = 0;
+   uint64_t m_prefetches    = 0;
+
+   std::list<uint64_t>                    m_lru; // front is the most recently used
+   std::unordered_map<uint64_t, Page_t>   m_pages;
+};
+
+}// namespace terbit
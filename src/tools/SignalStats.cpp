@@ -0,0 +1,133 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "SignalStats.h"
+#include "VecMath.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace terbit
+{
+
+// sum += v keeping the rounding error in comp
+static inline void neumaierAdd(double& sum, double& comp, double v)
+{
+   double t = sum + v;
+   if(std::fabs(sum) >= std::fabs(v))
+   {
+      comp += (sum - t) + v;
+   }
+   else
+   {
+      comp += (v - t) + sum;
+   }
+   sum = t;
+}
+
+void SignalStatsInit(SignalStats_t& s)
+{
+   s.count = 0;
+   s.sum = 0.0;
+   s.sumComp = 0.0;
+   s.m2 = 0.0;
+   s.min = std::numeric_limits<double>::infinity();
+   s.max = -std::numeric_limits<double>::infinity();
+}
+
+void SignalStatsAccumulate(SignalStats_t& s, const double* values, size_t n)
+{
+   while(n > 0)
+   {
+      size_t c = std::min(n, SIGNAL_STATS_BLOCK);
+
+      // sum and min/max, then the deviations from the block mean while the block is still in L1
+      VecReduce_t r;
+      VecReduceInit(r);
+      VecReduce(values, c, r);
+
+      SignalStats_t block;
+      block.count = c;
+      block.sum = r.sum;
+      block.sumComp = 0.0;
+      block.m2 = VecSumSquaredDeviation(values, r.sum / c, c);
+      block.min = r.min;
+      block.max = r.max;
+      SignalStatsMerge(s, block);
+
+      values += c;
+      n -= c;
+   }
+}
+
+void SignalStatsMerge(SignalStats_t& s, const SignalStats_t& other)
+{
+   if(0 == other.count)
+   {
+      return;
+   }
+   if(0 == s.count)
+   {
+      s = other;
+      return;
+   }
+
+   double na = (double)s.count;
+   double nb = (double)other.count;
+   double delta = SignalStatsMean(other) - SignalStatsMean(s);
+   s.m2 += other.m2 + delta * delta * na * nb / (na + nb);
+
+   neumaierAdd(s.sum, s.sumComp, other.sum);
+   s.sumComp += other.sumComp;
+   s.count += other.count;
+   if(other.min < s.min)
+   {
+      s.min = other.min;
+   }
+   if(other.max > s.max)
+   {
+      s.max = other.max;
+   }
+}
+
+double SignalStatsMean(const SignalStats_t& s)
+{
+   return s.count > 0 ? (s.sum + s.sumComp) / s.count : std::numeric_limits<double>::quiet_NaN();
+}
+
+// mean of the squares = variance + mean^2
+double SignalStatsRms(const SignalStats_t& s)
+{
+   double mean = SignalStatsMean(s);
+   return s.count > 0 ? std::sqrt(s.m2 / s.count + mean * mean) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double SignalStatsStdDev(const SignalStats_t& s, bool sample)
+{
+   uint64_t n = sample ? s.count - 1 : s.count;
+   return (s.count > 0 && n > 0) ? std::sqrt(s.m2 / n) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double SignalStatsPeakToPeak(const SignalStats_t& s)
+{
+   return s.count > 0 ? s.max - s.min : std::numeric_limits<double>::quiet_NaN();
+}
+
+double SignalStatsCrestFactor(const SignalStats_t& s)
+{
+   return s.count > 0 ? std::max(std::fabs(s.min), std::fabs(s.max)) / SignalStatsRms(s) : std::numeric_limits<double>::quiet_NaN();
+}
+
+}// namespace terbit
@@ -0,0 +1,60 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace terbit
+{
+
+/*** Statistics of a signal from one pass over its values: count, mean,
+ * spread (sum of squared deviations), min and max, from which RMS,
+ * standard deviation, peak-to-peak and crest factor follow.
+ * Values are taken SIGNAL_STATS_BLOCK at a time.  A block's sum, min/max
+ * and squared deviations come from the VecMath kernels while it is in L1,
+ * block sums are added with Neumaier (Kahan) compensation and the spreads
+ * merged pairwise (Chan et al.), so millions of samples keep their
+ * precision.  Stats of two ranges merge into the stats of both.
+ * A NaN value makes the mean, RMS and deviation NaN, min/max skip it.
+ **************************************************************/
+typedef struct
+{
+   uint64_t count;
+   double sum;     // the compensated sum is sum + sumComp
+   double sumComp;
+   double m2;      // sum of squared deviations from the mean
+   double min;
+   double max;
+}SignalStats_t;
+
+// values per kernel pass
+static const size_t SIGNAL_STATS_BLOCK = 256;
+
+void SignalStatsInit(SignalStats_t& s);
+void SignalStatsAccumulate(SignalStats_t& s, const double* values, size_t n);
+void SignalStatsMerge(SignalStats_t& s, const SignalStats_t& other);
+
+// NaN when there are no values
+double SignalStatsMean(const SignalStats_t& s);
+double SignalStatsRms(const SignalStats_t& s);
+// population (n) or sample (n - 1) standard deviation
+double SignalStatsStdDev(const SignalStats_t& s, bool sample);
+double SignalStatsPeakToPeak(const SignalStats_t& s);
+// largest magnitude over RMS
+double SignalStatsCrestFactor(const SignalStats_t& s);
+
+}// namespace terbit
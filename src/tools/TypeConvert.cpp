@@ -0,0 +1,775 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "TypeConvert.h"
+#include "Tools.h"
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TERBIT_CONVERT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 code is compiled per function so the rest of the build keeps its
+// baseline instruction set; MSVC allows the intrinsics without flags.
+#if defined(__GNUC__) || defined(__clang__)
+#define TERBIT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TERBIT_TARGET_AVX2
+#endif
+
+namespace terbit
+{
+
+// Doubles converted per pass, the block stays in L1 between the load and
+// store kernels.
+static const size_t CONVERT_BLOCK_ELTS = 512;
+
+static const double CONVERT_TWO63 = 9223372036854775808.0;
+static const double CONVERT_TWO64 = 18446744073709551616.0;
+
+// scale/offset are applied while loading, apply is false for 1/0
+typedef struct
+{
+   double scale;
+   double offset;
+   bool   apply;
+}ConvertScale_t;
+
+typedef void (*ConvertLoadFn)(const char* src, size_t n, double* out, const ConvertScale_t& sc);
+typedef void (*ConvertStoreFn)(const double* in, size_t n, char* dst);
+
+// ------------------------------ scalar kernels ------------------------------
+
+template<typename S>
+static inline double loadValue(const char* src)
+{
+   return (double)*(const S*)src;
+}
+
+template<>
+inline double loadValue<bool>(const char* src)
+{
+   return (0 != *(const uint8_t*)src) ? 1.0 : 0.0;
+}
+
+template<typename S>
+static void loadScalar(const char* src, size_t strideBytes, size_t n, double* out, const ConvertScale_t& sc)
+{
+   if(sc.apply)
+   {
+      for(size_t i = 0; i < n; ++i, src += strideBytes)
+      {
+         out[i] = loadValue<S>(src) * sc.scale + sc.offset;
+      }
+   }
+   else
+   {
+      for(size_t i = 0; i < n; ++i, src += strideBytes)
+      {
+         out[i] = loadValue<S>(src);
+      }
+   }
+}
+
+// NaN to 0, clamp, then truncate like a cast
+template<typename D>
+static inline D saturateFromDouble(double v)
+{
+   if(v != v)
+   {
+      return 0;
+   }
+   if(v <= (double)std::numeric_limits<D>::min())
+   {
+      return std::numeric_limits<D>::min();
+   }
+   if(v >= (double)std::numeric_limits<D>::max())
+   {
+      return std::numeric_limits<D>::max();
+   }
+   return (D)v;
+}
+
+// Truncate, then keep the low bits the way an integer cast through 64 bits
+// would.  Every step stays exact in double.
+template<typename D>
+static inline D wrapFromDouble(double v)
+{
+   if(v != v)
+   {
+      return 0;
+   }
+   v = std::trunc(v);
+   if(v >= CONVERT_TWO64 || v <= -CONVERT_TWO64)
+   {
+      v = std::fmod(v, CONVERT_TWO64);
+   }
+   if(v < -CONVERT_TWO63)
+   {
+      v += CONVERT_TWO64;
+   }
+   return (v >= CONVERT_TWO63) ? (D)(uint64_t)v : (D)(int64_t)v;
+}
+
+template<typename D>
+struct StoreScalar
+{
+   static void Run(const double* in, size_t n, char* dst, size_t strideBytes, bool saturate)
+   {
+      for(size_t i = 0; i < n; ++i, dst += strideBytes)
+      {
+         *(D*)dst = saturate ? saturateFromDouble<D>(in[i]) : wrapFromDouble<D>(in[i]);
+      }
+   }
+};
+
+template<>
+struct StoreScalar<float>
+{
+   static void Run(const double* in, size_t n, char* dst, size_t strideBytes, bool saturate)
+   {
+      saturate;
+      for(size_t i = 0; i < n; ++i, dst += strideBytes)
+      {
+         *(float*)dst = (float)in[i];
+      }
+   }
+};
+
+template<>
+struct StoreScalar<double>
+{
+   static void Run(const double* in, size_t n, char* dst, size_t strideBytes, bool saturate)
+   {
+      saturate;
+      for(size_t i = 0; i < n; ++i, dst += strideBytes)
+      {
+         *(double*)dst = in[i];
+      }
+   }
+};
+
+template<>
+struct StoreScalar<bool>
+{
+   static void Run(const double* in, size_t n, char* dst, size_t strideBytes, bool saturate)
+   {
+      saturate;
+      for(size_t i = 0; i < n; ++i, dst += strideBytes)
+      {
+         *(bool*)dst = (0.0 != in[i] && in[i] == in[i]);
+      }
+   }
+};
+
+// Exact integer to integer, no trip through double
+template<typename S, typename D>
+static inline D saturateInt(S v)
+{
+   if(std::numeric_limits<S>::is_signed && (int64_t)v < 0)
+   {
+      int64_t x = (int64_t)v;
+      return (x < (int64_t)std::numeric_limits<D>::min()) ? std::numeric_limits<D>::min() : (D)x;
+   }
+   uint64_t x = (uint64_t)v;
+   return (x > (uint64_t)std::numeric_limits<D>::max()) ? std::numeric_limits<D>::max() : (D)x;
+}
+
+template<typename S, typename D>
+static void convertIntScalar(const char* src, size_t srcStrideBytes, char* dst, size_t dstStrideBytes, size_t n, bool saturate)
+{
+   for(size_t i = 0; i < n; ++i, src += srcStrideBytes, dst += dstStrideBytes)
+   {
+      S v = *(const S*)src;
+      *(D*)dst = saturate ? saturateInt<S, D>(v) : (D)v;
+   }
+}
+
+template<typename D>
+static bool convertIntTo(TerbitDataType srcType, const char* src, size_t srcStrideBytes, char* dst, size_t dstStrideBytes, size_t n, bool saturate)
+{
+   switch(srcType)
+   {
+   case TERBIT_INT8:
+      convertIntScalar<int8_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   case TERBIT_UINT8:
+      convertIntScalar<uint8_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   case TERBIT_INT16:
+      convertIntScalar<int16_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   case TERBIT_UINT16:
+      convertIntScalar<uint16_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   case TERBIT_INT32:
+      convertIntScalar<int32_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   case TERBIT_UINT32:
+      convertIntScalar<uint32_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   case TERBIT_INT64:
+      convertIntScalar<int64_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   case TERBIT_UINT64:
+      convertIntScalar<uint64_t, D>(src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+      break;
+   default:
+      return false;
+   }
+   return true;
+}
+
+static bool convertInt(const char* src, TerbitDataType srcType, size_t srcStrideBytes,
+                       char* dst, TerbitDataType dstType, size_t dstStrideBytes, size_t n, bool saturate)
+{
+   switch(dstType)
+   {
+   case TERBIT_INT8:
+      return convertIntTo<int8_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   case TERBIT_UINT8:
+      return convertIntTo<uint8_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   case TERBIT_INT16:
+      return convertIntTo<int16_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   case TERBIT_UINT16:
+      return convertIntTo<uint16_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   case TERBIT_INT32:
+      return convertIntTo<int32_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   case TERBIT_UINT32:
+      return convertIntTo<uint32_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   case TERBIT_INT64:
+      return convertIntTo<int64_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   case TERBIT_UINT64:
+      return convertIntTo<uint64_t>(srcType, src, srcStrideBytes, dst, dstStrideBytes, n, saturate);
+   default:
+      return false;
+   }
+}
+
+static void loadBlockScalar(TerbitDataType type, const char* src, size_t strideBytes, size_t n, double* out, const ConvertScale_t& sc)
+{
+   switch(type)
+   {
+   case TERBIT_INT8:
+      loadScalar<int8_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_UINT8:
+      loadScalar<uint8_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_INT16:
+      loadScalar<int16_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_UINT16:
+      loadScalar<uint16_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_INT32:
+      loadScalar<int32_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_UINT32:
+      loadScalar<uint32_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_INT64:
+      loadScalar<int64_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_UINT64:
+      loadScalar<uint64_t>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_FLOAT:
+      loadScalar<float>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_DOUBLE:
+      loadScalar<double>(src, strideBytes, n, out, sc);
+      break;
+   case TERBIT_BOOL:
+      loadScalar<bool>(src, strideBytes, n, out, sc);
+      break;
+   default:
+      break;
+   }
+}
+
+static void storeBlockScalar(TerbitDataType type, const double* in, size_t n, char* dst, size_t strideBytes, bool saturate)
+{
+   switch(type)
+   {
+   case TERBIT_INT8:
+      StoreScalar<int8_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_UINT8:
+      StoreScalar<uint8_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_INT16:
+      StoreScalar<int16_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_UINT16:
+      StoreScalar<uint16_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_INT32:
+      StoreScalar<int32_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_UINT32:
+      StoreScalar<uint32_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_INT64:
+      StoreScalar<int64_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_UINT64:
+      StoreScalar<uint64_t>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_FLOAT:
+      StoreScalar<float>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_DOUBLE:
+      StoreScalar<double>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   case TERBIT_BOOL:
+      StoreScalar<bool>::Run(in, n, dst, strideBytes, saturate);
+      break;
+   default:
+      break;
+   }
+}
+
+#if TERBIT_CONVERT_X86
+
+// ------------------------------- AVX2 kernels -------------------------------
+// Loads widen 8 or 4 elements into doubles and scale them, the tail goes
+// through the scalar kernel.  Stores zero NaNs, clamp in double, truncate
+// to int32 and narrow with the saturating packs (which can't saturate any
+// more since the values are already in range).
+
+TERBIT_TARGET_AVX2 static inline void storePd(double* out, __m256d v, const ConvertScale_t& sc)
+{
+   if(sc.apply)
+   {
+      v = _mm256_add_pd(_mm256_mul_pd(v, _mm256_set1_pd(sc.scale)), _mm256_set1_pd(sc.offset));
+   }
+   _mm256_storeu_pd(out, v);
+}
+
+TERBIT_TARGET_AVX2 static inline void storeI32x8(double* out, __m256i v, const ConvertScale_t& sc)
+{
+   storePd(out, _mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), sc);
+   storePd(out + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), sc);
+}
+
+TERBIT_TARGET_AVX2 static void loadAvx2I8(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      storeI32x8(out + i, _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(src + i))), sc);
+   }
+   loadScalar<int8_t>(src + i, 1, n - i, out + i, sc);
+}
+
+TERBIT_TARGET_AVX2 static void loadAvx2U8(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      storeI32x8(out + i, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i))), sc);
+   }
+   loadScalar<uint8_t>(src + i, 1, n - i, out + i, sc);
+}
+
+TERBIT_TARGET_AVX2 static void loadAvx2I16(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      storeI32x8(out + i, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i * 2))), sc);
+   }
+   loadScalar<int16_t>(src + i * 2, 2, n - i, out + i, sc);
+}
+
+TERBIT_TARGET_AVX2 static void loadAvx2U16(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      storeI32x8(out + i, _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i * 2))), sc);
+   }
+   loadScalar<uint16_t>(src + i * 2, 2, n - i, out + i, sc);
+}
+
+TERBIT_TARGET_AVX2 static void loadAvx2I32(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      storePd(out + i, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(src + i * 4))), sc);
+   }
+   loadScalar<int32_t>(src + i * 4, 4, n - i, out + i, sc);
+}
+
+// no unsigned convert, bias into the signed range and add it back
+TERBIT_TARGET_AVX2 static void loadAvx2U32(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   const __m128i bias = _mm_set1_epi32((int)0x80000000);
+   const __m256d bias2 = _mm256_set1_pd(2147483648.0);
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i * 4)), bias);
+      storePd(out + i, _mm256_add_pd(_mm256_cvtepi32_pd(v), bias2), sc);
+   }
+   loadScalar<uint32_t>(src + i * 4, 4, n - i, out + i, sc);
+}
+
+TERBIT_TARGET_AVX2 static void loadAvx2F32(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      storePd(out + i, _mm256_cvtps_pd(_mm_loadu_ps((const float*)(src + i * 4))), sc);
+   }
+   loadScalar<float>(src + i * 4, 4, n - i, out + i, sc);
+}
+
+TERBIT_TARGET_AVX2 static void loadAvx2F64(const char* src, size_t n, double* out, const ConvertScale_t& sc)
+{
+   if(!sc.apply)
+   {
+      memcpy(out, src, n * sizeof(double));
+      return;
+   }
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      storePd(out + i, _mm256_loadu_pd((const double*)(src + i * 8)), sc);
+   }
+   loadScalar<double>(src + i * 8, 8, n - i, out + i, sc);
+}
+
+TERBIT_TARGET_AVX2 static inline __m128i clampToI32(const double* in, double lo, double hi)
+{
+   __m256d v = _mm256_loadu_pd(in);
+   v = _mm256_and_pd(v, _mm256_cmp_pd(v, v, _CMP_ORD_Q));
+   v = _mm256_min_pd(_mm256_max_pd(v, _mm256_set1_pd(lo)), _mm256_set1_pd(hi));
+   return _mm256_cvttpd_epi32(v);
+}
+
+TERBIT_TARGET_AVX2 static void storeAvx2I8(const double* in, size_t n, char* dst)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      __m128i w = _mm_packs_epi32(clampToI32(in + i, -128.0, 127.0), clampToI32(in + i + 4, -128.0, 127.0));
+      _mm_storel_epi64((__m128i*)(dst + i), _mm_packs_epi16(w, w));
+   }
+   StoreScalar<int8_t>::Run(in + i, n - i, dst + i, 1, true);
+}
+
+TERBIT_TARGET_AVX2 static void storeAvx2U8(const double* in, size_t n, char* dst)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      __m128i w = _mm_packs_epi32(clampToI32(in + i, 0.0, 255.0), clampToI32(in + i + 4, 0.0, 255.0));
+      _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(w, w));
+   }
+   StoreScalar<uint8_t>::Run(in + i, n - i, dst + i, 1, true);
+}
+
+TERBIT_TARGET_AVX2 static void storeAvx2I16(const double* in, size_t n, char* dst)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      __m128i w = _mm_packs_epi32(clampToI32(in + i, -32768.0, 32767.0), clampToI32(in + i + 4, -32768.0, 32767.0));
+      _mm_storeu_si128((__m128i*)(dst + i * 2), w);
+   }
+   StoreScalar<int16_t>::Run(in + i, n - i, dst + i * 2, 2, true);
+}
+
+TERBIT_TARGET_AVX2 static void storeAvx2U16(const double* in, size_t n, char* dst)
+{
+   size_t i = 0;
+   for(; i + 8 <= n; i += 8)
+   {
+      __m128i w = _mm_packus_epi32(clampToI32(in + i, 0.0, 65535.0), clampToI32(in + i + 4, 0.0, 65535.0));
+      _mm_storeu_si128((__m128i*)(dst + i * 2), w);
+   }
+   StoreScalar<uint16_t>::Run(in + i, n - i, dst + i * 2, 2, true);
+}
+
+TERBIT_TARGET_AVX2 static void storeAvx2I32(const double* in, size_t n, char* dst)
+{
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      _mm_storeu_si128((__m128i*)(dst + i * 4), clampToI32(in + i, -2147483648.0, 2147483647.0));
+   }
+   StoreScalar<int32_t>::Run(in + i, n - i, dst + i * 4, 4, true);
+}
+
+// Floor the clamped value (same as truncating a value >= 0) so the biased
+// value is a whole number, then convert signed and flip the bias back.
+TERBIT_TARGET_AVX2 static void storeAvx2U32(const double* in, size_t n, char* dst)
+{
+   const __m128i bias = _mm_set1_epi32((int)0x80000000);
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      __m256d v = _mm256_loadu_pd(in + i);
+      v = _mm256_and_pd(v, _mm256_cmp_pd(v, v, _CMP_ORD_Q));
+      v = _mm256_min_pd(_mm256_max_pd(v, _mm256_setzero_pd()), _mm256_set1_pd(4294967295.0));
+      v = _mm256_sub_pd(_mm256_floor_pd(v), _mm256_set1_pd(2147483648.0));
+      _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_xor_si128(_mm256_cvttpd_epi32(v), bias));
+   }
+   StoreScalar<uint32_t>::Run(in + i, n - i, dst + i * 4, 4, true);
+}
+
+TERBIT_TARGET_AVX2 static void storeAvx2F32(const double* in, size_t n, char* dst)
+{
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      _mm_storeu_ps((float*)(dst + i * 4), _mm256_cvtpd_ps(_mm256_loadu_pd(in + i)));
+   }
+   StoreScalar<float>::Run(in + i, n - i, dst + i * 4, 4, true);
+}
+
+static void storeF64(const double* in, size_t n, char* dst)
+{
+   memcpy(dst, in, n * sizeof(double));
+}
+
+static bool detectAvx2()
+{
+#if defined(_MSC_VER)
+   int info[4];
+   __cpuid(info, 0);
+   if(info[0] >= 7)
+   {
+      __cpuid(info, 1);
+      bool osxsave = 0 != (info[2] & (1 << 27));
+      __cpuidex(info, 7, 0);
+      bool avx2 = 0 != (info[1] & (1 << 5));
+      // the OS also has to save the YMM registers
+      return avx2 && osxsave && 6 == (_xgetbv(0) & 6);
+   }
+   return false;
+#else
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static ConvertLoadFn selectLoad(TerbitDataType type)
+{
+   switch(type)
+   {
+   case TERBIT_INT8:
+      return &loadAvx2I8;
+   case TERBIT_UINT8:
+      return &loadAvx2U8;
+   case TERBIT_INT16:
+      return &loadAvx2I16;
+   case TERBIT_UINT16:
+      return &loadAvx2U16;
+   case TERBIT_INT32:
+      return &loadAvx2I32;
+   case TERBIT_UINT32:
+      return &loadAvx2U32;
+   case TERBIT_FLOAT:
+      return &loadAvx2F32;
+   case TERBIT_DOUBLE:
+      return &loadAvx2F64;
+   default:
+      return NULL;
+   }
+}
+
+static ConvertStoreFn selectStore(TerbitDataType type)
+{
+   switch(type)
+   {
+   case TERBIT_INT8:
+      return &storeAvx2I8;
+   case TERBIT_UINT8:
+      return &storeAvx2U8;
+   case TERBIT_INT16:
+      return &storeAvx2I16;
+   case TERBIT_UINT16:
+      return &storeAvx2U16;
+   case TERBIT_INT32:
+      return &storeAvx2I32;
+   case TERBIT_UINT32:
+      return &storeAvx2U32;
+   case TERBIT_FLOAT:
+      return &storeAvx2F32;
+   case TERBIT_DOUBLE:
+      return &storeF64;
+   default:
+      return NULL;
+   }
+}
+
+#else // TERBIT_CONVERT_X86
+
+static bool detectAvx2()
+{
+   return false;
+}
+
+static ConvertLoadFn selectLoad(TerbitDataType type)
+{
+   type;
+   return NULL;
+}
+
+static ConvertStoreFn selectStore(TerbitDataType type)
+{
+   type;
+   return NULL;
+}
+
+#endif // TERBIT_CONVERT_X86
+
+static bool useAvx2()
+{
+   static const bool avx2 = detectAvx2();
+   return avx2;
+}
+
+const char* GetConvertKernelName()
+{
+   return useAvx2() ? "avx2" : "scalar";
+}
+
+// size_t is one of the fixed width types underneath
+static TerbitDataType normalizeType(TerbitDataType type)
+{
+   if(TERBIT_SIZE_T == type)
+   {
+      return (8 == sizeof(size_t)) ? TERBIT_UINT64 : TERBIT_UINT32;
+   }
+   return type;
+}
+
+static bool isIntegerType(TerbitDataType type)
+{
+   return type >= TERBIT_INT8 && type <= TERBIT_UINT64;
+}
+
+bool IsConvertibleDataType(TerbitDataType type)
+{
+   type = normalizeType(type);
+   return (type >= TERBIT_INT8 && type <= TERBIT_DOUBLE) || TERBIT_BOOL == type;
+}
+
+bool ConvertElements(const void* src, TerbitDataType srcType, size_t srcStrideBytes,
+                     void* dst, TerbitDataType dstType, size_t dstStrideBytes,
+                     size_t count, double scale, double offset, bool saturate)
+{
+   if(!IsConvertibleDataType(srcType) || !IsConvertibleDataType(dstType))
+   {
+      return false;
+   }
+
+   srcType = normalizeType(srcType);
+   dstType = normalizeType(dstType);
+
+   const char* s = (const char*)src;
+   char* d = (char*)dst;
+   size_t srcElt = TerbitDataTypeSize(srcType);
+   size_t dstElt = TerbitDataTypeSize(dstType);
+   bool unity = (1.0 == scale && 0.0 == offset);
+   ConvertScale_t sc = {scale, offset, !unity};
+
+   if(unity && srcType == dstType)
+   {
+      if(srcStrideBytes == srcElt && dstStrideBytes == dstElt)
+      {
+         memcpy(d, s, count * srcElt);
+      }
+      else
+      {
+         for(size_t i = 0; i < count; ++i, s += srcStrideBytes, d += dstStrideBytes)
+         {
+            memcpy(d, s, srcElt);
+         }
+      }
+      return true;
+   }
+
+   // doubles can't hold every 64 bit integer
+   if(unity && isIntegerType(srcType) && isIntegerType(dstType) && (8 == srcElt || 8 == dstElt))
+   {
+      return convertInt(s, srcType, srcStrideBytes, d, dstType, dstStrideBytes, count, saturate);
+   }
+
+   ConvertLoadFn load = NULL;
+   ConvertStoreFn store = NULL;
+   if(useAvx2())
+   {
+      if(srcStrideBytes == srcElt)
+      {
+         load = selectLoad(srcType);
+      }
+      // the vector stores always saturate
+      if(dstStrideBytes == dstElt && (saturate || !isIntegerType(dstType)))
+      {
+         store = selectStore(dstType);
+      }
+   }
+
+   // a contiguous double destination is its own block, saves a copy
+   bool inPlace = (TERBIT_DOUBLE == dstType && dstStrideBytes == dstElt);
+
+   double tmp[CONVERT_BLOCK_ELTS];
+   for(size_t done = 0; done < count; )
+   {
+      size_t n = std::min(count - done, CONVERT_BLOCK_ELTS);
+      double* block = inPlace ? (double*)d : tmp;
+
+      if(NULL != load)
+      {
+         load(s, n, block, sc);
+      }
+      else
+      {
+         loadBlockScalar(srcType, s, srcStrideBytes, n, block, sc);
+      }
+
+      if(!inPlace)
+      {
+         if(NULL != store)
+         {
+            store(block, n, d);
+         }
+         else
+         {
+            storeBlockScalar(dstType, block, n, d, dstStrideBytes, saturate);
+         }
+      }
+
+      s += n * srcStrideBytes;
+      d += n * dstStrideBytes;
+      done += n;
+   }
+   return true;
+}
+
+}// namespace terbit
@@ -0,0 +1,50 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "TerbitDefs.h"
+
+namespace terbit
+{
+
+/*** Element conversion between the numeric data types, int8 through
+ * uint64, float, double, size_t and bool, in every direction:
+ *    dst = src * scale + offset
+ * o Integer results truncate toward zero, the same as SetValue().
+ * o With saturate, integer results outside the destination range clamp to
+ *   its min/max and NaN becomes 0.  Without it they wrap like an integer
+ *   cast.  Floating point results are never clamped.
+ * o Integer to integer without scale/offset is exact for every width,
+ *   otherwise the math is done in double (64 bit integers above 2^53 lose
+ *   precision).
+ * Contiguous data runs through AVX2 kernels picked at runtime on x86: widen
+ * a block into doubles, scale, then clamp and narrow with the pack
+ * instructions.  Strided data, 64 bit integers and wrap mode use scalar
+ * code.  Same type without scale/offset is a plain copy.
+ * Returns false for a type that can't be converted.
+ **************************************************************/
+bool ConvertElements(const void* src, TerbitDataType srcType, size_t srcStrideBytes,
+                     void* dst, TerbitDataType dstType, size_t dstStrideBytes,
+                     size_t count, double scale = 1.0, double offset = 0.0, bool saturate = true);
+
+bool IsConvertibleDataType(TerbitDataType type);
+
+// Name of the kernel set in use ("avx2" or "scalar")
+const char* GetConvertKernelName();
+
+}// namespace terbit
@@ -0,0 +1,628 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "VecMath.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TERBIT_VEC_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 code is compiled per function so the rest of the build keeps its
+// baseline instruction set; MSVC allows the intrinsics without flags.
+#if defined(__GNUC__) || defined(__clang__)
+#define TERBIT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TERBIT_TARGET_AVX2
+#endif
+
+namespace terbit
+{
+
+#if TERBIT_VEC_X86
+
+static bool detectAvx2()
+{
+#if defined(_MSC_VER)
+   int info[4];
+   __cpuid(info, 0);
+   if(info[0] >= 7)
+   {
+      __cpuid(info, 1);
+      bool osxsave = 0 != (info[2] & (1 << 27));
+      __cpuidex(info, 7, 0);
+      bool avx2 = 0 != (info[1] & (1 << 5));
+      // the OS also has to save the YMM registers
+      return avx2 && osxsave && 6 == (_xgetbv(0) & 6);
+   }
+   return false;
+#else
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else // TERBIT_VEC_X86
+
+static bool detectAvx2()
+{
+   return false;
+}
+
+#endif // TERBIT_VEC_X86
+
+static bool useAvx2()
+{
+   static const bool avx2 = detectAvx2();
+   return avx2;
+}
+
+const char* GetVecKernelName()
+{
+   return useAvx2() ? "avx2" : "scalar";
+}
+
+// --------------------------------- operators ---------------------------------
+// each has a scalar Apply and, on x86, a 4 wide AVX2 Apply with the same
+// result for every input including NaN
+
+struct VecAddOp
+{
+   static inline double Apply(double a, double b) { return a + b; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+#endif
+};
+
+struct VecSubOp
+{
+   static inline double Apply(double a, double b) { return a - b; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+#endif
+};
+
+struct VecMulOp
+{
+   static inline double Apply(double a, double b) { return a * b; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+#endif
+};
+
+struct VecDivOp
+{
+   static inline double Apply(double a, double b) { return a / b; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a, __m256d b) { return _mm256_div_pd(a, b); }
+#endif
+};
+
+// min/max return b when either is NaN, like the instructions
+struct VecMinOp
+{
+   static inline double Apply(double a, double b) { return a < b ? a : b; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+#endif
+};
+
+struct VecMaxOp
+{
+   static inline double Apply(double a, double b) { return a > b ? a : b; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+#endif
+};
+
+#if TERBIT_VEC_X86
+#define TERBIT_VEC_COMPARE_OP(name, expr, pred) \
+struct name \
+{ \
+   static inline double Apply(double a, double b) { return (expr) ? 1.0 : 0.0; } \
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a, __m256d b) { return _mm256_and_pd(_mm256_cmp_pd(a, b, pred), _mm256_set1_pd(1.0)); } \
+};
+#else
+#define TERBIT_VEC_COMPARE_OP(name, expr, pred) \
+struct name \
+{ \
+   static inline double Apply(double a, double b) { return (expr) ? 1.0 : 0.0; } \
+};
+#endif
+
+TERBIT_VEC_COMPARE_OP(VecLtOp, a < b, _CMP_LT_OQ)
+TERBIT_VEC_COMPARE_OP(VecLeOp, a <= b, _CMP_LE_OQ)
+TERBIT_VEC_COMPARE_OP(VecGtOp, a > b, _CMP_GT_OQ)
+TERBIT_VEC_COMPARE_OP(VecGeOp, a >= b, _CMP_GE_OQ)
+TERBIT_VEC_COMPARE_OP(VecEqOp, a == b, _CMP_EQ_OQ)
+TERBIT_VEC_COMPARE_OP(VecNeOp, a != b, _CMP_NEQ_UQ)
+
+struct VecAbsOp
+{
+   static inline double Apply(double a) { return std::fabs(a); }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+#endif
+};
+
+struct VecNegOp
+{
+   static inline double Apply(double a) { return -a; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a) { return _mm256_xor_pd(_mm256_set1_pd(-0.0), a); }
+#endif
+};
+
+struct VecSqrtOp
+{
+   static inline double Apply(double a) { return std::sqrt(a); }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a) { return _mm256_sqrt_pd(a); }
+#endif
+};
+
+struct VecSquareOp
+{
+   static inline double Apply(double a) { return a * a; }
+#if TERBIT_VEC_X86
+   TERBIT_TARGET_AVX2 static inline __m256d Apply(__m256d a) { return _mm256_mul_pd(a, a); }
+#endif
+};
+
+// ------------------------------ scalar kernels ------------------------------
+
+template<typename Op>
+static void binaryScalar(const double* a, const double* b, double* out, size_t n)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      out[i] = Op::Apply(a[i], b[i]);
+   }
+}
+
+template<typename Op>
+static void unaryScalar(const double* a, double* out, size_t n)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      out[i] = Op::Apply(a[i]);
+   }
+}
+
+static void dbScalar(const double* a, double factor, double* out, size_t n)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      out[i] = factor * std::log10(std::fabs(a[i]));
+   }
+}
+
+static void scaleOffsetScalar(const double* a, double scale, double offset, double* out, size_t n)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      out[i] = a[i] * scale + offset;
+   }
+}
+
+// NaN passes through
+static void clipScalar(const double* a, double lo, double hi, double* out, size_t n)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      double v = lo > a[i] ? lo : a[i];
+      out[i] = hi < v ? hi : v;
+   }
+}
+
+static void selectScalar(const double* mask, const double* a, const double* b, double* out, size_t n)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      out[i] = (mask[i] != 0.0) ? a[i] : b[i];
+   }
+}
+
+static void reduceScalar(const double* a, size_t n, VecReduce_t& r)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      double v = a[i];
+      r.sum += v;
+      if(v < r.min)
+      {
+         r.min = v;
+      }
+      if(v > r.max)
+      {
+         r.max = v;
+      }
+      if(v != 0.0)
+      {
+         ++r.nonZero;
+      }
+   }
+   r.count += n;
+}
+
+static double dotScalar(const double* a, const double* b, size_t n)
+{
+   double sum = 0.0;
+   for(size_t i = 0; i < n; ++i)
+   {
+      sum += a[i] * b[i];
+   }
+   return sum;
+}
+
+static double sumSquaredDeviationScalar(const double* a, double mean, size_t n)
+{
+   double sum = 0.0;
+   for(size_t i = 0; i < n; ++i)
+   {
+      double d = a[i] - mean;
+      sum += d * d;
+   }
+   return sum;
+}
+
+// ------------------------------- AVX2 kernels -------------------------------
+
+#if TERBIT_VEC_X86
+
+template<typename Op>
+TERBIT_TARGET_AVX2 static void binaryAvx2(const double* a, const double* b, double* out, size_t n)
+{
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      _mm256_storeu_pd(out + i, Op::Apply(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+   }
+   binaryScalar<Op>(a + i, b + i, out + i, n - i);
+}
+
+template<typename Op>
+TERBIT_TARGET_AVX2 static void unaryAvx2(const double* a, double* out, size_t n)
+{
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      _mm256_storeu_pd(out + i, Op::Apply(_mm256_loadu_pd(a + i)));
+   }
+   unaryScalar<Op>(a + i, out + i, n - i);
+}
+
+TERBIT_TARGET_AVX2 static void scaleOffsetAvx2(const double* a, double scale, double offset, double* out, size_t n)
+{
+   __m256d s = _mm256_set1_pd(scale);
+   __m256d o = _mm256_set1_pd(offset);
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(a + i), s), o));
+   }
+   scaleOffsetScalar(a + i, scale, offset, out + i, n - i);
+}
+
+TERBIT_TARGET_AVX2 static void clipAvx2(const double* a, double lo, double hi, double* out, size_t n)
+{
+   __m256d l = _mm256_set1_pd(lo);
+   __m256d h = _mm256_set1_pd(hi);
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      // operand order keeps NaN, see clipScalar
+      _mm256_storeu_pd(out + i, _mm256_min_pd(h, _mm256_max_pd(l, _mm256_loadu_pd(a + i))));
+   }
+   clipScalar(a + i, lo, hi, out + i, n - i);
+}
+
+TERBIT_TARGET_AVX2 static void selectAvx2(const double* mask, const double* a, const double* b, double* out, size_t n)
+{
+   __m256d zero = _mm256_setzero_pd();
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      __m256d m = _mm256_cmp_pd(_mm256_loadu_pd(mask + i), zero, _CMP_NEQ_UQ);
+      _mm256_storeu_pd(out + i, _mm256_blendv_pd(_mm256_loadu_pd(b + i), _mm256_loadu_pd(a + i), m));
+   }
+   selectScalar(mask + i, a + i, b + i, out + i, n - i);
+}
+
+// four partial sums, so the total can differ from the scalar sum in the last bits
+TERBIT_TARGET_AVX2 static void reduceAvx2(const double* a, size_t n, VecReduce_t& r)
+{
+   static const int bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+   __m256d sum = _mm256_setzero_pd();
+   __m256d mn = _mm256_set1_pd(r.min);
+   __m256d mx = _mm256_set1_pd(r.max);
+   __m256d zero = _mm256_setzero_pd();
+   size_t nonZero = 0;
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      __m256d v = _mm256_loadu_pd(a + i);
+      sum = _mm256_add_pd(sum, v);
+      // v first so a NaN element leaves the running min/max alone
+      mn = _mm256_min_pd(v, mn);
+      mx = _mm256_max_pd(v, mx);
+      nonZero += bits[_mm256_movemask_pd(_mm256_cmp_pd(v, zero, _CMP_NEQ_UQ))];
+   }
+
+   double s[4], l[4], h[4];
+   _mm256_storeu_pd(s, sum);
+   _mm256_storeu_pd(l, mn);
+   _mm256_storeu_pd(h, mx);
+   r.sum += (s[0] + s[1]) + (s[2] + s[3]);
+   for(int k = 0; k < 4; ++k)
+   {
+      if(l[k] < r.min)
+      {
+         r.min = l[k];
+      }
+      if(h[k] > r.max)
+      {
+         r.max = h[k];
+      }
+   }
+   r.nonZero += nonZero;
+   r.count += i;
+   reduceScalar(a + i, n - i, r);
+}
+
+TERBIT_TARGET_AVX2 static double dotAvx2(const double* a, const double* b, size_t n)
+{
+   __m256d sum = _mm256_setzero_pd();
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+   }
+   double s[4];
+   _mm256_storeu_pd(s, sum);
+   return (s[0] + s[1]) + (s[2] + s[3]) + dotScalar(a + i, b + i, n - i);
+}
+
+TERBIT_TARGET_AVX2 static double sumSquaredDeviationAvx2(const double* a, double mean, size_t n)
+{
+   __m256d m = _mm256_set1_pd(mean);
+   __m256d sum = _mm256_setzero_pd();
+   size_t i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + i), m);
+      sum = _mm256_add_pd(sum, _mm256_mul_pd(d, d));
+   }
+   double s[4];
+   _mm256_storeu_pd(s, sum);
+   return (s[0] + s[1]) + (s[2] + s[3]) + sumSquaredDeviationScalar(a + i, mean, n - i);
+}
+
+#endif // TERBIT_VEC_X86
+
+// -------------------------------- dispatch --------------------------------
+
+template<typename Op>
+static void binary(const double* a, const double* b, double* out, size_t n)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      binaryAvx2<Op>(a, b, out, n);
+      return;
+   }
+#endif
+   binaryScalar<Op>(a, b, out, n);
+}
+
+template<typename Op>
+static void unary(const double* a, double* out, size_t n)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      unaryAvx2<Op>(a, out, n);
+      return;
+   }
+#endif
+   unaryScalar<Op>(a, out, n);
+}
+
+void VecBinary(VecBinaryOp op, const double* a, const double* b, double* out, size_t n)
+{
+   switch(op)
+   {
+   case VEC_ADD:
+      binary<VecAddOp>(a, b, out, n);
+      break;
+   case VEC_SUB:
+      binary<VecSubOp>(a, b, out, n);
+      break;
+   case VEC_MUL:
+      binary<VecMulOp>(a, b, out, n);
+      break;
+   case VEC_DIV:
+      binary<VecDivOp>(a, b, out, n);
+      break;
+   case VEC_MIN:
+      binary<VecMinOp>(a, b, out, n);
+      break;
+   case VEC_MAX:
+      binary<VecMaxOp>(a, b, out, n);
+      break;
+   }
+}
+
+void VecUnary(VecUnaryOp op, const double* a, double* out, size_t n)
+{
+   switch(op)
+   {
+   case VEC_ABS:
+      unary<VecAbsOp>(a, out, n);
+      break;
+   case VEC_NEG:
+      unary<VecNegOp>(a, out, n);
+      break;
+   case VEC_SQRT:
+      unary<VecSqrtOp>(a, out, n);
+      break;
+   case VEC_SQUARE:
+      unary<VecSquareOp>(a, out, n);
+      break;
+   case VEC_DB20:
+      dbScalar(a, 20.0, out, n);
+      break;
+   case VEC_DB10:
+      dbScalar(a, 10.0, out, n);
+      break;
+   }
+}
+
+void VecCompare(VecCompareOp op, const double* a, const double* b, double* out, size_t n)
+{
+   switch(op)
+   {
+   case VEC_LT:
+      binary<VecLtOp>(a, b, out, n);
+      break;
+   case VEC_LE:
+      binary<VecLeOp>(a, b, out, n);
+      break;
+   case VEC_GT:
+      binary<VecGtOp>(a, b, out, n);
+      break;
+   case VEC_GE:
+      binary<VecGeOp>(a, b, out, n);
+      break;
+   case VEC_EQ:
+      binary<VecEqOp>(a, b, out, n);
+      break;
+   case VEC_NE:
+      binary<VecNeOp>(a, b, out, n);
+      break;
+   }
+}
+
+void VecScaleOffset(const double* a, double scale, double offset, double* out, size_t n)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      scaleOffsetAvx2(a, scale, offset, out, n);
+      return;
+   }
+#endif
+   scaleOffsetScalar(a, scale, offset, out, n);
+}
+
+void VecClip(const double* a, double lo, double hi, double* out, size_t n)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      clipAvx2(a, lo, hi, out, n);
+      return;
+   }
+#endif
+   clipScalar(a, lo, hi, out, n);
+}
+
+void VecSelect(const double* mask, const double* a, const double* b, double* out, size_t n)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      selectAvx2(mask, a, b, out, n);
+      return;
+   }
+#endif
+   selectScalar(mask, a, b, out, n);
+}
+
+// each sum depends on the previous one, scalar on every target
+double VecCumSum(const double* a, double carry, double* out, size_t n)
+{
+   for(size_t i = 0; i < n; ++i)
+   {
+      carry += a[i];
+      out[i] = carry;
+   }
+   return carry;
+}
+
+void VecReduceInit(VecReduce_t& r)
+{
+   r.sum = 0.0;
+   r.min = std::numeric_limits<double>::infinity();
+   r.max = -std::numeric_limits<double>::infinity();
+   r.nonZero = 0;
+   r.count = 0;
+}
+
+void VecReduce(const double* a, size_t n, VecReduce_t& r)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      reduceAvx2(a, n, r);
+      return;
+   }
+#endif
+   reduceScalar(a, n, r);
+}
+
+void VecReduceMerge(VecReduce_t& r, const VecReduce_t& other)
+{
+   r.sum += other.sum;
+   if(other.min < r.min)
+   {
+      r.min = other.min;
+   }
+   if(other.max > r.max)
+   {
+      r.max = other.max;
+   }
+   r.nonZero += other.nonZero;
+   r.count += other.count;
+}
+
+double VecDot(const double* a, const double* b, size_t n)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      return dotAvx2(a, b, n);
+   }
+#endif
+   return dotScalar(a, b, n);
+}
+
+double VecSumSquaredDeviation(const double* a, double mean, size_t n)
+{
+#if TERBIT_VEC_X86
+   if(useAvx2())
+   {
+      return sumSquaredDeviationAvx2(a, mean, n);
+   }
+#endif
+   return sumSquaredDeviationScalar(a, mean, n);
+}
+
+}// namespace terbit
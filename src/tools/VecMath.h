@@ -0,0 +1,96 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace terbit
+{
+
+/*** Element-wise kernels over blocks of doubles for the script vector
+ * library.  Callers convert data set elements to doubles a block at a
+ * time (ConvertElements) and back, so one kernel serves every data type.
+ * Contiguous blocks run through AVX2 kernels picked at runtime on x86,
+ * otherwise scalar code.  out may be the same array as an input.
+ **************************************************************/
+
+typedef enum
+{
+   VEC_ADD,
+   VEC_SUB,
+   VEC_MUL,
+   VEC_DIV,
+   VEC_MIN,
+   VEC_MAX
+}VecBinaryOp;
+
+typedef enum
+{
+   VEC_ABS,
+   VEC_NEG,
+   VEC_SQRT,
+   VEC_SQUARE,
+   VEC_DB20,  // 20*log10(|x|), magnitude to dB
+   VEC_DB10   // 10*log10(|x|), power to dB
+}VecUnaryOp;
+
+// results are 1.0 or 0.0, NaN compares like C++ (only != is true)
+typedef enum
+{
+   VEC_LT,
+   VEC_LE,
+   VEC_GT,
+   VEC_GE,
+   VEC_EQ,
+   VEC_NE
+}VecCompareOp;
+
+// partial reduction of one or more blocks, NaN is skipped by min/max
+typedef struct
+{
+   double sum;
+   double min;
+   double max;
+   size_t nonZero;
+   size_t count;
+}VecReduce_t;
+
+void VecBinary(VecBinaryOp op, const double* a, const double* b, double* out, size_t n);
+void VecUnary(VecUnaryOp op, const double* a, double* out, size_t n);
+void VecCompare(VecCompareOp op, const double* a, const double* b, double* out, size_t n);
+
+// out = a*scale + offset
+void VecScaleOffset(const double* a, double scale, double offset, double* out, size_t n);
+// out = a clamped to [lo, hi]
+void VecClip(const double* a, double lo, double hi, double* out, size_t n);
+// out = mask != 0 ? a : b
+void VecSelect(const double* mask, const double* a, const double* b, double* out, size_t n);
+// running sum starting from carry, returns the last sum for the next block
+double VecCumSum(const double* a, double carry, double* out, size_t n);
+
+void VecReduceInit(VecReduce_t& r);
+void VecReduce(const double* a, size_t n, VecReduce_t& r);
+// combines the partial reductions of two ranges into r
+void VecReduceMerge(VecReduce_t& r, const VecReduce_t& other);
+double VecDot(const double* a, const double* b, size_t n);
+// sum of (a - mean)^2, the second pass of a two pass variance
+double VecSumSquaredDeviation(const double* a, double mean, size_t n);
+
+// Name of the kernel set in use ("avx2" or "scalar")
+const char* GetVecKernelName();
+
+}// namespace terbit
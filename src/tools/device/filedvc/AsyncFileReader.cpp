@@ -0,0 +1,680 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "AsyncFileReader.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <new>
+
+#if _WINDOWS
+#include <io.h>
+#include <malloc.h>
+#else
+#include <unistd.h>
+#include <aio.h>
+#include <stdlib.h>
+#endif
+
+#if TERBIT_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace terbit
+{
+
+/*** Issues reads into numbered slots and waits for them by slot.  The
+ * reader always waits for slots in the order it submitted them.
+ **************************************************************/
+class AsyncReadBackend
+{
+public:
+   virtual ~AsyncReadBackend() {}
+   virtual bool Submit(size_t slot, int fd, void* buf, size_t bytes, uint64_t offset) = 0;
+   // result is the byte count or a negative errno
+   virtual bool Wait(size_t slot, int64_t& result) = 0;
+};
+
+// Blocking fallback, the read happens at submit time
+class SyncBackend : public AsyncReadBackend
+{
+public:
+   SyncBackend(uint32_t depth) : m_results(depth, 0) {}
+
+   bool Submit(size_t slot, int fd, void* buf, size_t bytes, uint64_t offset)
+   {
+#if _WINDOWS
+      int64_t n = -1;
+      if(_lseeki64(fd, offset, SEEK_SET) >= 0)
+      {
+         n = _read(fd, buf, (unsigned int)bytes);
+      }
+      m_results[slot] = (n < 0) ? -errno : n;
+#else
+      size_t total = 0;
+      ssize_t n = 1;
+      while(total < bytes && n > 0)
+      {
+         n = pread(fd, (char*)buf + total, bytes - total, offset + total);
+         if(n > 0)
+         {
+            total += n;
+         }
+         else if(n < 0 && EINTR == errno)
+         {
+            n = 1;
+         }
+      }
+      m_results[slot] = (n < 0) ? -errno : (int64_t)total;
+#endif
+      return true;
+   }
+
+   bool Wait(size_t slot, int64_t& result)
+   {
+      result = m_results[slot];
+      return true;
+   }
+
+private:
+   std::vector<int64_t> m_results;
+};
+
+#if !_WINDOWS
+class PosixAioBackend : public AsyncReadBackend
+{
+public:
+   PosixAioBackend(uint32_t depth) : m_cbs(depth) {}
+
+   bool Submit(size_t slot, int fd, void* buf, size_t bytes, uint64_t offset)
+   {
+      struct aiocb& cb = m_cbs[slot];
+      memset(&cb, 0, sizeof(cb));
+      cb.aio_fildes = fd;
+      cb.aio_buf    = buf;
+      cb.aio_nbytes = bytes;
+      cb.aio_offset = offset;
+      return 0 == aio_read(&cb);
+   }
+
+   bool Wait(size_t slot, int64_t& result)
+   {
+      struct aiocb* list[1] = {&m_cbs[slot]};
+      int err;
+      while(EINPROGRESS == (err = aio_error(list[0])))
+      {
+         aio_suspend(list, 1, NULL);
+      }
+      ssize_t n = aio_return(list[0]);
+      result = (n < 0) ? -err : n;
+      return true;
+   }
+
+private:
+   std::vector<struct aiocb> m_cbs;
+};
+#endif // !_WINDOWS
+
+#if TERBIT_IO_URING
+// io_uring through the raw system calls so there is no liburing dependency.
+// Single producer/consumer (the reader), so only the ring indices shared
+// with the kernel need ordering.
+class UringBackend : public AsyncReadBackend
+{
+public:
+   UringBackend(uint32_t depth) : m_iov(depth), m_done(depth, false), m_results(depth, 0) {}
+
+   ~UringBackend()
+   {
+      if(NULL != m_sqes)
+      {
+         munmap(m_sqes, m_sqesBytes);
+      }
+      if(NULL != m_cqPtr && m_cqPtr != m_sqPtr)
+      {
+         munmap(m_cqPtr, m_cqBytes);
+      }
+      if(NULL != m_sqPtr)
+      {
+         munmap(m_sqPtr, m_sqBytes);
+      }
+      if(m_ringFd >= 0)
+      {
+         close(m_ringFd);
+      }
+   }
+
+   bool Init(uint32_t depth)
+   {
+      struct io_uring_params p;
+      memset(&p, 0, sizeof(p));
+      m_ringFd = (int)syscall(__NR_io_uring_setup, depth, &p);
+      if(m_ringFd < 0)
+      {
+         return false;
+      }
+
+      m_sqBytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+      m_cqBytes = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+      bool single = 0 != (p.features & IORING_FEAT_SINGLE_MMAP);
+      if(single)
+      {
+         m_sqBytes = m_cqBytes = (m_sqBytes > m_cqBytes) ? m_sqBytes : m_cqBytes;
+      }
+
+      m_sqPtr = mmap(NULL, m_sqBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+      if(MAP_FAILED == m_sqPtr)
+      {
+         m_sqPtr = NULL;
+         return false;
+      }
+      if(single)
+      {
+         m_cqPtr = m_sqPtr;
+      }
+      else
+      {
+         m_cqPtr = mmap(NULL, m_cqBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+         if(MAP_FAILED == m_cqPtr)
+         {
+            m_cqPtr = NULL;
+            return false;
+         }
+      }
+      m_sqesBytes = p.sq_entries * sizeof(struct io_uring_sqe);
+      void* sqes = mmap(NULL, m_sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+      if(MAP_FAILED == sqes)
+      {
+         return false;
+      }
+      m_sqes = (struct io_uring_sqe*)sqes;
+
+      char* sq = (char*)m_sqPtr;
+      char* cq = (char*)m_cqPtr;
+      m_sqTail  = (unsigned*)(sq + p.sq_off.tail);
+      m_sqMask  = (unsigned*)(sq + p.sq_off.ring_mask);
+      m_sqArray = (unsigned*)(sq + p.sq_off.array);
+      m_cqHead  = (unsigned*)(cq + p.cq_off.head);
+      m_cqTail  = (unsigned*)(cq + p.cq_off.tail);
+      m_cqMask  = (unsigned*)(cq + p.cq_off.ring_mask);
+      m_cqes    = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+      return true;
+   }
+
+   bool Submit(size_t slot, int fd, void* buf, size_t bytes, uint64_t offset)
+   {
+      m_iov[slot].iov_base = buf;
+      m_iov[slot].iov_len  = bytes;
+      m_done[slot] = false;
+
+      unsigned tail = *m_sqTail;
+      unsigned idx  = tail & *m_sqMask;
+      struct io_uring_sqe* sqe = &m_sqes[idx];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode    = IORING_OP_READV;
+      sqe->fd        = fd;
+      sqe->addr      = (uint64_t)(uintptr_t)&m_iov[slot];
+      sqe->len       = 1;
+      sqe->off       = offset;
+      sqe->user_data = slot;
+      m_sqArray[idx] = idx;
+      __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+      int ret;
+      do
+      {
+         ret = (int)syscall(__NR_io_uring_enter, m_ringFd, 1, 0, 0, NULL, 0);
+      }while(ret < 0 && EINTR == errno);
+      return 1 == ret;
+   }
+
+   bool Wait(size_t slot, int64_t& result)
+   {
+      bool retVal = true;
+      while(!m_done[slot] && retVal)
+      {
+         unsigned head = *m_cqHead;
+         if(head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+         {
+            struct io_uring_cqe* cqe = &m_cqes[head & *m_cqMask];
+            m_done[cqe->user_data]    = true;
+            m_results[cqe->user_data] = cqe->res;
+            __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+         }
+         else if(syscall(__NR_io_uring_enter, m_ringFd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && EINTR != errno)
+         {
+            retVal = false;
+         }
+      }
+      result = m_results[slot];
+      return retVal;
+   }
+
+private:
+   int      m_ringFd    = -1;
+   void*    m_sqPtr     = NULL;
+   void*    m_cqPtr     = NULL;
+   size_t   m_sqBytes   = 0;
+   size_t   m_cqBytes   = 0;
+   size_t   m_sqesBytes = 0;
+   unsigned *m_sqTail = NULL, *m_sqMask = NULL, *m_sqArray = NULL;
+   unsigned *m_cqHead = NULL, *m_cqTail = NULL, *m_cqMask = NULL;
+   struct io_uring_sqe* m_sqes = NULL;
+   struct io_uring_cqe* m_cqes = NULL;
+   std::vector<struct iovec> m_iov;
+   std::vector<bool>         m_done;
+   std::vector<int64_t>      m_results;
+};
+#endif // TERBIT_IO_URING
+
+static char* allocAligned(size_t bytes)
+{
+#if _WINDOWS
+   return (char*)_aligned_malloc(bytes, ASYNC_ALIGN_BYTES);
+#else
+   void* p = NULL;
+   return (0 == posix_memalign(&p, ASYNC_ALIGN_BYTES, bytes)) ? (char*)p : NULL;
+#endif
+}
+
+static void freeAligned(char* p)
+{
+#if _WINDOWS
+   _aligned_free(p);
+#else
+   free(p);
+#endif
+}
+
+AsyncFileReader::AsyncFileReader()
+{
+
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+   Close();
+}
+
+const char* AsyncFileReader::GetBackendName(Backend_t backend)
+{
+   switch(backend)
+   {
+   case AsyncUring:
+      return "io_uring";
+   case AsyncPosix:
+      return "posix-aio";
+   case AsyncSync:
+      return "sync";
+   default:
+      return "auto";
+   }
+}
+
+bool AsyncFileReader::Open(const QString& filename, Backend_t backend, bool direct, size_t blockBytes, uint32_t depth)
+{
+   bool retVal = false;
+
+   Close();
+
+   // O_DIRECT wants sizes and offsets in whole alignment units
+   blockBytes = (blockBytes + ASYNC_ALIGN_BYTES - 1) / ASYNC_ALIGN_BYTES * ASYNC_ALIGN_BYTES;
+   if(0 == blockBytes)
+   {
+      blockBytes = ASYNC_DEFAULT_BLOCK_BYTES;
+   }
+   if(0 == depth)
+   {
+      depth = 1;
+   }
+
+   if(openFile(filename, direct))
+   {
+      // no point keeping more blocks than the file fills
+      uint64_t fileBlocks = (m_fileBytes + blockBytes - 1) / blockBytes;
+      if(fileBlocks < depth)
+      {
+         depth = (fileBlocks > 0) ? (uint32_t)fileBlocks : 1;
+      }
+      m_blockBytes = blockBytes;
+      retVal = true;
+      for(uint32_t i = 0; i < depth && retVal; ++i)
+      {
+         char* p = allocAligned(blockBytes);
+         if(NULL != p)
+         {
+            m_blocks.push_back(p);
+            m_blockPos.push_back(0);
+         }
+         else
+         {
+            retVal = false;
+         }
+      }
+
+      retVal = retVal && createBackend(backend);
+      if(retVal)
+      {
+         retVal = SeekBegin();
+      }
+      if(!retVal)
+      {
+         Close();
+      }
+   }
+   return retVal;
+}
+
+bool AsyncFileReader::openFile(const QString& filename, bool direct)
+{
+   std::string path = filename.toStdString();
+#if _WINDOWS
+   direct;
+#pragma warning( disable : 4996 )
+   m_fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#pragma warning( default : 4996 )
+   m_direct = false;
+#else
+   m_fd = -1;
+#ifdef O_DIRECT
+   if(direct)
+   {
+      m_fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+   }
+#endif
+   m_direct = (m_fd >= 0);
+   if(m_fd < 0)
+   {
+      m_fd = open(path.c_str(), O_RDONLY);
+   }
+#if defined(F_NOCACHE)
+   if(direct && m_fd >= 0)
+   {
+      m_direct = (0 == fcntl(m_fd, F_NOCACHE, 1));
+   }
+#endif
+#endif // _WINDOWS
+
+   if(m_fd >= 0)
+   {
+#if _WINDOWS
+      struct _stat64 st;
+      m_fileBytes = (0 == _fstat64(m_fd, &st)) ? st.st_size : 0;
+#else
+      struct stat st;
+      m_fileBytes = (0 == fstat(m_fd, &st)) ? st.st_size : 0;
+#endif
+   }
+   return m_fd >= 0;
+}
+
+bool AsyncFileReader::createBackend(Backend_t backend)
+{
+   uint32_t depth = (uint32_t)m_blocks.size();
+
+#if TERBIT_IO_URING
+   if(AsyncAuto == backend || AsyncUring == backend)
+   {
+      UringBackend* b = new(std::nothrow) UringBackend(depth);
+      if(NULL != b && b->Init(depth))
+      {
+         m_backend = b;
+         m_backendType = AsyncUring;
+      }
+      else
+      {
+         delete b;
+      }
+   }
+#endif
+
+#if !_WINDOWS
+   if(NULL == m_backend && (AsyncAuto == backend || AsyncPosix == backend))
+   {
+      m_backend = new(std::nothrow) PosixAioBackend(depth);
+      m_backendType = AsyncPosix;
+   }
+#endif
+
+   if(NULL == m_backend && (AsyncAuto == backend || AsyncSync == backend))
+   {
+      m_backend = new(std::nothrow) SyncBackend(depth);
+      m_backendType = AsyncSync;
+   }
+
+   return NULL != m_backend;
+}
+
+void AsyncFileReader::Close(void)
+{
+   if(NULL != m_backend)
+   {
+      drain();
+      delete m_backend;
+      m_backend = NULL;
+   }
+   freeBlocks();
+   if(m_fd >= 0)
+   {
+#if _WINDOWS
+      _close(m_fd);
+#else
+      close(m_fd);
+#endif
+      m_fd = -1;
+   }
+   m_direct    = false;
+   m_error     = false;
+   m_fileBytes = 0;
+   m_filePos   = 0;
+   m_submitPos = 0;
+}
+
+void AsyncFileReader::freeBlocks(void)
+{
+   for(auto p : m_blocks)
+   {
+      freeAligned(p);
+   }
+   m_blocks.clear();
+   m_blockPos.clear();
+   m_head     = 0;
+   m_inFlight = 0;
+   m_held     = false;
+}
+
+// Wait out everything in flight so no read lands in a freed or reused block
+void AsyncFileReader::drain(void)
+{
+   int64_t result;
+   while(m_inFlight > 0)
+   {
+      m_backend->Wait(m_head, result);
+      m_head = (m_head + 1) % m_blocks.size();
+      --m_inFlight;
+   }
+   m_held = false;
+}
+
+void AsyncFileReader::submitNext(size_t slot)
+{
+   if(m_submitPos < m_fileBytes)
+   {
+      if(m_backend->Submit(slot, m_fd, m_blocks[slot], m_blockBytes, m_submitPos))
+      {
+         m_blockPos[slot] = m_submitPos;
+         m_submitPos += m_blockBytes;
+         ++m_inFlight;
+      }
+      else
+      {
+         m_error = true;
+         m_submitPos = m_fileBytes;
+      }
+   }
+}
+
+bool AsyncFileReader::SeekBegin(void)
+{
+   return Seek(0);
+}
+
+// Positions past the end of file leave nothing to read
+bool AsyncFileReader::Seek(uint64_t pos)
+{
+   if(!IsValid())
+   {
+      return false;
+   }
+
+   if(pos > m_fileBytes)
+   {
+      pos = m_fileBytes;
+   }
+   // O_DIRECT reads start on an alignment unit
+   uint64_t start = pos / ASYNC_ALIGN_BYTES * ASYNC_ALIGN_BYTES;
+
+   drain();
+   m_head      = 0;
+   m_submitPos = start;
+   m_filePos   = start;
+   m_heldBytes = 0;
+   m_heldPtr   = 0;
+   m_error     = false;
+   for(size_t i = 0; i < m_blocks.size(); ++i)
+   {
+      submitNext(i);
+   }
+
+   // the first block holds pos, Read() continues from there
+   if(pos > start && !m_error)
+   {
+      size_t n;
+      if(NULL != NextBlock(n))
+      {
+         m_heldPtr = (size_t)(pos - start) < n ? (size_t)(pos - start) : n;
+      }
+   }
+   return !m_error;
+}
+
+// result holds the bytes the block's read returned.  Anything short of the
+// block (or of the end of file, for the last one) is read again from where
+// it stopped; false when that fails or the file ends early, so the stream
+// never silently skips the missing bytes.
+bool AsyncFileReader::completeBlock(size_t slot, int64_t& result)
+{
+   uint64_t pos = m_blockPos[slot];
+   size_t want = (m_fileBytes - pos < m_blockBytes) ? (size_t)(m_fileBytes - pos) : m_blockBytes;
+   int64_t n = result;
+
+   while(n > 0 && (size_t)result < want)
+   {
+      if(!m_backend->Submit(slot, m_fd, m_blocks[slot] + result, want - result, pos + result) ||
+         !m_backend->Wait(slot, n))
+      {
+         n = -1;
+      }
+      else if(n > 0)
+      {
+         result += n;
+      }
+   }
+   return result < 0 || (size_t)result == want;
+}
+
+// Returns NULL at end of file or on a read failure (see GetError())
+const void* AsyncFileReader::NextBlock(size_t& nBytes)
+{
+   const void* retVal = NULL;
+   nBytes = 0;
+
+   if(!IsValid())
+   {
+      return NULL;
+   }
+
+   // the block the caller had is done with, queue the next read into it
+   if(m_held)
+   {
+      m_held = false;
+      submitNext(m_heldSlot);
+   }
+
+   if(m_inFlight > 0)
+   {
+      int64_t result;
+      size_t slot = m_head;
+      bool ok = m_backend->Wait(slot, result) && completeBlock(slot, result);
+      m_head = (m_head + 1) % m_blocks.size();
+      --m_inFlight;
+
+      if(ok && result > 0)
+      {
+         m_held      = true;
+         m_heldSlot  = slot;
+         m_heldBytes = (size_t)result;
+         m_heldPtr   = result;
+         m_filePos  += result;
+         nBytes      = (size_t)result;
+         retVal      = m_blocks[slot];
+      }
+      else if(!ok || result < 0)
+      {
+         // the blocks after a failed one would leave a gap in the stream
+         m_error = true;
+         m_submitPos = m_fileBytes;
+         drain();
+      }
+   }
+   return retVal;
+}
+
+uint64_t AsyncFileReader::Read(void* dst, uint64_t nBytes)
+{
+   uint64_t bytesXfrd = 0;
+   bool done = false;
+
+   while(bytesXfrd < nBytes && !done)
+   {
+      if(m_held && m_heldPtr < m_heldBytes)
+      {
+         uint64_t n = m_heldBytes - m_heldPtr;
+         if(n > nBytes - bytesXfrd)
+         {
+            n = nBytes - bytesXfrd;
+         }
+         memcpy((char*)dst + bytesXfrd, m_blocks[m_heldSlot] + m_heldPtr, n);
+         m_heldPtr += n;
+         bytesXfrd += n;
+      }
+      else
+      {
+         size_t n;
+         done = (NULL == NextBlock(n));
+         m_heldPtr = 0;
+      }
+   }
+   return bytesXfrd;
+}
+
+}// namespace terbit
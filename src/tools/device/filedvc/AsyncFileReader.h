@@ -0,0 +1,112 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <QString>
+
+namespace terbit
+{
+
+class AsyncReadBackend;
+
+static const size_t   ASYNC_DEFAULT_BLOCK_BYTES = 1024*1024;
+static const uint32_t ASYNC_DEFAULT_DEPTH       = 8;
+static const size_t   ASYNC_ALIGN_BYTES         = 4096;
+
+/*** Sequential file reader that keeps several block reads in flight.
+ * Blocks are aligned so the file can be opened with O_DIRECT (bypassing
+ * the page cache); if the file system refuses O_DIRECT the file is opened
+ * normally.  The reads are issued through a pluggable backend:
+ * o io_uring - Linux, when built with TERBIT_IO_URING and the kernel allows it
+ * o POSIX AIO - other POSIX systems, or when io_uring is unavailable
+ * o Sync - plain blocking reads (Windows), one block at a time
+ * NextBlock() hands out the blocks in file order without copying; the block
+ * stays valid until the next call, after which its buffer is reused for the
+ * next read.  Read() copies into a caller buffer instead.
+ * Seek() drops the reads in flight and starts again from the aligned block
+ * holding the new position, skipping up to it.
+ * A read that comes back short before the end of its block (split by the
+ * backend or interrupted) is continued for the rest of the block; if that
+ * fails the reader stops with GetError() set rather than skip the bytes.
+ **************************************************************/
+class AsyncFileReader
+{
+public:
+   typedef enum
+   {
+      AsyncAuto,
+      AsyncUring,
+      AsyncPosix,
+      AsyncSync
+   }Backend_t;
+
+   AsyncFileReader();
+   ~AsyncFileReader();
+
+   bool Open(const QString& filename, Backend_t backend = AsyncAuto, bool direct = true,
+             size_t blockBytes = ASYNC_DEFAULT_BLOCK_BYTES, uint32_t depth = ASYNC_DEFAULT_DEPTH);
+   void Close(void);
+
+   const void* NextBlock(size_t& nBytes);
+   uint64_t    Read(void* dst, uint64_t nBytes);
+   bool        SeekBegin(void);
+   bool        Seek(uint64_t pos);
+
+   bool      IsValid(void){return NULL != m_backend;}
+   bool      IsDirect(void){return m_direct;}
+   bool      GetError(void){return m_error;}
+   Backend_t GetBackend(void){return m_backendType;}
+   uint64_t  GetFileBytes(void){return m_fileBytes;}
+   // bytes handed out, Read() callers get the exact byte position
+   uint64_t  GetFilePos(void){return m_held ? m_filePos - (m_heldBytes - m_heldPtr) : m_filePos;}
+
+   static const char* GetBackendName(Backend_t backend);
+
+private:
+   AsyncFileReader(const AsyncFileReader& o); //disable copy ctor
+
+   bool openFile(const QString& filename, bool direct);
+   bool createBackend(Backend_t backend);
+   void submitNext(size_t slot);
+   bool completeBlock(size_t slot, int64_t& result);
+   void drain(void);
+   void freeBlocks(void);
+
+   int                m_fd          = -1;
+   bool               m_direct      = false;
+   bool               m_error       = false;
+   Backend_t          m_backendType = AsyncAuto;
+   AsyncReadBackend*  m_backend     = NULL;
+   std::vector<char*> m_blocks;
+   std::vector<uint64_t> m_blockPos; // file offset each block's read started at
+   size_t             m_blockBytes  = 0;
+   size_t             m_head        = 0; // oldest read in flight
+   size_t             m_inFlight    = 0;
+   bool               m_held        = false; // block m_heldSlot is out with the caller
+   size_t             m_heldSlot    = 0;
+   size_t             m_heldBytes   = 0;
+   size_t             m_heldPtr     = 0; // bytes of the held block consumed by Read()
+   uint64_t           m_submitPos   = 0;
+   uint64_t           m_filePos     = 0;
+   uint64_t           m_fileBytes   = 0;
+};
+
+}// namespace terbit
@@ -0,0 +1,525 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "AsyncFileWriter.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <QFileInfo>
+#include <boost/chrono.hpp>
+
+#if _WINDOWS
+#include <io.h>
+#include <malloc.h>
+#else
+#include <unistd.h>
+#include <stdlib.h>
+#endif
+
+namespace terbit
+{
+
+static char* allocAligned(size_t bytes)
+{
+#if _WINDOWS
+   return (char*)_aligned_malloc(bytes, WRITER_ALIGN_BYTES);
+#else
+   void* p = NULL;
+   return (0 == posix_memalign(&p, WRITER_ALIGN_BYTES, bytes)) ? (char*)p : NULL;
+#endif
+}
+
+static void freeAligned(char* p)
+{
+#if _WINDOWS
+   _aligned_free(p);
+#else
+   free(p);
+#endif
+}
+
+template <typename T>
+static void gatherElements(char* dst, const char* src, size_t count, size_t strideBytes)
+{
+   T* d = (T*)dst;
+   for(size_t i = 0; i < count; ++i, src += strideBytes)
+   {
+      d[i] = *(const T*)src;
+   }
+}
+
+AsyncFileWriter::AsyncFileWriter() : m_error(false)
+{
+   memset(&m_stats, 0, sizeof(m_stats));
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+   Close();
+}
+
+// blockBytes is rounded up to the alignment.  maxBlocks limits the memory
+// that can be queued: blockBytes * maxBlocks.
+bool AsyncFileWriter::Open(const QString& filename, uint64_t rotateBytes, bool direct, size_t blockBytes, uint32_t maxBlocks)
+{
+   bool retVal = false;
+
+   if(!IsOpen())
+   {
+      m_blockBytes   = ((blockBytes + WRITER_ALIGN_BYTES - 1) / WRITER_ALIGN_BYTES) * WRITER_ALIGN_BYTES;
+      if(0 == m_blockBytes)
+      {
+         m_blockBytes = WRITER_ALIGN_BYTES;
+      }
+      m_maxBlocks    = (maxBlocks < 2) ? 2 : maxBlocks;
+      m_rotateBytes  = ((rotateBytes + m_blockBytes - 1) / m_blockBytes) * m_blockBytes;
+      m_filePathName = filename;
+      m_directReq    = direct;
+      m_error        = false;
+      m_stop         = false;
+      m_totalBytes   = 0;
+      m_fill         = NULL;
+      m_fillBytes    = 0;
+      memset(&m_stats, 0, sizeof(m_stats));
+      m_writeNsSum   = 0;
+
+      if(openFile(0))
+      {
+         m_worker = new(std::nothrow) boost::thread(boost::bind(&AsyncFileWriter::writeLoop, this));
+         if(NULL == m_worker)
+         {
+            closeFile();
+         }
+         retVal = (NULL != m_worker);
+      }
+   }
+   return retVal;
+}
+
+void AsyncFileWriter::Close(void)
+{
+   if(IsOpen())
+   {
+      if(NULL != m_fill)
+      {
+         if(m_fillBytes > 0)
+         {
+            queueBlock(m_fill, m_fillBytes);
+         }
+         else
+         {
+            boost::lock_guard<boost::mutex> lock(m_mutex);
+            m_free.push_back(m_fill);
+         }
+         m_fill = NULL;
+      }
+
+      {
+         boost::lock_guard<boost::mutex> lock(m_mutex);
+         m_stop = true;
+      }
+      m_cond.notify_all();
+      m_worker->join();
+      delete m_worker;
+      m_worker = NULL;
+
+      closeFile();
+      freeBlocks();
+   }
+}
+
+void AsyncFileWriter::freeBlocks(void)
+{
+   for(auto p : m_blocks)
+   {
+      freeAligned(p);
+   }
+   m_blocks.clear();
+   m_free.clear();
+   m_queue.clear();
+}
+
+bool AsyncFileWriter::Write(const void* src, size_t nBytes)
+{
+   bool retVal = IsOpen() && !m_error;
+   const char* p = (const char*)src;
+
+   while(retVal && nBytes > 0)
+   {
+      if(NULL == m_fill)
+      {
+         m_fill = acquireBlock();
+         m_fillBytes = 0;
+         retVal = (NULL != m_fill);
+      }
+      if(retVal)
+      {
+         size_t n = m_blockBytes - m_fillBytes;
+         if(n > nBytes)
+         {
+            n = nBytes;
+         }
+         memcpy(m_fill + m_fillBytes, p, n);
+         m_fillBytes  += n;
+         m_totalBytes += n;
+         p      += n;
+         nBytes -= n;
+         if(m_fillBytes == m_blockBytes)
+         {
+            queueBlock(m_fill, m_fillBytes);
+            m_fill = NULL;
+         }
+      }
+   }
+   return retVal;
+}
+
+// Packs every strideBytes-th element straight into the pool blocks, the
+// caller doesn't need a contiguous copy of strided data.
+bool AsyncFileWriter::WriteStrided(const void* src, size_t eltBytes, size_t count, size_t strideBytes)
+{
+   if(strideBytes == eltBytes || 1 == count)
+   {
+      return Write(src, eltBytes * count);
+   }
+
+   bool retVal = IsOpen() && !m_error;
+   const char* p = (const char*)src;
+
+   while(retVal && count > 0)
+   {
+      if(NULL == m_fill)
+      {
+         m_fill = acquireBlock();
+         m_fillBytes = 0;
+         retVal = (NULL != m_fill);
+      }
+      if(retVal)
+      {
+         size_t n = (m_blockBytes - m_fillBytes) / eltBytes;
+         if(0 == n)
+         {
+            // element straddles the block end
+            retVal = Write(p, eltBytes);
+            p += strideBytes;
+            --count;
+            continue;
+         }
+         if(n > count)
+         {
+            n = count;
+         }
+         char* dst = m_fill + m_fillBytes;
+         switch(eltBytes)
+         {
+         case 1:
+            gatherElements<uint8_t>(dst, p, n, strideBytes);
+            break;
+         case 2:
+            gatherElements<uint16_t>(dst, p, n, strideBytes);
+            break;
+         case 4:
+            gatherElements<uint32_t>(dst, p, n, strideBytes);
+            break;
+         case 8:
+            gatherElements<uint64_t>(dst, p, n, strideBytes);
+            break;
+         default:
+            for(size_t i = 0; i < n; ++i)
+            {
+               memcpy(dst + i * eltBytes, p + i * strideBytes, eltBytes);
+            }
+            break;
+         }
+         m_fillBytes  += n * eltBytes;
+         m_totalBytes += n * eltBytes;
+         p     += n * strideBytes;
+         count -= n;
+         if(m_fillBytes == m_blockBytes)
+         {
+            queueBlock(m_fill, m_fillBytes);
+            m_fill = NULL;
+         }
+      }
+   }
+   return retVal;
+}
+
+// Free block, a new one while the pool is below the limit, otherwise wait
+// for the worker to finish one.
+char* AsyncFileWriter::acquireBlock(void)
+{
+   char* retVal = NULL;
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+
+   if(m_free.empty() && m_blocks.size() < m_maxBlocks)
+   {
+      retVal = allocAligned(m_blockBytes);
+      if(NULL != retVal)
+      {
+         m_blocks.push_back(retVal);
+      }
+   }
+
+   if(NULL == retVal && !m_blocks.empty())
+   {
+      if(m_free.empty())
+      {
+         ++m_stats.stallCount;
+      }
+      while(m_free.empty())
+      {
+         m_cond.wait(lock);
+      }
+      retVal = m_free.back();
+      m_free.pop_back();
+   }
+   return retVal;
+}
+
+void AsyncFileWriter::queueBlock(char* pBuf, size_t nBytes)
+{
+   Block_t b;
+   b.pBuf   = pBuf;
+   b.nBytes = nBytes;
+   {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_queue.push_back(b);
+      m_stats.backlogBytes += nBytes;
+      if(m_stats.backlogBytes > m_stats.maxBacklogBytes)
+      {
+         m_stats.maxBacklogBytes = m_stats.backlogBytes;
+      }
+   }
+   m_cond.notify_all();
+}
+
+// Worker: write the queued blocks in order.  After an error the blocks are
+// still returned to the pool so the producer never waits forever.
+void AsyncFileWriter::writeLoop(void)
+{
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+   while(true)
+   {
+      while(!m_stop && m_queue.empty())
+      {
+         m_cond.wait(lock);
+      }
+      if(m_queue.empty())
+      {
+         break; // stopped and drained
+      }
+
+      Block_t b = m_queue.front();
+      m_queue.pop_front();
+      bool error = m_error;
+      lock.unlock();
+
+      boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+      bool ok = !error && writeBlock(b);
+      uint64_t ns = boost::chrono::duration_cast<boost::chrono::nanoseconds>(boost::chrono::steady_clock::now() - start).count();
+
+      lock.lock();
+      m_free.push_back(b.pBuf);
+      m_stats.backlogBytes -= b.nBytes;
+      if(ok)
+      {
+         m_stats.bytesWritten += b.nBytes;
+         ++m_stats.blocksWritten;
+         m_writeNsSum += ns;
+         m_stats.lastWriteMs = ns / 1.0e6;
+         if(m_stats.lastWriteMs > m_stats.maxWriteMs)
+         {
+            m_stats.maxWriteMs = m_stats.lastWriteMs;
+         }
+         m_stats.meanWriteMs = m_writeNsSum / 1.0e6 / m_stats.blocksWritten;
+      }
+      else
+      {
+         m_error = true;
+      }
+      m_cond.notify_all();
+   }
+}
+
+bool AsyncFileWriter::writeBlock(const Block_t& b)
+{
+   if(m_rotateBytes > 0 && m_fileBytes >= m_rotateBytes)
+   {
+      closeFile();
+      if(!openFile(m_fileIdx + 1))
+      {
+         return false;
+      }
+   }
+
+#if defined(__linux__)
+   // keep the size so a reader of the file being written never sees the
+   // preallocated tail; closeFile() trims what wasn't used
+   if(m_fileBytes + b.nBytes > m_allocBytes)
+   {
+      uint64_t len = WRITER_PREALLOC_BYTES;
+      if(m_rotateBytes > 0 && m_allocBytes + len > m_rotateBytes)
+      {
+         len = m_rotateBytes - m_allocBytes;
+      }
+      if(len < b.nBytes)
+      {
+         len = b.nBytes;
+      }
+      fallocate(m_fd, FALLOC_FL_KEEP_SIZE, m_allocBytes, len);
+      m_allocBytes += len;
+   }
+#endif
+
+   // direct i/o needs whole aligned blocks, pad the last short block, the
+   // file is truncated to its real length on close
+   size_t nBytes = b.nBytes;
+   if(m_direct && 0 != nBytes % WRITER_ALIGN_BYTES)
+   {
+      size_t padded = ((nBytes + WRITER_ALIGN_BYTES - 1) / WRITER_ALIGN_BYTES) * WRITER_ALIGN_BYTES;
+      memset(b.pBuf + nBytes, 0, padded - nBytes);
+      nBytes = padded;
+   }
+
+   size_t done = 0;
+   while(done < nBytes)
+   {
+#if _WINDOWS
+      int n = _write(m_fd, b.pBuf + done, (unsigned int)(nBytes - done));
+#else
+      ssize_t n = write(m_fd, b.pBuf + done, nBytes - done);
+      if(n < 0 && EINTR == errno)
+      {
+         continue;
+      }
+#endif
+      if(n <= 0)
+      {
+         return false;
+      }
+      done += n;
+   }
+   m_fileBytes += b.nBytes;
+   return true;
+}
+
+bool AsyncFileWriter::openFile(uint32_t idx)
+{
+   QString name = buildFileName(idx);
+   std::string path = name.toStdString();
+
+#if _WINDOWS
+#pragma warning( disable : 4996 )
+   m_fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#pragma warning( default : 4996 )
+   m_direct = false;
+#else
+   m_fd = -1;
+#ifdef O_DIRECT
+   if(m_directReq)
+   {
+      m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+   }
+#endif
+   m_direct = (m_fd >= 0);
+   if(m_fd < 0)
+   {
+      m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   }
+#if defined(F_NOCACHE)
+   if(m_directReq && m_fd >= 0)
+   {
+      m_direct = (0 == fcntl(m_fd, F_NOCACHE, 1));
+   }
+#endif
+#endif // _WINDOWS
+
+   m_fileIdx    = idx;
+   m_fileBytes  = 0;
+   m_allocBytes = 0;
+   if(m_fd >= 0)
+   {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_curFilePathName = name;
+      ++m_stats.fileCount;
+   }
+   return m_fd >= 0;
+}
+
+// drops the padding of the last block and any unused preallocation
+void AsyncFileWriter::closeFile(void)
+{
+   if(m_fd >= 0)
+   {
+#if _WINDOWS
+      _chsize_s(m_fd, m_fileBytes);
+      _close(m_fd);
+#else
+      if(0 != ftruncate(m_fd, m_fileBytes))
+      {
+         m_error = true;
+      }
+      close(m_fd);
+#endif
+      m_fd = -1;
+   }
+}
+
+// name.ext, or name_0000.ext, name_0001.ext, ... when rotating
+QString AsyncFileWriter::buildFileName(uint32_t idx)
+{
+   if(0 == m_rotateBytes)
+   {
+      return m_filePathName;
+   }
+
+   QFileInfo fi(m_filePathName);
+   QString name = QString("%1/%2_%3").arg(fi.path()).arg(fi.completeBaseName()).arg(idx, 4, 10, QChar('0'));
+   if(!fi.suffix().isEmpty())
+   {
+      name.append(".").append(fi.suffix());
+   }
+   return name;
+}
+
+QString AsyncFileWriter::GetCurFilePathName(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   return m_curFilePathName;
+}
+
+AsyncFileWriter::Stats_t AsyncFileWriter::GetStats(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   return m_stats;
+}
+
+// backlog and file count describe the current state and are kept
+void AsyncFileWriter::ResetStats(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   uint64_t backlog = m_stats.backlogBytes;
+   uint32_t files   = m_stats.fileCount;
+   memset(&m_stats, 0, sizeof(m_stats));
+   m_stats.backlogBytes    = backlog;
+   m_stats.maxBacklogBytes = backlog;
+   m_stats.fileCount       = files;
+   m_writeNsSum = 0;
+}
+
+}// namespace terbit
@@ -0,0 +1,129 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <QString>
+#include <boost/thread.hpp>
+
+namespace terbit
+{
+
+static const size_t   WRITER_DEFAULT_BLOCK_BYTES = 4*1024*1024;
+static const uint32_t WRITER_DEFAULT_MAX_BLOCKS  = 64;
+static const uint64_t WRITER_PREALLOC_BYTES      = 64*1024*1024;
+static const size_t   WRITER_ALIGN_BYTES         = 4096;
+
+/*** Sequential file writer that does the disk writes on a worker thread.
+ * Write() copies the caller's data into fixed-size aligned blocks taken
+ * from a pool and queues each block once it is full, so the caller only
+ * pays for a memcpy.  The pool grows on demand up to maxBlocks; past that
+ * Write() waits for the worker to free a block (counted as a stall)
+ * instead of dropping data.
+ * o The file is opened with O_DIRECT when the file system allows it, every
+ *   write is a whole block.  Only the last block at Close() is short; it is
+ *   padded to the alignment and the file truncated to the real length.
+ * o Space is preallocated ahead of the write position (fallocate on Linux)
+ *   so the file system doesn't extend the file on every block.
+ * o With a rotate size the data goes to numbered files, name_0000.ext,
+ *   name_0001.ext, ... each holding rotateBytes (rounded up to whole blocks).
+ *   The files can be played back as a file list by the FileDevice.
+ **************************************************************/
+class AsyncFileWriter
+{
+public:
+   typedef struct
+   {
+      uint64_t bytesWritten;    // on disk
+      uint64_t blocksWritten;
+      uint64_t backlogBytes;    // queued, not yet on disk
+      uint64_t maxBacklogBytes;
+      uint64_t stallCount;      // Write() waited for a free block
+      uint32_t fileCount;
+      double   lastWriteMs;     // duration of the disk write of one block
+      double   maxWriteMs;
+      double   meanWriteMs;
+   }Stats_t;
+
+   AsyncFileWriter();
+   ~AsyncFileWriter();
+
+   bool Open(const QString& filename, uint64_t rotateBytes = 0, bool direct = true,
+             size_t blockBytes = WRITER_DEFAULT_BLOCK_BYTES, uint32_t maxBlocks = WRITER_DEFAULT_MAX_BLOCKS);
+   // writes out everything queued, blocks until done
+   void Close(void);
+
+   bool Write(const void* src, size_t nBytes);
+   bool WriteStrided(const void* src, size_t eltBytes, size_t count, size_t strideBytes);
+
+   bool     IsOpen(void){return NULL != m_worker;}
+   bool     IsDirect(void){return m_direct;}
+   bool     GetError(void){return m_error;}
+   uint64_t GetQueuedBytes(void){return m_totalBytes;}
+   QString  GetCurFilePathName(void);
+   Stats_t  GetStats(void);
+   void     ResetStats(void);
+
+private:
+   AsyncFileWriter(const AsyncFileWriter& o); //disable copy ctor
+
+   typedef struct
+   {
+      char*  pBuf;
+      size_t nBytes;
+   }Block_t;
+
+   char* acquireBlock(void);
+   void  queueBlock(char* pBuf, size_t nBytes);
+   void  writeLoop(void);
+   bool  writeBlock(const Block_t& b);
+   bool  openFile(uint32_t idx);
+   void  closeFile(void);
+   QString buildFileName(uint32_t idx);
+   void  freeBlocks(void);
+
+   QString              m_filePathName;
+   QString              m_curFilePathName;
+   uint64_t             m_rotateBytes = 0;
+   size_t               m_blockBytes  = 0;
+   uint32_t             m_maxBlocks   = 0;
+   bool                 m_direct      = false;
+   bool                 m_directReq   = false;
+   int                  m_fd          = -1;
+   uint32_t             m_fileIdx     = 0;
+   uint64_t             m_fileBytes   = 0; // written to the current file
+   uint64_t             m_allocBytes  = 0; // preallocated in the current file
+   uint64_t             m_totalBytes  = 0; // handed to Write(), producer only
+   char*                m_fill        = NULL; // block being filled, producer only
+   size_t               m_fillBytes   = 0;
+   std::vector<char*>   m_blocks;   // all blocks, for freeing
+   std::vector<char*>   m_free;
+   std::deque<Block_t>  m_queue;
+   bool                 m_stop        = false;
+   std::atomic<bool>    m_error;      // set by the worker, read by Write()
+   Stats_t              m_stats;
+   uint64_t             m_writeNsSum  = 0;
+   boost::thread*       m_worker      = NULL;
+   boost::mutex         m_mutex;
+   boost::condition_variable m_cond;
+};
+
+}// namespace terbit
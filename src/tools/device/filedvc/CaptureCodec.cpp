@@ -0,0 +1,276 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "CaptureCodec.h"
+#include <stdio.h>
+#include <string.h>
+
+#if _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace terbit
+{
+
+static_assert(sizeof(CaptureHeader_t) == 64, "capture header layout");
+static_assert(sizeof(CaptureIndexEntry_t) == 16, "capture index layout");
+static_assert(sizeof(CaptureFooter_t) == 32, "capture footer layout");
+
+// number of bits needed to hold v
+static inline unsigned bitWidth(uint64_t v)
+{
+   if(0 == v)
+   {
+      return 0;
+   }
+#if _MSC_VER
+   unsigned long idx;
+   _BitScanReverse64(&idx, v);
+   return idx + 1;
+#else
+   return 64 - __builtin_clzll(v);
+#endif
+}
+
+// n values of b bits each, LSB first.  Writes (n*b+7)/8 bytes.
+static uint8_t* packBits(const uint64_t* v, size_t n, unsigned b, uint8_t* out)
+{
+   uint64_t acc  = 0;
+   unsigned nAcc = 0;
+
+   if(0 == b)
+   {
+      return out;
+   }
+
+   for(size_t i = 0; i < n; ++i)
+   {
+      acc |= v[i] << nAcc;
+      unsigned room = 64 - nAcc;
+      if(b >= room)
+      {
+         memcpy(out, &acc, 8);
+         out += 8;
+         acc  = (room < 64) ? v[i] >> room : 0;
+         nAcc = b - room;
+      }
+      else
+      {
+         nAcc += b;
+      }
+   }
+   unsigned tail = (nAcc + 7) / 8;
+   memcpy(out, &acc, tail);
+   return out + tail;
+}
+
+static void unpackBits(const uint8_t* in, size_t n, unsigned b, uint64_t* v)
+{
+   if(0 == b)
+   {
+      memset(v, 0, n * sizeof(uint64_t));
+      return;
+   }
+
+   // copy the block with zero padding so every value is a plain 8 byte load
+   uint8_t  pad[CAPTURE_BLOCK_ELTS * 8 + 16];
+   size_t   nBytes = (n * b + 7) / 8;
+   uint64_t mask   = (64 == b) ? ~(uint64_t)0 : (((uint64_t)1 << b) - 1);
+   size_t   bitPos = 0;
+
+   memcpy(pad, in, nBytes);
+   memset(pad + nBytes, 0, 16);
+   for(size_t i = 0; i < n; ++i, bitPos += b)
+   {
+      size_t   byte = bitPos >> 3;
+      unsigned sh   = bitPos & 7;
+      uint64_t w;
+      memcpy(&w, pad + byte, 8);
+      uint64_t val = w >> sh;
+      if(sh + b > 64)
+      {
+         val |= (uint64_t)pad[byte + 8] << (64 - sh);
+      }
+      v[i] = val & mask;
+   }
+}
+
+// U is the unsigned type of the element width, deltas wrap in that width
+template <typename U>
+static size_t encodeDelta(const U* src, size_t nElts, uint8_t* dst)
+{
+   const unsigned bits = sizeof(U) * 8;
+   uint64_t zz[CAPTURE_BLOCK_ELTS];
+   uint8_t* p = dst;
+   U prev = 0;
+
+   *p++ = CAPTURE_CODEC_DELTA;
+   for(size_t start = 0; start < nElts; start += CAPTURE_BLOCK_ELTS)
+   {
+      size_t m = nElts - start;
+      if(m > CAPTURE_BLOCK_ELTS)
+      {
+         m = CAPTURE_BLOCK_ELTS;
+      }
+
+      uint64_t all = 0;
+      for(size_t i = 0; i < m; ++i)
+      {
+         U v = src[start + i];
+         U d = (U)(v - prev);
+         prev = v;
+         U z = (U)((U)(d << 1) ^ (U)(0 - (d >> (bits - 1))));
+         zz[i] = z;
+         all |= z;
+      }
+
+      unsigned b = bitWidth(all);
+      *p++ = (uint8_t)b;
+      p = packBits(zz, m, b, p);
+   }
+   return p - dst;
+}
+
+template <typename U>
+static bool decodeDelta(const uint8_t* src, size_t srcBytes, size_t nElts, U* dst)
+{
+   const unsigned bits = sizeof(U) * 8;
+   uint64_t zz[CAPTURE_BLOCK_ELTS];
+   const uint8_t* p   = src;
+   const uint8_t* end = src + srcBytes;
+   U prev = 0;
+
+   for(size_t start = 0; start < nElts; start += CAPTURE_BLOCK_ELTS)
+   {
+      size_t m = nElts - start;
+      if(m > CAPTURE_BLOCK_ELTS)
+      {
+         m = CAPTURE_BLOCK_ELTS;
+      }
+
+      if(p >= end)
+      {
+         return false;
+      }
+      unsigned b = *p++;
+      size_t nBytes = (m * b + 7) / 8;
+      if(b > bits || (size_t)(end - p) < nBytes)
+      {
+         return false;
+      }
+      unpackBits(p, m, b, zz);
+      p += nBytes;
+
+      for(size_t i = 0; i < m; ++i)
+      {
+         U z = (U)zz[i];
+         U d = (U)((U)(z >> 1) ^ (U)(0 - (z & 1)));
+         prev = (U)(prev + d);
+         dst[start + i] = prev;
+      }
+   }
+   return true;
+}
+
+size_t CaptureMaxChunkBytes(size_t eltBytes, size_t nElts)
+{
+   // raw, or packing at full width plus a width byte per block
+   return 1 + nElts * eltBytes + (nElts + CAPTURE_BLOCK_ELTS - 1) / CAPTURE_BLOCK_ELTS;
+}
+
+size_t CaptureEncodeChunk(const void* src, size_t eltBytes, size_t nElts, uint8_t* dst)
+{
+   size_t retVal = 0;
+   size_t rawBytes = 1 + nElts * eltBytes;
+
+   switch(eltBytes)
+   {
+   case 1:
+      retVal = encodeDelta<uint8_t>((const uint8_t*)src, nElts, dst);
+      break;
+   case 2:
+      retVal = encodeDelta<uint16_t>((const uint16_t*)src, nElts, dst);
+      break;
+   case 4:
+      retVal = encodeDelta<uint32_t>((const uint32_t*)src, nElts, dst);
+      break;
+   case 8:
+      retVal = encodeDelta<uint64_t>((const uint64_t*)src, nElts, dst);
+      break;
+   default:
+      break;
+   }
+
+   if(0 == retVal || retVal >= rawBytes)
+   {
+      dst[0] = CAPTURE_CODEC_RAW;
+      memcpy(dst + 1, src, nElts * eltBytes);
+      retVal = rawBytes;
+   }
+   return retVal;
+}
+
+bool CaptureDecodeChunk(const uint8_t* src, size_t srcBytes, size_t eltBytes, size_t nElts, void* dst)
+{
+   bool retVal = false;
+
+   if(srcBytes > 0 && CAPTURE_CODEC_RAW == src[0])
+   {
+      retVal = (srcBytes - 1 == nElts * eltBytes);
+      if(retVal)
+      {
+         memcpy(dst, src + 1, nElts * eltBytes);
+      }
+   }
+   else if(srcBytes > 0 && CAPTURE_CODEC_DELTA == src[0])
+   {
+      switch(eltBytes)
+      {
+      case 1:
+         retVal = decodeDelta<uint8_t>(src + 1, srcBytes - 1, nElts, (uint8_t*)dst);
+         break;
+      case 2:
+         retVal = decodeDelta<uint16_t>(src + 1, srcBytes - 1, nElts, (uint16_t*)dst);
+         break;
+      case 4:
+         retVal = decodeDelta<uint32_t>(src + 1, srcBytes - 1, nElts, (uint32_t*)dst);
+         break;
+      case 8:
+         retVal = decodeDelta<uint64_t>(src + 1, srcBytes - 1, nElts, (uint64_t*)dst);
+         break;
+      default:
+         break;
+      }
+   }
+   return retVal;
+}
+
+bool IsCaptureFile(const QString& filename)
+{
+   bool retVal = false;
+   uint32_t magic = 0;
+
+#pragma warning( disable : 4996 )
+   FILE* f = fopen(filename.toStdString().c_str(), "rb");
+#pragma warning( default : 4996 )
+   if(NULL != f)
+   {
+      retVal = (1 == fread(&magic, sizeof(magic), 1, f)) && CAPTURE_MAGIC == magic;
+      fclose(f);
+   }
+   return retVal;
+}
+
+}// namespace terbit
@@ -0,0 +1,99 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <QString>
+
+namespace terbit
+{
+
+/*** Chunked capture container (.tbc)
+ *
+ *   Header      64 bytes, CaptureHeader_t
+ *   Chunk 0..n  independently compressed, see CaptureEncodeChunk()
+ *   Index       CaptureIndexEntry_t per chunk
+ *   Footer      32 bytes, CaptureFooter_t
+ *
+ * Everything the writer knows up front is in the header; the index and
+ * footer are appended on close so a recording is written strictly
+ * sequentially.  A reader finds the index through the footer at the end
+ * of the file.  All chunks hold chunkElts elements except the last.
+ * Values are little-endian.
+ *
+ * Chunk codec: the first byte selects the encoding.
+ * o CAPTURE_CODEC_RAW - the elements as is.
+ * o CAPTURE_CODEC_DELTA - each element minus the previous one (0 before
+ *   the first element of the chunk) in the element width with wrap-around,
+ *   zigzag mapped so small negative deltas are small numbers, then bit
+ *   packed in blocks of 128 values.  Each block is one byte holding the bit
+ *   width of its largest value, followed by the values packed LSB first.
+ *   Slowly varying ADC codes need only a few bits per sample.
+ * The encoder falls back to raw when packing doesn't help (e.g. noise or
+ * floating point data).  The codec only depends on the element size, it
+ * is lossless for every data type.
+ **************************************************************/
+
+static const uint32_t CAPTURE_MAGIC        = 0x43434254; // "TBCC"
+static const uint32_t CAPTURE_FOOTER_MAGIC = 0x45434254; // "TBCE"
+static const uint16_t CAPTURE_VERSION      = 1;
+static const uint32_t CAPTURE_DEFAULT_CHUNK_ELTS = 256*1024;
+static const size_t   CAPTURE_BLOCK_ELTS   = 128;
+
+static const uint8_t  CAPTURE_CODEC_RAW    = 0;
+static const uint8_t  CAPTURE_CODEC_DELTA  = 1;
+
+typedef struct
+{
+   uint32_t magic;
+   uint16_t version;
+   uint16_t headerBytes;
+   uint32_t dataType;      // TerbitDataType
+   uint32_t eltBytes;
+   uint32_t samplingBits;  // 0 if unknown
+   uint32_t chunkElts;
+   double   samplingRate;  // Hz, 0 if unknown
+   uint8_t  reserved[32];
+}CaptureHeader_t;
+
+typedef struct
+{
+   uint64_t offset;
+   uint32_t bytes;
+   uint32_t nElts;
+}CaptureIndexEntry_t;
+
+typedef struct
+{
+   uint64_t indexOffset;
+   uint64_t chunkCount;
+   uint64_t totalElts;
+   uint32_t reserved;
+   uint32_t magic;
+}CaptureFooter_t;
+
+// worst case size of an encoded chunk
+size_t CaptureMaxChunkBytes(size_t eltBytes, size_t nElts);
+// returns the encoded size, dst must hold CaptureMaxChunkBytes()
+size_t CaptureEncodeChunk(const void* src, size_t eltBytes, size_t nElts, uint8_t* dst);
+bool   CaptureDecodeChunk(const uint8_t* src, size_t srcBytes, size_t eltBytes, size_t nElts, void* dst);
+
+// true if the file starts with a capture header
+bool   IsCaptureFile(const QString& filename);
+
+}// namespace terbit
@@ -0,0 +1,374 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "ChunkedCaptureWriter.h"
+#include <string.h>
+#include <algorithm>
+
+namespace terbit
+{
+
+static const uint32_t CHUNKED_WRITER_MAX_THREADS = 8;
+
+template <typename T>
+static void gatherChunkElements(char* dst, const char* src, size_t count, size_t strideBytes)
+{
+   T* d = (T*)dst;
+   for(size_t i = 0; i < count; ++i, src += strideBytes)
+   {
+      d[i] = *(const T*)src;
+   }
+}
+
+ChunkedCaptureWriter::ChunkedCaptureWriter()
+{
+}
+
+ChunkedCaptureWriter::~ChunkedCaptureWriter()
+{
+   Close();
+}
+
+bool ChunkedCaptureWriter::Open(const QString& filename, uint32_t dataType, size_t eltBytes,
+                                double samplingRate, uint32_t samplingBits,
+                                bool direct, uint32_t maxBlocks,
+                                uint32_t threads, uint32_t chunkElts)
+{
+   CaptureHeader_t header;
+
+   if(IsOpen() || 0 == chunkElts ||
+      (1 != eltBytes && 2 != eltBytes && 4 != eltBytes && 8 != eltBytes))
+   {
+      return false;
+   }
+
+   if(!m_file.Open(filename, 0, direct, WRITER_DEFAULT_BLOCK_BYTES, maxBlocks))
+   {
+      return false;
+   }
+
+   memset(&header, 0, sizeof(header));
+   header.magic        = CAPTURE_MAGIC;
+   header.version      = CAPTURE_VERSION;
+   header.headerBytes  = sizeof(header);
+   header.dataType     = dataType;
+   header.eltBytes     = (uint32_t)eltBytes;
+   header.samplingBits = samplingBits;
+   header.chunkElts    = chunkElts;
+   header.samplingRate = samplingRate;
+   m_file.Write(&header, sizeof(header));
+
+   if(0 == threads)
+   {
+      threads = std::min(std::max(boost::thread::hardware_concurrency(), 1u), CHUNKED_WRITER_MAX_THREADS);
+   }
+
+   m_eltBytes   = eltBytes;
+   m_chunkBytes = (size_t)chunkElts * eltBytes;
+   m_slots.resize(2 * threads);
+   for(auto& s : m_slots)
+   {
+      s.raw.resize(m_chunkBytes);
+      s.enc.resize(CaptureMaxChunkBytes(eltBytes, chunkElts));
+      s.rawBytes = 0;
+      s.encBytes = 0;
+      s.state    = SlotFree;
+   }
+   m_index.clear();
+   m_fileOffset = sizeof(header);
+   m_encBytes   = 0;
+   m_totalBytes = 0;
+   m_fill       = NULL;
+   m_fillSeq    = 0;
+   m_encodeSeq  = 0;
+   m_writeSeq   = 0;
+   m_draining   = false;
+   m_error      = false;
+   m_stallCount = 0;
+
+   m_stop = false;
+   for(uint32_t i = 0; i < threads; ++i)
+   {
+      m_workers.push_back(new boost::thread(boost::bind(&ChunkedCaptureWriter::encodeLoop, this)));
+   }
+   return true;
+}
+
+void ChunkedCaptureWriter::Close(void)
+{
+   CaptureFooter_t footer;
+
+   if(!IsOpen())
+   {
+      return;
+   }
+
+   if(NULL != m_fill && m_fill->rawBytes >= m_eltBytes)
+   {
+      queueFill();
+   }
+   m_fill = NULL;
+
+   {
+      boost::unique_lock<boost::mutex> lock(m_mutex);
+      while(m_writeSeq < m_fillSeq)
+      {
+         m_cond.wait(lock);
+      }
+   }
+   stopWorkers();
+
+   memset(&footer, 0, sizeof(footer));
+   footer.indexOffset = m_fileOffset;
+   footer.chunkCount  = m_index.size();
+   footer.magic       = CAPTURE_FOOTER_MAGIC;
+   for(auto& e : m_index)
+   {
+      footer.totalElts += e.nElts;
+   }
+   if(!m_index.empty())
+   {
+      m_file.Write(&m_index[0], m_index.size() * sizeof(CaptureIndexEntry_t));
+   }
+   m_file.Write(&footer, sizeof(footer));
+   m_file.Close();
+
+   m_slots.clear();
+   m_index.clear();
+}
+
+void ChunkedCaptureWriter::stopWorkers(void)
+{
+   {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_stop = true;
+   }
+   m_cond.notify_all();
+   for(auto w : m_workers)
+   {
+      w->join();
+      delete w;
+   }
+   m_workers.clear();
+}
+
+// The slot for the next chunk is free once the chunk that used it a lap
+// ago has been drained to the file writer.
+bool ChunkedCaptureWriter::acquireFill(void)
+{
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+   Slot_t& s = m_slots[m_fillSeq % m_slots.size()];
+   if(SlotFree != s.state)
+   {
+      ++m_stallCount;
+      while(SlotFree != s.state && !m_error)
+      {
+         m_cond.wait(lock);
+      }
+   }
+   if(!m_error)
+   {
+      m_fill = &s;
+      m_fill->rawBytes = 0;
+   }
+   return !m_error;
+}
+
+void ChunkedCaptureWriter::queueFill(void)
+{
+   {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_fill->state = SlotQueued;
+      ++m_fillSeq;
+   }
+   m_fill = NULL;
+   m_cond.notify_all();
+}
+
+void ChunkedCaptureWriter::encodeLoop(void)
+{
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+   while(true)
+   {
+      while(!m_stop && m_encodeSeq >= m_fillSeq)
+      {
+         m_cond.wait(lock);
+      }
+      if(m_stop)
+      {
+         break;
+      }
+
+      Slot_t& s = m_slots[m_encodeSeq % m_slots.size()];
+      ++m_encodeSeq;
+      s.state = SlotEncoding;
+      lock.unlock();
+
+      s.encBytes = CaptureEncodeChunk(&s.raw[0], m_eltBytes, s.rawBytes / m_eltBytes, &s.enc[0]);
+
+      lock.lock();
+      s.state = SlotEncoded;
+      drain(lock);
+   }
+}
+
+// Hands the encoded chunks to the file writer in sequence order.  Only one
+// thread drains at a time; the file write itself is done unlocked.
+void ChunkedCaptureWriter::drain(boost::unique_lock<boost::mutex>& lock)
+{
+   while(!m_draining && m_writeSeq < m_fillSeq)
+   {
+      Slot_t& s = m_slots[m_writeSeq % m_slots.size()];
+      if(SlotEncoded != s.state)
+      {
+         break;
+      }
+
+      m_draining = true;
+      lock.unlock();
+      bool ok = m_file.Write(&s.enc[0], s.encBytes);
+      lock.lock();
+
+      CaptureIndexEntry_t e;
+      e.offset = m_fileOffset;
+      e.bytes  = (uint32_t)s.encBytes;
+      e.nElts  = (uint32_t)(s.rawBytes / m_eltBytes);
+      m_index.push_back(e);
+      m_fileOffset += s.encBytes;
+      m_encBytes   += s.encBytes;
+      if(!ok)
+      {
+         m_error = true;
+      }
+      s.state    = SlotFree;
+      m_draining = false;
+      ++m_writeSeq;
+      m_cond.notify_all();
+   }
+}
+
+bool ChunkedCaptureWriter::Write(const void* src, size_t nBytes)
+{
+   bool retVal = IsOpen() && !GetError();
+   const char* p = (const char*)src;
+
+   while(retVal && nBytes > 0)
+   {
+      if(NULL == m_fill)
+      {
+         retVal = acquireFill();
+      }
+      if(retVal)
+      {
+         size_t n = std::min(m_chunkBytes - m_fill->rawBytes, nBytes);
+         memcpy(&m_fill->raw[m_fill->rawBytes], p, n);
+         m_fill->rawBytes += n;
+         m_totalBytes     += n;
+         p      += n;
+         nBytes -= n;
+         if(m_fill->rawBytes == m_chunkBytes)
+         {
+            queueFill();
+         }
+      }
+   }
+   return retVal;
+}
+
+bool ChunkedCaptureWriter::WriteStrided(const void* src, size_t eltBytes, size_t count, size_t strideBytes)
+{
+   if(strideBytes == eltBytes || 1 == count)
+   {
+      return Write(src, eltBytes * count);
+   }
+
+   bool retVal = IsOpen() && !GetError();
+   const char* p = (const char*)src;
+
+   while(retVal && count > 0)
+   {
+      if(NULL == m_fill)
+      {
+         retVal = acquireFill();
+      }
+      if(retVal)
+      {
+         size_t n = (m_chunkBytes - m_fill->rawBytes) / eltBytes;
+         if(0 == n)
+         {
+            // element straddles the chunk end
+            retVal = Write(p, eltBytes);
+            p += strideBytes;
+            --count;
+            continue;
+         }
+         if(n > count)
+         {
+            n = count;
+         }
+         char* dst = &m_fill->raw[m_fill->rawBytes];
+         switch(eltBytes)
+         {
+         case 1:
+            gatherChunkElements<uint8_t>(dst, p, n, strideBytes);
+            break;
+         case 2:
+            gatherChunkElements<uint16_t>(dst, p, n, strideBytes);
+            break;
+         case 4:
+            gatherChunkElements<uint32_t>(dst, p, n, strideBytes);
+            break;
+         case 8:
+            gatherChunkElements<uint64_t>(dst, p, n, strideBytes);
+            break;
+         default:
+            for(size_t i = 0; i < n; ++i)
+            {
+               memcpy(dst + i * eltBytes, p + i * strideBytes, eltBytes);
+            }
+            break;
+         }
+         m_fill->rawBytes += n * eltBytes;
+         m_totalBytes     += n * eltBytes;
+         p     += n * strideBytes;
+         count -= n;
+         if(m_fill->rawBytes == m_chunkBytes)
+         {
+            queueFill();
+         }
+      }
+   }
+   return retVal;
+}
+
+bool ChunkedCaptureWriter::GetError(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   return m_error || m_file.GetError();
+}
+
+uint64_t ChunkedCaptureWriter::GetEncodedBytes(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   return m_encBytes;
+}
+
+uint64_t ChunkedCaptureWriter::GetStallCount(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   return m_stallCount;
+}
+
+}// namespace terbit
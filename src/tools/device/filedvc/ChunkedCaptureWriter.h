@@ -0,0 +1,109 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <QString>
+#include <boost/thread.hpp>
+#include "AsyncFileWriter.h"
+#include "CaptureCodec.h"
+
+namespace terbit
+{
+
+/*** Records a chunked capture container (see CaptureCodec.h).
+ * Write() copies into the chunk being filled.  Full chunks are encoded by
+ * worker threads in parallel and handed to an AsyncFileWriter strictly in
+ * order, so the disk sees one sequential stream.  Whichever worker
+ * finishes the oldest outstanding chunk drains it to the file writer.
+ * With all slots taken Write() waits for the encoders (counted as a stall
+ * on top of the file writer's own stalls).
+ * Close() encodes the partial last chunk and appends the index and footer.
+ **************************************************************/
+class ChunkedCaptureWriter
+{
+public:
+   ChunkedCaptureWriter();
+   ~ChunkedCaptureWriter();
+
+   bool Open(const QString& filename, uint32_t dataType, size_t eltBytes,
+             double samplingRate = 0.0, uint32_t samplingBits = 0,
+             bool direct = true, uint32_t maxBlocks = WRITER_DEFAULT_MAX_BLOCKS,
+             uint32_t threads = 0, uint32_t chunkElts = CAPTURE_DEFAULT_CHUNK_ELTS);
+   // encodes and writes out everything queued, blocks until done
+   void Close(void);
+
+   bool Write(const void* src, size_t nBytes);
+   bool WriteStrided(const void* src, size_t eltBytes, size_t count, size_t strideBytes);
+
+   bool     IsOpen(void){return m_file.IsOpen();}
+   bool     GetError(void);
+   uint64_t GetQueuedBytes(void){return m_totalBytes;}
+   uint64_t GetEncodedBytes(void);
+   uint64_t GetStallCount(void);
+   AsyncFileWriter& GetFileWriter(void){return m_file;}
+
+private:
+   ChunkedCaptureWriter(const ChunkedCaptureWriter& o); //disable copy ctor
+
+   typedef enum
+   {
+      SlotFree,
+      SlotQueued,
+      SlotEncoding,
+      SlotEncoded
+   }SlotState_t;
+
+   typedef struct
+   {
+      std::vector<char>    raw;
+      std::vector<uint8_t> enc;
+      size_t               rawBytes;
+      size_t               encBytes;
+      SlotState_t          state;
+   }Slot_t;
+
+   bool acquireFill(void);
+   void queueFill(void);
+   void encodeLoop(void);
+   void drain(boost::unique_lock<boost::mutex>& lock);
+   void stopWorkers(void);
+
+   AsyncFileWriter      m_file;
+   size_t               m_eltBytes    = 0;
+   size_t               m_chunkBytes  = 0;
+   std::vector<Slot_t>  m_slots;
+   std::vector<CaptureIndexEntry_t> m_index;
+   uint64_t             m_fileOffset  = 0; // where the next chunk lands
+   uint64_t             m_encBytes    = 0;
+   uint64_t             m_totalBytes  = 0; // handed to Write(), producer only
+   Slot_t*              m_fill        = NULL; // producer only
+   uint64_t             m_fillSeq     = 0; // chunk being filled
+   uint64_t             m_encodeSeq   = 0; // next chunk for an encoder
+   uint64_t             m_writeSeq    = 0; // next chunk for the file writer
+   bool                 m_draining    = false;
+   bool                 m_stop        = false;
+   bool                 m_error       = false;
+   uint64_t             m_stallCount  = 0;
+   std::vector<boost::thread*> m_workers;
+   boost::mutex         m_mutex;
+   boost::condition_variable m_cond;
+};
+
+}// namespace terbit
@@ -0,0 +1,378 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "FileDvcChunked.h"
+#include <string.h>
+#include <algorithm>
+
+namespace terbit
+{
+
+static const uint32_t CHUNKED_MAX_THREADS = 8;
+
+static bool seekFile(FILE* f, uint64_t pos, int whence)
+{
+#if !_WINDOWS
+   return 0 == fseeko(f, pos, whence);
+#else
+   return 0 == _fseeki64(f, pos, whence);
+#endif // !_WINDOWS
+}
+
+static uint64_t tellFile(FILE* f)
+{
+#if !_WINDOWS
+   return ftello(f);
+#else
+   return _ftelli64(f);
+#endif // !_WINDOWS
+}
+
+static FILE* openFile(const QString& filename)
+{
+#pragma warning( disable : 4996 )
+   return fopen(filename.toStdString().c_str(), "rb");
+#pragma warning( default : 4996 )
+}
+
+FileDvcChunked::FileDvcChunked()
+{
+   memset(&m_header, 0, sizeof(m_header));
+}
+
+FileDvcChunked::~FileDvcChunked()
+{
+   Close();
+}
+
+bool FileDvcChunked::Open(const QString& filename, bool loop, uint32_t threads)
+{
+   bool retVal = false;
+
+   if(IsValid())
+   {
+      return false;
+   }
+
+   FILE* f = openFile(filename);
+   if(NULL != f)
+   {
+      retVal = readIndex(f);
+      fclose(f);
+   }
+
+   if(retVal)
+   {
+      m_filePathName = filename;
+      m_loop         = loop;
+      m_threads      = threads;
+      if(0 == m_threads)
+      {
+         m_threads = std::min(std::max(boost::thread::hardware_concurrency(), 1u), CHUNKED_MAX_THREADS);
+      }
+
+      // two slots per worker so the workers stay busy while the reader
+      // copies out of the oldest chunks
+      m_slots.resize(2 * m_threads);
+      for(auto& s : m_slots)
+      {
+         s.data.resize(m_chunkBytes);
+         s.nBytes = 0;
+         s.state  = SlotFree;
+      }
+      m_nextSeq = 0;
+      m_readSeq = 0;
+      m_readPtr = 0;
+      m_readPos = 0;
+      m_error   = false;
+      startWorkers();
+   }
+   else
+   {
+      m_index.clear();
+   }
+   return retVal;
+}
+
+void FileDvcChunked::Close(void)
+{
+   stopWorkers();
+   m_slots.clear();
+   m_index.clear();
+   m_filePathName.clear();
+   m_dataBytes       = 0;
+   m_compressedBytes = 0;
+   m_chunkBytes      = 0;
+   m_readPos         = 0;
+   m_error           = false;
+}
+
+// Validates header, footer and index before anything is decoded so a
+// truncated recording (e.g. the writer never closed) is rejected up front.
+bool FileDvcChunked::readIndex(FILE* f)
+{
+   CaptureFooter_t footer;
+   uint64_t fileBytes;
+   uint64_t totalElts = 0;
+
+   if(1 != fread(&m_header, sizeof(m_header), 1, f) ||
+      CAPTURE_MAGIC != m_header.magic || CAPTURE_VERSION < m_header.version ||
+      m_header.headerBytes < sizeof(m_header) || 0 == m_header.chunkElts ||
+      (1 != m_header.eltBytes && 2 != m_header.eltBytes && 4 != m_header.eltBytes && 8 != m_header.eltBytes))
+   {
+      return false;
+   }
+
+   if(!seekFile(f, 0, SEEK_END))
+   {
+      return false;
+   }
+   fileBytes = tellFile(f);
+   if(fileBytes < m_header.headerBytes + sizeof(footer) ||
+      !seekFile(f, fileBytes - sizeof(footer), SEEK_SET) ||
+      1 != fread(&footer, sizeof(footer), 1, f) ||
+      CAPTURE_FOOTER_MAGIC != footer.magic || 0 == footer.chunkCount ||
+      footer.indexOffset < m_header.headerBytes ||
+      footer.indexOffset + footer.chunkCount * sizeof(CaptureIndexEntry_t) + sizeof(footer) != fileBytes)
+   {
+      return false;
+   }
+
+   m_index.resize(footer.chunkCount);
+   if(!seekFile(f, footer.indexOffset, SEEK_SET) ||
+      footer.chunkCount != fread(&m_index[0], sizeof(CaptureIndexEntry_t), footer.chunkCount, f))
+   {
+      return false;
+   }
+
+   for(size_t i = 0; i < m_index.size(); ++i)
+   {
+      const CaptureIndexEntry_t& e = m_index[i];
+      bool last = (i + 1 == m_index.size());
+      if(e.offset < m_header.headerBytes || e.offset + e.bytes > footer.indexOffset ||
+         0 == e.bytes || 0 == e.nElts || e.nElts > m_header.chunkElts ||
+         (!last && e.nElts != m_header.chunkElts))
+      {
+         return false;
+      }
+      totalElts += e.nElts;
+   }
+   if(totalElts != footer.totalElts)
+   {
+      return false;
+   }
+
+   m_chunkBytes      = (uint64_t)m_header.chunkElts * m_header.eltBytes;
+   m_dataBytes       = totalElts * m_header.eltBytes;
+   m_compressedBytes = fileBytes;
+   return true;
+}
+
+void FileDvcChunked::startWorkers(void)
+{
+   m_stop = false;
+   for(uint32_t i = 0; i < m_threads; ++i)
+   {
+      m_workers.push_back(new boost::thread(boost::bind(&FileDvcChunked::decodeLoop, this)));
+   }
+}
+
+void FileDvcChunked::stopWorkers(void)
+{
+   if(!m_workers.empty())
+   {
+      {
+         boost::lock_guard<boost::mutex> lock(m_mutex);
+         m_stop = true;
+      }
+      m_cond.notify_all();
+      for(auto w : m_workers)
+      {
+         w->join();
+         delete w;
+      }
+      m_workers.clear();
+   }
+}
+
+// Sequences past this one don't exist, loop mode never runs out
+uint64_t FileDvcChunked::lastSeq(void)
+{
+   return m_loop ? UINT64_MAX : m_index.size() - 1;
+}
+
+// Worker: claim the next sequence once its slot is free, then read and
+// decode the chunk without holding the lock.  Workers finish out of order,
+// the reader waits on the slot it needs.
+void FileDvcChunked::decodeLoop(void)
+{
+   std::vector<uint8_t> comp;
+   FILE* f = openFile(m_filePathName);
+
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+   while(true)
+   {
+      while(!m_stop && (m_nextSeq > lastSeq() || m_nextSeq >= m_readSeq + m_slots.size()))
+      {
+         m_cond.wait(lock);
+      }
+      if(m_stop)
+      {
+         break;
+      }
+
+      uint64_t seq = m_nextSeq++;
+      Slot_t& s = m_slots[seq % m_slots.size()];
+      const CaptureIndexEntry_t& e = m_index[seq % m_index.size()];
+      s.state = SlotBusy;
+      lock.unlock();
+
+      bool ok = false;
+      if(NULL != f)
+      {
+         comp.resize(e.bytes);
+         ok = seekFile(f, e.offset, SEEK_SET) && 1 == fread(&comp[0], e.bytes, 1, f) &&
+              CaptureDecodeChunk(&comp[0], e.bytes, m_header.eltBytes, e.nElts, &s.data[0]);
+      }
+
+      lock.lock();
+      s.nBytes = (uint64_t)e.nElts * m_header.eltBytes;
+      s.state  = ok ? SlotReady : SlotError;
+      m_cond.notify_all();
+   }
+   lock.unlock();
+
+   if(NULL != f)
+   {
+      fclose(f);
+   }
+}
+
+uint64_t FileDvcChunked::Read(void* dst, size_t eltSize, uint64_t nElts, const void* src)
+{
+   uint64_t bytesXfrd = 0;
+   uint64_t bytes2Xfr = nElts * eltSize;
+   src;
+
+   if(!IsValid())
+   {
+      return 0;
+   }
+
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+   while(bytesXfrd < bytes2Xfr && !m_error && m_readSeq <= lastSeq())
+   {
+      // the slot of m_readSeq belongs to the reader once it is ready
+      Slot_t& s = m_slots[m_readSeq % m_slots.size()];
+      while(SlotReady != s.state && SlotError != s.state)
+      {
+         m_cond.wait(lock);
+      }
+      if(SlotError == s.state)
+      {
+         m_error = true;
+         break;
+      }
+
+      uint64_t n = s.nBytes - m_readPtr;
+      if(n > bytes2Xfr - bytesXfrd)
+      {
+         n = bytes2Xfr - bytesXfrd;
+      }
+      lock.unlock();
+      memcpy((char*)dst + bytesXfrd, &s.data[m_readPtr], n);
+      lock.lock();
+
+      m_readPtr += n;
+      bytesXfrd += n;
+      if(m_readPtr == s.nBytes)
+      {
+         s.state   = SlotFree;
+         m_readPtr = 0;
+         ++m_readSeq;
+         m_cond.notify_all();
+      }
+   }
+
+   m_readPos += bytesXfrd;
+   if(m_loop && m_dataBytes > 0)
+   {
+      m_readPos %= m_dataBytes;
+   }
+
+   return bytesXfrd;
+}
+
+bool FileDvcChunked::GetEof(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   return m_error || m_readSeq > lastSeq();
+}
+
+uint64_t FileDvcChunked::SeekBegin(void)
+{
+   return Seek(0);
+}
+
+// Discards the decoded chunks and restarts the workers at the chunk
+// holding pos.  The reader skips into that chunk once it's decoded.
+uint64_t FileDvcChunked::Seek(uint64_t pos)
+{
+   uint64_t retVal = -1;
+   if(IsValid())
+   {
+      stopWorkers();
+      if(pos > m_dataBytes)
+      {
+         pos = m_dataBytes;
+      }
+      m_readSeq = pos / m_chunkBytes;
+      m_readPtr = pos - m_readSeq * m_chunkBytes;
+      if(pos == m_dataBytes)
+      {
+         // the end of the data, or the start again when looping
+         m_readSeq = m_index.size();
+         m_readPtr = 0;
+      }
+      m_nextSeq = m_readSeq;
+      for(auto& s : m_slots)
+      {
+         s.state = SlotFree;
+      }
+      m_error   = false;
+      m_readPos = m_loop ? pos % m_dataBytes : pos;
+      startWorkers();
+      retVal = m_readPos;
+   }
+   return retVal;
+}
+
+// Restarts the workers from the current position, the sequence numbers of
+// a looping reader may already be past the last chunk.
+void FileDvcChunked::SetLoop(bool loop)
+{
+   if(IsValid())
+   {
+      stopWorkers();
+      m_loop = loop;
+      Seek(m_readPos);
+   }
+   else
+   {
+      m_loop = loop;
+   }
+}
+
+}// namespace terbit
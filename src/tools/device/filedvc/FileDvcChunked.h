@@ -0,0 +1,106 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include <QString>
+#include <boost/thread.hpp>
+#include "IFileDvc.h"
+#include "CaptureCodec.h"
+
+namespace terbit
+{
+
+/*** Plays back a chunked capture container (see CaptureCodec.h) as the
+ * decoded byte stream.  Worker threads decode the chunks ahead of the
+ * reader in parallel, each with its own file handle.  Chunk sequence s is
+ * decoded into slot s % slots, and a worker only starts on a sequence
+ * once the reader has released the slot, so the reader always consumes the
+ * chunks in order.  In loop mode the sequence keeps counting and maps back
+ * to chunk s % chunkCount.
+ * The file position and size are in decoded bytes, so seeking is the same
+ * as for a raw file; a seek only decodes the chunk it lands in.
+ **************************************************************/
+class FileDvcChunked : public IFileDvc
+{
+public:
+   FileDvcChunked();
+   ~FileDvcChunked();
+
+   bool Open(const QString& filename, bool loop = false, uint32_t threads = 0);
+   void Close(void);
+
+   uint64_t Read(void* dst, size_t eltSize, uint64_t nElts, const void* src);
+
+   void     SetLoop(bool loop);
+   bool     GetLoop(void){return m_loop;}
+   bool     GetEof(void);
+   bool     IsValid(void){return !m_index.empty();}
+   uint64_t GetFileBytes(void){return m_dataBytes;}
+   uint64_t GetFilePos(void){return m_readPos;}
+   uint64_t SeekBegin(void);
+   uint64_t Seek(uint64_t pos);
+
+   const CaptureHeader_t& GetHeader(void){return m_header;}
+   uint64_t GetCompressedBytes(void){return m_compressedBytes;}
+   uint32_t GetNumThreads(void){return (uint32_t)m_workers.size();}
+
+private:
+   typedef enum
+   {
+      SlotFree,
+      SlotBusy,
+      SlotReady,
+      SlotError
+   }SlotState_t;
+
+   typedef struct
+   {
+      std::vector<char> data;   // decoded chunk
+      uint64_t          nBytes;
+      SlotState_t       state;
+   }Slot_t;
+
+   bool readIndex(FILE* f);
+   void startWorkers(void);
+   void stopWorkers(void);
+   void decodeLoop(void);
+   uint64_t lastSeq(void);
+
+   QString                  m_filePathName;
+   CaptureHeader_t          m_header;
+   std::vector<CaptureIndexEntry_t> m_index;
+   uint64_t                 m_dataBytes       = 0;
+   uint64_t                 m_compressedBytes = 0;
+   uint64_t                 m_chunkBytes      = 0; // decoded bytes of a full chunk
+   uint32_t                 m_threads         = 0;
+   bool                     m_loop            = false;
+   std::vector<Slot_t>      m_slots;
+   uint64_t                 m_nextSeq   = 0; // next sequence to hand to a worker
+   uint64_t                 m_readSeq   = 0; // sequence being consumed
+   uint64_t                 m_readPtr   = 0; // bytes consumed in the m_readSeq chunk
+   uint64_t                 m_readPos   = 0;
+   bool                     m_error     = false;
+   bool                     m_stop      = false;
+   std::vector<boost::thread*> m_workers;
+   boost::mutex             m_mutex;
+   boost::condition_variable m_cond;
+};
+
+}// namespace terbit
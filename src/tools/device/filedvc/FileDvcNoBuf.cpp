@@ -16,6 +16,7 @@ limitations under the License.
 #include "FileDvcNoBuf.h"
 #include <stdio.h>
 #include <fcntl.h>
+#include <algorithm>
 
 #if _WINDOWS
 #include <io.h>
@@ -48,6 +49,8 @@ bool FileDvcNoBuf::Open(const QStringList& files, bool loop)
 
 void FileDvcNoBuf::Close(void)
 {
+   m_reader.Close();
+   m_readerIdx = (size_t)-1;
    for(auto it : m_fileList)
    {
       if(NULL != it.hFile)
@@ -61,6 +64,7 @@ void FileDvcNoBuf::Close(void)
    m_dataBytes    = 0;
    m_isValid      = false;
    m_fileList.clear();
+   m_fileOffsets.clear();
 }
 
 // QString.isNull() returns true on failure
@@ -118,6 +122,7 @@ uint64_t FileDvcNoBuf::SetCurFilePos(uint64_t pos)
 
       retVal = m_fileList[m_curFileIdx].curFilePos = getFilePos(m_fileList[m_curFileIdx].hFile);
       m_dataPos = calcCurDataPos();
+      updateEod();
    }
    else
    {
@@ -141,28 +146,20 @@ uint64_t FileDvcNoBuf::GetCurFilePos()
 }
 
 
-// Can only set to the last position
+// Positions past the end go to the end of the last file.  The file holding
+// pos is found from the file start offsets, no data is read.
 uint64_t FileDvcNoBuf::SetDataPos(uint64_t pos)
 {
-   uint64_t sum = 0;
-   if(pos > m_dataBytes - 1)
+   if(!m_fileList.empty())
    {
-      pos = m_dataBytes - 1;
-   }
-
-   bool done = false;
-   for(auto i = 0; i < m_fileList.size() && !done; ++i)
-   {
-      if(sum + m_fileList[i].nFileBytes > pos)
+      if(pos > m_dataBytes)
       {
-         m_curFileIdx = i;
-         SetCurFilePos(pos - sum);
-         done = true;
-      }
-      else
-      {
-         sum += m_fileList[i].nFileBytes;
+         pos = m_dataBytes;
       }
+
+      // last file starting at or before pos
+      m_curFileIdx = std::upper_bound(m_fileOffsets.begin(), m_fileOffsets.end(), pos) - m_fileOffsets.begin() - 1;
+      SetCurFilePos(pos - m_fileOffsets[m_curFileIdx]);
    }
 
    return GetDataPos();
@@ -189,6 +186,37 @@ void FileDvcNoBuf::SeekFileBegin()
     rewind(m_fileList[m_curFileIdx].hFile);
     m_fileList[m_curFileIdx].curFilePos = 0;
     m_dataPos = calcCurDataPos();
+    updateEod();
+}
+
+void FileDvcNoBuf::SetLoop(bool loop)
+{
+   m_loop = loop;
+   updateEod();
+}
+
+// Seeking or toggling loop has to re-evaluate end of data, otherwise a
+// device that once hit the end stays stuck there after a rewind.
+void FileDvcNoBuf::updateEod()
+{
+   m_eod = (m_dataPos == m_dataBytes) && !m_loop;
+}
+
+// Hint the OS to start pulling in the file after the current one so that
+// crossing a file boundary doesn't stall on a cold file.
+void FileDvcNoBuf::AdviseNextFile()
+{
+#if !_WINDOWS
+   size_t next = m_curFileIdx + 1;
+   if(next >= m_fileList.size() && m_loop)
+   {
+      next = 0;
+   }
+   if(next < m_fileList.size() && next != m_curFileIdx)
+   {
+      posix_fadvise(fileno(m_fileList[next].hFile), 0, 0, POSIX_FADV_WILLNEED);
+   }
+#endif // !_WINDOWS
 }
 
 
@@ -253,6 +281,7 @@ bool FileDvcNoBuf::ReIndex(const QStringList &filePaths)
       if(NULL != fi.hFile)
       {
          retVal = true;
+         m_fileOffsets.push_back(m_dataBytes);
          fi.nFileBytes = getFileBytes(fi.hFile);
          m_dataBytes += fi.nFileBytes;
          fi.filePathName = it;
@@ -271,13 +300,7 @@ bool FileDvcNoBuf::ReIndex(const QStringList &filePaths)
 
 uint64_t FileDvcNoBuf::calcCurDataPos()
 {
-   uint64_t retVal = 0;
-   for(auto i = 0; i < m_curFileIdx; ++i)
-   {
-      retVal += m_fileList[i].nFileBytes;
-   }
-
-   return retVal += m_fileList[m_curFileIdx].curFilePos;
+   return m_fileOffsets[m_curFileIdx] + m_fileList[m_curFileIdx].curFilePos;
 }
 
 // returns -1 if file access failure
@@ -334,12 +357,13 @@ uint64_t FileDvcNoBuf::Read(void* dst, size_t eltSize, uint64_t nElts)
    {
       if(m_curFileIdx < m_fileList.size())// safety check
       {
-         bytesRead = fread((char*)dst + bytesXfrd, 1, bytes2Xfr - bytesXfrd, m_fileList[m_curFileIdx].hFile);
+         bool eof;
+         bytesRead = readCurFile((char*)dst + bytesXfrd, bytes2Xfr - bytesXfrd, eof);
          m_fileList[m_curFileIdx].curFilePos += bytesRead;
          if(bytesRead < bytes2Xfr - bytesXfrd)
          {
             // Check for EOF.
-            if(feof(m_fileList[m_curFileIdx].hFile))
+            if(eof)
             {
                bool rollover;
                done = !getNextFile(rollover);
@@ -352,7 +376,6 @@ uint64_t FileDvcNoBuf::Read(void* dst, size_t eltSize, uint64_t nElts)
             {
                // some sort of error
                // TODO: signal access failure
-               clearerr(m_fileList[m_curFileIdx].hFile);
                done = true;
             }
          }
@@ -368,12 +391,56 @@ uint64_t FileDvcNoBuf::Read(void* dst, size_t eltSize, uint64_t nElts)
          done = true;
       }
 
-      m_eod = (m_dataPos == m_dataBytes) && !m_loop;
+      updateEod();
    }
 
    return bytesXfrd;
 }
 
+// Reads the current file from its curFilePos.  The reader is opened on the
+// file the first time it is read after a file change (buffered, looping
+// reads the files again) and re-positioned when a seek or rewind moved
+// curFilePos away from where its reads left off.
+uint64_t FileDvcNoBuf::readCurFile(void* dst, uint64_t bytes, bool& eof)
+{
+   FileInfo_t& fi = m_fileList[m_curFileIdx];
+   uint64_t bytesRead;
+
+   if(m_readerIdx != m_curFileIdx)
+   {
+      m_reader.Open(fi.filePathName, AsyncFileReader::AsyncAuto, false);
+      m_readerIdx = m_curFileIdx;
+   }
+
+   if(m_reader.IsValid())
+   {
+      if(m_reader.GetFilePos() != fi.curFilePos)
+      {
+         m_reader.Seek(fi.curFilePos);
+      }
+      bytesRead = m_reader.Read(dst, bytes);
+      eof = !m_reader.GetError() && m_reader.GetFilePos() >= m_reader.GetFileBytes();
+   }
+   else
+   {
+      if(getFilePos(fi.hFile) != fi.curFilePos)
+      {
+#if !_WINDOWS
+         fseeko(fi.hFile, fi.curFilePos, SEEK_SET);
+#else
+         _fseeki64(fi.hFile, fi.curFilePos, SEEK_SET);
+#endif // !_WINDOWS
+      }
+      bytesRead = fread(dst, 1, bytes, fi.hFile);
+      eof = 0 != feof(fi.hFile);
+      if(bytesRead < bytes && !eof)
+      {
+         clearerr(fi.hFile);
+      }
+   }
+   return bytesRead;
+}
+
 bool FileDvcNoBuf::getNextFile(bool& rollover)
 {
    bool retVal = false;
@@ -18,6 +18,7 @@ limitations under the License.
 #include <QString>
 #include <QStringList>
 #include <stdio.h>
+#include "AsyncFileReader.h"
 
 namespace terbit
 {
@@ -37,6 +38,9 @@ namespace terbit
  * recalculate the size.
  * This class will emit several signals on certain events such
  * as crossing into a new file or having a file access failure.
+ * Reads go through one AsyncFileReader that follows the current file,
+ * re-opened when the device moves to another file and re-positioned after
+ * a seek; stdio reads are the fallback for a file it can't open.
  **************************************************************/
 
 class FileDvcNoBuf
@@ -52,7 +56,7 @@ public:
    void   Close(void);
 
    // Accessor Functions
-   void     SetLoop(bool loop){m_loop = loop;}
+   void     SetLoop(bool loop);
    bool     GetLoop(void){return m_loop;}
    QString  GetCurFilePathName(void);
    uint64_t GetCurFileBytes(void);
@@ -67,6 +71,9 @@ public:
    void     SeekFileBegin(void);
    bool     AdvanceFile(int64_t nfiles);
    bool     ReIndex(const QStringList& filePaths);
+   size_t   GetCurFileIdx(void){return m_curFileIdx;}
+   size_t   GetNumFiles(void){return m_fileList.size();}
+   void     AdviseNextFile(void);
    // TODO: a reindex that takes a file that could be more surgical
 
 
@@ -84,6 +91,8 @@ private:
    bool getNextFile(bool &rollover);
    uint64_t calcCurDataPos();
    uint64_t getFilePos(FILE* hFile);
+   void updateEod(void);
+   uint64_t readCurFile(void* dst, uint64_t bytes, bool& eof);
 
 private:
    typedef struct
@@ -104,5 +113,8 @@ private:
    uint64_t   m_dataPos    = 0;
    uint64_t   m_dataBytes  = 0;
    std::vector<FileDvcNoBuf::FileInfo_t> m_fileList;
+   std::vector<uint64_t> m_fileOffsets; // data position of the start of each file
+   AsyncFileReader m_reader;
+   size_t     m_readerIdx  = (size_t)-1; // file m_reader was last opened on
 };
 }// namespace terbit
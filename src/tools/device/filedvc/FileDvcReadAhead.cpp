@@ -0,0 +1,276 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "FileDvcReadAhead.h"
+#include <string.h>
+#include <new>
+
+namespace terbit
+{
+
+static const uint64_t READ_AHEAD_CHUNK_BYTES = 4*1024*1024;
+static const size_t   READ_AHEAD_CHUNKS      = 4;
+
+FileDvcReadAhead::FileDvcReadAhead()
+{
+
+}
+
+FileDvcReadAhead::~FileDvcReadAhead()
+{
+   Close();
+}
+
+bool FileDvcReadAhead::Open(const QStringList& files, bool loop)
+{
+   bool retVal = false;
+
+   if(!m_dvc.IsValid() && m_dvc.Open(files, loop))
+   {
+      retVal = true;
+      for(size_t i = 0; i < READ_AHEAD_CHUNKS && retVal; ++i)
+      {
+         Chunk_t c;
+         c.pBuf    = new(std::nothrow) char[READ_AHEAD_CHUNK_BYTES];
+         c.nBytes  = 0;
+         c.readPtr = 0;
+         if(NULL != c.pBuf)
+         {
+            m_chunks.push_back(c);
+         }
+         else
+         {
+            retVal = false;
+         }
+      }
+
+      if(retVal)
+      {
+         m_readPos = 0;
+         startWorker();
+      }
+      else
+      {
+         freeChunks();
+         m_dvc.Close();
+      }
+   }
+   return retVal;
+}
+
+void FileDvcReadAhead::Close(void)
+{
+   stopWorker();
+   freeChunks();
+   m_dvc.Close();
+   m_readPos = 0;
+}
+
+void FileDvcReadAhead::freeChunks(void)
+{
+   for(auto& c : m_chunks)
+   {
+      delete[] c.pBuf;
+   }
+   m_chunks.clear();
+   m_head  = 0;
+   m_count = 0;
+   m_eod   = false;
+}
+
+void FileDvcReadAhead::startWorker(void)
+{
+   m_stop   = false;
+   m_worker = new boost::thread(boost::bind(&FileDvcReadAhead::prefetchLoop, this));
+}
+
+void FileDvcReadAhead::stopWorker(void)
+{
+   if(NULL != m_worker)
+   {
+      {
+         boost::lock_guard<boost::mutex> lock(m_mutex);
+         m_stop = true;
+      }
+      m_cond.notify_all();
+      m_worker->join();
+      delete m_worker;
+      m_worker = NULL;
+   }
+}
+
+// Worker: fill the free chunks in order.  The chunk being filled is not
+// visible to the consumer until m_count is bumped, so the disk read itself
+// happens outside the lock.
+void FileDvcReadAhead::prefetchLoop(void)
+{
+   size_t lastFileIdx = m_dvc.GetCurFileIdx();
+   m_dvc.AdviseNextFile();
+
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+   while(true)
+   {
+      while(!m_stop && (m_count == m_chunks.size() || m_eod))
+      {
+         m_cond.wait(lock);
+      }
+      if(m_stop)
+      {
+         break;
+      }
+
+      Chunk_t& c = m_chunks[(m_head + m_count) % m_chunks.size()];
+      lock.unlock();
+
+      uint64_t bytes = m_dvc.Read(c.pBuf, 1, READ_AHEAD_CHUNK_BYTES);
+      if(m_dvc.GetCurFileIdx() != lastFileIdx)
+      {
+         lastFileIdx = m_dvc.GetCurFileIdx();
+         m_dvc.AdviseNextFile();
+      }
+
+      lock.lock();
+      c.nBytes  = bytes;
+      c.readPtr = 0;
+      if(bytes > 0)
+      {
+         ++m_count;
+      }
+      // a short read is either the end of data or an access failure,
+      // either way there is nothing more to fetch
+      m_eod = m_dvc.GetEod() || bytes < READ_AHEAD_CHUNK_BYTES;
+      m_cond.notify_all();
+   }
+}
+
+uint64_t FileDvcReadAhead::Read(void* dst, size_t eltSize, uint64_t nElts, const void* src)
+{
+   uint64_t bytesXfrd = 0;
+   uint64_t bytes2Xfr = nElts * eltSize;
+   src;
+
+   if(!IsValid())
+   {
+      return 0;
+   }
+
+   boost::unique_lock<boost::mutex> lock(m_mutex);
+   while(bytesXfrd < bytes2Xfr)
+   {
+      while(0 == m_count && !m_eod)
+      {
+         m_cond.wait(lock);
+      }
+      if(0 == m_count)
+      {
+         break; // end of data
+      }
+
+      // the head chunk belongs to the consumer while m_count > 0
+      Chunk_t& c = m_chunks[m_head];
+      uint64_t n = c.nBytes - c.readPtr;
+      if(n > bytes2Xfr - bytesXfrd)
+      {
+         n = bytes2Xfr - bytesXfrd;
+      }
+      lock.unlock();
+      memcpy((char*)dst + bytesXfrd, c.pBuf + c.readPtr, n);
+      lock.lock();
+
+      c.readPtr += n;
+      bytesXfrd += n;
+      if(c.readPtr == c.nBytes)
+      {
+         m_head = (m_head + 1) % m_chunks.size();
+         --m_count;
+         m_cond.notify_all();
+      }
+   }
+
+   m_readPos += bytesXfrd;
+   if(m_dvc.GetLoop() && m_dvc.GetDataBytes() > 0)
+   {
+      m_readPos %= m_dvc.GetDataBytes();
+   }
+
+   return bytesXfrd;
+}
+
+bool FileDvcReadAhead::GetEof(void)
+{
+   boost::lock_guard<boost::mutex> lock(m_mutex);
+   return m_eod && 0 == m_count;
+}
+
+// Discards whatever was read ahead and restarts from the first file
+uint64_t FileDvcReadAhead::SeekBegin(void)
+{
+   uint64_t retVal = -1;
+   if(IsValid())
+   {
+      stopWorker();
+      m_dvc.SeekDataBegin();
+      m_head    = 0;
+      m_count   = 0;
+      m_eod     = false;
+      m_readPos = 0;
+      startWorker();
+      retVal = m_readPos;
+   }
+   return retVal;
+}
+
+// Discards whatever was read ahead and restarts at pos, which may be in any
+// file of the list.
+uint64_t FileDvcReadAhead::Seek(uint64_t pos)
+{
+   uint64_t retVal = -1;
+   if(IsValid())
+   {
+      stopWorker();
+      m_dvc.SetDataPos(pos);
+      m_head    = 0;
+      m_count   = 0;
+      m_eod     = m_dvc.GetEod();
+      m_readPos = m_dvc.GetDataPos();
+      startWorker();
+      retVal = m_readPos;
+   }
+   return retVal;
+}
+
+// Data already queued stays valid; the worker just continues (or resumes,
+// if it had stopped at the end) with the new setting.
+void FileDvcReadAhead::SetLoop(bool loop)
+{
+   if(IsValid())
+   {
+      stopWorker();
+      m_dvc.SetLoop(loop);
+      {
+         boost::lock_guard<boost::mutex> lock(m_mutex);
+         m_eod = m_dvc.GetEod();
+      }
+      startWorker();
+   }
+   else
+   {
+      m_dvc.SetLoop(loop);
+   }
+}
+
+}// namespace terbit
@@ -0,0 +1,85 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <QString>
+#include <QStringList>
+#include <boost/thread.hpp>
+#include "IFileDvc.h"
+#include "FileDvcNoBuf.h"
+
+namespace terbit
+{
+
+/*** Streams a list of files as one continuous source.  A worker thread
+ * reads ahead through a FileDvcNoBuf into a small queue of fixed-size
+ * chunks so the consumer never waits on the disk unless it outruns it,
+ * and the next file in the list is hinted to the OS before the boundary
+ * is crossed.  Loop mode wraps from the last file back to the first.
+ * Read() copies out of the queued chunks; GetEof() only reports true
+ * once the worker has hit the end of the data and the queue is drained.
+ **************************************************************/
+class FileDvcReadAhead : public IFileDvc
+{
+public:
+   FileDvcReadAhead();
+   ~FileDvcReadAhead();
+
+   bool Open(const QStringList& files, bool loop = false);
+   void Close(void);
+
+   uint64_t Read(void* dst, size_t eltSize, uint64_t nElts, const void* src);
+
+   void     SetLoop(bool loop);
+   bool     GetLoop(void){return m_dvc.GetLoop();}
+   bool     GetEof(void);
+   bool     IsValid(void){return m_dvc.IsValid();}
+   uint64_t GetFileBytes(void){return m_dvc.GetDataBytes();}
+   uint64_t GetFilePos(void){return m_readPos;}
+   uint64_t SeekBegin(void);
+   uint64_t Seek(uint64_t pos);
+   size_t   GetNumFiles(void){return m_dvc.GetNumFiles();}
+
+private:
+   typedef struct
+   {
+      char*    pBuf;
+      uint64_t nBytes;
+      uint64_t readPtr;
+   }Chunk_t;
+
+   void startWorker(void);
+   void stopWorker(void);
+   void prefetchLoop(void);
+   void freeChunks(void);
+
+   FileDvcNoBuf         m_dvc;
+   std::vector<Chunk_t> m_chunks;
+   size_t               m_head  = 0; // next chunk to consume
+   size_t               m_count = 0; // chunks filled and not yet consumed
+   bool                 m_eod   = false; // worker reached the end of data
+   bool                 m_stop  = false;
+   uint64_t             m_readPos = 0;
+   boost::thread*       m_worker  = NULL;
+   boost::mutex         m_mutex;
+   boost::condition_variable m_cond;
+};
+
+}// namespace terbit
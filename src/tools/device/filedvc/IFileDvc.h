@@ -0,0 +1,53 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace terbit
+{
+
+/*** Common read interface of the file devices so a consumer such as the
+ * FileDevice block can stream from a single cached/mapped file (FileDvc)
+ * or from a set of files read ahead on a worker thread (FileDvcReadAhead)
+ * without caring which one it holds.
+ **************************************************************/
+class IFileDvc
+{
+public:
+   IFileDvc() {}
+   virtual ~IFileDvc() {}
+
+   virtual uint64_t Read(void* dst, size_t eltSize, uint64_t nElts, const void* src) = 0;
+   // Zero-copy read; devices that can't hand out pointers return NULL
+   virtual const void* ReadMapped(uint64_t nBytes) { nBytes; return NULL; }
+
+   virtual void     SetLoop(bool loop) = 0;
+   virtual bool     GetEof(void) = 0;
+   virtual bool     IsValid(void) = 0;
+   virtual bool     IsMapped(void) { return false; }
+   virtual uint64_t GetFileBytes(void) = 0;
+   virtual uint64_t GetFilePos(void) = 0;
+   virtual uint64_t SeekBegin(void) = 0;
+   // Jump to a byte offset in the data without reading up to it, offsets
+   // past the end go to the end.  Returns the new position.
+   virtual uint64_t Seek(uint64_t pos) = 0;
+};
+
+}// namespace terbit
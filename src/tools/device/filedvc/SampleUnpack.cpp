@@ -0,0 +1,336 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "SampleUnpack.h"
+#include "tools/Tools.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TERBIT_UNPACK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 code is compiled per function so the rest of the build keeps its
+// baseline instruction set; MSVC allows the intrinsics without flags.
+#if defined(__GNUC__) || defined(__clang__)
+#define TERBIT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TERBIT_TARGET_AVX2
+#endif
+
+namespace terbit
+{
+
+static bool isPackedBits(uint32_t packedBits)
+{
+   return 12 == packedBits || 14 == packedBits || 24 == packedBits;
+}
+
+static bool isSigned(TerbitDataType type)
+{
+   return TERBIT_INT16 == type || TERBIT_INT32 == type;
+}
+
+bool SampleFormatSupported(TerbitDataType type, uint32_t packedBits, bool bigEndian)
+{
+   bigEndian;
+   switch(packedBits)
+   {
+   case 0:
+      return type >= TERBIT_INT8 && type <= TERBIT_DOUBLE;
+   case 12:
+   case 14:
+      return TERBIT_INT16 == type || TERBIT_UINT16 == type;
+   case 24:
+      return TERBIT_INT32 == type || TERBIT_UINT32 == type;
+   default:
+      return false;
+   }
+}
+
+uint32_t SampleFormatGroupElts(uint32_t packedBits)
+{
+   switch(packedBits)
+   {
+   case 12:
+      return 2;
+   case 14:
+      return 4;
+   default:
+      return 1;
+   }
+}
+
+uint64_t SampleFormatBytes(TerbitDataType type, uint32_t packedBits, uint64_t nElts)
+{
+   if(isPackedBits(packedBits))
+   {
+      uint32_t group = SampleFormatGroupElts(packedBits);
+      nElts = (nElts + group - 1) / group * group;
+      return nElts * packedBits / 8;
+   }
+   return nElts * TerbitDataTypeSize(type);
+}
+
+uint64_t SampleFormatElts(TerbitDataType type, uint32_t packedBits, uint64_t nBytes)
+{
+   if(isPackedBits(packedBits))
+   {
+      return nBytes * 8 / packedBits;
+   }
+   return nBytes / TerbitDataTypeSize(type);
+}
+
+// ------------------------------- scalar kernels ------------------------------
+
+// Reads only the bytes that hold each sample, so it is also the tail of
+// the vector kernels.
+template<typename T>
+static void unpackScalar(const uint8_t* src, T* dst, uint64_t first, uint64_t nElts, uint32_t bits, bool bigEndian, bool sign)
+{
+   uint32_t mask = (1u << bits) - 1;
+   uint32_t signShift = 32 - bits;
+
+   for(uint64_t i = first; i < nElts; ++i)
+   {
+      uint64_t bit = i * bits;
+      const uint8_t* p = src + (bit >> 3);
+      uint32_t shift = (uint32_t)(bit & 7);
+      uint32_t nBytes = (shift + bits + 7) >> 3;
+      uint32_t v = 0;
+
+      if(bigEndian)
+      {
+         for(uint32_t k = 0; k < nBytes; ++k)
+         {
+            v = (v << 8) | p[k];
+         }
+         v >>= nBytes * 8 - shift - bits;
+      }
+      else
+      {
+         for(uint32_t k = 0; k < nBytes; ++k)
+         {
+            v |= (uint32_t)p[k] << (8 * k);
+         }
+         v >>= shift;
+      }
+      v &= mask;
+      dst[i] = sign ? (T)((int32_t)(v << signShift) >> signShift) : (T)v;
+   }
+}
+
+static void swapScalar(const uint8_t* src, uint8_t* dst, uint64_t first, uint64_t nElts, size_t eltBytes)
+{
+   uint8_t tmp[8];
+   for(uint64_t i = first; i < nElts; ++i)
+   {
+      const uint8_t* s = src + i * eltBytes;
+      for(size_t k = 0; k < eltBytes; ++k)
+      {
+         tmp[k] = s[eltBytes - 1 - k];
+      }
+      memcpy(dst + i * eltBytes, tmp, eltBytes);
+   }
+}
+
+// ------------------------------- AVX2 kernels -------------------------------
+#if TERBIT_UNPACK_X86
+
+// Each 128 bit lane unpacks 4 samples, which always start on a byte.  The
+// shuffle gathers the 3 bytes holding a sample into its dword (in value
+// order for big endian), a variable shift lines the sample up with bit 0.
+TERBIT_TARGET_AVX2 static uint64_t unpackAvx2(const uint8_t* src, uint64_t srcBytes, char* dst, uint64_t nElts, uint32_t bits, bool bigEndian, bool sign)
+{
+   char shuf[32];
+   int  shifts[8];
+   uint32_t laneBytes = bits / 2;
+   uint64_t i = 0;
+
+   for(uint32_t j = 0; j < 4; ++j)
+   {
+      uint32_t bit = j * bits;
+      uint32_t off = bit >> 3;
+      uint32_t sh  = bit & 7;
+      for(uint32_t k = 0; k < 3; ++k)
+      {
+         shuf[4 * j + k] = (char)(bigEndian ? off + 2 - k : off + k);
+      }
+      shuf[4 * j + 3] = (char)0x80;
+      shifts[j] = bigEndian ? 24 - sh - bits : sh;
+   }
+   memcpy(shuf + 16, shuf, 16);
+   memcpy(shifts + 4, shifts, 4 * sizeof(int));
+
+   __m256i vShuf  = _mm256_loadu_si256((const __m256i*)shuf);
+   __m256i vShift = _mm256_loadu_si256((const __m256i*)shifts);
+   __m256i vMask  = _mm256_set1_epi32((1 << bits) - 1);
+   __m128i vLeft  = _mm_cvtsi32_si128(32 - bits);
+
+   // 8 samples use `bits` bytes, stop before the 16 byte load of the upper
+   // lane runs past the end of the source
+   while(i + 8 <= nElts && i / 8 * bits + laneBytes + 16 <= srcBytes)
+   {
+      const uint8_t* p = src + i / 8 * bits;
+      __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                          _mm_loadu_si128((const __m128i*)(p + laneBytes)), 1);
+      v = _mm256_srlv_epi32(_mm256_shuffle_epi8(v, vShuf), vShift);
+      if(sign)
+      {
+         v = _mm256_sra_epi32(_mm256_sll_epi32(v, vLeft), vLeft);
+      }
+      else
+      {
+         v = _mm256_and_si256(v, vMask);
+      }
+
+      if(24 == bits)
+      {
+         _mm256_storeu_si256((__m256i*)(dst + i * 4), v);
+      }
+      else
+      {
+         // values fit a signed 16 bit either way, no saturation happens
+         __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+         _mm_storeu_si128((__m128i*)(dst + i * 2), w);
+      }
+      i += 8;
+   }
+   return i;
+}
+
+TERBIT_TARGET_AVX2 static uint64_t swapAvx2(const uint8_t* src, uint8_t* dst, uint64_t nElts, size_t eltBytes)
+{
+   char shuf[32];
+   uint64_t nBytes = nElts * eltBytes;
+   uint64_t b = 0;
+
+   for(size_t k = 0; k < 16; ++k)
+   {
+      shuf[k] = (char)(k - k % eltBytes + eltBytes - 1 - k % eltBytes);
+   }
+   memcpy(shuf + 16, shuf, 16);
+   __m256i vShuf = _mm256_loadu_si256((const __m256i*)shuf);
+
+   for(; b + 32 <= nBytes; b += 32)
+   {
+      __m256i v = _mm256_loadu_si256((const __m256i*)(src + b));
+      _mm256_storeu_si256((__m256i*)(dst + b), _mm256_shuffle_epi8(v, vShuf));
+   }
+   return b / eltBytes;
+}
+
+static bool detectAvx2()
+{
+#if defined(_MSC_VER)
+   int info[4];
+   __cpuid(info, 0);
+   if(info[0] >= 7)
+   {
+      __cpuid(info, 1);
+      bool osxsave = 0 != (info[2] & (1 << 27));
+      __cpuidex(info, 7, 0);
+      bool avx2 = 0 != (info[1] & (1 << 5));
+      // the OS also has to save the YMM registers
+      return avx2 && osxsave && 6 == (_xgetbv(0) & 6);
+   }
+   return false;
+#else
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+static uint64_t unpackAvx2(const uint8_t* src, uint64_t srcBytes, char* dst, uint64_t nElts, uint32_t bits, bool bigEndian, bool sign)
+{
+   src; srcBytes; dst; nElts; bits; bigEndian; sign;
+   return 0;
+}
+
+static uint64_t swapAvx2(const uint8_t* src, uint8_t* dst, uint64_t nElts, size_t eltBytes)
+{
+   src; dst; nElts; eltBytes;
+   return 0;
+}
+
+static bool detectAvx2()
+{
+   return false;
+}
+
+#endif // TERBIT_UNPACK_X86
+
+static bool useAvx2()
+{
+   static const bool avx2 = detectAvx2();
+   return avx2;
+}
+
+const char* GetSampleUnpackKernelName()
+{
+   return useAvx2() ? "avx2" : "scalar";
+}
+
+bool SampleUnpack(const void* src, void* dst, uint64_t nElts, TerbitDataType type, uint32_t packedBits, bool bigEndian)
+{
+   const uint8_t* s = (const uint8_t*)src;
+   uint64_t done = 0;
+
+   if(!SampleFormatSupported(type, packedBits, bigEndian))
+   {
+      return false;
+   }
+
+   if(0 == packedBits)
+   {
+      size_t eltBytes = TerbitDataTypeSize(type);
+      if(!bigEndian || 1 == eltBytes)
+      {
+         if(src != dst)
+         {
+            memcpy(dst, src, nElts * eltBytes);
+         }
+         return true;
+      }
+      if(useAvx2())
+      {
+         done = swapAvx2(s, (uint8_t*)dst, nElts, eltBytes);
+      }
+      swapScalar(s, (uint8_t*)dst, done, nElts, eltBytes);
+      return true;
+   }
+
+   bool sign = isSigned(type);
+   if(useAvx2())
+   {
+      done = unpackAvx2(s, SampleFormatBytes(type, packedBits, nElts), (char*)dst, nElts, packedBits, bigEndian, sign);
+   }
+   if(24 == packedBits)
+   {
+      unpackScalar<int32_t>(s, (int32_t*)dst, done, nElts, packedBits, bigEndian, sign);
+   }
+   else
+   {
+      unpackScalar<int16_t>(s, (int16_t*)dst, done, nElts, packedBits, bigEndian, sign);
+   }
+   return true;
+}
+
+}// namespace terbit
@@ -0,0 +1,55 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tools/TerbitDefs.h"
+
+namespace terbit
+{
+
+/*** Sample formats of digitizer files that aren't native data types.
+ * o packedBits 0 - byte aligned samples of the data type.  bigEndian swaps
+ *   the byte order of each element (any numeric type).
+ * o packedBits 12, 14 - samples packed back to back into a bit stream,
+ *   unpacked into INT16 (sign extended) or UINT16.  2 samples per 3 bytes
+ *   for 12 bit, 4 per 7 bytes for 14 bit.
+ * o packedBits 24 - 3 byte samples unpacked into INT32 or UINT32.
+ * For packed samples bigEndian selects the bit order: false fills each
+ * byte from its least significant bit (sample 0 of 12 bit is byte0 plus the
+ * low nibble of byte1), true from its most significant bit (byte0 then the
+ * high nibble of byte1).
+ * Unpacking runs through AVX2 shuffle kernels picked at runtime on x86,
+ * with scalar code for the tail and other CPUs.
+ **************************************************************/
+bool     SampleFormatSupported(TerbitDataType type, uint32_t packedBits, bool bigEndian);
+// number of elements that fill a whole number of bytes (1 when not packed)
+uint32_t SampleFormatGroupElts(uint32_t packedBits);
+// bytes in the file for nElts elements, nElts is rounded up to a group
+uint64_t SampleFormatBytes(TerbitDataType type, uint32_t packedBits, uint64_t nElts);
+// whole elements in nBytes of the file
+uint64_t SampleFormatElts(TerbitDataType type, uint32_t packedBits, uint64_t nBytes);
+
+// src holds SampleFormatBytes(nElts) bytes.  dst may equal src when not
+// packed (byte swap in place).
+bool     SampleUnpack(const void* src, void* dst, uint64_t nElts, TerbitDataType type, uint32_t packedBits, bool bigEndian);
+
+// Name of the kernel set in use ("avx2" or "scalar")
+const char* GetSampleUnpackKernelName();
+
+}// namespace terbit
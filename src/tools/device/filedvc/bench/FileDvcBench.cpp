@@ -0,0 +1,207 @@
+/*
+Copyright 2016 Codependable, LLC and Jonathan David Guerin
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/*** Compares read throughput of the stdio path FileDvc and FileDvcNoBuf
+ * fall back to (fread into a 1 MB buffer) with AsyncFileReader, which they
+ * read through, on each available backend, with and without O_DIRECT.
+ *
+ *   filedvc-bench [-passes n] [-block bytes] [-depth n] [file ...]
+ *
+ * With no files the sample-data files under $TERBIT_CONNECTOR_HOME are used.
+ * Buffered runs after the first pass are served from the page cache, so
+ * compare direct runs against a cold cache (or files larger than RAM) for
+ * device bandwidth.
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include <QDir>
+#include <QString>
+#include <QStringList>
+#include "tools/device/filedvc/AsyncFileReader.h"
+
+using namespace terbit;
+
+static const size_t STDIO_BUF_BYTES = 1024*1024;
+
+typedef struct
+{
+   uint64_t bytes;
+   double   seconds;
+}BenchResult_t;
+
+static double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool benchStdio(const QStringList& files, BenchResult_t& r)
+{
+   std::vector<char> buf(STDIO_BUF_BYTES);
+   auto start = std::chrono::steady_clock::now();
+
+   r.bytes = 0;
+   for(auto& f : files)
+   {
+      FILE* hFile = fopen(f.toStdString().c_str(), "rb");
+      if(NULL == hFile)
+      {
+         return false;
+      }
+      size_t n;
+      while((n = fread(buf.data(), 1, buf.size(), hFile)) > 0)
+      {
+         r.bytes += n;
+      }
+      fclose(hFile);
+   }
+   r.seconds = elapsed(start);
+   return true;
+}
+
+static bool benchAsync(const QStringList& files, AsyncFileReader::Backend_t backend, bool direct,
+                       size_t blockBytes, uint32_t depth, BenchResult_t& r, bool& gotDirect)
+{
+   auto start = std::chrono::steady_clock::now();
+
+   r.bytes = 0;
+   gotDirect = direct;
+   for(auto& f : files)
+   {
+      AsyncFileReader reader;
+      if(!reader.Open(f, backend, direct, blockBytes, depth) || reader.GetBackend() != backend)
+      {
+         return false;
+      }
+      gotDirect = gotDirect && reader.IsDirect();
+
+      size_t n;
+      volatile char sink = 0;
+      const void* p;
+      while(NULL != (p = reader.NextBlock(n)))
+      {
+         sink += ((const char*)p)[0];
+         r.bytes += n;
+      }
+      if(reader.GetError())
+      {
+         return false;
+      }
+   }
+   r.seconds = elapsed(start);
+   return true;
+}
+
+static void report(const char* name, const char* mode, const std::vector<BenchResult_t>& runs)
+{
+   uint64_t bytes = 0;
+   double seconds = 0, best = 0;
+   for(auto& r : runs)
+   {
+      bytes += r.bytes;
+      seconds += r.seconds;
+      double gbps = (r.seconds > 0) ? r.bytes / r.seconds / 1e9 : 0;
+      best = (gbps > best) ? gbps : best;
+   }
+   printf("%-10s %-9s %8.3f GB/s avg %8.3f GB/s best (%llu bytes x %u)\n", name, mode,
+          (seconds > 0) ? bytes / seconds / 1e9 : 0.0, best,
+          (unsigned long long)(runs.empty() ? 0 : runs[0].bytes), (unsigned)runs.size());
+}
+
+int main(int argc, char* argv[])
+{
+   uint32_t passes = 5;
+   size_t blockBytes = ASYNC_DEFAULT_BLOCK_BYTES;
+   uint32_t depth = ASYNC_DEFAULT_DEPTH;
+   QStringList files;
+
+   for(int i = 1; i < argc; ++i)
+   {
+      if(0 == strcmp(argv[i], "-passes") && i + 1 < argc)
+      {
+         passes = atoi(argv[++i]);
+      }
+      else if(0 == strcmp(argv[i], "-block") && i + 1 < argc)
+      {
+         blockBytes = strtoull(argv[++i], NULL, 0);
+      }
+      else if(0 == strcmp(argv[i], "-depth") && i + 1 < argc)
+      {
+         depth = atoi(argv[++i]);
+      }
+      else
+      {
+         files.append(QString::fromLocal8Bit(argv[i]));
+      }
+   }
+
+   if(files.isEmpty())
+   {
+      QDir dir(QString::fromLocal8Bit(qgetenv("TERBIT_CONNECTOR_HOME")) + "/sample-data");
+      for(auto& f : dir.entryList(QStringList("*.bin"), QDir::Files, QDir::Name))
+      {
+         files.append(dir.filePath(f));
+      }
+   }
+   if(files.isEmpty())
+   {
+      fprintf(stderr, "no input files\n");
+      return 1;
+   }
+
+   printf("%d files, %u passes, block %llu bytes, depth %u\n", files.size(), passes,
+          (unsigned long long)blockBytes, depth);
+
+   std::vector<BenchResult_t> runs;
+   BenchResult_t r;
+   for(uint32_t i = 0; i < passes && benchStdio(files, r); ++i)
+   {
+      runs.push_back(r);
+   }
+   report("stdio", "buffered", runs);
+
+   AsyncFileReader::Backend_t backends[] = {AsyncFileReader::AsyncUring, AsyncFileReader::AsyncPosix, AsyncFileReader::AsyncSync};
+   for(auto backend : backends)
+   {
+      for(int direct = 0; direct < 2; ++direct)
+      {
+         bool gotDirect = false;
+         runs.clear();
+         for(uint32_t i = 0; i < passes && benchAsync(files, backend, 0 != direct, blockBytes, depth, r, gotDirect); ++i)
+         {
+            runs.push_back(r);
+         }
+         if(runs.empty())
+         {
+            printf("%-10s %-9s unavailable\n", AsyncFileReader::GetBackendName(backend), direct ? "direct" : "buffered");
+         }
+         else if(direct && !gotDirect)
+         {
+            printf("%-10s %-9s unavailable (file system refused O_DIRECT)\n", AsyncFileReader::GetBackendName(backend), "direct");
+         }
+         else
+         {
+            report(AsyncFileReader::GetBackendName(backend), direct ? "direct" : "buffered", runs);
+         }
+      }
+   }
+
+   return 0;
+}
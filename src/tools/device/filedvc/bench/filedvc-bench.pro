@@ -0,0 +1,32 @@
+#-------------------------------------------------
+#
+# Read throughput benchmark for the filedvc layer.
+# Not part of buildall, build it on its own:
+#   qmake filedvc-bench.pro && make
+#
+#-------------------------------------------------
+
+REPO_DIR = $$(TERBIT_CONNECTOR_HOME)
+
+QT       -= gui
+TARGET   = filedvc-bench
+TEMPLATE = app
+CONFIG   += console
+CONFIG   -= app_bundle
+
+#be sure to include after settting REPO_DIR and TARGET
+include($${REPO_DIR}/src/tools/qmaketerbit.pri)
+
+SOURCES += \
+    FileDvcBench.cpp \
+    ../AsyncFileReader.cpp
+
+HEADERS += \
+    ../AsyncFileReader.h
+
+LIBS += $$TEMP_LIBS
+
+# POSIX AIO (AsyncFileReader) is in librt before glibc 2.34
+linux-g++*{
+   LIBS += -lrt
+}
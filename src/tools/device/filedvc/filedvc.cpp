@@ -20,6 +20,8 @@ limitations under the License.
 
 #if _WINDOWS
 #include <io.h>
+#else
+#include <sys/mman.h>
 #endif
 
 namespace terbit
@@ -42,9 +44,12 @@ FileDvc::FileDvc()
    m_eod          = false;
    m_filePos      = 0;
    m_isValid      = false;
+   m_pMapFile     = NULL;
+   m_pMap         = NULL;
 }
 
-bool FileDvc::Open(const QString& filename, bool loop)
+// mapped requests a memory-mapped file, see mapFile() for the fallback
+bool FileDvc::Open(const QString& filename, bool loop, bool mapped)
 {
    bool retVal;
    if(m_isValid)
@@ -53,8 +58,16 @@ bool FileDvc::Open(const QString& filename, bool loop)
    }
    else
    {
-      retVal = m_isValid = initialize(filename, loop, true);
-
+      m_loop = loop;
+      m_filePathName = filename;
+      if(mapped && mapFile())
+      {
+         retVal = m_isValid = true;
+      }
+      else
+      {
+         retVal = m_isValid = initialize(filename, loop, true);
+      }
    }
    return retVal;
 }
@@ -66,6 +79,8 @@ void FileDvc::Close(void)
       fclose(m_pFile);
       m_pFile = NULL;
    }
+   m_reader.Close();
+   unmapFile();
    m_loop         = false;
    m_eof          = false;
    m_eod          = false;
@@ -80,9 +95,54 @@ FileDvc::~FileDvc()
    {
       fclose(m_pFile);
    }
+   unmapFile();
    delete [] m_pBuf;
 }
 
+// Maps the whole file.  An empty file or a failed mapping (e.g. a file
+// larger than the address space on a 32-bit build) returns false and
+// the caller falls back to the RAM cache.
+bool FileDvc::mapFile(void)
+{
+   m_pMapFile = new(std::nothrow) QFile(m_filePathName);
+   if(NULL != m_pMapFile && m_pMapFile->open(QIODevice::ReadOnly) && m_pMapFile->size() > 0)
+   {
+      // private mapping so a consumer writing into the data set
+      // gets its own copy of the page instead of touching the file
+      m_pMap = m_pMapFile->map(0, m_pMapFile->size(), QFileDevice::MapPrivateOption);
+   }
+
+   if(NULL != m_pMap)
+   {
+      m_fileBytes = m_pMapFile->size();
+      m_filePos   = 0;
+      m_eof = m_eod = false;
+#if !_WINDOWS
+      madvise(m_pMap, m_fileBytes, MADV_SEQUENTIAL);
+#endif
+   }
+   else
+   {
+      unmapFile();
+   }
+   return NULL != m_pMap;
+}
+
+void FileDvc::unmapFile(void)
+{
+   if(NULL != m_pMapFile)
+   {
+      if(NULL != m_pMap)
+      {
+         m_pMapFile->unmap(m_pMap);
+      }
+      m_pMapFile->close();
+      delete m_pMapFile;
+   }
+   m_pMapFile = NULL;
+   m_pMap     = NULL;
+}
+
 bool FileDvc::initialize(const QString& filename, bool loop, bool newFile)
 {
    bool retVal = false;
@@ -127,14 +187,14 @@ bool FileDvc::initialize(const QString& filename, bool loop, bool newFile)
          _fseeki64(m_pFile, 0, SEEK_END);
          bufSize = m_fileBytes = _ftelli64(m_pFile);
 #endif // !_WINDOWS
+
+         // only files too big for the cache bypass the page cache; small
+         // files are usually re-opened and are faster served from it
+         m_reader.Open(filename, AsyncFileReader::AsyncAuto, m_fileBytes > g_MaxBufBytes);
       }
-      rewind(m_pFile);
+      seekFile(0);
       m_filePos = 0;
-#if !_WINDOWS
-      m_eof = (m_fileBytes == ftello(m_pFile));
-#else
-      m_eof = (m_fileBytes == _ftelli64(m_pFile));
-#endif
+      m_eof = (m_fileBytes == tellFile());
 
       if(bufSize <= m_bufBytes)
       {
@@ -191,21 +251,13 @@ bool FileDvc::initialize(const QString& filename, bool loop, bool newFile)
       {         
          retVal = true;
          // Fill buffer with data from file.
-#if 1
-         size_t temp = fread(m_pBuf, 1, bufSize, m_pFile);
-#else
-         size_t temp = _read((int)m_pFile, m_pBuf, bufSize);
-#endif //!_WINDOWS
+         size_t temp = loadBuffer(bufSize);
          if(temp != bufSize && temp != m_fileBytes)
          {
             // we should have read a full buffer or the whole file
             retVal = false;
          }
-#if !_WINDOWS
-         m_eof = (m_fileBytes ==  ftello(m_pFile));
-#else
-         m_eof = (m_fileBytes == _ftelli64(m_pFile));
-#endif // !_WINDOWS
+         m_eof = (m_fileBytes == tellFile());
          m_endDataPtr = temp;
          m_readPtr    = 0;
          m_eod        = false;
@@ -217,10 +269,171 @@ bool FileDvc::initialize(const QString& filename, bool loop, bool newFile)
 
 uint64_t FileDvc::SeekBegin(void)
 {
-   initialize("", m_loop, false);
+   if(NULL != m_pMap)
+   {
+      m_filePos = 0;
+      m_eof = m_eod = false;
+   }
+   else
+   {
+      initialize("", m_loop, false);
+   }
    return GetFilePos();
 }
 
+// Mapped files and files that fit in the cache just move the read position.
+// Otherwise the cache is refilled starting at pos.
+uint64_t FileDvc::Seek(uint64_t pos)
+{
+   if(pos > m_fileBytes)
+   {
+      pos = m_fileBytes;
+   }
+
+   if(NULL != m_pMap)
+   {
+      m_filePos = pos;
+      m_eof = m_eod = false;
+      if(m_filePos == m_fileBytes)
+      {
+         if(m_loop)
+         {
+            m_filePos = 0;
+         }
+         else
+         {
+            m_eof = m_eod = true;
+         }
+      }
+   }
+   else if(NULL != m_pFile && NULL != m_pBuf && m_fileBytes > 0)
+   {
+      if(m_endDataPtr == m_fileBytes)
+      {
+         // whole file is in the cache
+         m_readPtr = pos;
+      }
+      else
+      {
+         seekFile(pos);
+         m_eof = false;
+         fillDataBuffer(m_pBuf);
+         m_readPtr = 0;
+      }
+      m_filePos = pos % m_fileBytes;
+      m_eod = !m_loop && m_eof && m_readPtr >= m_endDataPtr;
+   }
+   return GetFilePos();
+}
+
+// Returns a pointer into the file mapping for nBytes starting at the current
+// position and advances past them.  Returns NULL (without advancing) when
+// the file is not mapped or the bytes are not contiguous in the mapping,
+// i.e. the request would run past the end of file.  Callers fall back to
+// Read() in that case, which handles the tail and loop wrap-around.
+const void* FileDvc::ReadMapped(uint64_t nBytes)
+{
+   const void* retVal = NULL;
+
+   if(NULL != m_pMap && !m_eod && nBytes > 0 && m_filePos + nBytes <= m_fileBytes)
+   {
+      retVal = m_pMap + m_filePos;
+      m_filePos += nBytes;
+      if(m_filePos == m_fileBytes)
+      {
+         if(m_loop)
+         {
+            m_filePos = 0;
+         }
+         else
+         {
+            m_eof = m_eod = true;
+         }
+      }
+   }
+   return retVal;
+}
+
+// copy from the mapping, wrapping to the beginning of file in loop mode
+uint64_t FileDvc::readMapped(void* dst, uint64_t totalBytes)
+{
+   uint64_t bytesXfrd = 0;
+   uint64_t bytes2Xfr;
+
+   while(bytesXfrd < totalBytes && !m_eod)
+   {
+      bytes2Xfr = totalBytes - bytesXfrd;
+      if(bytes2Xfr > m_fileBytes - m_filePos)
+      {
+         bytes2Xfr = m_fileBytes - m_filePos;
+      }
+
+      memcpy((char*)dst + bytesXfrd, m_pMap + m_filePos, bytes2Xfr);
+      bytesXfrd += bytes2Xfr;
+      m_filePos += bytes2Xfr;
+
+      if(m_filePos >= m_fileBytes)
+      {
+         if(m_loop)
+         {
+            m_filePos = 0;
+         }
+         else
+         {
+            m_eof = m_eod = true;
+         }
+      }
+   }
+   return bytesXfrd;
+}
+
+
+// Fill the cache buffer from the current file position, fillDataBuffer()
+// continues from where the data ended for files larger than the buffer.
+size_t FileDvc::loadBuffer(size_t bytes)
+{
+   return readFile(m_pBuf, bytes);
+}
+
+// The file is read through the async reader, with the reads after this
+// one already in flight, or stdio when the reader couldn't open it.
+size_t FileDvc::readFile(char* dst, size_t bytes)
+{
+   if(m_reader.IsValid())
+   {
+      return (size_t)m_reader.Read(dst, bytes);
+   }
+   return fread(dst, 1, bytes, m_pFile);
+}
+
+void FileDvc::seekFile(uint64_t pos)
+{
+   if(m_reader.IsValid())
+   {
+      m_reader.Seek(pos);
+   }
+   else
+   {
+#if !_WINDOWS
+      fseeko(m_pFile, pos, SEEK_SET);
+#else
+      _fseeki64(m_pFile, pos, SEEK_SET);
+#endif // !_WINDOWS
+   }
+}
+
+uint64_t FileDvc::tellFile(void)
+{
+   if(m_reader.IsValid())
+   {
+      return m_reader.GetFilePos();
+   }
+#if !_WINDOWS
+   return ftello(m_pFile);
+#else
+   return _ftelli64(m_pFile);
+#endif // !_WINDOWS
+}
 
 // This helper function assumes that it has already been determined that we
 // have a valid file and buffer and that we need to read data from the file
@@ -241,18 +454,14 @@ size_t FileDvc::fillDataBuffer(char* dst)
 
    while(bytesXfrd < bytes2Xfr && !done)
    {
-      bytesRead = fread(dst + bytesXfrd, 1, bytes2Xfr - bytesXfrd, m_pFile);
-#if !_WINDOWS
-         m_eof = (m_fileBytes ==  ftello(m_pFile));
-#else
-         m_eof = (m_fileBytes == _ftelli64(m_pFile));
-#endif // !_WINDOWS
+      bytesRead = readFile(dst + bytesXfrd, bytes2Xfr - bytesXfrd);
+      m_eof = (m_fileBytes == tellFile());
 
       if(bytesRead < bytes2Xfr)
       {
          if(m_eof && m_loop)
          {
-            rewind(m_pFile);
+            seekFile(0);
          }
          else
          {
@@ -278,6 +487,11 @@ uint64_t FileDvc::Read(void* dst, size_t eltSize, uint64_t nElts, const void* sr
 
    src; // warning
 
+   if(NULL != m_pMap)
+   {
+      return readMapped(dst, totalBytes);
+   }
+
    // are we a going concern?
    if(NULL != m_pFile && m_endDataPtr > 0 && nElts > 0)
    {
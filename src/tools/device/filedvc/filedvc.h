@@ -19,7 +19,10 @@ limitations under the License.
 
 #include <stdint.h>
 #include <QString>
+#include <QFile>
 #include <stdio.h>
+#include "IFileDvc.h"
+#include "AsyncFileReader.h"
 
 namespace terbit
 {
@@ -31,8 +34,16 @@ namespace terbit
  * then the files and buffers must be carefully managed.
  * There are various ways to approach this - one circular buffer (like a
  * FIFO), ping-pong buffers, multiple buffers, etc.
+ * When opened as mapped, the whole file is memory-mapped instead of cached.
+ * ReadMapped() then hands out pointers straight into the mapping so callers
+ * can avoid copying; Read() still works and copies from the mapping,
+ * handling wrap-around for loop mode.
+ * The cache is filled through an AsyncFileReader kept open with the file
+ * (several reads in flight), the initial fill as well as the refills and
+ * seeks of a file larger than the cache.  fread is the fallback when that
+ * reader can't open the file.
  **************************************************************/
-class FileDvc
+class FileDvc : public IFileDvc
 {
 public:
    FileDvc();
@@ -41,7 +52,8 @@ public:
    // Basic device functions
    uint64_t Read(void* dst, size_t eltSize, uint64_t nElts, const void* src);
    uint64_t Write(const void* src, size_t eltSize, uint64_t nElts, void* dst);
-   bool   Open(const QString& filename, bool loop = false);
+   bool   Open(const QString& filename, bool loop = false, bool mapped = false);
+   const void* ReadMapped(uint64_t nBytes);
    void   Close(void);
 
    // Accessor Functions
@@ -55,13 +67,22 @@ public:
    uint64_t GetFileBytes(void){return  m_fileBytes;}
    bool     GetEof(void){return m_eod;}
    bool     IsValid(){return m_isValid;}
+   bool     IsMapped(void){return NULL != m_pMap;}
    uint64_t GetFilePos(void){return m_filePos;}
    uint64_t SeekBegin(void);
+   uint64_t Seek(uint64_t pos);
 
 
 private:
    bool initialize(const QString& filename, bool loop, bool newFile);
    size_t fillDataBuffer(char* dst);
+   size_t loadBuffer(size_t bytes);
+   bool mapFile(void);
+   void unmapFile(void);
+   uint64_t readMapped(void* dst, uint64_t totalBytes);
+   size_t readFile(char* dst, size_t bytes);
+   void seekFile(uint64_t pos);
+   uint64_t tellFile(void);
 
    bool      m_loop;
    bool      m_eof; // end of file
@@ -76,6 +97,9 @@ private:
    size_t    m_endDataPtr;
    uint64_t    m_fileBytes;
    char*     m_pBuf;
+   QFile*    m_pMapFile;
+   uchar*    m_pMap;
+   AsyncFileReader m_reader;
 };
 }// namespace terbit
 #endif // FILEDVC_H
@@ -11,6 +11,10 @@ win32{
 
 linux-g++*{
    QMAKE_CXXFLAGS += -std=c++11
+   # async file reads through io_uring (raw syscalls, no liburing needed)
+   exists(/usr/include/linux/io_uring.h) {
+      DEFINES += TERBIT_IO_URING
+   }
 }
 
 message($$QMAKESPEC)